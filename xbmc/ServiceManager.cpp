@@ -81,6 +81,18 @@ void CServiceManager::DeinitTesting()
   m_network.reset();
 }
 
+void CServiceManager::InitPVRManagerForTesting()
+{
+  // not started, the PVR containers can be loaded from the databases only
+  m_PVRManager.reset(new PVR::CPVRManager());
+}
+
+void CServiceManager::DeinitPVRManagerForTesting()
+{
+  m_PVRManager->Deinit();
+  m_PVRManager.reset();
+}
+
 bool CServiceManager::InitStageOne()
 {
   m_Platform.reset(CPlatform::CreateInstance());
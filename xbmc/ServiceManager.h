@@ -88,6 +88,11 @@ public:
   bool InitStageTwo(const CAppParamParser &params, const std::string& profilesUserDataFolder);
   bool InitStageThree(const std::shared_ptr<CProfileManager>& profileManager);
   void DeinitTesting();
+  /**\brief Create a PVR manager that is not started, for tests of the PVR containers. Needs an
+   * announcement manager.
+   */
+  void InitPVRManagerForTesting();
+  void DeinitPVRManagerForTesting();
   void DeinitStageThree();
   void DeinitStageTwo();
   void DeinitStageOne();
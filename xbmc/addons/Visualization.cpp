@@ -77,10 +77,13 @@ void CVisualization::Stop()
     m_struct.toAddon->stop(&m_struct);
 }
 
-void CVisualization::AudioData(const float* audioData, int audioDataLength, float *freqData, int freqDataLength)
+void CVisualization::AudioData(const float* audioData, int audioDataLength, const float* freqData, int freqDataLength)
 {
+  // the spectrum is shared between all visualizations, the addon API predates
+  // const correctness here but never writes to it
   if (m_struct.toAddon->audio_data)
-    m_struct.toAddon->audio_data(&m_struct, audioData, audioDataLength, freqData, freqDataLength);
+    m_struct.toAddon->audio_data(&m_struct, audioData, audioDataLength,
+                                 const_cast<float*>(freqData), freqDataLength);
 }
 
 bool CVisualization::IsDirty()
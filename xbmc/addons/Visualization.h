@@ -22,7 +22,7 @@ public:
 
   bool Start(int channels, int samplesPerSec, int bitsPerSample, const std::string& songName);
   void Stop();
-  void AudioData(const float* audioData, int audioDataLength, float *freqData, int freqDataLength);
+  void AudioData(const float* audioData, int audioDataLength, const float* freqData, int freqDataLength);
   bool IsDirty();
   void Render();
   void GetInfo(VIS_INFO *info);
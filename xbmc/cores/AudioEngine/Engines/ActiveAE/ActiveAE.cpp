@@ -24,6 +24,7 @@ using namespace ActiveAE;
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "windowing/WinSystem.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/log.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
@@ -42,6 +43,8 @@ void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 
 void CEngineStats::UpdateSinkDelay(const AEDelayStatus& status, int samples)
 {
+  CPerformanceTrace::AddCounter("AESink::Delay", status.GetDelay() * 1000);
+
   CSingleLock lock(m_lock);
   m_sinkDelay = status;
   if (samples > m_bufferedSamples)
@@ -1399,6 +1402,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         m_vizBuffers = new CActiveAEBufferPoolResample(m_internalFormat, vizFormat, m_settings.resampleQuality);
         //! @todo use cache of sync + water level
         m_vizBuffers->Create(2000 + m_stats.GetMaxDelay() * 1000, false, false);
+        m_vizTap.Configure(vizFormat.m_frames * 2, CAESpectrumTap::VIZ_FFT_SIZE);
         m_vizInitialized = false;
       }
     }
@@ -2243,6 +2247,9 @@ bool CActiveAE::RunStages()
             int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
             int64_t timestamp = now + status.GetDelay() * 1000;
             busy |= m_vizBuffers->ResampleBuffers(timestamp);
+            bool wantsFreq = false;
+            for (auto& it : m_audioCallback)
+              wantsFreq |= it->WantsFreq();
             while(!m_vizBuffers->m_outputSamples.empty())
             {
               CSampleBuffer *buf = m_vizBuffers->m_outputSamples.front();
@@ -2252,8 +2259,11 @@ bool CActiveAE::RunStages()
               {
                 unsigned int samples = static_cast<unsigned int>(buf->pkt->nb_samples) *
                                        buf->pkt->config.channels / buf->pkt->planes;
+                // spectrum is computed once here and shared by all callbacks
+                AESpectrumBlock block = m_vizTap.Publish(
+                    reinterpret_cast<float*>(buf->pkt->data[0]), samples, wantsFreq);
                 for (auto& it : m_audioCallback)
-                  it->OnAudioData((float*)(buf->pkt->data[0]), samples);
+                  it->OnAudioBlock(block);
                 buf->Return();
                 m_vizBuffers->m_outputSamples.pop_front();
               }
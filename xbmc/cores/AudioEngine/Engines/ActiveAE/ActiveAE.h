@@ -12,6 +12,7 @@
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Utils/AESpectrumTap.h"
 #include "guilib/DispResource.h"
 #include "threads/Thread.h"
 
@@ -384,6 +385,7 @@ protected:
 
   // viz
   std::vector<IAudioCallback*> m_audioCallback;
+  CAESpectrumTap m_vizTap;
   bool m_vizInitialized;
   CCriticalSection m_vizLock;
 
@@ -15,6 +15,7 @@
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "utils/EndianSwap.h"
 #include "utils/MemUtils.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/log.h"
 
 #include <algorithm>
@@ -917,6 +918,8 @@ void CActiveAESink::ReturnBuffers()
 
 unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
 {
+  CPerformanceTraceSpan span("AESink::OutputSamples");
+
   uint8_t **buffer = samples->pkt->data;
   uint8_t *packBuffer;
   unsigned int frames = samples->pkt->nb_samples;
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "cores/AudioEngine/Utils/AESpectrumTap.h"
+
 // IAudioCallback.h: interface for the IAudioCallback class.
 //
 //////////////////////////////////////////////////////////////////////
@@ -19,5 +21,15 @@ public:
   virtual ~IAudioCallback() = default;
   virtual void OnInitialize(int iChannels, int iSamplesPerSec, int iBitsPerSample) = 0;
   virtual void OnAudioData(const float* pAudioData, unsigned int iAudioDataLength) = 0;
-};
 
+  /*!
+   * \brief Whether the engine should compute a spectrum for the blocks passed to OnAudioBlock.
+   */
+  virtual bool WantsFreq() const { return false; }
+
+  /*!
+   * \brief Called by engines which publish through a CAESpectrumTap. The block is
+   * shared by all callbacks, so implementations must not modify it.
+   */
+  virtual void OnAudioBlock(const AESpectrumBlock& block) { OnAudioData(block.pcm, block.samples); }
+};
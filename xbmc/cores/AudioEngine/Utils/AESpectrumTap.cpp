@@ -0,0 +1,91 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESpectrumTap.h"
+
+#include "utils/rfft.h"
+
+#include <algorithm>
+#include <string.h>
+
+CAESpectrumTap::CAESpectrumTap() = default;
+
+CAESpectrumTap::~CAESpectrumTap() = default;
+
+void CAESpectrumTap::Configure(unsigned int maxSamples, unsigned int fftSize)
+{
+  for (auto& slot : m_slots)
+  {
+    slot.sequence.store(0, std::memory_order_release);
+    slot.pcm.assign(maxSamples, 0.0f);
+    slot.freq.assign(fftSize, 0.0f);
+    slot.samples = 0;
+    slot.hasFreq = false;
+  }
+
+  m_maxSamples = maxSamples;
+  m_fftSize = fftSize;
+  m_fftInput.assign(fftSize * 2, 0.0f);
+  m_transform.reset(fftSize > 0 ? new RFFT(fftSize, false) : nullptr);
+}
+
+AESpectrumBlock CAESpectrumTap::Publish(const float* pcm, unsigned int samples, bool computeFreq)
+{
+  AESpectrumBlock block;
+  if (m_maxSamples == 0 || !pcm)
+    return block;
+
+  const uint64_t sequence = m_latest.load(std::memory_order_relaxed) + 1;
+  Slot& slot = m_slots[sequence % RING_SIZE];
+
+  // mark the slot as being written before touching its data
+  slot.sequence.store(0, std::memory_order_release);
+
+  slot.samples = std::min(samples, m_maxSamples);
+  memcpy(slot.pcm.data(), pcm, slot.samples * sizeof(float));
+
+  slot.hasFreq = computeFreq && m_transform;
+  if (slot.hasFreq)
+  {
+    // the transform always consumes a full window, zero pad short blocks
+    const unsigned int fftSamples = std::min<unsigned int>(slot.samples, m_fftInput.size());
+    memcpy(m_fftInput.data(), slot.pcm.data(), fftSamples * sizeof(float));
+    std::fill(m_fftInput.begin() + fftSamples, m_fftInput.end(), 0.0f);
+    m_transform->calc(m_fftInput.data(), slot.freq.data());
+  }
+
+  slot.sequence.store(sequence, std::memory_order_release);
+  m_latest.store(sequence, std::memory_order_release);
+
+  GetBlock(sequence, block);
+  return block;
+}
+
+bool CAESpectrumTap::GetBlock(uint64_t sequence, AESpectrumBlock& block) const
+{
+  if (sequence == 0)
+    return false;
+
+  const Slot& slot = m_slots[sequence % RING_SIZE];
+  if (slot.sequence.load(std::memory_order_acquire) != sequence)
+    return false;
+
+  block.tap = this;
+  block.sequence = sequence;
+  block.pcm = slot.pcm.data();
+  block.samples = slot.samples;
+  block.freq = slot.hasFreq ? slot.freq.data() : nullptr;
+  block.freqLength = slot.hasFreq ? m_fftSize : 0;
+  return true;
+}
+
+bool CAESpectrumTap::IsCurrent(uint64_t sequence) const
+{
+  return sequence != 0 &&
+         m_slots[sequence % RING_SIZE].sequence.load(std::memory_order_acquire) == sequence;
+}
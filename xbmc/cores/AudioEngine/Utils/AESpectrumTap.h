@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+class RFFT;
+class CAESpectrumTap;
+
+/*!
+ * \brief View of one block of interleaved stereo PCM together with its spectrum.
+ *
+ * The pointers reference storage owned by the CAESpectrumTap and are only
+ * valid as long as the block has not been overwritten, see CAESpectrumTap::IsCurrent.
+ */
+struct AESpectrumBlock
+{
+  const CAESpectrumTap* tap = nullptr;
+  uint64_t sequence = 0; //!< 0 means "no block"
+  const float* pcm = nullptr;
+  unsigned int samples = 0; //!< number of floats in pcm
+  const float* freq = nullptr; //!< nullptr if no spectrum was requested
+  unsigned int freqLength = 0; //!< number of floats in freq
+};
+
+/*!
+ * \brief Single producer, multiple consumer tap for visualization data.
+ *
+ * The engine publishes every viz block exactly once; the spectrum is computed
+ * at that point and all consumers read the same storage. Publishing does not
+ * lock: every slot carries a sequence number which is reset while the slot is
+ * rewritten, so readers on other threads can detect blocks that were replaced
+ * while they were using them.
+ */
+class CAESpectrumTap
+{
+public:
+  static constexpr unsigned int RING_SIZE = 32;
+  //! frames per channel transformed for visualizations
+  static constexpr unsigned int VIZ_FFT_SIZE = 256;
+
+  CAESpectrumTap();
+  ~CAESpectrumTap();
+
+  /*!
+   * \brief (Re)allocate the ring. Invalidates all previously returned blocks.
+   * \param maxSamples capacity of a block in floats (interleaved stereo)
+   * \param fftSize number of frames per channel fed into the FFT
+   */
+  void Configure(unsigned int maxSamples, unsigned int fftSize);
+
+  /*!
+   * \brief Copy a block into the ring and compute its spectrum if requested.
+   * Must only be called from the producing thread.
+   */
+  AESpectrumBlock Publish(const float* pcm, unsigned int samples, bool computeFreq);
+
+  /*!
+   * \brief Look up a previously published block.
+   * \return false if the block has already been overwritten
+   */
+  bool GetBlock(uint64_t sequence, AESpectrumBlock& block) const;
+
+  /*!
+   * \brief Check if a block obtained earlier is still intact.
+   */
+  bool IsCurrent(uint64_t sequence) const;
+
+  uint64_t GetLatestSequence() const { return m_latest.load(std::memory_order_acquire); }
+
+  unsigned int GetFFTSize() const { return m_fftSize; }
+
+private:
+  struct Slot
+  {
+    std::atomic<uint64_t> sequence{0};
+    std::vector<float> pcm;
+    std::vector<float> freq;
+    unsigned int samples = 0;
+    bool hasFreq = false;
+  };
+
+  std::array<Slot, RING_SIZE> m_slots;
+  std::vector<float> m_fftInput;
+  std::unique_ptr<RFFT> m_transform;
+  unsigned int m_maxSamples = 0;
+  unsigned int m_fftSize = 0;
+  std::atomic<uint64_t> m_latest{0};
+};
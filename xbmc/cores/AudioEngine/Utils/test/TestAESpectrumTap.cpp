@@ -0,0 +1,91 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AESpectrumTap.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(TestAESpectrumTap, PublishSharesStorage)
+{
+  CAESpectrumTap tap;
+  tap.Configure(1024, 256);
+
+  std::vector<float> pcm(512, 0.5f);
+  AESpectrumBlock block = tap.Publish(pcm.data(), pcm.size(), true);
+
+  ASSERT_EQ(block.tap, &tap);
+  EXPECT_EQ(block.sequence, 1u);
+  EXPECT_EQ(block.samples, 512u);
+  ASSERT_NE(block.freq, nullptr);
+  EXPECT_EQ(block.freqLength, 256u);
+  EXPECT_NE(block.pcm, pcm.data());
+
+  // lookups return the very same storage, no copies
+  AESpectrumBlock lookup;
+  ASSERT_TRUE(tap.GetBlock(block.sequence, lookup));
+  EXPECT_EQ(lookup.pcm, block.pcm);
+  EXPECT_EQ(lookup.freq, block.freq);
+
+  // constant signal ends up in the DC bin of both channels
+  EXPECT_NEAR(block.freq[0], 1.0f, 1e-5f);
+  EXPECT_NEAR(block.freq[1], 1.0f, 1e-5f);
+  EXPECT_NEAR(block.freq[2], 0.0f, 1e-5f);
+}
+
+TEST(TestAESpectrumTap, NoFreqWhenNotRequested)
+{
+  CAESpectrumTap tap;
+  tap.Configure(1024, 256);
+
+  std::vector<float> pcm(512, 0.0f);
+  AESpectrumBlock block = tap.Publish(pcm.data(), pcm.size(), false);
+  EXPECT_EQ(block.freq, nullptr);
+  EXPECT_EQ(block.freqLength, 0u);
+}
+
+TEST(TestAESpectrumTap, ClampsToCapacity)
+{
+  CAESpectrumTap tap;
+  tap.Configure(128, 32);
+
+  std::vector<float> pcm(512, 0.0f);
+  AESpectrumBlock block = tap.Publish(pcm.data(), pcm.size(), true);
+  EXPECT_EQ(block.samples, 128u);
+}
+
+TEST(TestAESpectrumTap, OverwrittenBlocksAreDetected)
+{
+  CAESpectrumTap tap;
+  tap.Configure(64, 16);
+
+  std::vector<float> pcm(64, 0.0f);
+  const uint64_t first = tap.Publish(pcm.data(), pcm.size(), false).sequence;
+  EXPECT_TRUE(tap.IsCurrent(first));
+
+  for (unsigned int i = 0; i < CAESpectrumTap::RING_SIZE; ++i)
+    tap.Publish(pcm.data(), pcm.size(), false);
+
+  AESpectrumBlock block;
+  EXPECT_FALSE(tap.IsCurrent(first));
+  EXPECT_FALSE(tap.GetBlock(first, block));
+  EXPECT_EQ(tap.GetLatestSequence(), first + CAESpectrumTap::RING_SIZE);
+  EXPECT_TRUE(tap.GetBlock(tap.GetLatestSequence(), block));
+}
+
+TEST(TestAESpectrumTap, ConfigureInvalidates)
+{
+  CAESpectrumTap tap;
+  tap.Configure(64, 16);
+
+  std::vector<float> pcm(64, 0.0f);
+  const uint64_t sequence = tap.Publish(pcm.data(), pcm.size(), false).sequence;
+  tap.Configure(64, 16);
+  EXPECT_FALSE(tap.IsCurrent(sequence));
+}
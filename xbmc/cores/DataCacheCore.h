@@ -35,6 +35,8 @@ public:
   void SetVideoDecoderName(std::string name, bool isHw);
   std::string GetVideoDecoderName();
   bool IsVideoHwDecoder();
+  void SetVideoDecoderThreading(std::string threading);
+  std::string GetVideoDecoderThreading();
   void SetVideoDeintMethod(std::string method);
   std::string GetVideoDeintMethod();
   void SetVideoPixelFormat(std::string pixFormat);
@@ -134,6 +136,7 @@ protected:
   {
     std::string decoderName;
     bool isHwDecoder;
+    std::string decoderThreading;
     std::string deintMethod;
     std::string pixFormat;
     std::string stereoMode;
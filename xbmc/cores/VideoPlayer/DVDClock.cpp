@@ -12,6 +12,7 @@
 #include "cores/VideoPlayer/Interface/TimingConstants.h"
 #include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 
@@ -156,6 +157,7 @@ void CDVDClock::SetSpeed(int iSpeed)
 void CDVDClock::SetSpeedAdjust(double adjust)
 {
   CLog::Log(LOGDEBUG, "CDVDClock::SetSpeedAdjust - adjusted:{:f}", adjust);
+  CPerformanceTrace::AddCounter("Clock::SpeedAdjust", adjust);
 
   CSingleLock lock(m_critSection);
   m_speedAdjust = adjust;
@@ -174,6 +176,8 @@ double CDVDClock::ErrorAdjust(double error, const char* log)
   double clock, absolute, adjustment;
   clock = GetClock(absolute);
 
+  CPerformanceTrace::AddCounter("Clock::Error", DVD_TIME_TO_MSEC(error));
+
   // skip minor updates while speed adjust is active
   // -> adjusting buffer levels
   if (m_speedAdjust != 0 && error < DVD_MSEC_TO_TIME(100))
@@ -209,6 +213,8 @@ double CDVDClock::ErrorAdjust(double error, const char* log)
 
 void CDVDClock::Discontinuity(double clock, double absolute)
 {
+  CPerformanceTrace::AddInstant("Clock::Discontinuity");
+
   CSingleLock lock(m_critSection);
   m_startClock = AbsoluteToSystem(absolute);
   if(m_pauseClock)
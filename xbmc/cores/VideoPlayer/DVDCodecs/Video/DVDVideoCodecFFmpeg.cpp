@@ -23,6 +23,7 @@
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "system.h"
@@ -365,19 +366,31 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     if (m_decoderState == STATE_NONE)
     {
       m_decoderState = STATE_HW_SINGLE;
+      m_threadingPolicy.Reset();
+      m_processInfo.SetVideoDecoderThreading("none");
     }
     else
     {
-      int num_threads = CServiceBroker::GetCPUInfo()->GetCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
+      const CVideoCodecThreadingPolicy::Decision threading = m_threadingPolicy.Configure(
+          hints.codec, pCodec->capabilities, hints.width, hints.height,
+          m_processInfo.IsRealtimeStream(), CServiceBroker::GetCPUInfo()->GetCPUCount());
+      m_pCodecContext->thread_count = threading.threads;
+      if (threading.type == CVideoCodecThreadingPolicy::Type::FRAME)
+        m_pCodecContext->thread_type = FF_THREAD_FRAME;
+      else if (threading.type == CVideoCodecThreadingPolicy::Type::SLICE)
+        m_pCodecContext->thread_type = FF_THREAD_SLICE;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with {} threads",
-                num_threads);
+
+      const std::string threadingName = CVideoCodecThreadingPolicy::ToString(threading);
+      m_processInfo.SetVideoDecoderThreading(threadingName);
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open with threading: {}", threadingName);
     }
   }
   else
+  {
     m_decoderState = STATE_SW_SINGLE;
+    m_processInfo.SetVideoDecoderThreading("none");
+  }
 
   // if we don't do this, then some codecs seem to fail.
   m_pCodecContext->coded_height = hints.height;
@@ -412,6 +425,9 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     return false;
   }
 
+  // e.g. key frames only for thumbnail extraction, restored when dropping ends
+  m_skipFrame = m_pCodecContext->skip_frame;
+
   m_pFrame = av_frame_alloc();
   if (!m_pFrame)
   {
@@ -748,19 +764,29 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   // here we got a frame
   int64_t framePTS = m_pDecodedFrame->best_effort_timestamp;
 
-  if (m_pCodecContext->skip_frame > AVDISCARD_DEFAULT)
+  bool dropped = false;
+  if (m_pCodecContext->skip_frame > m_skipFrame)
   {
     if (m_dropCtrl.m_state == CDropControl::VALID &&
         m_dropCtrl.m_lastPTS != AV_NOPTS_VALUE &&
         framePTS != AV_NOPTS_VALUE &&
         framePTS > (m_dropCtrl.m_lastPTS + m_dropCtrl.m_diffPTS * 1.5))
     {
+      dropped = true;
       m_droppedFrames++;
       if (m_interlaced)
         m_droppedFrames++;
     }
   }
-  m_dropCtrl.Process(framePTS, m_pCodecContext->skip_frame > AVDISCARD_DEFAULT);
+  m_dropCtrl.Process(framePTS, m_pCodecContext->skip_frame > m_skipFrame);
+
+  // the decoder can't keep up, reopen it with more threads if the policy has any to give
+  if (m_decoderState == STATE_SW_MULTI && m_threadingPolicy.OnFrame(dropped))
+  {
+    CLog::Log(LOGINFO, "CDVDVideoCodecFFmpeg::GetPicture - dropping frames, rebalance threading");
+    av_frame_unref(m_pDecodedFrame);
+    return VC_REOPEN;
+  }
 
   if (m_pDecodedFrame->key_frame)
   {
@@ -1334,13 +1360,13 @@ void CDVDVideoCodecFFmpeg::SetCodecControl(int flags)
 
     if (bDrop)
     {
-      m_pCodecContext->skip_frame = AVDISCARD_NONREF;
+      m_pCodecContext->skip_frame = std::max(AVDISCARD_NONREF, m_skipFrame);
       m_pCodecContext->skip_idct = AVDISCARD_NONREF;
       m_pCodecContext->skip_loop_filter = AVDISCARD_NONREF;
     }
     else
     {
-      m_pCodecContext->skip_frame = AVDISCARD_DEFAULT;
+      m_pCodecContext->skip_frame = m_skipFrame;
       m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
       m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
     }
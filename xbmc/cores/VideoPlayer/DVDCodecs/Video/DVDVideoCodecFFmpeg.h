@@ -12,6 +12,7 @@
 #include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "DVDVideoCodec.h"
 #include "DVDVideoPPFFmpeg.h"
+#include "VideoCodecThreadingPolicy.h"
 #include <string>
 #include <vector>
 
@@ -94,10 +95,12 @@ protected:
   int m_droppedFrames = 0;
   bool m_requestSkipDeint = false;
   int m_codecControlFlags = 0;
+  AVDiscard m_skipFrame = AVDISCARD_DEFAULT; //!< skip_frame requested by the codec options
   bool m_interlaced = false;
   double m_DAR = 1.0;
   CDVDStreamInfo m_hints;
   CDVDCodecOptions m_options;
+  CVideoCodecThreadingPolicy m_threadingPolicy;
 
   struct CDropControl
   {
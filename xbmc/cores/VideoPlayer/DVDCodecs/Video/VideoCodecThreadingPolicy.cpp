@@ -0,0 +1,177 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoCodecThreadingPolicy.h"
+
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+
+namespace
+{
+// frame threads allowed while low latency is preferred, each one delays output by a frame
+constexpr int LOW_LATENCY_FRAME_THREADS = 2;
+
+#if defined(AV_CODEC_CAP_OTHER_THREADS)
+constexpr int CAP_INTERNAL_THREADS = AV_CODEC_CAP_OTHER_THREADS;
+#else
+constexpr int CAP_INTERNAL_THREADS = AV_CODEC_CAP_AUTO_THREADS;
+#endif
+} // namespace
+
+CVideoCodecThreadingPolicy::Decision CVideoCodecThreadingPolicy::Configure(AVCodecID codec,
+                                                                           int capabilities,
+                                                                           int width,
+                                                                           int height,
+                                                                           bool lowLatency,
+                                                                           int cpuCount)
+{
+  m_codec = codec;
+  m_capabilities = capabilities;
+  m_width = width;
+  m_height = height;
+  m_lowLatency = lowLatency;
+  m_cpuCount = std::max(1, cpuCount);
+  m_frames = 0;
+  m_drops = 0;
+
+  m_decision = Decide(m_extraThreads, m_preferThroughput);
+  return m_decision;
+}
+
+bool CVideoCodecThreadingPolicy::OnFrame(bool dropped)
+{
+  m_frames++;
+  if (dropped)
+    m_drops++;
+
+  if (m_frames < DROP_WINDOW)
+    return false;
+
+  const bool overloaded = m_drops * 100 >= m_frames * DROP_PERCENT;
+  m_frames = 0;
+  m_drops = 0;
+  if (!overloaded)
+    return false;
+
+  // giving up low latency frees the most decoding power, try that before adding threads
+  if (m_lowLatency && !m_preferThroughput)
+  {
+    const Decision decision = Decide(m_extraThreads, true);
+    if (decision.type != m_decision.type || decision.threads != m_decision.threads)
+    {
+      m_preferThroughput = true;
+      return true;
+    }
+  }
+
+  const int extraThreads = m_extraThreads + std::max(1, m_cpuCount / 2);
+  const Decision decision = Decide(extraThreads, m_preferThroughput);
+  if (decision.type == m_decision.type && decision.threads == m_decision.threads)
+    return false;
+
+  m_extraThreads = extraThreads;
+  return true;
+}
+
+void CVideoCodecThreadingPolicy::Reset()
+{
+  m_extraThreads = 0;
+  m_preferThroughput = false;
+  m_frames = 0;
+  m_drops = 0;
+}
+
+std::string CVideoCodecThreadingPolicy::ToString(const Decision& decision)
+{
+  switch (decision.type)
+  {
+    case Type::SLICE:
+      return StringUtils::Format("slice x{}", decision.threads);
+    case Type::FRAME:
+      return StringUtils::Format("frame x{}", decision.threads);
+    case Type::INTERNAL:
+      return StringUtils::Format("codec x{}", decision.threads);
+    case Type::NONE:
+    default:
+      return "none";
+  }
+}
+
+CVideoCodecThreadingPolicy::Decision CVideoCodecThreadingPolicy::Decide(int extraThreads,
+                                                                        bool preferThroughput) const
+{
+  // more threads than 1.5x the CPUs only add contention
+  const int maxThreads = std::min(MAX_THREADS, std::max(1, m_cpuCount * 3 / 2));
+  int threads = std::min(maxThreads, GetThreadsForSize(m_width, m_height) + extraThreads);
+
+  const bool canFrame = (m_capabilities & AV_CODEC_CAP_FRAME_THREADS) != 0;
+  const bool canSlice = (m_capabilities & AV_CODEC_CAP_SLICE_THREADS) != 0;
+  const bool canInternal = (m_capabilities & CAP_INTERNAL_THREADS) != 0;
+  const bool lowLatency = m_lowLatency && !preferThroughput;
+
+  Decision decision;
+  if (threads <= 1)
+    return decision;
+
+  if (canSlice && lowLatency && HasEffectiveSliceThreading(m_codec))
+  {
+    decision.type = Type::SLICE;
+    decision.threads = std::min(threads, m_cpuCount);
+  }
+  else if (canFrame)
+  {
+    decision.type = Type::FRAME;
+    decision.threads = lowLatency ? std::min(threads, LOW_LATENCY_FRAME_THREADS) : threads;
+  }
+  else if (canSlice)
+  {
+    decision.type = Type::SLICE;
+    decision.threads = std::min(threads, m_cpuCount);
+  }
+  else if (canInternal)
+  {
+    decision.type = Type::INTERNAL;
+    decision.threads = threads;
+  }
+
+  if (decision.threads <= 1)
+    decision = Decision();
+
+  return decision;
+}
+
+bool CVideoCodecThreadingPolicy::HasEffectiveSliceThreading(AVCodecID codec)
+{
+  // codecs whose encoders commonly split pictures into independently decodable parts,
+  // H.264 streams mostly come with a single slice per picture
+  switch (codec)
+  {
+    case AV_CODEC_ID_HEVC: // wavefronts and tiles
+    case AV_CODEC_ID_VP9: // tiles
+    case AV_CODEC_ID_MPEG2VIDEO: // a slice per macroblock row
+    case AV_CODEC_ID_PRORES:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int CVideoCodecThreadingPolicy::GetThreadsForSize(int width, int height)
+{
+  // unknown sizes are most likely HD
+  if (width <= 0 || height <= 0)
+    return 8;
+
+  const int pixels = width * height;
+  if (pixels <= 1024 * 576)
+    return 4;
+  if (pixels <= 2048 * 1152)
+    return 8;
+  return MAX_THREADS;
+}
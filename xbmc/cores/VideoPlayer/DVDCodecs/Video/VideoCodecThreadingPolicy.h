@@ -0,0 +1,103 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/*!
+ \brief Chooses how a software video decoder uses threads.
+
+ Frame threading scales best but delays output by one frame per thread, which is paid again
+ after every seek. Slice threading adds no delay but only helps codecs and streams that code
+ pictures in independent slices, tiles or wavefronts. Decoders like libdav1d run their own
+ thread pool and only need a thread count.
+
+ The policy picks the threading type and thread count from the codec, its capabilities, the
+ picture size and the number of CPUs. While playing it watches frames dropped because the
+ decoder could not keep up and asks for the decoder to be reopened with more threads.
+ */
+class CVideoCodecThreadingPolicy
+{
+public:
+  enum class Type
+  {
+    NONE, //!< single threaded
+    SLICE, //!< FF_THREAD_SLICE
+    FRAME, //!< FF_THREAD_FRAME
+    INTERNAL, //!< the decoder manages its own threads
+  };
+
+  struct Decision
+  {
+    Type type = Type::NONE;
+    int threads = 1;
+  };
+
+  static constexpr int MAX_THREADS = 16; //!< FFmpeg's limit for automatic thread setup
+  static constexpr unsigned int DROP_WINDOW = 250; //!< frames to judge the drop rate over
+  static constexpr unsigned int DROP_PERCENT = 5; //!< drop rate that triggers a rebalance
+
+  CVideoCodecThreadingPolicy() = default;
+
+  /*!
+   \brief Decide how to thread a decoder that is about to be opened.
+   Increases from earlier rebalances are kept, call Reset() for a new stream.
+   \param codec the codec of the stream
+   \param capabilities the AV_CODEC_CAP_* flags of the decoder
+   \param width coded width of the stream, 0 if unknown
+   \param height coded height of the stream, 0 if unknown
+   \param lowLatency prefer threading that does not delay output, e.g. for live streams
+   \param cpuCount number of CPUs available
+   */
+  Decision Configure(AVCodecID codec,
+                     int capabilities,
+                     int width,
+                     int height,
+                     bool lowLatency,
+                     int cpuCount);
+
+  /*!
+   \brief Account for a decoded frame.
+   \param dropped true if frames were dropped because the decoder fell behind
+   \return true if the decoder should be reopened to apply a new decision
+   */
+  bool OnFrame(bool dropped);
+
+  /*!
+   \brief Forget rebalances made for the previous stream.
+   */
+  void Reset();
+
+  const Decision& GetDecision() const { return m_decision; }
+
+  static std::string ToString(const Decision& decision);
+
+private:
+  Decision Decide(int extraThreads, bool preferThroughput) const;
+  static bool HasEffectiveSliceThreading(AVCodecID codec);
+  static int GetThreadsForSize(int width, int height);
+
+  // stream the decoder was configured for
+  AVCodecID m_codec = AV_CODEC_ID_NONE;
+  int m_capabilities = 0;
+  int m_width = 0;
+  int m_height = 0;
+  bool m_lowLatency = false;
+  int m_cpuCount = 1;
+
+  Decision m_decision;
+  int m_extraThreads = 0; //!< threads added by rebalancing
+  bool m_preferThroughput = false; //!< set once drops showed that low latency costs too much
+  unsigned int m_frames = 0;
+  unsigned int m_drops = 0;
+};
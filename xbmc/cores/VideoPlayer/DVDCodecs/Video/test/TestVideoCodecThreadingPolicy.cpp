@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/Video/VideoCodecThreadingPolicy.h"
+
+#include <gtest/gtest.h>
+
+using Policy = CVideoCodecThreadingPolicy;
+
+namespace
+{
+constexpr int FRAME_AND_SLICE = AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS;
+
+// feed a window of frames with the given number of drops
+bool FeedWindow(Policy& policy, unsigned int drops)
+{
+  bool rebalance = false;
+  for (unsigned int i = 0; i < Policy::DROP_WINDOW; i++)
+    rebalance = policy.OnFrame(i < drops);
+  return rebalance;
+}
+} // namespace
+
+TEST(TestVideoCodecThreadingPolicy, ScalesWithResolution)
+{
+  Policy policy;
+
+  Policy::Decision sd = policy.Configure(AV_CODEC_ID_H264, FRAME_AND_SLICE, 720, 576, false, 16);
+  EXPECT_EQ(Policy::Type::FRAME, sd.type);
+  EXPECT_EQ(4, sd.threads);
+
+  Policy::Decision hd = policy.Configure(AV_CODEC_ID_H264, FRAME_AND_SLICE, 1920, 1080, false, 16);
+  EXPECT_EQ(Policy::Type::FRAME, hd.type);
+  EXPECT_EQ(8, hd.threads);
+
+  Policy::Decision uhd =
+      policy.Configure(AV_CODEC_ID_HEVC, FRAME_AND_SLICE, 3840, 2160, false, 16);
+  EXPECT_EQ(Policy::Type::FRAME, uhd.type);
+  EXPECT_EQ(Policy::MAX_THREADS, uhd.threads);
+}
+
+TEST(TestVideoCodecThreadingPolicy, LimitedByCPUs)
+{
+  Policy policy;
+
+  Policy::Decision decision =
+      policy.Configure(AV_CODEC_ID_HEVC, FRAME_AND_SLICE, 3840, 2160, false, 4);
+  EXPECT_EQ(6, decision.threads);
+
+  decision = policy.Configure(AV_CODEC_ID_HEVC, FRAME_AND_SLICE, 3840, 2160, false, 1);
+  EXPECT_EQ(Policy::Type::NONE, decision.type);
+  EXPECT_EQ(1, decision.threads);
+}
+
+TEST(TestVideoCodecThreadingPolicy, LowLatency)
+{
+  Policy policy;
+
+  // slices don't delay output
+  Policy::Decision hevc = policy.Configure(AV_CODEC_ID_HEVC, FRAME_AND_SLICE, 1920, 1080, true, 8);
+  EXPECT_EQ(Policy::Type::SLICE, hevc.type);
+  EXPECT_EQ(8, hevc.threads);
+
+  // but H.264 seldom has more than one slice, so keep frame threading short
+  Policy::Decision h264 = policy.Configure(AV_CODEC_ID_H264, FRAME_AND_SLICE, 1920, 1080, true, 8);
+  EXPECT_EQ(Policy::Type::FRAME, h264.type);
+  EXPECT_EQ(2, h264.threads);
+}
+
+TEST(TestVideoCodecThreadingPolicy, InternalThreading)
+{
+  Policy policy;
+
+  Policy::Decision av1 =
+      policy.Configure(AV_CODEC_ID_AV1, AV_CODEC_CAP_OTHER_THREADS, 1920, 1080, false, 8);
+  EXPECT_EQ(Policy::Type::INTERNAL, av1.type);
+  EXPECT_EQ(8, av1.threads);
+  EXPECT_EQ("codec x8", Policy::ToString(av1));
+
+  Policy::Decision none = policy.Configure(AV_CODEC_ID_VC1, 0, 1920, 1080, false, 8);
+  EXPECT_EQ(Policy::Type::NONE, none.type);
+  EXPECT_EQ("none", Policy::ToString(none));
+}
+
+TEST(TestVideoCodecThreadingPolicy, RebalanceOnDrops)
+{
+  Policy policy;
+  policy.Configure(AV_CODEC_ID_H264, FRAME_AND_SLICE, 1920, 1080, true, 8);
+
+  // occasional drops are no reason to reopen the decoder
+  EXPECT_FALSE(FeedWindow(policy, 1));
+
+  // first give up low latency
+  EXPECT_TRUE(FeedWindow(policy, Policy::DROP_WINDOW / 10));
+  Policy::Decision decision =
+      policy.Configure(AV_CODEC_ID_H264, FRAME_AND_SLICE, 1920, 1080, true, 8);
+  EXPECT_EQ(Policy::Type::FRAME, decision.type);
+  EXPECT_EQ(8, decision.threads);
+
+  // then add threads up to the limit
+  EXPECT_TRUE(FeedWindow(policy, Policy::DROP_WINDOW / 10));
+  decision = policy.Configure(AV_CODEC_ID_H264, FRAME_AND_SLICE, 1920, 1080, true, 8);
+  EXPECT_EQ(12, decision.threads);
+
+  EXPECT_FALSE(FeedWindow(policy, Policy::DROP_WINDOW / 10));
+
+  // a new stream starts from scratch
+  policy.Reset();
+  decision = policy.Configure(AV_CODEC_ID_H264, FRAME_AND_SLICE, 1920, 1080, true, 8);
+  EXPECT_EQ(2, decision.threads);
+}
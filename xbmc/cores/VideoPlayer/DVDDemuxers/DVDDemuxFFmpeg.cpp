@@ -11,6 +11,7 @@
 #include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
+#include "DemuxProbeCache.h"
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "Util.h"
@@ -30,6 +31,7 @@
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <sstream>
 #include <utility>
 
@@ -189,6 +191,13 @@ static int64_t dvd_file_seek(void* h, int64_t pos, int whence)
 ////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+// limits of avformat_find_stream_info when only the stream parameters are needed
+constexpr int64_t PROBE_ONLY_SIZE = 512 * 1024;
+constexpr int64_t PROBE_ONLY_DURATION = AV_TIME_BASE;
+} // namespace
+
 CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
 {
   m_pFormatContext = NULL;
@@ -209,6 +218,9 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
 
 CDVDDemuxFFmpeg::~CDVDDemuxFFmpeg()
 {
+  if (m_probeCache)
+    m_probeCache->Save();
+
   Dispose();
   ff_flush_avutil_log_buffers();
 }
@@ -225,7 +237,9 @@ bool CDVDDemuxFFmpeg::Aborted()
   return false;
 }
 
-bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool fileinfo)
+bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput,
+                           bool fileinfo,
+                           bool probeOnly)
 {
   AVInputFormat* iformat = NULL;
   std::string strFile;
@@ -244,6 +258,17 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
   m_pInput = pInput;
   strFile = m_pInput->GetFileName();
 
+  // kept over the second open of transport streams and Reset()
+  if (!probeOnly && m_probeCacheFileId > 0 &&
+      (!m_probeCache || m_probeCache->GetPath() != strFile))
+  {
+    if (m_probeCache)
+      m_probeCache->Save();
+    m_probeCache = CDemuxProbeCache::Load(*m_pInput, m_probeCacheFileId);
+  }
+  m_useSeekIndex = false;
+  m_seekIndexStream = -1;
+
   if (m_pInput->GetContent().length() > 0)
   {
     std::string content = m_pInput->GetContent();
@@ -533,32 +558,73 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
   m_bAVI = strcmp(m_pFormatContext->iformat->name, "avi") == 0;
   m_bSup = strcmp(m_pFormatContext->iformat->name, "sup") == 0;
 
+  const char* formatName = m_pFormatContext->iformat->name;
+  bool probeRestored = false;
+  int64_t cachedDuration = AV_NOPTS_VALUE;
+  if (m_streaminfo && m_probeCache && m_probeCache->HasProbe(formatName))
+  {
+    if (m_checkTransportStream)
+    {
+      // the first pass over transport streams only finds the duration, which is known
+      cachedDuration = m_probeCache->GetDuration();
+      m_streaminfo = false;
+    }
+    else
+      probeRestored = m_probeCache->RestoreProbe(m_pFormatContext);
+  }
+
+  bool headerInfo = false;
+  if (m_streaminfo && probeOnly && !probeRestored)
+  {
+    headerInfo = HasHeaderStreamInfo();
+    if (!headerInfo)
+    {
+      av_opt_set_int(m_pFormatContext, "probesize", PROBE_ONLY_SIZE, 0);
+      av_opt_set_int(m_pFormatContext, "analyzeduration", PROBE_ONLY_DURATION, 0);
+      m_pFormatContext->fps_probe_size = 0;
+    }
+  }
+
   if (m_streaminfo)
   {
-    /* to speed up dvd switches, only analyse very short */
-    if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
-      av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
-
-    CLog::Log(LOGDEBUG, "{} - avformat_find_stream_info starting", __FUNCTION__);
-    int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
-    if (iErr < 0)
-    {
-      CLog::Log(LOGWARNING, "could not find codec parameters for {}", CURL::GetRedacted(strFile));
-      if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) ||
-          m_pInput->IsStreamType(DVDSTREAM_TYPE_BLURAY) ||
-          (m_pFormatContext->nb_streams == 1 &&
-           m_pFormatContext->streams[0]->codecpar->codec_id == AV_CODEC_ID_AC3) ||
-          m_checkTransportStream)
-      {
-        // special case, our codecs can still handle it.
-      }
-      else
+    if (probeRestored)
+    {
+      CLog::Log(LOGDEBUG, "{} - codec parameters restored from probe cache", __FUNCTION__);
+    }
+    else if (headerInfo)
+    {
+      CLog::Log(LOGDEBUG, "{} - codec parameters taken from the container headers", __FUNCTION__);
+    }
+    else
+    {
+      /* to speed up dvd switches, only analyse very short */
+      if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
+        av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
+
+      CLog::Log(LOGDEBUG, "{} - avformat_find_stream_info starting", __FUNCTION__);
+      int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
+      if (iErr < 0)
       {
-        Dispose();
-        return false;
+        CLog::Log(LOGWARNING, "could not find codec parameters for {}",
+                  CURL::GetRedacted(strFile));
+        if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) ||
+            m_pInput->IsStreamType(DVDSTREAM_TYPE_BLURAY) ||
+            (m_pFormatContext->nb_streams == 1 &&
+             m_pFormatContext->streams[0]->codecpar->codec_id == AV_CODEC_ID_AC3) ||
+            m_checkTransportStream)
+        {
+          // special case, our codecs can still handle it.
+        }
+        else
+        {
+          Dispose();
+          return false;
+        }
       }
+      else if (m_probeCache && !m_probeCache->HasProbe(formatName))
+        m_probeCache->StoreProbe(m_pFormatContext);
+      CLog::Log(LOGDEBUG, "{} - av_find_stream_info finished", __FUNCTION__);
     }
-    CLog::Log(LOGDEBUG, "{} - av_find_stream_info finished", __FUNCTION__);
 
     // print some extra information
     av_dump_format(m_pFormatContext, 0, CURL::GetRedacted(strFile).c_str(), 0);
@@ -576,6 +642,9 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
     skipCreateStreams = true;
   }
 
+  if (m_probeCache && CDemuxProbeCache::NeedsSeekIndex(formatName))
+    m_useSeekIndex = true;
+
   // reset any timeout
   m_timeout.SetInfinite();
 
@@ -659,6 +728,12 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
       return false;
     m_pFormatContext->duration = duration;
   }
+  else if (cachedDuration != AV_NOPTS_VALUE)
+  {
+    CLog::Log(LOGDEBUG, "{} - transport stream duration restored from probe cache",
+              __FUNCTION__);
+    m_pFormatContext->duration = cachedDuration;
+  }
 
   return true;
 }
@@ -1074,6 +1149,9 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
 
       AVStream* stream = m_pFormatContext->streams[m_pkt.pkt.stream_index];
 
+      if (m_useSeekIndex && (m_pkt.pkt.flags & AV_PKT_FLAG_KEY))
+        AddSeekIndexEntry(stream, m_pkt.pkt);
+
       if (IsTransportStreamReady())
       {
         if (m_program != UINT_MAX)
@@ -1273,10 +1351,30 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double* startpts)
   else if (m_pFormatContext->start_time != (int64_t)AV_NOPTS_VALUE && !ismp3 && !m_bSup)
     seek_pts += m_pFormatContext->start_time;
 
-  int ret;
+  int ret = -1;
   {
     CSingleLock lock(m_critSection);
-    ret = av_seek_frame(m_pFormatContext, m_seekStream, seek_pts, backwards ? AVSEEK_FLAG_BACKWARD : 0);
+
+    // go straight to a known key frame instead of bisecting the file
+    const CDemuxSeekIndex::Entry* keyFrame = nullptr;
+    if (m_useSeekIndex)
+    {
+      int64_t target = seek_pts;
+      if (m_seekStream >= 0)
+        target = av_rescale_q(seek_pts, m_pFormatContext->streams[m_seekStream]->time_base,
+                              AV_TIME_BASE_Q);
+      keyFrame = m_probeCache->GetSeekIndex().Find(target, backwards);
+      if (keyFrame)
+      {
+        ret = av_seek_frame(m_pFormatContext, -1, keyFrame->pos, AVSEEK_FLAG_BYTE);
+        if (ret < 0)
+          keyFrame = nullptr;
+      }
+    }
+
+    if (!keyFrame)
+      ret = av_seek_frame(m_pFormatContext, m_seekStream, seek_pts,
+                          backwards ? AVSEEK_FLAG_BACKWARD : 0);
 
     if (ret < 0)
     {
@@ -1303,7 +1401,11 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double* startpts)
         ret = 0;
     }
 
-    if (ret >= 0)
+    if (ret >= 0 && keyFrame)
+    {
+      m_currentPts = ConvertTimestamp(keyFrame->time, AV_TIME_BASE, 1);
+    }
+    else if (ret >= 0)
     {
       if (m_pFormatContext->iformat->read_seek)
         m_seekToKeyFrame = true;
@@ -2387,6 +2489,63 @@ bool CDVDDemuxFFmpeg::IsTransportStreamReady()
   return state == TRANSPORT_STREAM_STATE::READY;
 }
 
+bool CDVDDemuxFFmpeg::HasHeaderStreamInfo()
+{
+  if (!CDemuxProbeCache::CanRestoreFormat(m_pFormatContext->iformat->name) ||
+      m_pFormatContext->nb_streams == 0)
+    return false;
+
+  int64_t duration = AV_NOPTS_VALUE;
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    const AVStream* st = m_pFormatContext->streams[i];
+    const AVCodecParameters* par = st->codecpar;
+    if (par->codec_id == AV_CODEC_ID_NONE)
+      return false;
+
+    if (par->codec_type == AVMEDIA_TYPE_VIDEO && !(st->disposition & AV_DISPOSITION_ATTACHED_PIC) &&
+        (par->width <= 0 || par->height <= 0))
+      return false;
+
+    // the DTS type is only known from the bitstream
+    if (par->codec_type == AVMEDIA_TYPE_AUDIO &&
+        (par->channels <= 0 || par->codec_id == AV_CODEC_ID_DTS))
+      return false;
+
+    if (st->duration != AV_NOPTS_VALUE)
+      duration = std::max(duration, av_rescale_q(st->duration, st->time_base, AV_TIME_BASE_Q));
+  }
+
+  // the file duration is otherwise only estimated by avformat_find_stream_info
+  if (m_pFormatContext->duration == AV_NOPTS_VALUE)
+  {
+    if (duration == AV_NOPTS_VALUE)
+      return false;
+    m_pFormatContext->duration = duration;
+  }
+
+  return true;
+}
+
+void CDVDDemuxFFmpeg::AddSeekIndexEntry(const AVStream* stream, const AVPacket& pkt)
+{
+  if (m_seekIndexStream < 0)
+  {
+    if (stream->codecpar->codec_type != AVMEDIA_TYPE_VIDEO ||
+        (stream->disposition & AV_DISPOSITION_ATTACHED_PIC))
+      return;
+    m_seekIndexStream = stream->index;
+  }
+  else if (stream->index != m_seekIndexStream)
+    return;
+
+  const int64_t ts = pkt.pts != AV_NOPTS_VALUE ? pkt.pts : pkt.dts;
+  if (ts == AV_NOPTS_VALUE || pkt.pos < 0)
+    return;
+
+  m_probeCache->GetSeekIndex().Add(av_rescale_q(ts, stream->time_base, AV_TIME_BASE_Q), pkt.pos);
+}
+
 void CDVDDemuxFFmpeg::ResetVideoStreams()
 {
   AVStream* st;
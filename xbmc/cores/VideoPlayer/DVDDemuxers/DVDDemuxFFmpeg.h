@@ -20,6 +20,7 @@ extern "C" {
 }
 
 class CDVDDemuxFFmpeg;
+class CDemuxProbeCache;
 class CURL;
 
 enum class TRANSPORT_STREAM_STATE
@@ -83,7 +84,21 @@ public:
   CDVDDemuxFFmpeg();
   ~CDVDDemuxFFmpeg() override;
 
-  bool Open(const std::shared_ptr<CDVDInputStream>& pInput, bool fileinfo);
+  /*!
+   \brief Open the demuxer.
+   \param fileinfo open for reading file information instead of playback
+   \param probeOnly only the stream parameters are needed, e.g. for stream details. The
+   streams of containers declaring them in their headers are taken from there without reading
+   any packets, other files are probed with a small probe size.
+   */
+  bool Open(const std::shared_ptr<CDVDInputStream>& pInput, bool fileinfo, bool probeOnly = false);
+
+  /*!
+   \brief Cache the probe and seek index of the played file in the video database, see
+   CDemuxProbeCache. Must be called before Open().
+   \param idFile id of the file in the video database
+   */
+  void EnableProbeCache(int idFile) { m_probeCacheFileId = idFile; }
   void Dispose();
   bool Reset() override ;
   void Flush() override;
@@ -133,6 +148,8 @@ protected:
   void UpdateCurrentPTS();
   bool IsProgramChange();
   unsigned int HLSSelectProgram();
+  void AddSeekIndexEntry(const AVStream* stream, const AVPacket& pkt);
+  bool HasHeaderStreamInfo();
 
   std::string GetStereoModeFromMetadata(AVDictionary* pMetadata);
   std::string ConvertCodecToInternalStereoMode(const std::string& mode, const StereoModeConversionMap* conversionMap);
@@ -175,5 +192,10 @@ protected:
   double m_dtsAtDisplayTime;
   bool m_seekToKeyFrame = false;
   double m_startTime = 0;
+
+  int m_probeCacheFileId = -1;
+  std::unique_ptr<CDemuxProbeCache> m_probeCache;
+  bool m_useSeekIndex = false;
+  int m_seekIndexStream = -1; // stream whose key frames go into the seek index
 };
 
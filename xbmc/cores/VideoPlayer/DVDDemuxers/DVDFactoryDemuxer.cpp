@@ -18,7 +18,9 @@
 #include "utils/log.h"
 
 CDVDDemux* CDVDFactoryDemuxer::CreateDemuxer(const std::shared_ptr<CDVDInputStream>& pInputStream,
-                                             bool fileinfo)
+                                             bool fileinfo,
+                                             bool probeOnly,
+                                             int probeCacheFileId)
 {
   if (!pInputStream)
     return NULL;
@@ -72,7 +74,9 @@ CDVDDemux* CDVDFactoryDemuxer::CreateDemuxer(const std::shared_ptr<CDVDInputStre
   }
 
   std::unique_ptr<CDVDDemuxFFmpeg> demuxer(new CDVDDemuxFFmpeg());
-  if (demuxer->Open(pInputStream, fileinfo))
+  if (probeCacheFileId > 0 && !fileinfo)
+    demuxer->EnableProbeCache(probeCacheFileId);
+  if (demuxer->Open(pInputStream, fileinfo, probeOnly))
     return demuxer.release();
   else
     return NULL;
@@ -16,6 +16,15 @@ class CDVDInputStream;
 class CDVDFactoryDemuxer
 {
 public:
+  /*!
+   \brief Create and open the demuxer of an input stream.
+   \param fileinfo open for reading file information instead of playback
+   \param probeOnly only the stream parameters are needed, see CDVDDemuxFFmpeg::Open
+   \param probeCacheFileId video database id of a file opened for playback, to cache its probe
+   in the database, see CDVDDemuxFFmpeg::EnableProbeCache
+   */
   static CDVDDemux* CreateDemuxer(const std::shared_ptr<CDVDInputStream>& pInputStream,
-                                  bool fileinfo = false);
+                                  bool fileinfo = false,
+                                  bool probeOnly = false,
+                                  int probeCacheFileId = -1);
 };
@@ -0,0 +1,302 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxProbeCache.h"
+
+#include "DVDInputStreams/DVDInputStream.h"
+#include "URL.h"
+#include "utils/Base64.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/JobManager.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+
+#include <cstring>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavutil/mem.h>
+}
+
+namespace
+{
+// bump when the stored parameters change, older probes are ignored then
+constexpr int PROBE_VERSION = 1;
+
+void StoreRational(const AVRational& rational, CVariant& value)
+{
+  value = CVariant(CVariant::VariantTypeArray);
+  value.push_back(rational.num);
+  value.push_back(rational.den);
+}
+
+AVRational RestoreRational(const CVariant& value)
+{
+  if (!value.isArray() || value.size() != 2)
+    return {0, 1};
+  return {static_cast<int>(value[0].asInteger()), static_cast<int>(value[1].asInteger())};
+}
+
+void StoreStream(const AVStream* stream, CVariant& value)
+{
+  const AVCodecParameters* par = stream->codecpar;
+
+  value["id"] = stream->id;
+  value["type"] = par->codec_type;
+  value["codec"] = par->codec_id;
+  value["tag"] = par->codec_tag;
+  value["format"] = par->format;
+  value["bitrate"] = par->bit_rate;
+  value["bitspercodedsample"] = par->bits_per_coded_sample;
+  value["bitsperrawsample"] = par->bits_per_raw_sample;
+  value["profile"] = par->profile;
+  value["level"] = par->level;
+  value["width"] = par->width;
+  value["height"] = par->height;
+  StoreRational(par->sample_aspect_ratio, value["sar"]);
+  value["fieldorder"] = par->field_order;
+  value["colorrange"] = par->color_range;
+  value["colorprimaries"] = par->color_primaries;
+  value["colortrc"] = par->color_trc;
+  value["colorspace"] = par->color_space;
+  value["chromalocation"] = par->chroma_location;
+  value["videodelay"] = par->video_delay;
+  value["channellayout"] = par->channel_layout;
+  value["channels"] = par->channels;
+  value["samplerate"] = par->sample_rate;
+  value["blockalign"] = par->block_align;
+  value["framesize"] = par->frame_size;
+  value["initialpadding"] = par->initial_padding;
+  StoreRational(stream->avg_frame_rate, value["avgframerate"]);
+  StoreRational(stream->r_frame_rate, value["rframerate"]);
+  value["starttime"] = stream->start_time;
+  value["duration"] = stream->duration;
+  if (par->extradata && par->extradata_size > 0)
+    value["extradata"] =
+        Base64::Encode(reinterpret_cast<const char*>(par->extradata), par->extradata_size);
+}
+
+template<typename T>
+void RestoreIfUnset(T& field, T unset, const CVariant& value)
+{
+  if (field == unset && !value.isNull())
+    field = static_cast<T>(value.asInteger());
+}
+
+void RestoreStream(const CVariant& value, AVStream* stream)
+{
+  AVCodecParameters* par = stream->codecpar;
+
+  RestoreIfUnset(par->codec_tag, 0u, value["tag"]);
+  RestoreIfUnset(par->format, -1, value["format"]);
+  RestoreIfUnset(par->bit_rate, static_cast<int64_t>(0), value["bitrate"]);
+  RestoreIfUnset(par->bits_per_coded_sample, 0, value["bitspercodedsample"]);
+  RestoreIfUnset(par->bits_per_raw_sample, 0, value["bitsperrawsample"]);
+  RestoreIfUnset(par->profile, FF_PROFILE_UNKNOWN, value["profile"]);
+  RestoreIfUnset(par->level, FF_LEVEL_UNKNOWN, value["level"]);
+  RestoreIfUnset(par->width, 0, value["width"]);
+  RestoreIfUnset(par->height, 0, value["height"]);
+  if (par->sample_aspect_ratio.num == 0)
+    par->sample_aspect_ratio = RestoreRational(value["sar"]);
+  RestoreIfUnset(par->field_order, AV_FIELD_UNKNOWN, value["fieldorder"]);
+  RestoreIfUnset(par->color_range, AVCOL_RANGE_UNSPECIFIED, value["colorrange"]);
+  RestoreIfUnset(par->color_primaries, AVCOL_PRI_UNSPECIFIED, value["colorprimaries"]);
+  RestoreIfUnset(par->color_trc, AVCOL_TRC_UNSPECIFIED, value["colortrc"]);
+  RestoreIfUnset(par->color_space, AVCOL_SPC_UNSPECIFIED, value["colorspace"]);
+  RestoreIfUnset(par->chroma_location, AVCHROMA_LOC_UNSPECIFIED, value["chromalocation"]);
+  RestoreIfUnset(par->video_delay, 0, value["videodelay"]);
+  if (par->channel_layout == 0)
+    par->channel_layout = value["channellayout"].asUnsignedInteger();
+  RestoreIfUnset(par->channels, 0, value["channels"]);
+  RestoreIfUnset(par->sample_rate, 0, value["samplerate"]);
+  RestoreIfUnset(par->block_align, 0, value["blockalign"]);
+  RestoreIfUnset(par->frame_size, 0, value["framesize"]);
+  RestoreIfUnset(par->initial_padding, 0, value["initialpadding"]);
+  if (stream->avg_frame_rate.num == 0)
+    stream->avg_frame_rate = RestoreRational(value["avgframerate"]);
+  if (stream->r_frame_rate.num == 0)
+    stream->r_frame_rate = RestoreRational(value["rframerate"]);
+  RestoreIfUnset(stream->start_time, static_cast<int64_t>(AV_NOPTS_VALUE), value["starttime"]);
+  RestoreIfUnset(stream->duration, static_cast<int64_t>(AV_NOPTS_VALUE), value["duration"]);
+
+  if (par->extradata_size == 0 && value.isMember("extradata"))
+  {
+    const std::string extradata = Base64::Decode(value["extradata"].asString());
+    if (!extradata.empty())
+    {
+      av_freep(&par->extradata);
+      par->extradata = static_cast<uint8_t*>(
+          av_mallocz(extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+      if (par->extradata)
+      {
+        memcpy(par->extradata, extradata.data(), extradata.size());
+        par->extradata_size = static_cast<int>(extradata.size());
+      }
+    }
+  }
+}
+} // namespace
+
+CDemuxProbeCache::CDemuxProbeCache(const std::string& path, int idFile, int64_t fileSize)
+  : m_path(path), m_idFile(idFile), m_fileSize(fileSize)
+{
+}
+
+std::unique_ptr<CDemuxProbeCache> CDemuxProbeCache::Load(CDVDInputStream& input, int idFile)
+{
+  if (idFile <= 0)
+    return nullptr;
+
+  // growing files like running recordings or timeshift would invalidate the cache constantly
+  if (!input.IsStreamType(DVDSTREAM_TYPE_FILE) || input.IsRealtime())
+    return nullptr;
+
+  const std::string path = input.GetFileName();
+  if (path.empty() || URIUtils::IsInternetStream(path) || URIUtils::IsSpecial(path))
+    return nullptr;
+
+  const int64_t fileSize = input.GetLength();
+  if (fileSize <= 0)
+    return nullptr;
+
+  std::unique_ptr<CDemuxProbeCache> cache(new CDemuxProbeCache(path, idFile, fileSize));
+
+  CVideoDatabase db;
+  if (!db.Open())
+    return cache;
+
+  std::string probe;
+  std::string seekIndex;
+  if (db.GetDemuxCache(idFile, fileSize, probe, seekIndex))
+  {
+    if (!probe.empty() && (!CJSONVariantParser::Parse(probe, cache->m_probe) ||
+                           cache->m_probe["version"].asInteger() != PROBE_VERSION))
+      cache->m_probe = CVariant();
+
+    if (!cache->m_seekIndex.Deserialize(seekIndex))
+      CLog::Log(LOGWARNING, "CDemuxProbeCache::{} - invalid seek index for {}", __FUNCTION__,
+                CURL::GetRedacted(path));
+
+    CLog::Log(LOGDEBUG, "CDemuxProbeCache::{} - {}probe, {} key frames for {}", __FUNCTION__,
+              cache->m_probe.isObject() ? "" : "no ", cache->m_seekIndex.Size(),
+              CURL::GetRedacted(path));
+  }
+  db.Close();
+
+  return cache;
+}
+
+bool CDemuxProbeCache::HasProbe(const char* format) const
+{
+  return format && m_probe.isObject() && m_probe["format"].asString() == format;
+}
+
+int64_t CDemuxProbeCache::GetDuration() const
+{
+  if (!m_probe.isMember("duration"))
+    return AV_NOPTS_VALUE;
+  return m_probe["duration"].asInteger();
+}
+
+bool CDemuxProbeCache::RestoreProbe(AVFormatContext* context) const
+{
+  if (!HasProbe(context->iformat->name) || !CanRestoreFormat(context->iformat->name))
+    return false;
+
+  const CVariant& streams = m_probe["streams"];
+  if (!streams.isArray() || streams.size() != context->nb_streams)
+    return false;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream* stream = context->streams[i];
+    const CVariant& value = streams[i];
+    if (value["id"].asInteger() != stream->id ||
+        value["type"].asInteger() != stream->codecpar->codec_type ||
+        value["codec"].asInteger() != stream->codecpar->codec_id ||
+        stream->codecpar->codec_id == AV_CODEC_ID_NONE)
+      return false;
+  }
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+    RestoreStream(streams[i], context->streams[i]);
+
+  RestoreIfUnset(context->duration, static_cast<int64_t>(AV_NOPTS_VALUE), m_probe["duration"]);
+  RestoreIfUnset(context->start_time, static_cast<int64_t>(AV_NOPTS_VALUE),
+                 m_probe["starttime"]);
+  RestoreIfUnset(context->bit_rate, static_cast<int64_t>(0), m_probe["bitrate"]);
+
+  return true;
+}
+
+void CDemuxProbeCache::StoreProbe(const AVFormatContext* context)
+{
+  if (!context->iformat->name ||
+      (!CanRestoreFormat(context->iformat->name) && !NeedsSeekIndex(context->iformat->name)))
+    return;
+
+  CVariant probe(CVariant::VariantTypeObject);
+  probe["version"] = PROBE_VERSION;
+  probe["format"] = context->iformat->name;
+  probe["duration"] = context->duration;
+  probe["starttime"] = context->start_time;
+  probe["bitrate"] = context->bit_rate;
+
+  // transport streams only need the duration, streams are created while demuxing
+  if (CanRestoreFormat(context->iformat->name))
+  {
+    probe["streams"] = CVariant(CVariant::VariantTypeArray);
+    for (unsigned int i = 0; i < context->nb_streams; i++)
+    {
+      CVariant stream;
+      StoreStream(context->streams[i], stream);
+      probe["streams"].push_back(stream);
+    }
+  }
+
+  m_probe = probe;
+  m_probeChanged = true;
+}
+
+void CDemuxProbeCache::Save()
+{
+  if (!m_probeChanged && !m_seekIndex.IsChanged())
+    return;
+
+  std::string probe;
+  if (m_probe.isObject())
+    CJSONVariantWriter::Write(m_probe, probe, true);
+
+  CLog::Log(LOGDEBUG, "CDemuxProbeCache::{} - {} key frames for {}", __FUNCTION__,
+            m_seekIndex.Size(), CURL::GetRedacted(m_path));
+
+  CJobManager::GetInstance().Submit(
+      [idFile = m_idFile, fileSize = m_fileSize, probe, seekIndex = m_seekIndex.Serialize()]() {
+        CVideoDatabase db;
+        if (!db.Open())
+          return;
+        db.SetDemuxCache(idFile, fileSize, probe, seekIndex);
+        db.Close();
+      });
+
+  m_probeChanged = false;
+  m_seekIndex.SetUnchanged();
+}
+
+bool CDemuxProbeCache::CanRestoreFormat(const char* format)
+{
+  return format && (strcmp(format, "matroska,webm") == 0 ||
+                    strcmp(format, "mov,mp4,m4a,3gp,3g2,mj2") == 0 || strcmp(format, "avi") == 0);
+}
+
+bool CDemuxProbeCache::NeedsSeekIndex(const char* format)
+{
+  return format && (strcmp(format, "mpegts") == 0 || strcmp(format, "mpeg") == 0);
+}
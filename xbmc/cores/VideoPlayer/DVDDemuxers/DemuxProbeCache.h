@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "DemuxSeekIndex.h"
+#include "utils/Variant.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+class CDVDInputStream;
+struct AVFormatContext;
+
+/*!
+ \brief Stream parameters and key frame index of a file, persisted in the video database.
+
+ The first playback of a file stores what avformat_find_stream_info() found, so later opens
+ can restore the codec parameters and skip probing. For transport streams, where the probe
+ pass only determines the duration, the whole first open pass is skipped. The key frame index
+ gathered while playing is stored with it, see CDemuxSeekIndex.
+
+ Entries are keyed by the file in the video database and dropped when the file size changes.
+ Only files the video database already knows are cached, it doesn't add files.
+ */
+class CDemuxProbeCache
+{
+public:
+  /*!
+   \brief Load the cache of an input stream.
+   \param idFile id of the file in the video database, files that aren't in the database are not
+   cached
+   \return the cache or nullptr if the input is no local, finished file of the video database
+   */
+  static std::unique_ptr<CDemuxProbeCache> Load(CDVDInputStream& input, int idFile);
+
+  const std::string& GetPath() const { return m_path; }
+
+  /*!
+   \brief Whether a probe of the given input format is cached.
+   */
+  bool HasProbe(const char* format) const;
+
+  /*!
+   \brief Duration of the file in AV_TIME_BASE units as found by the probe.
+   */
+  int64_t GetDuration() const;
+
+  /*!
+   \brief Restore cached codec parameters to the streams of a freshly opened file.
+   Parameters the demuxer found in the headers are kept.
+   \return false if the streams don't match the cache or the format can't be restored,
+   the file has to be probed then
+   */
+  bool RestoreProbe(AVFormatContext* context) const;
+
+  /*!
+   \brief Store the parameters of a probed file.
+   */
+  void StoreProbe(const AVFormatContext* context);
+
+  CDemuxSeekIndex& GetSeekIndex() { return m_seekIndex; }
+
+  /*!
+   \brief Write changes to the video database in the background.
+   */
+  void Save();
+
+  /*!
+   \brief Whether the streams of a format can be restored instead of probed, which is only
+   the case for containers that declare all streams in their headers.
+   */
+  static bool CanRestoreFormat(const char* format);
+
+  /*!
+   \brief Whether a format seeks by bisecting on timestamps and benefits from a seek index.
+   */
+  static bool NeedsSeekIndex(const char* format);
+
+private:
+  CDemuxProbeCache(const std::string& path, int idFile, int64_t fileSize);
+
+  std::string m_path;
+  int m_idFile;
+  int64_t m_fileSize;
+  CVariant m_probe;
+  bool m_probeChanged = false;
+  CDemuxSeekIndex m_seekIndex;
+};
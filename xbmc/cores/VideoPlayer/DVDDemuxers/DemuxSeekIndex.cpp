@@ -0,0 +1,124 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxSeekIndex.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+namespace
+{
+bool EntryBefore(const CDemuxSeekIndex::Entry& entry, int64_t time)
+{
+  return entry.time < time;
+}
+} // namespace
+
+bool CDemuxSeekIndex::Add(int64_t time, int64_t pos)
+{
+  if (time < 0 || pos < 0 || m_entries.size() >= MAX_ENTRIES)
+    return false;
+
+  // mostly appended while playing, inserted after seeks
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), time, EntryBefore);
+  if (it != m_entries.end() && it->time - time < MIN_DISTANCE)
+    return false;
+  if (it != m_entries.begin() && time - std::prev(it)->time < MIN_DISTANCE)
+    return false;
+
+  m_entries.insert(it, {time, pos});
+  m_changed = true;
+  return true;
+}
+
+const CDemuxSeekIndex::Entry* CDemuxSeekIndex::Find(int64_t time, bool backwards) const
+{
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), time, EntryBefore);
+  if (backwards)
+  {
+    if (it == m_entries.end() || it->time != time)
+    {
+      if (it == m_entries.begin())
+        return nullptr;
+      --it;
+    }
+    if (time - it->time > MAX_GAP)
+      return nullptr;
+  }
+  else if (it == m_entries.end() || it->time - time > MAX_GAP)
+    return nullptr;
+
+  return &*it;
+}
+
+void CDemuxSeekIndex::Clear()
+{
+  m_changed = !m_entries.empty();
+  m_entries.clear();
+}
+
+std::string CDemuxSeekIndex::Serialize() const
+{
+  std::string index;
+  index.reserve(m_entries.size() * 12);
+
+  int64_t time = 0;
+  int64_t pos = 0;
+  for (const auto& entry : m_entries)
+  {
+    const int64_t ms = entry.time / 1000;
+    if (!index.empty())
+      index += ',';
+    index += std::to_string(ms - time);
+    index += ':';
+    index += std::to_string(entry.pos - pos);
+    time = ms;
+    pos = entry.pos;
+  }
+  return index;
+}
+
+bool CDemuxSeekIndex::Deserialize(const std::string& index)
+{
+  m_entries.clear();
+  m_changed = false;
+
+  int64_t time = 0;
+  int64_t pos = 0;
+  const char* p = index.c_str();
+  while (*p)
+  {
+    char* end = nullptr;
+    const long long deltaTime = strtoll(p, &end, 10);
+    if (end == p || *end != ':' || (deltaTime <= 0 && !m_entries.empty()))
+    {
+      m_entries.clear();
+      return false;
+    }
+    p = end + 1;
+
+    const long long deltaPos = strtoll(p, &end, 10);
+    if (end == p || (*end != ',' && *end != '\0'))
+    {
+      m_entries.clear();
+      return false;
+    }
+    p = *end ? end + 1 : end;
+
+    time += deltaTime;
+    pos += deltaPos;
+    if (time < 0 || pos < 0 || m_entries.size() >= MAX_ENTRIES)
+    {
+      m_entries.clear();
+      return false;
+    }
+    m_entries.push_back({time * 1000, pos});
+  }
+  return true;
+}
@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Sparse index of key frame byte offsets of a file.
+
+ Built while a file is demuxed and persisted with the probe cache, so seeks in formats
+ without an index of their own (MPEG-TS, MPEG-PS) can go straight to a key frame instead
+ of bisecting the file on timestamps. Only key frames at least MIN_DISTANCE apart are kept.
+ */
+class CDemuxSeekIndex
+{
+public:
+  static constexpr int64_t MIN_DISTANCE = 2000000; //!< us between two entries
+  static constexpr int64_t MAX_GAP = 2 * MIN_DISTANCE; //!< us to a target time an entry is used for
+  static constexpr size_t MAX_ENTRIES = 20000;
+
+  struct Entry
+  {
+    int64_t time; //!< timestamp of the key frame in us, as used by the demuxer
+    int64_t pos; //!< byte offset of the key frame packet
+  };
+
+  /*!
+   \brief Add a key frame, unless there's an entry closer than MIN_DISTANCE.
+   \return true if the entry was added
+   */
+  bool Add(int64_t time, int64_t pos);
+
+  /*!
+   \brief Find the key frame to seek to for a target time.
+   \param time target time in us
+   \param backwards find the key frame at or before the target, otherwise at or after it
+   \return the entry or nullptr if the index doesn't cover the target
+   */
+  const Entry* Find(int64_t time, bool backwards) const;
+
+  size_t Size() const { return m_entries.size(); }
+  bool IsEmpty() const { return m_entries.empty(); }
+  bool IsChanged() const { return m_changed; }
+  void SetUnchanged() { m_changed = false; }
+  void Clear();
+
+  /*!
+   \brief Serialize the index as delta coded "time:pos" pairs, times in ms.
+   */
+  std::string Serialize() const;
+  bool Deserialize(const std::string& index);
+
+private:
+  std::vector<Entry> m_entries; // sorted by time
+  bool m_changed = false;
+};
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DemuxSeekIndex.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr int64_t SECOND = 1000000;
+
+// key frames every half second, as written while playing sequentially
+void Play(CDemuxSeekIndex& index, int64_t from, int64_t to)
+{
+  for (int64_t time = from; time < to; time += SECOND / 2)
+    index.Add(time, time / 10);
+}
+} // namespace
+
+TEST(TestDemuxSeekIndex, KeepsEntriesApart)
+{
+  CDemuxSeekIndex index;
+  Play(index, 0, 60 * SECOND);
+
+  EXPECT_EQ(60 * SECOND / CDemuxSeekIndex::MIN_DISTANCE, static_cast<int64_t>(index.Size()));
+  EXPECT_TRUE(index.IsChanged());
+
+  // playing the same part again adds nothing
+  index.SetUnchanged();
+  Play(index, 10 * SECOND, 20 * SECOND);
+  EXPECT_FALSE(index.IsChanged());
+
+  EXPECT_FALSE(index.Add(-1, 0));
+  EXPECT_FALSE(index.Add(100 * SECOND, -1));
+}
+
+TEST(TestDemuxSeekIndex, FindsKeyFrames)
+{
+  CDemuxSeekIndex index;
+  Play(index, 0, 60 * SECOND);
+  // after a seek
+  Play(index, 600 * SECOND, 610 * SECOND);
+
+  const CDemuxSeekIndex::Entry* entry = index.Find(31 * SECOND, true);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(30 * SECOND, entry->time);
+  EXPECT_EQ(3 * SECOND, entry->pos);
+
+  entry = index.Find(31 * SECOND, false);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(32 * SECOND, entry->time);
+
+  entry = index.Find(30 * SECOND, false);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(30 * SECOND, entry->time);
+
+  entry = index.Find(605 * SECOND, true);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(604 * SECOND, entry->time);
+
+  // never played, the index doesn't know the key frames there
+  EXPECT_EQ(nullptr, index.Find(300 * SECOND, true));
+  EXPECT_EQ(nullptr, index.Find(300 * SECOND, false));
+  EXPECT_EQ(nullptr, index.Find(700 * SECOND, true));
+}
+
+TEST(TestDemuxSeekIndex, Serialization)
+{
+  CDemuxSeekIndex index;
+  Play(index, 0, 20 * SECOND);
+  Play(index, 100 * SECOND, 110 * SECOND);
+
+  const std::string serialized = index.Serialize();
+  EXPECT_EQ(0u, serialized.find("0:0,2000:200000,"));
+
+  CDemuxSeekIndex restored;
+  ASSERT_TRUE(restored.Deserialize(serialized));
+  EXPECT_FALSE(restored.IsChanged());
+  ASSERT_EQ(index.Size(), restored.Size());
+  EXPECT_EQ(serialized, restored.Serialize());
+
+  const CDemuxSeekIndex::Entry* entry = restored.Find(105 * SECOND, true);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(104 * SECOND, entry->time);
+  EXPECT_EQ(104 * SECOND / 10, entry->pos);
+
+  EXPECT_TRUE(restored.Deserialize(""));
+  EXPECT_TRUE(restored.IsEmpty());
+  EXPECT_FALSE(restored.Deserialize("0:0,x:1"));
+  EXPECT_TRUE(restored.IsEmpty());
+  EXPECT_FALSE(restored.Deserialize("1000:10,0:10"));
+}
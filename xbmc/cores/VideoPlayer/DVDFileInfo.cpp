@@ -14,6 +14,9 @@
 #include "pictures/Picture.h"
 #include "video/VideoInfoTag.h"
 #include "filesystem/StackDirectory.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Timer.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 
@@ -26,6 +29,7 @@
 #include "DVDDemuxers/DVDDemux.h"
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDCodecs/Video/DVDVideoCodec.h"
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
@@ -40,8 +44,11 @@
 #include "Util.h"
 #include "utils/LangCodeExpander.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <memory>
+#include <numeric>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -85,10 +92,374 @@ int DegreeToOrientation(int degrees)
   }
 }
 
+namespace
+{
+// decoders are kept for a while so that extracting thumbs from a series of files with the same
+// video format, e.g. the episodes of a season, does not open a new decoder for every file
+constexpr size_t MAX_THUMB_DECODERS = 2;
+constexpr auto THUMB_DECODER_IDLE_TIME = std::chrono::seconds(30);
+
+struct ThumbDecoder
+{
+  ~ThumbDecoder()
+  {
+    if (scaler)
+      sws_freeContext(scaler);
+  }
+
+  CDVDStreamInfo hint;
+  bool keyFramesOnly = false;
+  int lowres = 0;
+  std::unique_ptr<CProcessInfo> processInfo;
+  std::unique_ptr<CDVDVideoCodec> codec;
+  SwsContext* scaler = nullptr;
+  std::chrono::steady_clock::time_point released;
+};
+
+class CThumbDecoderCache
+{
+public:
+  CThumbDecoderCache() : m_expiryTimer([this]() { OnExpiryTimeout(); }) {}
+
+  std::unique_ptr<ThumbDecoder> Acquire(CDVDStreamInfo& hint,
+                                        bool keyFramesOnly,
+                                        unsigned int maxWidth)
+  {
+    const int lowres = keyFramesOnly ? GetLowres(hint, maxWidth) : 0;
+
+    std::unique_ptr<ThumbDecoder> decoder;
+    {
+      CSingleLock lock(m_section);
+      Expire();
+      auto it = std::find_if(m_decoders.begin(), m_decoders.end(),
+                             [&hint, keyFramesOnly,
+                              lowres](const std::unique_ptr<ThumbDecoder>& entry) {
+                               return entry->keyFramesOnly == keyFramesOnly &&
+                                      entry->lowres == lowres &&
+                                      entry->hint.Equal(hint, CDVDStreamInfo::COMPARE_EXTRADATA);
+                             });
+      if (it != m_decoders.end())
+      {
+        decoder = std::move(*it);
+        m_decoders.erase(it);
+      }
+    }
+
+    if (decoder)
+    {
+      decoder->codec->Reset();
+      return decoder;
+    }
+
+    return Create(hint, keyFramesOnly, lowres);
+  }
+
+  void Release(std::unique_ptr<ThumbDecoder> decoder)
+  {
+    // codecs of inputstream add-ons are bound to the stream they were opened for
+    if (!decoder || decoder->hint.externalInterfaces)
+      return;
+
+    decoder->released = std::chrono::steady_clock::now();
+
+    std::unique_ptr<ThumbDecoder> evicted;
+    bool startTimer = false;
+    {
+      CSingleLock lock(m_section);
+      m_decoders.insert(m_decoders.begin(), std::move(decoder));
+      if (m_decoders.size() > MAX_THUMB_DECODERS)
+      {
+        evicted = std::move(m_decoders.back());
+        m_decoders.pop_back();
+      }
+      Expire();
+
+      startTimer = !m_expiryScheduled;
+      m_expiryScheduled = true;
+    }
+
+    // free idle decoders also when no further thumbs are extracted. a timer that decided to stop
+    // does not take the lock anymore, wait for it to end before it is started again
+    if (startTimer)
+    {
+      m_expiryTimer.Stop(true);
+      m_expiryTimer.Start(std::chrono::duration_cast<std::chrono::milliseconds>(
+                              THUMB_DECODER_IDLE_TIME)
+                              .count());
+    }
+  }
+
+  void Clear()
+  {
+    std::vector<std::unique_ptr<ThumbDecoder>> decoders;
+    CSingleLock lock(m_section);
+    decoders.swap(m_decoders);
+  }
+
+private:
+  static std::unique_ptr<ThumbDecoder> Create(CDVDStreamInfo& hint, bool keyFramesOnly, int lowres)
+  {
+    auto decoder = std::make_unique<ThumbDecoder>();
+    decoder->hint = hint;
+    decoder->keyFramesOnly = keyFramesOnly;
+    decoder->lowres = lowres;
+    decoder->processInfo.reset(CProcessInfo::CreateInstance());
+    std::vector<AVPixelFormat> pixFmts;
+    pixFmts.push_back(AV_PIX_FMT_YUV420P);
+    decoder->processInfo->SetPixFormats(pixFmts);
+
+    if (hint.externalInterfaces)
+    {
+      decoder->keyFramesOnly = false;
+      decoder->lowres = 0;
+      decoder->codec = CDVDFactoryCodec::CreateVideoCodec(hint, *decoder->processInfo);
+    }
+    else
+    {
+      CDVDCodecOptions options;
+      if (keyFramesOnly)
+      {
+        options.m_keys.emplace_back("skip_frame", "nokey");
+        if (lowres > 0)
+          options.m_keys.emplace_back("lowres", std::to_string(lowres));
+      }
+
+      auto codec = std::make_unique<CDVDVideoCodecFFmpeg>(*decoder->processInfo);
+      if (codec->Open(hint, options))
+        decoder->codec = std::move(codec);
+    }
+
+    if (!decoder->codec)
+      return nullptr;
+
+    return decoder;
+  }
+
+  // largest lowres factor that still decodes pictures at least as wide as the thumbnails
+  static int GetLowres(const CDVDStreamInfo& hint, unsigned int maxWidth)
+  {
+    const AVCodec* codec = avcodec_find_decoder(hint.codec);
+    if (!codec || hint.width <= 0)
+      return 0;
+
+    const int thumbWidth = static_cast<int>(maxWidth);
+    int lowres = 0;
+    while (lowres < codec->max_lowres && (hint.width >> (lowres + 1)) >= thumbWidth)
+      lowres++;
+
+    return lowres;
+  }
+
+  void Expire()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    m_decoders.erase(std::remove_if(m_decoders.begin(), m_decoders.end(),
+                                    [now](const std::unique_ptr<ThumbDecoder>& entry) {
+                                      return now - entry->released >= THUMB_DECODER_IDLE_TIME;
+                                    }),
+                     m_decoders.end());
+  }
+
+  void OnExpiryTimeout()
+  {
+    std::vector<std::unique_ptr<ThumbDecoder>> expired;
+    CSingleLock lock(m_section);
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = m_decoders.begin(); it != m_decoders.end();)
+    {
+      if (now - (*it)->released >= THUMB_DECODER_IDLE_TIME)
+      {
+        expired.emplace_back(std::move(*it));
+        it = m_decoders.erase(it);
+      }
+      else
+        ++it;
+    }
+
+    if (m_decoders.empty())
+    {
+      m_expiryScheduled = false;
+      return;
+    }
+
+    // the least recently released decoder is the last one
+    const auto remaining = THUMB_DECODER_IDLE_TIME - (now - m_decoders.back()->released);
+    m_expiryTimer.RestartAsync(
+        std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count() + 1);
+  }
+
+  CCriticalSection m_section;
+  std::vector<std::unique_ptr<ThumbDecoder>> m_decoders;
+  bool m_expiryScheduled = false;
+  CTimer m_expiryTimer;
+};
+
+CThumbDecoderCache& GetThumbDecoderCache()
+{
+  static CThumbDecoderCache cache;
+  return cache;
+}
+
+CDVDVideoCodec::VCReturn GetThumbPicture(CDVDVideoCodec& codec, VideoPicture& picture)
+{
+  CDVDVideoCodec::VCReturn state = CDVDVideoCodec::VC_NONE;
+  while (state == CDVDVideoCodec::VC_NONE)
+    state = codec.GetPicture(&picture);
+
+  return state;
+}
+
+// decode from the current demuxer position until a picture comes out
+bool DecodeThumbPicture(CDVDDemux& demuxer,
+                        int videoStream,
+                        ThumbDecoder& decoder,
+                        VideoPicture& picture,
+                        int& packetsTried)
+{
+  // num streams * 160 frames, should get a valid frame, if not abort.
+  int abort_index = demuxer.GetNrOfStreams() * 160;
+  do
+  {
+    DemuxPacket* pPacket = demuxer.Read();
+    packetsTried++;
+
+    if (!pPacket)
+      break;
+
+    if (pPacket->iStreamId != videoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    decoder.codec->AddData(*pPacket);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    CDVDVideoCodec::VCReturn state = GetThumbPicture(*decoder.codec, picture);
+
+    // the skipped frames never arrive to push a key frame out of the reorder delay,
+    // drain it. the decoder restarts with the next packet.
+    if (state == CDVDVideoCodec::VC_BUFFER && decoder.keyFramesOnly)
+    {
+      decoder.codec->SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+      state = GetThumbPicture(*decoder.codec, picture);
+      decoder.codec->SetCodecControl(0);
+    }
+
+    if (state == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
+      return true;
+
+  } while (abort_index--);
+
+  return false;
+}
+
+// scale the picture to BGRA and hand it to the callback, false if the picture couldn't be scaled.
+// proceed is set to false if extraction should stop.
+bool ScaleThumbPicture(VideoPicture& picture,
+                       const CDVDStreamInfo& hint,
+                       SwsContext*& scaler,
+                       unsigned int maxWidth,
+                       size_t index,
+                       const CDVDFileInfo::ExtractedFrameCallback& callback,
+                       bool& proceed)
+{
+  proceed = true;
+
+  unsigned int nWidth = std::min(picture.iDisplayWidth, maxWidth);
+  double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+  if (hint.forced_aspect && hint.aspect != 0)
+    aspect = hint.aspect;
+  unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
+
+  scaler = sws_getCachedContext(scaler, picture.iWidth, picture.iHeight, AV_PIX_FMT_YUV420P,
+                                nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, nullptr,
+                                nullptr, nullptr);
+  if (!scaler)
+    return false;
+
+  // We pass the buffers to sws_scale uses 16 aligned widths when using intrinsics
+  int sizeNeeded = FFALIGN(nWidth, 16) * nHeight * 4;
+  uint8_t *pOutBuf = static_cast<uint8_t*>(av_malloc(sizeNeeded));
+  if (!pOutBuf)
+    return false;
+
+  uint8_t *planes[YuvImage::MAX_PLANES];
+  int stride[YuvImage::MAX_PLANES];
+  picture.videoBuffer->GetPlanes(planes);
+  picture.videoBuffer->GetStrides(stride);
+  uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+  int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+  uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+  int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+  int orientation = DegreeToOrientation(hint.orientation);
+  sws_scale(scaler, src, srcStride, 0, picture.iHeight, dst, dstStride);
+
+  proceed = callback(index, pOutBuf, nWidth, nHeight, nWidth * 4, orientation);
+  av_free(pOutBuf);
+
+  return true;
+}
+} // namespace
+
 bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
                                 CTextureDetails &details,
                                 CStreamDetails *pStreamDetails,
                                 int64_t pos)
+{
+  std::vector<ThumbPosition> positions(1);
+  positions[0].pos = pos;
+  positions[0].details = &details;
+  return ExtractThumbs(fileItem, positions, pStreamDetails);
+}
+
+bool CDVDFileInfo::ExtractThumbs(const CFileItem& fileItem,
+                                 std::vector<ThumbPosition>& positions,
+                                 CStreamDetails* pStreamDetails)
+{
+  std::vector<int64_t> times;
+  for (auto& position : positions)
+  {
+    position.extracted = false;
+    times.push_back(position.pos);
+  }
+
+  const unsigned int maxWidth =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes;
+  const bool result = ExtractFrames(
+      fileItem, times, maxWidth, pStreamDetails,
+      [&positions](size_t index, const uint8_t* pixels, unsigned int width, unsigned int height,
+                   unsigned int pitch, int orientation) {
+        CTextureDetails* details = positions[index].details;
+        if (details)
+        {
+          details->width = width;
+          details->height = height;
+          CPicture::CacheTexture(const_cast<uint8_t*>(pixels), width, height, pitch, orientation,
+                                 width, height, CTextureCache::GetCachedPath(details->file));
+          positions[index].extracted = true;
+        }
+        return true;
+      });
+
+  for (const auto& position : positions)
+  {
+    if (!position.extracted && position.details)
+    {
+      XFILE::CFile file;
+      if (file.OpenForWrite(CTextureCache::GetCachedPath(position.details->file)))
+        file.Close();
+    }
+  }
+
+  return result;
+}
+
+bool CDVDFileInfo::ExtractFrames(const CFileItem& fileItem,
+                                 const std::vector<int64_t>& positions,
+                                 unsigned int maxWidth,
+                                 CStreamDetails* pStreamDetails,
+                                 const ExtractedFrameCallback& callback)
 {
   const std::string redactPath = CURL::GetRedacted(fileItem.GetPath());
   auto start = std::chrono::steady_clock::now();
@@ -180,137 +551,102 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     }
   }
 
-  bool bOk = false;
   int packetsTried = 0;
+  int extracted = 0;
 
   if (nVideoStream != -1)
   {
-    std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
-    std::vector<AVPixelFormat> pixFmts;
-    pixFmts.push_back(AV_PIX_FMT_YUV420P);
-    pProcessInfo->SetPixFormats(pixFmts);
-
     CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
     hint.codecOptions = CODEC_FORCE_SOFTWARE;
 
-    std::unique_ptr<CDVDVideoCodec> pVideoCodec =
-        CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+    CThumbDecoderCache& decoders = GetThumbDecoderCache();
+    std::unique_ptr<ThumbDecoder> decoder = decoders.Acquire(hint, true, maxWidth);
+    if (!decoder)
+      decoder = decoders.Acquire(hint, false, maxWidth);
 
-    if (pVideoCodec)
+    int nTotalLen = pDemuxer->GetStreamLength();
+    auto seekPos = [nTotalLen, &positions](size_t index) {
+      return (positions[index] == -1) ? static_cast<int64_t>(nTotalLen / 3) : positions[index];
+    };
+
+    // visit the positions in file order, chapters come from a single pass through the file
+    std::vector<size_t> sorted(positions.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&seekPos](size_t a, size_t b) { return seekPos(a) < seekPos(b); });
+
+    for (size_t index : sorted)
     {
-      int nTotalLen = pDemuxer->GetStreamLength();
-      int64_t nSeekTo = (pos == -1) ? nTotalLen / 3 : pos;
+      if (!decoder)
+        break;
+
+      int64_t nSeekTo = seekPos(index);
 
       CLog::Log(LOGDEBUG, "{} - seeking to pos {}ms (total: {}ms) in {}", __FUNCTION__, nSeekTo,
                 nTotalLen, redactPath);
 
-      if (pDemuxer->SeekTime(static_cast<double>(nSeekTo), true))
+      VideoPicture picture = {};
+      bool decoded = false;
+      const bool seeked = pDemuxer->SeekTime(static_cast<double>(nSeekTo), true);
+      if (seeked)
       {
-        CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
-        VideoPicture picture = {};
-
-        // num streams * 160 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 160;
-        do
-        {
-          DemuxPacket* pPacket = pDemuxer->Read();
-          packetsTried++;
-
-          if (!pPacket)
-            break;
-
-          if (pPacket->iStreamId != nVideoStream)
-          {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
-
-          pVideoCodec->AddData(*pPacket);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-
-          iDecoderState = CDVDVideoCodec::VC_NONE;
-          while (iDecoderState == CDVDVideoCodec::VC_NONE)
-          {
-            iDecoderState = pVideoCodec->GetPicture(&picture);
-          }
-
-          if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
-          {
-            if(!(picture.iFlags & DVP_FLAG_DROPPED))
-              break;
-          }
+        decoder->codec->Reset();
+        decoded = DecodeThumbPicture(*pDemuxer, nVideoStream, *decoder, picture, packetsTried);
+      }
 
-        } while (abort_index--);
+      if (seeked && !decoded && decoder->keyFramesOnly)
+      {
+        // e.g. broadcasts using intra refresh have no frames flagged as key frames
+        CLog::Log(LOGDEBUG, "{} - no key frame found in {}, decoding all frames", __FUNCTION__,
+                  redactPath);
+        picture.Reset();
+        decoder = decoders.Acquire(hint, false, maxWidth);
+        if (decoder && pDemuxer->SeekTime(static_cast<double>(nSeekTo), true))
+          decoded = DecodeThumbPicture(*pDemuxer, nVideoStream, *decoder, picture, packetsTried);
+      }
 
-        if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
-        {
-          {
-            unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
-
-            // We pass the buffers to sws_scale uses 16 aligned widths when using intrinsics
-            int sizeNeeded = FFALIGN(nWidth, 16) * nHeight * 4;
-            uint8_t *pOutBuf = static_cast<uint8_t*>(av_malloc(sizeNeeded));
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-            if (context)
-            {
-              uint8_t *planes[YuvImage::MAX_PLANES];
-              int stride[YuvImage::MAX_PLANES];
-              picture.videoBuffer->GetPlanes(planes);
-              picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-            av_free(pOutBuf);
-          }
-        }
+      if (decoded)
+      {
+        bool proceed = true;
+        if (ScaleThumbPicture(picture, hint, decoder->scaler, maxWidth, index, callback, proceed))
+          extracted++;
         else
-        {
-          CLog::Log(LOGDEBUG, "{} - decode failed in {} after {} packets.", __FUNCTION__,
-                    redactPath, packetsTried);
-        }
+          CLog::Log(LOGDEBUG, "{} - unable to scale the frame from {}", __FUNCTION__, redactPath);
+
+        if (!proceed)
+          break;
+      }
+      else
+      {
+        CLog::Log(LOGDEBUG, "{} - decode failed in {} after {} packets.", __FUNCTION__,
+                  redactPath, packetsTried);
       }
     }
+
+    decoders.Release(std::move(decoder));
   }
 
   if (pDemuxer)
     delete pDemuxer;
 
-  if(!bOk)
-  {
-    XFILE::CFile file;
-    if(file.OpenForWrite(CTextureCache::GetCachedPath(details.file)))
-      file.Close();
-  }
-
   auto end = std::chrono::steady_clock::now();
   auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-  CLog::Log(LOGDEBUG, "{} - measured {} ms to extract thumb from file <{}> in {} packets. ",
-            __FUNCTION__, duration.count(), redactPath, packetsTried);
+  CLog::Log(LOGDEBUG, "{} - measured {} ms to extract {} of {} frames from file <{}> in {} packets. ",
+            __FUNCTION__, duration.count(), extracted, positions.size(), redactPath, packetsTried);
+
+  return extracted > 0;
+}
 
-  return bOk;
+void CDVDFileInfo::ReleaseThumbDecoders()
+{
+  GetThumbDecoderCache().Clear();
 }
 
 /**
  * \brief Open the item pointed to by pItem and extract streamdetails
  * \return true if the stream details have changed
  */
-bool CDVDFileInfo::GetFileStreamDetails(CFileItem *pItem)
+bool CDVDFileInfo::GetFileStreamDetails(CFileItem* pItem, bool probeOnly)
 {
   if (!pItem)
     return false;
@@ -342,7 +678,7 @@ bool CDVDFileInfo::GetFileStreamDetails(CFileItem *pItem)
     return false;
   }
 
-  CDVDDemux *pDemuxer = CDVDFactoryDemuxer::CreateDemuxer(pInputStream, true);
+  CDVDDemux* pDemuxer = CDVDFactoryDemuxer::CreateDemuxer(pInputStream, true, probeOnly);
   if (pDemuxer)
   {
     bool retVal = DemuxerToStreamDetails(pInputStream, pDemuxer, pItem->GetVideoInfoTag()->m_streamDetails, strFileNameAndPath);
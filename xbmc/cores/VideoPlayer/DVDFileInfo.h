@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -22,14 +24,63 @@ class CTextureDetails;
 class CDVDFileInfo
 {
 public:
+  /** \brief A position to extract a thumbnail from, see ExtractThumbs(). */
+  struct ThumbPosition
+  {
+    int64_t pos = -1; ///< position in ms, -1 for a third into the file
+    CTextureDetails* details = nullptr; ///< cache file to write, receives the size of the image
+    bool extracted = false; ///< set when a thumbnail was written for this position
+  };
+
   // Extract a thumbnail image from the media referenced by fileItem, optionally populating a streamdetails class with the data
   static bool ExtractThumb(const CFileItem& fileItem,
                            CTextureDetails &details,
                            CStreamDetails *pStreamDetails,
                            int64_t pos);
 
+  /** \brief Extract thumbnail images for several positions with a single open of the file.
+  *   See ExtractFrames(), the cache file of every position that fails is left empty.
+  *   \param[in,out] positions The positions to extract, extracted is set for the written ones.
+  *   \param[out] pStreamDetails Optional stream details to fill in.
+  *   \return true if at least one thumbnail was extracted.
+  */
+  static bool ExtractThumbs(const CFileItem& fileItem,
+                            std::vector<ThumbPosition>& positions,
+                            CStreamDetails* pStreamDetails);
+
+  /** \brief Called with every frame extracted by ExtractFrames().
+  *   Gets the index of the position, the BGRA pixels, width, height, pitch and orientation.
+  *   Returns false to stop the extraction.
+  */
+  using ExtractedFrameCallback = std::function<bool(size_t index,
+                                                    const uint8_t* pixels,
+                                                    unsigned int width,
+                                                    unsigned int height,
+                                                    unsigned int pitch,
+                                                    int orientation)>;
+
+  /** \brief Extract scaled down frames for several positions with a single open of the file.
+  *   Only key frames are decoded, at a reduced resolution where the codec supports it.
+  *   Positions are visited in ascending order, positions that fail are not reported.
+  *   \param[in] positions Positions in ms, -1 for a third into the file.
+  *   \param[in] maxWidth Maximum width of the frames handed to the callback.
+  *   \param[out] pStreamDetails Optional stream details to fill in.
+  *   \return true if at least one frame was extracted.
+  */
+  static bool ExtractFrames(const CFileItem& fileItem,
+                            const std::vector<int64_t>& positions,
+                            unsigned int maxWidth,
+                            CStreamDetails* pStreamDetails,
+                            const ExtractedFrameCallback& callback);
+
+  /** \brief Free the decoders kept for thumbnail extraction of further files. Decoders that are
+   not reused are freed after a while without this call too.
+  */
+  static void ReleaseThumbDecoders();
+
   // Probe the files streams and store the info in the VideoInfoTag
-  static bool GetFileStreamDetails(CFileItem *pItem);
+  // probeOnly takes the streams from the container headers where possible, see CDVDDemuxFFmpeg::Open
+  static bool GetFileStreamDetails(CFileItem* pItem, bool probeOnly = false);
   static bool DemuxerToStreamDetails(const std::shared_ptr<CDVDInputStream>& pInputStream,
                                      CDVDDemux* pDemux,
                                      CStreamDetails& details,
@@ -9,9 +9,14 @@
 #include "InputStreamPVRChannel.h"
 
 #include "ServiceBroker.h"
+#include "TimeshiftBuffer.h"
 #include "pvr/PVRManager.h"
 #include "pvr/addons/PVRClient.h"
 #include "pvr/channels/PVRChannelGroupsContainer.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
 #include "utils/log.h"
 
 using namespace PVR;
@@ -35,6 +40,38 @@ CDVDInputStream::IDemux* CInputStreamPVRChannel::GetIDemux()
   return CInputStreamPVRBase::GetIDemux();
 }
 
+CDVDInputStream::IPosTime* CInputStreamPVRChannel::GetIPosTime()
+{
+  if (m_timeshiftBuffer)
+    return this;
+
+  return nullptr;
+}
+
+bool CInputStreamPVRChannel::GetTimes(Times& times)
+{
+  if (m_timeshiftBuffer)
+    return m_timeshiftBuffer->GetTimes(times);
+
+  return CInputStreamPVRBase::GetTimes(times);
+}
+
+void CInputStreamPVRChannel::Pause(bool bPaused)
+{
+  // the timeshift buffer continues buffering the live stream while paused
+  if (!m_timeshiftBuffer)
+    CInputStreamPVRBase::Pause(bPaused);
+}
+
+bool CInputStreamPVRChannel::PosTime(int ms)
+{
+  if (!m_timeshiftBuffer || !m_timeshiftBuffer->SeekTime(ms))
+    return false;
+
+  m_eof = false;
+  return true;
+}
+
 bool CInputStreamPVRChannel::OpenPVRStream()
 {
   std::shared_ptr<CPVRChannel> channel = m_item.GetPVRChannelInfoTag();
@@ -51,13 +88,55 @@ bool CInputStreamPVRChannel::OpenPVRStream()
     m_bDemuxActive = m_client->GetClientCapabilities().HandlesDemuxing();
     CLog::Log(LOGDEBUG, "CInputStreamPVRChannel - {} - opened channel stream {}", __FUNCTION__,
               m_item.GetPath());
+
+    if (!m_bDemuxActive)
+      StartTimeshiftBuffer();
+
     return true;
   }
   return false;
 }
 
+void CInputStreamPVRChannel::StartTimeshiftBuffer()
+{
+  const int iBufferSize =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iPVRTimeshiftBufferSize;
+  if (iBufferSize <= 0)
+    return;
+
+  bool bCanPause = false;
+  bool bCanSeek = false;
+  m_client->CanPauseStream(bCanPause);
+  m_client->CanSeekStream(bCanSeek);
+  if (bCanPause && bCanSeek)
+    return;
+
+  const std::shared_ptr<CPVRClient> client = m_client;
+  m_timeshiftBuffer = std::make_unique<CTimeshiftBuffer>(
+      [client](uint8_t* buf, int buf_size) {
+        int ret = -1;
+        client->ReadLiveStream(buf, buf_size, ret);
+        return ret;
+      },
+      URIUtils::AddFileToFolder("special://temp/timeshift", StringUtils::CreateUUID()),
+      static_cast<uint64_t>(iBufferSize) * 1024 * 1024);
+
+  if (m_timeshiftBuffer->Start())
+  {
+    CLog::Log(LOGDEBUG, "CInputStreamPVRChannel - {} - using local timeshift buffer for {}",
+              __FUNCTION__, m_item.GetPath());
+  }
+  else
+  {
+    m_timeshiftBuffer.reset();
+  }
+}
+
 void CInputStreamPVRChannel::ClosePVRStream()
 {
+  // stop reading the live stream before closing it
+  m_timeshiftBuffer.reset();
+
   if (m_client && (m_client->CloseLiveStream() == PVR_ERROR_NO_ERROR))
   {
     m_bDemuxActive = false;
@@ -68,6 +147,9 @@ void CInputStreamPVRChannel::ClosePVRStream()
 
 int CInputStreamPVRChannel::ReadPVRStream(uint8_t* buf, int buf_size)
 {
+  if (m_timeshiftBuffer)
+    return m_timeshiftBuffer->Read(buf, buf_size);
+
   int ret = -1;
 
   if (m_client)
@@ -78,6 +160,9 @@ int CInputStreamPVRChannel::ReadPVRStream(uint8_t* buf, int buf_size)
 
 int64_t CInputStreamPVRChannel::SeekPVRStream(int64_t offset, int whence)
 {
+  if (m_timeshiftBuffer)
+    return m_timeshiftBuffer->Seek(offset, whence);
+
   int64_t ret = -1;
 
   if (m_client)
@@ -88,6 +173,9 @@ int64_t CInputStreamPVRChannel::SeekPVRStream(int64_t offset, int whence)
 
 int64_t CInputStreamPVRChannel::GetPVRStreamLength()
 {
+  if (m_timeshiftBuffer)
+    return m_timeshiftBuffer->GetLength();
+
   int64_t ret = -1;
 
   if (m_client)
@@ -106,6 +194,9 @@ CDVDInputStream::ENextStream CInputStreamPVRChannel::NextPVRStream()
 
 bool CInputStreamPVRChannel::CanPausePVRStream()
 {
+  if (m_timeshiftBuffer)
+    return true;
+
   bool ret = false;
 
   if (m_client)
@@ -116,6 +207,9 @@ bool CInputStreamPVRChannel::CanPausePVRStream()
 
 bool CInputStreamPVRChannel::CanSeekPVRStream()
 {
+  if (m_timeshiftBuffer)
+    return true;
+
   bool ret = false;
 
   if (m_client)
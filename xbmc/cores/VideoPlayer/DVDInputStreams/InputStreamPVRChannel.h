@@ -10,13 +10,24 @@
 
 #include "InputStreamPVRBase.h"
 
-class CInputStreamPVRChannel : public CInputStreamPVRBase
+#include <memory>
+
+class CTimeshiftBuffer;
+
+class CInputStreamPVRChannel : public CInputStreamPVRBase, public CDVDInputStream::IPosTime
 {
 public:
   CInputStreamPVRChannel(IVideoPlayer* pPlayer, const CFileItem& fileitem);
   ~CInputStreamPVRChannel() override;
 
   CDVDInputStream::IDemux* GetIDemux() override;
+  CDVDInputStream::IPosTime* GetIPosTime() override;
+
+  bool GetTimes(Times& times) override;
+  void Pause(bool bPaused) override;
+
+  // IPosTime
+  bool PosTime(int ms) override;
 
 protected:
   bool OpenPVRStream() override;
@@ -29,5 +40,8 @@ protected:
   bool CanSeekPVRStream() override;
 
 private:
+  void StartTimeshiftBuffer();
+
   bool m_bDemuxActive;
+  std::unique_ptr<CTimeshiftBuffer> m_timeshiftBuffer;
 };
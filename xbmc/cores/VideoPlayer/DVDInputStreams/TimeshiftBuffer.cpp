@@ -0,0 +1,542 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TimeshiftBuffer.h"
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace
+{
+constexpr size_t TS_PACKET_SIZE = 188;
+constexpr uint8_t TS_SYNC_BYTE = 0x47;
+constexpr int PAT_PID = 0;
+constexpr uint8_t PAT_TABLE_ID = 0x00;
+constexpr uint8_t PMT_TABLE_ID = 0x02;
+constexpr int READ_CHUNK_SIZE = 64 * 1024;
+constexpr unsigned int READ_TIMEOUT_MS = 10000;
+constexpr int64_t PCR_WRAP = INT64_C(1) << 33;
+
+int64_t GetTicks()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool IsVideoStreamType(uint8_t streamType)
+{
+  switch (streamType)
+  {
+    case 0x01: // MPEG-1
+    case 0x02: // MPEG-2
+    case 0x10: // MPEG-4 part 2
+    case 0x1B: // H.264
+    case 0x24: // HEVC
+    case 0x42: // AVS
+    case 0xEA: // VC-1
+      return true;
+    default:
+      return false;
+  }
+}
+} // namespace
+
+CTimeshiftBuffer::CTimeshiftBuffer(const SourceFunction& source,
+                                   const std::string& directory,
+                                   uint64_t budget,
+                                   uint64_t segmentSize)
+  : CThread("TimeshiftBuffer"),
+    m_source(source),
+    m_directory(directory),
+    m_segmentSize(segmentSize),
+    m_maxSegments(std::max<size_t>(2, static_cast<size_t>(budget / segmentSize)))
+{
+}
+
+CTimeshiftBuffer::~CTimeshiftBuffer()
+{
+  Stop();
+}
+
+bool CTimeshiftBuffer::Start()
+{
+  if (!XFILE::CDirectory::Exists(m_directory) && !XFILE::CDirectory::Create(m_directory))
+  {
+    CLog::Log(LOGERROR, "CTimeshiftBuffer::{} - unable to create directory '{}'", __FUNCTION__,
+              m_directory);
+    return false;
+  }
+
+  m_startTime = time(nullptr);
+  m_startTicks = GetTicks();
+
+  CLog::Log(LOGDEBUG, "CTimeshiftBuffer::{} - buffering up to {} segments of {} bytes in '{}'",
+            __FUNCTION__, m_maxSegments, m_segmentSize, m_directory);
+  Create();
+  return true;
+}
+
+void CTimeshiftBuffer::Stop()
+{
+  StopThread(true);
+
+  CSingleLock readLock(m_readSection);
+  CSingleLock lock(m_critSection);
+  m_writeFile.reset();
+  m_readFile.reset();
+  m_readPath.clear();
+
+  for (const auto& segment : m_segments)
+    XFILE::CFile::Delete(segment.path);
+  m_segments.clear();
+  m_keyFrames.clear();
+
+  // also when nothing was buffered
+  if (XFILE::CDirectory::Exists(m_directory))
+    XFILE::CDirectory::Remove(m_directory);
+
+  m_endOfStream = true;
+  m_dataAvailable.Set();
+}
+
+void CTimeshiftBuffer::Process()
+{
+  std::vector<uint8_t> buf(READ_CHUNK_SIZE);
+
+  while (!m_bStop)
+  {
+    const int read = m_source(buf.data(), READ_CHUNK_SIZE);
+    if (read <= 0)
+    {
+      if (read < 0)
+        CLog::Log(LOGERROR, "CTimeshiftBuffer::{} - error reading the live stream", __FUNCTION__);
+      break;
+    }
+
+    Append(buf.data(), static_cast<size_t>(read));
+  }
+
+  CSingleLock lock(m_critSection);
+  m_endOfStream = true;
+  m_dataAvailable.Set();
+}
+
+void CTimeshiftBuffer::Append(const uint8_t* buf, size_t size)
+{
+  while (size > 0 && !m_bStop)
+  {
+    if (!m_writeFile || m_segments.back().length >= m_segmentSize)
+    {
+      if (!OpenSegment())
+      {
+        m_bStop = true;
+        return;
+      }
+    }
+
+    const size_t chunk =
+        static_cast<size_t>(std::min<uint64_t>(size, m_segmentSize - m_segments.back().length));
+    const ssize_t written = m_writeFile->Write(buf, chunk);
+    if (written <= 0)
+    {
+      CLog::Log(LOGERROR, "CTimeshiftBuffer::{} - error writing segment '{}'", __FUNCTION__,
+                m_segments.back().path);
+      m_bStop = true;
+      return;
+    }
+
+    CSingleLock lock(m_critSection);
+
+    // split the data into ts packets, skipping bytes until the next sync byte if out of sync
+    const uint64_t start = m_end;
+    for (size_t i = 0; i < static_cast<size_t>(written);)
+    {
+      if (m_packetFill == 0)
+      {
+        if (buf[i] != TS_SYNC_BYTE)
+        {
+          i++;
+          continue;
+        }
+        m_packetPos = start + i;
+      }
+
+      const size_t copy = std::min(TS_PACKET_SIZE - m_packetFill, static_cast<size_t>(written) - i);
+      std::copy(buf + i, buf + i + copy, m_packet + m_packetFill);
+      m_packetFill += copy;
+      i += copy;
+
+      if (m_packetFill == TS_PACKET_SIZE)
+      {
+        IndexPacket(m_packet, m_packetPos);
+        m_packetFill = 0;
+      }
+    }
+
+    m_segments.back().length += written;
+    m_end += written;
+    m_time = std::max(m_time, GetTime());
+    m_dataAvailable.Set();
+
+    buf += written;
+    size -= written;
+  }
+}
+
+bool CTimeshiftBuffer::OpenSegment()
+{
+  const std::string path =
+      URIUtils::AddFileToFolder(m_directory, StringUtils::Format("{:08}.ts", m_nextSegment++));
+
+  auto file = std::make_unique<XFILE::CFile>();
+  if (!file->OpenForWrite(path, true))
+  {
+    CLog::Log(LOGERROR, "CTimeshiftBuffer::{} - unable to open segment '{}'", __FUNCTION__, path);
+    return false;
+  }
+  m_writeFile = std::move(file);
+
+  CSingleLock readLock(m_readSection);
+  CSingleLock lock(m_critSection);
+  m_segments.emplace_back(Segment{m_end, 0, path});
+  DropSegments();
+  return true;
+}
+
+void CTimeshiftBuffer::DropSegments()
+{
+  while (m_segments.size() > m_maxSegments)
+  {
+    const Segment& segment = m_segments.front();
+    if (segment.path == m_readPath)
+    {
+      m_readFile.reset();
+      m_readPath.clear();
+    }
+    XFILE::CFile::Delete(segment.path);
+    m_segments.pop_front();
+  }
+
+  const uint64_t start = m_segments.front().start;
+  while (!m_keyFrames.empty() && m_keyFrames.front().pos < start)
+    m_keyFrames.pop_front();
+}
+
+void CTimeshiftBuffer::IndexPacket(const uint8_t* packet, uint64_t pos)
+{
+  const int pid = ((packet[1] & 0x1F) << 8) | packet[2];
+  if (pid == PAT_PID || pid == m_pmtPid)
+  {
+    ParseSection(packet, pid);
+    return;
+  }
+
+  // no adaptation field
+  if (!(packet[3] & 0x20) || packet[4] == 0)
+    return;
+
+  const uint8_t flags = packet[5];
+
+  if ((flags & 0x10) && packet[4] >= 7 && (m_pcrPid < 0 || pid == m_pcrPid))
+  {
+    m_pcrPid = pid;
+
+    int64_t pcr = (static_cast<int64_t>(packet[6]) << 25) | (packet[7] << 17) |
+                  (packet[8] << 9) | (packet[9] << 1) | (packet[10] >> 7);
+    pcr += m_pcrWraps * PCR_WRAP;
+    if (m_lastPcr >= 0 && pcr < m_lastPcr - PCR_WRAP / 2)
+    {
+      m_pcrWraps++;
+      pcr += PCR_WRAP;
+    }
+
+    if (m_firstPcr < 0)
+    {
+      // continue the wall clock times used before the first pcr
+      m_firstPcr = pcr - m_time * 9 / 100;
+    }
+    m_lastPcr = pcr;
+  }
+
+  // random access indicator, other streams set it on their own access units
+  if ((flags & 0x40) && pid == m_keyFramePid)
+    m_keyFrames.emplace_back(KeyFrame{std::max(m_time, GetTime()), pos});
+}
+
+void CTimeshiftBuffer::ParseSection(const uint8_t* packet, int pid)
+{
+  // only sections starting in this packet and fitting into it, as PAT and PMT usually do
+  if (!(packet[1] & 0x40) || !(packet[3] & 0x10))
+    return;
+
+  size_t offset = 4;
+  if (packet[3] & 0x20)
+    offset += 1 + packet[4];
+  if (offset >= TS_PACKET_SIZE)
+    return;
+
+  offset += 1 + packet[offset]; // pointer field
+  if (offset + 12 > TS_PACKET_SIZE)
+    return;
+
+  const uint8_t* section = packet + offset;
+  const size_t sectionLength = ((section[1] & 0x0F) << 8) | section[2];
+  if (sectionLength < 9 || offset + 3 + sectionLength > TS_PACKET_SIZE)
+    return;
+
+  const size_t end = 3 + sectionLength - 4; // without the crc
+
+  if (pid == PAT_PID && section[0] == PAT_TABLE_ID)
+  {
+    // the pmt of the first program, program 0 is the network information
+    for (size_t i = 8; i + 4 <= end; i += 4)
+    {
+      const int program = (section[i] << 8) | section[i + 1];
+      if (program != 0)
+      {
+        m_pmtPid = ((section[i + 2] & 0x1F) << 8) | section[i + 3];
+        break;
+      }
+    }
+  }
+  else if (pid == m_pmtPid && section[0] == PMT_TABLE_ID)
+  {
+    int keyFramePid = -1;
+    for (size_t i = 12 + (((section[10] & 0x0F) << 8) | section[11]); i + 5 <= end;
+         i += 5 + (((section[i + 3] & 0x0F) << 8) | section[i + 4]))
+    {
+      const int streamPid = ((section[i + 1] & 0x1F) << 8) | section[i + 2];
+      if (IsVideoStreamType(section[i]))
+      {
+        keyFramePid = streamPid;
+        break;
+      }
+
+      // radio channels, any access unit of the first stream will do
+      if (keyFramePid < 0)
+        keyFramePid = streamPid;
+    }
+
+    if (keyFramePid >= 0 && keyFramePid != m_keyFramePid)
+    {
+      CLog::Log(LOGDEBUG, "CTimeshiftBuffer::{} - indexing key frames of pid {}", __FUNCTION__,
+                keyFramePid);
+      m_keyFramePid = keyFramePid;
+    }
+  }
+}
+
+int64_t CTimeshiftBuffer::GetTime()
+{
+  if (m_firstPcr >= 0)
+    return (m_lastPcr - m_firstPcr) * 100 / 9;
+
+  return (GetTicks() - m_startTicks) * 1000;
+}
+
+const CTimeshiftBuffer::Segment* CTimeshiftBuffer::FindSegment(uint64_t pos) const
+{
+  auto it = std::upper_bound(m_segments.begin(), m_segments.end(), pos,
+                             [](uint64_t value, const Segment& segment) {
+                               return value < segment.start;
+                             });
+  if (it == m_segments.begin())
+    return nullptr;
+
+  --it;
+  return pos < it->start + it->length ? &*it : nullptr;
+}
+
+int CTimeshiftBuffer::Read(uint8_t* buf, int buf_size)
+{
+  while (true)
+  {
+    {
+      // keeps the segment from being dropped while reading it without the buffer lock
+      CSingleLock readLock(m_readSection);
+
+      uint64_t pos = 0;
+      Segment segment{};
+      {
+        CSingleLock lock(m_critSection);
+
+        if (!m_segments.empty() && m_readPos < m_segments.front().start)
+        {
+          // fell out of the ring while paused
+          m_readPos = m_keyFrames.empty() ? m_segments.front().start : m_keyFrames.front().pos;
+          CLog::Log(LOGDEBUG, "CTimeshiftBuffer::{} - position dropped, continuing at {}",
+                    __FUNCTION__, m_readPos);
+        }
+
+        const Segment* current = FindSegment(m_readPos);
+        if (!current && m_endOfStream)
+          return 0;
+
+        if (current)
+        {
+          segment = *current;
+          pos = m_readPos;
+        }
+      }
+
+      if (!segment.path.empty())
+      {
+        const int read = ReadSegment(segment, pos, buf, buf_size);
+        if (read < 0)
+          return -1;
+
+        CSingleLock lock(m_critSection);
+        // read again at the new position if seeked meanwhile
+        if (m_readPos == pos)
+        {
+          m_readPos += read;
+          return read;
+        }
+        continue;
+      }
+    }
+
+    if (!m_dataAvailable.WaitMSec(READ_TIMEOUT_MS))
+    {
+      CLog::Log(LOGERROR, "CTimeshiftBuffer::{} - timeout waiting for the live stream",
+                __FUNCTION__);
+      return -1;
+    }
+  }
+}
+
+int CTimeshiftBuffer::ReadSegment(const Segment& segment,
+                                  uint64_t pos,
+                                  uint8_t* buf,
+                                  int buf_size)
+{
+  if (!m_readFile || m_readPath != segment.path)
+  {
+    m_readFile = std::make_unique<XFILE::CFile>();
+    m_readPath = segment.path;
+    if (!m_readFile->Open(m_readPath))
+    {
+      CLog::Log(LOGERROR, "CTimeshiftBuffer::{} - unable to open segment '{}'", __FUNCTION__,
+                m_readPath);
+      m_readFile.reset();
+      m_readPath.clear();
+      return -1;
+    }
+  }
+
+  const uint64_t offset = pos - segment.start;
+  if (m_readFile->Seek(offset, SEEK_SET) != static_cast<int64_t>(offset))
+    return -1;
+
+  const size_t size = static_cast<size_t>(
+      std::min<uint64_t>(buf_size, segment.start + segment.length - pos));
+  const ssize_t read = m_readFile->Read(buf, size);
+  if (read <= 0)
+    return -1;
+
+  return static_cast<int>(read);
+}
+
+int64_t CTimeshiftBuffer::Seek(int64_t offset, int whence)
+{
+  CSingleLock lock(m_critSection);
+
+  int64_t pos;
+  switch (whence)
+  {
+    case SEEK_SET:
+      pos = offset;
+      break;
+    case SEEK_CUR:
+      pos = static_cast<int64_t>(m_readPos) + offset;
+      break;
+    case SEEK_END:
+      pos = static_cast<int64_t>(m_end) + offset;
+      break;
+    default:
+      return -1;
+  }
+
+  const int64_t start = m_segments.empty() ? 0 : static_cast<int64_t>(m_segments.front().start);
+  if (pos < start || pos > static_cast<int64_t>(m_end))
+    return -1;
+
+  m_readPos = static_cast<uint64_t>(pos);
+  return pos;
+}
+
+bool CTimeshiftBuffer::SeekTime(int64_t time)
+{
+  CSingleLock lock(m_critSection);
+
+  if (m_keyFrames.empty())
+    return false;
+
+  auto it = std::upper_bound(m_keyFrames.begin(), m_keyFrames.end(), time * 1000,
+                             [](int64_t value, const KeyFrame& keyFrame) {
+                               return value < keyFrame.time;
+                             });
+  if (it != m_keyFrames.begin())
+    --it;
+
+  m_readPos = it->pos;
+  return true;
+}
+
+int64_t CTimeshiftBuffer::GetLength() const
+{
+  CSingleLock lock(m_critSection);
+  return static_cast<int64_t>(m_end);
+}
+
+int64_t CTimeshiftBuffer::GetStart() const
+{
+  CSingleLock lock(m_critSection);
+  return m_segments.empty() ? 0 : static_cast<int64_t>(m_segments.front().start);
+}
+
+uint64_t CTimeshiftBuffer::GetBufferedBytes() const
+{
+  CSingleLock lock(m_critSection);
+  return m_segments.empty() ? 0 : m_end - m_segments.front().start;
+}
+
+bool CTimeshiftBuffer::GetTimes(CDVDInputStream::ITimes::Times& times) const
+{
+  CSingleLock lock(m_critSection);
+
+  if (m_end == 0)
+    return false;
+
+  times.startTime = m_startTime;
+  times.ptsStart = 0;
+  times.ptsBegin = m_keyFrames.empty() ? m_time : m_keyFrames.front().time;
+  times.ptsEnd = m_time;
+  return true;
+}
+
+std::deque<CTimeshiftBuffer::KeyFrame> CTimeshiftBuffer::GetKeyFrames() const
+{
+  CSingleLock lock(m_critSection);
+  return m_keyFrames;
+}
+
+bool CTimeshiftBuffer::IsEndOfStream() const
+{
+  CSingleLock lock(m_critSection);
+  return m_endOfStream;
+}
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "DVDInputStream.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+namespace XFILE
+{
+class CFile;
+}
+
+/*!
+ \brief Local, disk-backed timeshift buffer for live MPEG-TS streams.
+
+ A writer thread continuously reads the live stream and appends it to a ring of segment
+ files, dropping the oldest segment when the size budget is exceeded. Key frames (packets of the
+ video stream announced in the PMT with the random access indicator set, of the first stream for
+ radio channels) are indexed with their PCR time, so pause, rewind and
+ seek are served from the local files, independent of the capabilities of the source. Byte
+ positions are absolute since the start of the stream, the positions of dropped segments
+ can not be read anymore.
+ */
+class CTimeshiftBuffer : private CThread
+{
+public:
+  /*!
+   \brief Reads the live stream like CDVDInputStream::Read, returns 0 at the end of the stream
+   and -1 on errors.
+   */
+  using SourceFunction = std::function<int(uint8_t* buf, int buf_size)>;
+
+  static constexpr uint64_t DEFAULT_SEGMENT_SIZE = 8 * 1024 * 1024;
+
+  struct KeyFrame
+  {
+    int64_t time; //!< time of the key frame in us since the start of the stream
+    uint64_t pos; //!< byte offset of the key frame packet
+  };
+
+  /*!
+   \brief Create a timeshift buffer.
+   \param source the live stream
+   \param directory the directory to create the segment files in, created if needed
+   \param budget the maximum number of bytes kept on disk
+   \param segmentSize the size of a segment file
+   */
+  CTimeshiftBuffer(const SourceFunction& source,
+                   const std::string& directory,
+                   uint64_t budget,
+                   uint64_t segmentSize = DEFAULT_SEGMENT_SIZE);
+  ~CTimeshiftBuffer() override;
+
+  /*!
+   \brief Start buffering the live stream.
+   \return false if the directory could not be created
+   */
+  bool Start();
+
+  /*!
+   \brief Stop buffering and remove the segment files.
+   */
+  void Stop();
+
+  /*!
+   \brief Read from the current position, waiting for the live stream if the position is at
+   the end of the buffer. If the position was dropped from the ring meanwhile, reading continues
+   at the oldest buffered key frame.
+   \return the number of bytes read, 0 at the end of the stream, -1 on errors
+   */
+  int Read(uint8_t* buf, int buf_size);
+
+  /*!
+   \brief Seek to a buffered byte position, like CDVDInputStream::Seek.
+   \return the new position or -1 if the position is not buffered
+   */
+  int64_t Seek(int64_t offset, int whence);
+
+  /*!
+   \brief Seek to the key frame at or before a time.
+   \param time the time in ms since the start of the stream
+   \return false if no key frame is buffered
+   */
+  bool SeekTime(int64_t time);
+
+  /*!
+   \brief The byte position of the live end of the buffer.
+   */
+  int64_t GetLength() const;
+
+  /*!
+   \brief The first buffered byte position.
+   */
+  int64_t GetStart() const;
+
+  /*!
+   \brief The number of bytes currently kept on disk.
+   */
+  uint64_t GetBufferedBytes() const;
+
+  /*!
+   \brief The buffered times: ptsStart is the start of the stream, ptsBegin the oldest buffered
+   key frame and ptsEnd the live end of the buffer.
+   \return false if nothing has been buffered yet
+   */
+  bool GetTimes(CDVDInputStream::ITimes::Times& times) const;
+
+  /*!
+   \brief The buffered key frames, oldest first.
+   */
+  std::deque<KeyFrame> GetKeyFrames() const;
+
+  bool IsEndOfStream() const;
+
+protected:
+  void Process() override;
+
+private:
+  struct Segment
+  {
+    uint64_t start;
+    uint64_t length;
+    std::string path;
+  };
+
+  void Append(const uint8_t* buf, size_t size);
+  bool OpenSegment();
+  void DropSegments();
+  void IndexPacket(const uint8_t* packet, uint64_t pos);
+  void ParseSection(const uint8_t* packet, int pid);
+  int ReadSegment(const Segment& segment, uint64_t pos, uint8_t* buf, int buf_size);
+  int64_t GetTime();
+  const Segment* FindSegment(uint64_t pos) const;
+
+  const SourceFunction m_source;
+  const std::string m_directory;
+  const uint64_t m_segmentSize;
+  const size_t m_maxSegments;
+
+  // writer thread only
+  std::unique_ptr<XFILE::CFile> m_writeFile;
+  uint8_t m_packet[188];
+  size_t m_packetFill = 0;
+  uint64_t m_packetPos = 0;
+  int m_pcrPid = -1;
+  int m_pmtPid = -1;
+  int m_keyFramePid = -1;
+  int64_t m_firstPcr = -1;
+  int64_t m_lastPcr = -1;
+  int64_t m_pcrWraps = 0;
+  unsigned int m_nextSegment = 0;
+
+  mutable CCriticalSection m_critSection;
+  std::deque<Segment> m_segments;
+  std::deque<KeyFrame> m_keyFrames;
+  uint64_t m_end = 0;
+  int64_t m_time = 0;
+  time_t m_startTime = 0;
+  int64_t m_startTicks = 0;
+  bool m_endOfStream = false;
+
+  // reader, file i/o is done without holding m_critSection. segments are only dropped while
+  // holding m_readSection, which is always taken before m_critSection.
+  CCriticalSection m_readSection;
+  std::unique_ptr<XFILE::CFile> m_readFile;
+  std::string m_readPath;
+  uint64_t m_readPos = 0;
+
+  CEvent m_dataAvailable;
+};
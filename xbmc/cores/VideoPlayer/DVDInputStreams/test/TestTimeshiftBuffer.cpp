@@ -0,0 +1,304 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDInputStreams/TimeshiftBuffer.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr int PACKET_SIZE = 188;
+constexpr uint32_t PACKETS = 10000; // one packet per ms
+constexpr uint32_t KEY_FRAME_INTERVAL = 50;
+constexpr uint32_t KEY_FRAME_PACKET = 2; // of each interval, after the PAT and the PMT
+constexpr uint32_t PCR_INTERVAL = 10;
+
+constexpr int PAT_PID = 0x0000;
+constexpr int PMT_PID = 0x1000;
+constexpr int VIDEO_PID = 0x0100;
+constexpr int AUDIO_PID = 0x0101;
+
+const std::string TS_FILE = "special://temp/timeshift_test.ts";
+const std::string BUFFER_DIRECTORY = "special://temp/timeshift_test";
+
+using Clock = std::chrono::steady_clock;
+
+void SetPid(uint8_t* packet, int pid)
+{
+  packet[0] = 0x47;
+  packet[1] = static_cast<uint8_t>(pid >> 8);
+  packet[2] = static_cast<uint8_t>(pid);
+}
+
+/*!
+ * @brief Fill a packet with a PSI section, without a valid crc.
+ */
+void SetSection(uint8_t* packet, int pid, std::vector<uint8_t> section)
+{
+  section.insert(section.end(), 4, 0); // crc
+  section[1] = static_cast<uint8_t>(0xB0 | ((section.size() - 3) >> 8));
+  section[2] = static_cast<uint8_t>(section.size() - 3);
+
+  std::fill(packet, packet + PACKET_SIZE, 0xFF);
+  SetPid(packet, pid);
+  packet[1] |= 0x40; // payload unit start
+  packet[3] = 0x10;
+  packet[4] = 0; // pointer field
+  std::copy(section.begin(), section.end(), packet + 5);
+}
+
+/*!
+ * @brief Write a ts file with a packet per ms, the packet number in the last bytes of the packet.
+ * Every key frame interval starts with a PAT and a PMT announcing an audio and a video stream. Key
+ * frames and PCRs are sent on the video pid, the audio pid sets the random access indicator too.
+ */
+void WriteTSFile()
+{
+  XFILE::CFile file;
+  ASSERT_TRUE(file.OpenForWrite(TS_FILE, true));
+
+  uint8_t packet[PACKET_SIZE];
+  for (uint32_t i = 0; i < PACKETS; i++)
+  {
+    const uint32_t pos = i % KEY_FRAME_INTERVAL;
+    if (pos == 0)
+    {
+      SetSection(packet, PAT_PID,
+                 {0x00, 0, 0, 0x00, 0x01, 0xC1, 0, 0, 0x00, 0x01, 0xE0 | (PMT_PID >> 8),
+                  PMT_PID & 0xFF});
+    }
+    else if (pos == 1)
+    {
+      SetSection(packet, PMT_PID,
+                 {0x02, 0, 0, 0x00, 0x01, 0xC1, 0, 0, 0xE0 | (VIDEO_PID >> 8), VIDEO_PID & 0xFF,
+                  0xF0, 0, 0x03, 0xE0 | (AUDIO_PID >> 8), AUDIO_PID & 0xFF, 0xF0, 0, 0x1B,
+                  0xE0 | (VIDEO_PID >> 8), VIDEO_PID & 0xFF, 0xF0, 0});
+    }
+    else if (pos == KEY_FRAME_INTERVAL / 2)
+    {
+      std::fill(packet, packet + PACKET_SIZE, 0);
+      SetPid(packet, AUDIO_PID);
+      packet[3] = 0x30 | (i & 0x0F);
+      packet[4] = 1;
+      packet[5] = 0x40;
+    }
+    else
+    {
+      std::fill(packet, packet + PACKET_SIZE, 0);
+      SetPid(packet, VIDEO_PID);
+      packet[3] = 0x30 | (i & 0x0F);
+      packet[4] = 7;
+      packet[5] = 0;
+    }
+
+    if (i % PCR_INTERVAL == KEY_FRAME_PACKET)
+    {
+      const uint64_t pcr = i * 90;
+      packet[5] |= 0x10;
+      packet[6] = static_cast<uint8_t>(pcr >> 25);
+      packet[7] = static_cast<uint8_t>(pcr >> 17);
+      packet[8] = static_cast<uint8_t>(pcr >> 9);
+      packet[9] = static_cast<uint8_t>(pcr >> 1);
+      packet[10] = static_cast<uint8_t>(((pcr & 1) << 7) | 0x7E);
+      packet[11] = 0;
+    }
+    if (pos == KEY_FRAME_PACKET)
+      packet[5] |= 0x40;
+
+    packet[PACKET_SIZE - 4] = static_cast<uint8_t>(i >> 24);
+    packet[PACKET_SIZE - 3] = static_cast<uint8_t>(i >> 16);
+    packet[PACKET_SIZE - 2] = static_cast<uint8_t>(i >> 8);
+    packet[PACKET_SIZE - 1] = static_cast<uint8_t>(i);
+    ASSERT_EQ(PACKET_SIZE, file.Write(packet, PACKET_SIZE));
+  }
+}
+} // namespace
+
+class TestTimeshiftBuffer : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    WriteTSFile();
+    ASSERT_TRUE(m_file.Open(TS_FILE));
+  }
+
+  void TearDown() override
+  {
+    m_file.Close();
+    XFILE::CFile::Delete(TS_FILE);
+  }
+
+  /*!
+   * @brief Serve the ts file as a live stream, delivering chunks of packets with a delay.
+   */
+  CTimeshiftBuffer::SourceFunction GetSource(int iDelayMs, int iPacketsPerChunk)
+  {
+    return [this, iDelayMs, iPacketsPerChunk](uint8_t* buf, int buf_size) {
+      if (iDelayMs > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(iDelayMs));
+      return static_cast<int>(
+          m_file.Read(buf, std::min(buf_size, iPacketsPerChunk * PACKET_SIZE)));
+    };
+  }
+
+  /*!
+   * @brief Read a packet from the buffer.
+   * @return The number of the packet or -1 at the end of the stream.
+   */
+  static int64_t ReadPacket(CTimeshiftBuffer& buffer)
+  {
+    uint8_t packet[PACKET_SIZE];
+    int fill = 0;
+    while (fill < PACKET_SIZE)
+    {
+      const int read = buffer.Read(packet + fill, PACKET_SIZE - fill);
+      if (read <= 0)
+        return -1;
+      fill += read;
+    }
+
+    EXPECT_EQ(0x47, packet[0]);
+    return (packet[PACKET_SIZE - 4] << 24) | (packet[PACKET_SIZE - 3] << 16) |
+           (packet[PACKET_SIZE - 2] << 8) | packet[PACKET_SIZE - 1];
+  }
+
+  static void WaitForEndOfStream(const CTimeshiftBuffer& buffer)
+  {
+    while (!buffer.IsEndOfStream())
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  XFILE::CFile m_file;
+};
+
+TEST_F(TestTimeshiftBuffer, KeyFrameIndex)
+{
+  CTimeshiftBuffer buffer(GetSource(0, 100), BUFFER_DIRECTORY, 16 * 1024 * 1024, 256 * 1024);
+  ASSERT_TRUE(buffer.Start());
+
+  for (uint32_t i = 0; i < PACKETS; i++)
+    ASSERT_EQ(i, ReadPacket(buffer));
+  EXPECT_EQ(-1, ReadPacket(buffer));
+
+  EXPECT_EQ(PACKETS * PACKET_SIZE, buffer.GetLength());
+  EXPECT_EQ(0, buffer.GetStart());
+
+  // only the key frames of the video stream, the times start with the first pcr
+  const std::deque<CTimeshiftBuffer::KeyFrame> keyFrames = buffer.GetKeyFrames();
+  ASSERT_EQ(PACKETS / KEY_FRAME_INTERVAL, keyFrames.size());
+  EXPECT_EQ(2000000, keyFrames[40].time);
+  EXPECT_EQ((2000u + KEY_FRAME_PACKET) * PACKET_SIZE, keyFrames[40].pos);
+
+  CDVDInputStream::ITimes::Times times;
+  ASSERT_TRUE(buffer.GetTimes(times));
+  EXPECT_EQ(0, times.ptsBegin);
+  EXPECT_EQ((PACKETS - PCR_INTERVAL) * 1000, times.ptsEnd);
+
+  // rewind to the key frame at or before the target time
+  ASSERT_TRUE(buffer.SeekTime(2025));
+  EXPECT_EQ(2000 + KEY_FRAME_PACKET, ReadPacket(buffer));
+  ASSERT_TRUE(buffer.SeekTime(0));
+  EXPECT_EQ(KEY_FRAME_PACKET, ReadPacket(buffer));
+
+  EXPECT_EQ(500 * PACKET_SIZE, buffer.Seek(500 * PACKET_SIZE, SEEK_SET));
+  EXPECT_EQ(500, ReadPacket(buffer));
+  EXPECT_EQ(-1, buffer.Seek(1, SEEK_END));
+
+  buffer.Stop();
+  EXPECT_FALSE(XFILE::CDirectory::Exists(BUFFER_DIRECTORY, false));
+}
+
+TEST_F(TestTimeshiftBuffer, NothingBuffered)
+{
+  CTimeshiftBuffer buffer([](uint8_t*, int) { return 0; }, BUFFER_DIRECTORY, 16 * 1024 * 1024);
+  ASSERT_TRUE(buffer.Start());
+  WaitForEndOfStream(buffer);
+  EXPECT_EQ(0, buffer.Read(nullptr, PACKET_SIZE));
+
+  buffer.Stop();
+  EXPECT_FALSE(XFILE::CDirectory::Exists(BUFFER_DIRECTORY, false));
+}
+
+TEST_F(TestTimeshiftBuffer, RingBudget)
+{
+  constexpr uint64_t SEGMENT_SIZE = 64 * 1024;
+  constexpr uint64_t BUDGET = 4 * SEGMENT_SIZE;
+
+  CTimeshiftBuffer buffer(GetSource(0, 100), BUFFER_DIRECTORY, BUDGET, SEGMENT_SIZE);
+  ASSERT_TRUE(buffer.Start());
+  WaitForEndOfStream(buffer);
+
+  EXPECT_EQ(PACKETS * PACKET_SIZE, buffer.GetLength());
+  EXPECT_LE(buffer.GetBufferedBytes(), BUDGET);
+  EXPECT_GT(buffer.GetStart(), 0);
+
+  // the start of the stream has been dropped
+  EXPECT_EQ(-1, buffer.Seek(0, SEEK_SET));
+  const std::deque<CTimeshiftBuffer::KeyFrame> keyFrames = buffer.GetKeyFrames();
+  ASSERT_FALSE(keyFrames.empty());
+  EXPECT_GE(static_cast<int64_t>(keyFrames.front().pos), buffer.GetStart());
+
+  // reading the dropped position continues at the oldest key frame
+  const int64_t packet = ReadPacket(buffer);
+  EXPECT_EQ(KEY_FRAME_PACKET, packet % KEY_FRAME_INTERVAL);
+  EXPECT_EQ(static_cast<int64_t>(keyFrames.front().pos), packet * PACKET_SIZE);
+
+  for (int64_t i = packet + 1; i < PACKETS; i++)
+    ASSERT_EQ(i, ReadPacket(buffer));
+}
+
+TEST_F(TestTimeshiftBuffer, PauseWhileBuffering)
+{
+  CTimeshiftBuffer buffer(GetSource(2, 50), BUFFER_DIRECTORY, 16 * 1024 * 1024, 256 * 1024);
+  ASSERT_TRUE(buffer.Start());
+
+  for (uint32_t i = 0; i < 100; i++)
+    ASSERT_EQ(i, ReadPacket(buffer));
+
+  // paused, the live stream is still buffered
+  const int64_t length = buffer.GetLength();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_GT(buffer.GetLength(), length);
+
+  for (uint32_t i = 100; i < PACKETS; i++)
+    ASSERT_EQ(i, ReadPacket(buffer));
+  EXPECT_EQ(-1, ReadPacket(buffer));
+}
+
+TEST_F(TestTimeshiftBuffer, SeekLatency)
+{
+  CTimeshiftBuffer buffer(GetSource(0, 100), BUFFER_DIRECTORY, 16 * 1024 * 1024, 256 * 1024);
+  ASSERT_TRUE(buffer.Start());
+  WaitForEndOfStream(buffer);
+
+  constexpr int SEEKS = 200;
+  Clock::duration total{};
+  for (int i = 0; i < SEEKS; i++)
+  {
+    const int64_t time = (i * 7919) % (PACKETS - KEY_FRAME_INTERVAL);
+    const auto start = Clock::now();
+    ASSERT_TRUE(buffer.SeekTime(time));
+    const int64_t packet = ReadPacket(buffer);
+    total += Clock::now() - start;
+
+    EXPECT_EQ(time - time % KEY_FRAME_INTERVAL + KEY_FRAME_PACKET, packet);
+  }
+
+  const double seekUs = std::chrono::duration<double, std::micro>(total).count() / SEEKS;
+  RecordProperty("local_seek_us", static_cast<int>(seekUs));
+  EXPECT_LT(seekUs, 50000);
+}
@@ -8,17 +8,18 @@
 
 #include "DVDSubtitleLineCollection.h"
 
-#include <stddef.h>
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
 
+#include <algorithm>
+#include <limits>
 
-CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+namespace
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
+// lines starting later than this after the requested time are left for a later call
+constexpr double LOOKAHEAD = DVD_SEC_TO_TIME(2);
+} // namespace
 
-  m_iSize = 0;
-}
+CDVDSubtitleLineCollection::CDVDSubtitleLineCollection() = default;
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 {
@@ -27,85 +28,115 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
-
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
-  {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
+  m_lines.push_back({pOverlay->iPTSStartTime, pOverlay->iPTSStopTime, NO_SOURCE, pOverlay});
+  m_indexed = false;
+}
 
-  m_iSize++;
+void CDVDSubtitleLineCollection::Add(double startTime, double stopTime, size_t source)
+{
+  m_lines.push_back({startTime, stopTime, source, nullptr});
+  m_indexed = false;
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
-
-  for (ListElement* p1 = m_pHead; p1->pNext != NULL; p1 = p1->pNext)
+  // materialized lines are tracked by index
+  for (size_t index : m_materialized)
   {
-    for (ListElement* p2 = p1->pNext; p2 != NULL; p2 = p2->pNext)
-    {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
-    }
+    m_lines[index].overlay->Release();
+    m_lines[index].overlay = nullptr;
   }
+  m_materialized.clear();
+
+  std::stable_sort(m_lines.begin(), m_lines.end(), [](const SLine& a, const SLine& b) {
+    return a.startTime < b.startTime;
+  });
+  m_indexed = false;
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  ReleasePassed();
+  UpdateIndex();
 
-  if (m_pCurrent)
+  // every line before the first one whose stop time, or that of a line before it, reaches iPts
+  // has ended
+  const auto first =
+      std::lower_bound(m_maxStopTime.begin() + std::min(m_current, m_maxStopTime.size()),
+                       m_maxStopTime.end(), iPts);
+  m_current = first - m_maxStopTime.begin();
+
+  while (m_current < m_lines.size())
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
+    SLine& line = m_lines[m_current];
+    if (line.startTime > iPts + LOOKAHEAD)
+      break;
 
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
+    m_current++;
+    if (line.stopTime < iPts)
+      continue;
 
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
+    if (!line.overlay && m_factory)
+    {
+      line.overlay = m_factory(line.source);
+      if (line.overlay)
+      {
+        line.overlay->iPTSStartTime = line.startTime;
+        line.overlay->iPTSStopTime = line.stopTime;
+        m_materialized.push_back(m_current - 1);
+      }
     }
+
+    if (line.overlay)
+      return line.overlay;
   }
-  return pOverlay;
+  return nullptr;
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
+  for (auto& line : m_lines)
   {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
+    if (line.overlay)
+      line.overlay->Release();
+  }
 
-    pElement->pOverlay->Release();
-    delete pElement;
+  m_lines.clear();
+  m_maxStopTime.clear();
+  m_materialized.clear();
+  m_indexed = true;
+  m_current = 0;
+}
+
+void CDVDSubtitleLineCollection::UpdateIndex()
+{
+  if (m_indexed)
+    return;
+
+  m_maxStopTime.resize(m_lines.size());
+  double maxStopTime = std::numeric_limits<double>::lowest();
+  for (size_t i = 0; i < m_lines.size(); i++)
+  {
+    maxStopTime = std::max(maxStopTime, m_lines[i].stopTime);
+    m_maxStopTime[i] = maxStopTime;
   }
+  m_indexed = true;
+}
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+void CDVDSubtitleLineCollection::ReleasePassed()
+{
+  // the caller holds a clone of the overlays returned by Get() before
+  auto it = std::remove_if(m_materialized.begin(), m_materialized.end(), [this](size_t index) {
+    if (index >= m_current)
+      return false;
+    m_lines[index].overlay->Release();
+    m_lines[index].overlay = nullptr;
+    return true;
+  });
+  m_materialized.erase(it, m_materialized.end());
 }
@@ -10,39 +10,80 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
+#include <functional>
+#include <stddef.h>
+#include <vector>
+
+/*!
+ \brief Time index of the lines of a subtitle file.
 
-} ListElement;
+ Lines are either added with their overlay, or by their times and a source position only,
+ in which case the overlay is created by the overlay factory when Get() reaches the line and
+ released again once playback is past it. Parsers of large files only index the lines on open
+ that way and convert them around the playback position: Get() doesn't return lines starting
+ more than a few seconds after the requested time.
 
+ Lookups jump over the lines that ended before the requested time in O(log n), so seeking
+ doesn't walk the collection from its start.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
+  /*!
+   \brief Creates the overlay of a line added by its times, with one reference owned by the
+   collection. The times of the overlay are set by the collection.
+   \param source the position passed to Add()
+   */
+  using OverlayFactory = std::function<CDVDOverlay*(size_t source)>;
+
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
   void Add(CDVDOverlay* pSubtitle);
+
+  /*!
+   \brief Add a line whose overlay is created when needed, see SetOverlayFactory().
+   \param source position of the line in the file, passed to the overlay factory
+   */
+  void Add(double startTime, double stopTime, size_t source);
+  void SetOverlayFactory(OverlayFactory factory) { m_factory = std::move(factory); }
+
   void Sort();
 
-  CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
+  /*!
+   \brief Get the next line that is shown at iPts or starts shortly after it.
+   \return the overlay, or nullptr if there is no further line up to a few seconds after iPts
+   */
+  CDVDOverlay* Get(double iPts = 0LL);
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() const { return static_cast<int>(m_lines.size()); }
+
+  /*!
+   \brief Number of lines with an overlay created by the overlay factory.
+   */
+  size_t GetMaterializedSize() const { return m_materialized.size(); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  static constexpr size_t NO_SOURCE = static_cast<size_t>(-1);
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
-};
+  struct SLine
+  {
+    double startTime;
+    double stopTime;
+    size_t source;
+    CDVDOverlay* overlay;
+  };
 
+  void UpdateIndex();
+  void ReleasePassed();
+
+  std::vector<SLine> m_lines;
+  std::vector<double> m_maxStopTime; // highest stop time of the lines up to an index
+  bool m_indexed = true;
+  size_t m_current = 0;
+  std::vector<size_t> m_materialized; // lines with an overlay of the factory
+  OverlayFactory m_factory;
+};
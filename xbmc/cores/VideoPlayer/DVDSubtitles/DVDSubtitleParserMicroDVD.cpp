@@ -10,7 +10,6 @@
 
 #include "DVDCodecs/Overlay/DVDOverlayText.h"
 #include "DVDStreamInfo.h"
-#include "DVDSubtitleTagMicroDVD.h"
 #include "cores/VideoPlayer/Interface/TimingConstants.h"
 #include "utils/RegExp.h"
 #include "utils/log.h"
@@ -42,33 +41,49 @@ bool CDVDSubtitleParserMicroDVD::Open(CDVDStreamInfo &hints)
 
   char line[1024];
 
-  CRegExp reg;
-  if (!reg.RegComp("\\{([0-9]+)\\}\\{([0-9]+)\\}"))
+  if (!m_reg.RegComp("\\{([0-9]+)\\}\\{([0-9]+)\\}"))
     return false;
-  CDVDSubtitleTagMicroDVD TagConv;
 
+  // only index the lines, they are converted when playback gets there
+  long source = m_pStream->Seek(0, SEEK_CUR);
   while (m_pStream->ReadLine(line, sizeof(line)))
   {
     if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
       line[strlen(line) - 1] = 0;
 
-    int pos = reg.RegFind(line);
+    int pos = m_reg.RegFind(line);
     if (pos > -1)
     {
-      const char* text = line + pos + reg.GetFindLen();
-      std::string startFrame(reg.GetMatch(1));
-      std::string endFrame  (reg.GetMatch(2));
-      CDVDOverlayText* pOverlay = new CDVDOverlayText();
-      pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
-
-      pOverlay->iPTSStartTime = m_framerate * atoi(startFrame.c_str());
-      pOverlay->iPTSStopTime  = m_framerate * atoi(endFrame.c_str());
-
-      TagConv.ConvertLine(pOverlay, text, strlen(text));
-      m_collection.Add(pOverlay);
+      std::string startFrame(m_reg.GetMatch(1));
+      std::string endFrame  (m_reg.GetMatch(2));
+      m_collection.Add(m_framerate * atoi(startFrame.c_str()), m_framerate * atoi(endFrame.c_str()),
+                       source);
     }
+    source = m_pStream->Seek(0, SEEK_CUR);
   }
+  m_collection.SetOverlayFactory([this](size_t source) { return CreateOverlay(source); });
 
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserMicroDVD::CreateOverlay(size_t source)
+{
+  char line[1024];
+
+  m_pStream->Seek(static_cast<long>(source), SEEK_SET);
+  if (!m_pStream->ReadLine(line, sizeof(line)))
+    return nullptr;
+
+  if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
+    line[strlen(line) - 1] = 0;
+
+  int pos = m_reg.RegFind(line);
+  if (pos < 0)
+    return nullptr;
+
+  const char* text = line + pos + m_reg.GetFindLen();
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+  m_tagConv.ConvertLine(pOverlay, text, strlen(text));
+  return pOverlay;
+}
+
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "DVDSubtitleParser.h"
+#include "DVDSubtitleTagMicroDVD.h"
+#include "utils/RegExp.h"
 
 #include <memory>
 
@@ -20,5 +22,9 @@ public:
 
   bool Open(CDVDStreamInfo &hints) override;
 private:
+  CDVDOverlay* CreateOverlay(size_t source);
+
   double m_framerate;
+  CRegExp m_reg;
+  CDVDSubtitleTagMicroDVD m_tagConv;
 };
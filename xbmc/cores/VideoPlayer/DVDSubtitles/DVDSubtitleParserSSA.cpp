@@ -35,7 +35,7 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
   if(!m_libass->CreateTrack(const_cast<char*>(buffer.c_str()), buffer.length()))
     return false;
 
-  //Creating the overlays by going through the list of ass_events
+  // index the ass_events, the overlays are only created around the playback position
   ASS_Event* assEvent = m_libass->GetEvents();
   int numEvents = m_libass->GetNrOfEvents();
 
@@ -44,15 +44,17 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
     ASS_Event* curEvent =  (assEvent+i);
     if (curEvent)
     {
-      CDVDOverlaySSA* overlay = new CDVDOverlaySSA(m_libass);
-
-      overlay->iPTSStartTime = (double)curEvent->Start * (DVD_TIME_BASE / 1000);
-      overlay->iPTSStopTime  = (double)(curEvent->Start + curEvent->Duration) * (DVD_TIME_BASE / 1000);
-
-      overlay->replace = true;
-      m_collection.Add(overlay);
+      m_collection.Add(static_cast<double>(curEvent->Start) * (DVD_TIME_BASE / 1000),
+                       static_cast<double>(curEvent->Start + curEvent->Duration) *
+                           (DVD_TIME_BASE / 1000),
+                       i);
     }
   }
+  m_collection.SetOverlayFactory([this](size_t) {
+    CDVDOverlaySSA* overlay = new CDVDOverlaySSA(m_libass);
+    overlay->replace = true;
+    return overlay;
+  });
   m_collection.Sort();
   return true;
 }
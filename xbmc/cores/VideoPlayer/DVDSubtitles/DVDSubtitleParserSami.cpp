@@ -10,7 +10,6 @@
 
 #include "DVDCodecs/Overlay/DVDOverlayText.h"
 #include "DVDStreamInfo.h"
-#include "DVDSubtitleTagSami.h"
 #include "cores/VideoPlayer/Interface/TimingConstants.h"
 #include "utils/RegExp.h"
 #include "utils/StringUtils.h"
@@ -34,65 +33,89 @@ bool CDVDSubtitleParserSami::Open(CDVDStreamInfo &hints)
 
   char line[1024];
 
-  CRegExp reg(true);
-  if (!reg.RegComp("<SYNC START=\"?([0-9]+)\"?>"))
+  if (!m_reg.RegComp("<SYNC START=\"?([0-9]+)\"?>"))
     return false;
 
   std::string strFileName;
-  std::string strClassID;
   strFileName = URIUtils::GetFileName(m_filename);
 
-  CDVDSubtitleTagSami TagConv;
-  if (!TagConv.Init())
+  if (!m_tagConv.Init())
     return false;
-  TagConv.LoadHead(m_pStream.get());
-  if (TagConv.m_Langclass.size() >= 2)
+  m_tagConv.LoadHead(m_pStream.get());
+  if (m_tagConv.m_Langclass.size() >= 2)
   {
-    for (unsigned int i = 0; i < TagConv.m_Langclass.size(); i++)
+    for (unsigned int i = 0; i < m_tagConv.m_Langclass.size(); i++)
     {
-      if (strFileName.find(TagConv.m_Langclass[i].Name, 9) == 9)
+      if (strFileName.find(m_tagConv.m_Langclass[i].Name, 9) == 9)
       {
-        strClassID = TagConv.m_Langclass[i].ID;
-        StringUtils::ToLower(strClassID);
+        m_classID = m_tagConv.m_Langclass[i].ID;
+        StringUtils::ToLower(m_classID);
         break;
       }
     }
   }
-  const char *lang = NULL;
-  if (!strClassID.empty())
-    lang = strClassID.c_str();
 
-  CDVDOverlayText* pOverlay = NULL;
+  // only index the sync points, their text is converted when playback gets there
+  bool pending = false;
+  double startTime = 0.0;
+  long source = 0;
+  long offset = m_pStream->Seek(0, SEEK_CUR);
   while (m_pStream->ReadLine(line, sizeof(line)))
   {
-    if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
-      line[strlen(line) - 1] = 0;
-
-    int pos = reg.RegFind(line);
-    const char* text = line;
+    int pos = m_reg.RegFind(line);
     if (pos > -1)
     {
-      std::string start = reg.GetMatch(1);
-      if(pOverlay)
-      {
-        TagConv.ConvertLine(pOverlay, text, pos, lang);
-        pOverlay->iPTSStopTime  = (double)atoi(start.c_str()) * DVD_TIME_BASE / 1000;
-        pOverlay->Release();
-        TagConv.CloseTag(pOverlay);
-      }
-
-      pOverlay = new CDVDOverlayText();
-      pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
+      const double time = (double)atoi(m_reg.GetMatch(1).c_str()) * DVD_TIME_BASE / 1000;
+      if (pending)
+        m_collection.Add(startTime, time, source);
 
-      pOverlay->iPTSStartTime = (double)atoi(start.c_str()) * DVD_TIME_BASE / 1000;
-      pOverlay->iPTSStopTime  = DVD_NOPTS_VALUE;
-      m_collection.Add(pOverlay);
-      text += pos + reg.GetFindLen();
+      pending = true;
+      startTime = time;
+      source = offset;
     }
-    if(pOverlay)
-      TagConv.ConvertLine(pOverlay, text, strlen(text), lang);
+    offset = m_pStream->Seek(0, SEEK_CUR);
   }
+  if (pending)
+    m_collection.Add(startTime, DVD_NOPTS_VALUE, source);
+
   m_collection.Sort();
+  m_collection.SetOverlayFactory([this](size_t source) { return CreateOverlay(source); });
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserSami::CreateOverlay(size_t source)
+{
+  char line[1024];
+  const char* lang = m_classID.empty() ? nullptr : m_classID.c_str();
+
+  m_pStream->Seek(static_cast<long>(source), SEEK_SET);
+  if (!m_pStream->ReadLine(line, sizeof(line)))
+    return nullptr;
+
+  if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
+    line[strlen(line) - 1] = 0;
+  int pos = m_reg.RegFind(line);
+  if (pos < 0)
+    return nullptr;
+
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+  const char* text = line + pos + m_reg.GetFindLen();
+  m_tagConv.ConvertLine(pOverlay, text, strlen(text), lang);
+
+  // the text of a sync point runs up to the next one
+  while (m_pStream->ReadLine(line, sizeof(line)))
+  {
+    if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
+      line[strlen(line) - 1] = 0;
+    pos = m_reg.RegFind(line);
+    if (pos > -1)
+    {
+      m_tagConv.ConvertLine(pOverlay, line, pos, lang);
+      break;
+    }
+    m_tagConv.ConvertLine(pOverlay, line, strlen(line), lang);
+  }
+  m_tagConv.CloseTag(pOverlay);
+
+  return pOverlay;
+}
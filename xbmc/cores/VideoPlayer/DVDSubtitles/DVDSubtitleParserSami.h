@@ -9,8 +9,11 @@
 #pragma once
 
 #include "DVDSubtitleParser.h"
+#include "DVDSubtitleTagSami.h"
+#include "utils/RegExp.h"
 
 #include <memory>
+#include <string>
 
 class CDVDOverlayText;
 class CRegExp;
@@ -21,4 +24,11 @@ public:
   CDVDSubtitleParserSami(std::unique_ptr<CDVDSubtitleStream> && pStream, const std::string& strFile);
   ~CDVDSubtitleParserSami() override;
   bool Open(CDVDStreamInfo &hints) override;
+
+private:
+  CDVDOverlay* CreateOverlay(size_t source);
+
+  CRegExp m_reg;
+  CDVDSubtitleTagSami m_tagConv;
+  std::string m_classID;
 };
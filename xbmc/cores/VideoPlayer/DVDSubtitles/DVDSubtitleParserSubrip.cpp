@@ -28,8 +28,7 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
-  CDVDSubtitleTagSami TagConv;
-  if (!TagConv.Init())
+  if (!m_tagConv.Init())
     return false;
 
   char line[1024];
@@ -54,11 +53,10 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
       }
       else if (c == 14) // time info
       {
-        CDVDOverlayText* pOverlay = new CDVDOverlayText();
-        pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
-
-        pOverlay->iPTSStartTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
-        pOverlay->iPTSStopTime  = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
+        // only index the text, it's converted when playback gets there
+        const long source = m_pStream->Seek(0, SEEK_CUR);
+        const double startTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
+        const double stopTime = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
 
         while (m_pStream->ReadLine(line, sizeof(line)))
         {
@@ -67,15 +65,35 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
 
           // empty line, next subtitle is about to start
           if (strLine.length() <= 0) break;
-
-          TagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
         }
-        TagConv.CloseTag(pOverlay);
-        m_collection.Add(pOverlay);
+        m_collection.Add(startTime, stopTime, source);
       }
     }
   }
+  m_collection.SetOverlayFactory([this](size_t source) { return CreateOverlay(source); });
   m_collection.Sort();
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserSubrip::CreateOverlay(size_t source)
+{
+  m_pStream->Seek(static_cast<long>(source), SEEK_SET);
+
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+
+  char line[1024];
+  std::string strLine;
+  while (m_pStream->ReadLine(line, sizeof(line)))
+  {
+    strLine = line;
+    StringUtils::Trim(strLine);
+
+    // empty line, next subtitle is about to start
+    if (strLine.length() <= 0) break;
+
+    m_tagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
+  }
+  m_tagConv.CloseTag(pOverlay);
+  return pOverlay;
+}
+
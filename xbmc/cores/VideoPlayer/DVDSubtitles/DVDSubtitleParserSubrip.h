@@ -9,6 +9,7 @@
 #pragma once
 
 #include "DVDSubtitleParser.h"
+#include "DVDSubtitleTagSami.h"
 
 #include <memory>
 
@@ -19,5 +20,9 @@ public:
   ~CDVDSubtitleParserSubrip() override;
 
   bool Open(CDVDStreamInfo &hints) override;
+
 private:
+  CDVDOverlay* CreateOverlay(size_t source);
+
+  CDVDSubtitleTagSami m_tagConv;
 };
@@ -127,6 +127,9 @@ int CDVDSubtitleStream::Read(char* buf, int buf_size)
 
 long CDVDSubtitleStream::Seek(long offset, int whence)
 {
+  // reading past the end sets the fail bit, seekg would fail then
+  m_stringstream.clear();
+
   switch (whence)
   {
     case SEEK_CUR:
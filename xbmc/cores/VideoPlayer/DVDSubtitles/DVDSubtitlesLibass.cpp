@@ -20,6 +20,8 @@
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
 
+#include <algorithm>
+
 namespace
 {
 
@@ -200,3 +202,23 @@ int CDVDSubtitlesLibass::GetNrOfEvents() const
     return 0;
   return m_track->n_events;
 }
+
+bool CDVDSubtitlesLibass::GetEventsTimeRange(int firstEvent, double& start, double& end) const
+{
+  CSingleLock lock(m_section);
+  if (!m_track || firstEvent < 0 || firstEvent >= m_track->n_events)
+    return false;
+
+  long long startMs = m_track->events[firstEvent].Start;
+  long long endMs = startMs + m_track->events[firstEvent].Duration;
+  for (int i = firstEvent + 1; i < m_track->n_events; i++)
+  {
+    const ASS_Event& event = m_track->events[i];
+    startMs = std::min(startMs, event.Start);
+    endMs = std::max(endMs, event.Start + event.Duration);
+  }
+
+  start = DVD_MSEC_TO_TIME(startMs);
+  end = DVD_MSEC_TO_TIME(endMs);
+  return true;
+}
@@ -36,6 +36,16 @@ public:
   */
   int GetNrOfEvents() const;
 
+  /*!
+  * \brief Get the time range the events from an index on are shown in. Events that are
+  * decoded later are appended to the track.
+  * \param firstEvent index of the first event
+  * \param start [out] earliest start of the events
+  * \param end [out] latest end of the events
+  * \return false if there are no events from the index on
+  */
+  bool GetEventsTimeRange(int firstEvent, double& start, double& end) const;
+
   bool DecodeHeader(char* data, int size);
   bool DecodeDemuxPkt(const char* data, int size, double start, double duration);
   bool CreateTrack(char* buf, size_t size);
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleLineCollection.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr double SECOND = 1000000.0;
+
+// a line every two seconds, shown for one second
+void Index(CDVDSubtitleLineCollection& collection, size_t lines)
+{
+  for (size_t i = 0; i < lines; i++)
+    collection.Add(i * 2 * SECOND, (i * 2 + 1) * SECOND, i);
+}
+
+class CTestOverlay : public CDVDOverlay
+{
+public:
+  explicit CTestOverlay(size_t source) : CDVDOverlay(DVDOVERLAY_TYPE_TEXT), m_source(source) {}
+
+  size_t m_source;
+};
+} // namespace
+
+TEST(TestDVDSubtitleLineCollection, GetSeeksToLine)
+{
+  CDVDSubtitleLineCollection collection;
+  for (int i = 9; i >= 0; i--)
+  {
+    CDVDOverlay* overlay = new CDVDOverlay(DVDOVERLAY_TYPE_TEXT);
+    overlay->iPTSStartTime = i * 2 * SECOND;
+    overlay->iPTSStopTime = (i * 2 + 1) * SECOND;
+    collection.Add(overlay);
+  }
+  collection.Sort();
+
+  CDVDOverlay* overlay = collection.Get(10.5 * SECOND);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(10 * SECOND, overlay->iPTSStartTime);
+
+  // lines are returned one after the other from the current one
+  overlay = collection.Get(10.5 * SECOND);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(12 * SECOND, overlay->iPTSStartTime);
+
+  // seeking backwards needs a reset
+  collection.Reset();
+  overlay = collection.Get(2.5 * SECOND);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(2 * SECOND, overlay->iPTSStartTime);
+
+  EXPECT_EQ(nullptr, collection.Get(30 * SECOND));
+}
+
+TEST(TestDVDSubtitleLineCollection, OverlappingLines)
+{
+  CDVDSubtitleLineCollection collection;
+  collection.Add(0, 10 * SECOND, 0);
+  collection.Add(1 * SECOND, 2 * SECOND, 1);
+  collection.Add(3 * SECOND, 4 * SECOND, 2);
+  collection.SetOverlayFactory([](size_t source) { return new CTestOverlay(source); });
+
+  // the long first line is still shown after the second one ended
+  CDVDOverlay* overlay = collection.Get(5 * SECOND);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(0u, static_cast<CTestOverlay*>(overlay)->m_source);
+
+  overlay = collection.Get(5 * SECOND);
+  EXPECT_EQ(nullptr, overlay);
+}
+
+TEST(TestDVDSubtitleLineCollection, CreatesOverlaysAroundPosition)
+{
+  CDVDSubtitleLineCollection collection;
+  Index(collection, 1000);
+
+  size_t created = 0;
+  collection.SetOverlayFactory([&created](size_t source) {
+    created++;
+    return new CTestOverlay(source);
+  });
+  EXPECT_EQ(1000, collection.GetSize());
+  EXPECT_EQ(0u, collection.GetMaterializedSize());
+
+  CDVDOverlay* overlay = collection.Get(1000.5 * SECOND);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(500u, static_cast<CTestOverlay*>(overlay)->m_source);
+  EXPECT_EQ(1000 * SECOND, overlay->iPTSStartTime);
+  EXPECT_EQ(1001 * SECOND, overlay->iPTSStopTime);
+  EXPECT_EQ(1u, created);
+  EXPECT_EQ(1u, collection.GetMaterializedSize());
+
+  // lines playback is past are released again
+  for (int i = 1; i <= 10; i++)
+    ASSERT_NE(nullptr, collection.Get((1000.5 + i * 2) * SECOND));
+  EXPECT_EQ(11u, created);
+  EXPECT_EQ(1u, collection.GetMaterializedSize());
+
+  collection.Clear();
+  EXPECT_EQ(0, collection.GetSize());
+  EXPECT_EQ(0u, collection.GetMaterializedSize());
+}
+
+TEST(TestDVDSubtitleLineCollection, OnlyReturnsLinesNearPosition)
+{
+  CDVDSubtitleLineCollection collection;
+  Index(collection, 1000);
+
+  size_t created = 0;
+  collection.SetOverlayFactory([&created](size_t source) {
+    created++;
+    return new CTestOverlay(source);
+  });
+
+  // the subtitle player asks for lines until there are none, like on every call of its Process()
+  auto process = [&collection](double pts) {
+    std::vector<size_t> sources;
+    while (CDVDOverlay* overlay = collection.Get(pts))
+      sources.push_back(static_cast<CTestOverlay*>(overlay)->m_source);
+    return sources;
+  };
+
+  std::vector<size_t> sources = process(1000.5 * SECOND);
+  EXPECT_EQ(std::vector<size_t>({500, 501}), sources);
+  EXPECT_EQ(2u, created);
+
+  // nothing new until playback gets close to the next line
+  EXPECT_TRUE(process(1001.5 * SECOND).empty());
+  EXPECT_EQ(2u, created);
+
+  sources = process(1002.5 * SECOND);
+  EXPECT_EQ(std::vector<size_t>({502}), sources);
+  EXPECT_EQ(3u, created);
+  EXPECT_LE(collection.GetMaterializedSize(), 2u);
+
+  // seeking forward skips the lines in between without creating them
+  EXPECT_EQ(std::vector<size_t>({900, 901}), process(1800.5 * SECOND));
+  EXPECT_EQ(5u, created);
+}
@@ -64,6 +64,7 @@ void CProcessInfo::ResetVideoCodecInfo()
 
   m_videoIsHWDecoder = false;
   m_videoDecoderName = "unknown";
+  m_videoDecoderThreading = "none";
   m_videoDeintMethod = "unknown";
   m_videoPixelFormat = "unknown";
   m_videoStereoMode.clear();
@@ -80,6 +81,7 @@ void CProcessInfo::ResetVideoCodecInfo()
   if (m_dataCache)
   {
     m_dataCache->SetVideoDecoderName(m_videoDecoderName, m_videoIsHWDecoder);
+    m_dataCache->SetVideoDecoderThreading(m_videoDecoderThreading);
     m_dataCache->SetVideoDeintMethod(m_videoDeintMethod);
     m_dataCache->SetVideoPixelFormat(m_videoPixelFormat);
     m_dataCache->SetVideoDimensions(m_videoWidth, m_videoHeight);
@@ -115,6 +117,23 @@ bool CProcessInfo::IsVideoHwDecoder()
   return m_videoIsHWDecoder;
 }
 
+void CProcessInfo::SetVideoDecoderThreading(const std::string &threading)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  m_videoDecoderThreading = threading;
+
+  if (m_dataCache)
+    m_dataCache->SetVideoDecoderThreading(m_videoDecoderThreading);
+}
+
+std::string CProcessInfo::GetVideoDecoderThreading()
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  return m_videoDecoderThreading;
+}
+
 void CProcessInfo::SetVideoDeintMethod(const std::string &method)
 {
   CSingleLock lock(m_videoCodecSection);
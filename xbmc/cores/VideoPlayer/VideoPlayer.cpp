@@ -52,6 +52,7 @@
 #include "storage/MediaManager.h"
 #include "utils/JobManager.h"
 #include "utils/LangCodeExpander.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StreamDetails.h"
 #include "utils/StreamUtils.h"
 #include "utils/StringUtils.h"
@@ -821,10 +822,17 @@ bool CVideoPlayer::OpenDemuxStream()
 
   CLog::Log(LOGINFO, "Creating Demuxer");
 
+  // cache the probe of files the video database knows, not of parts of a stack or of a disc
+  int probeCacheFileId = -1;
+  if (m_item.HasVideoInfoTag() && m_item.GetVideoInfoTag()->m_iFileId > 0 &&
+      m_pInputStream->GetFileName() == m_item.GetDynPath())
+    probeCacheFileId = m_item.GetVideoInfoTag()->m_iFileId;
+
   int attempts = 10;
   while (!m_bStop && attempts-- > 0)
   {
-    m_pDemuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(m_pInputStream));
+    m_pDemuxer.reset(
+        CDVDFactoryDemuxer::CreateDemuxer(m_pInputStream, false, false, probeCacheFileId));
     if(!m_pDemuxer && m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER))
     {
       continue;
@@ -995,6 +1003,7 @@ void CVideoPlayer::OpenDefaultStreams(bool reset)
 
 bool CVideoPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
 {
+  CPerformanceTraceSpan span("VideoPlayer::ReadPacket");
 
   // check if we should read from subtitle demuxer
   if (m_pSubtitleDemuxer && m_VideoPlayerSubtitle->AcceptsData())
@@ -1583,6 +1592,8 @@ bool CVideoPlayer::CheckIsCurrent(CCurrentStream& current, CDemuxStream* stream,
 
 void CVideoPlayer::ProcessPacket(CDemuxStream* pStream, DemuxPacket* pPacket)
 {
+  CPerformanceTraceSpan span("VideoPlayer::ProcessPacket");
+
   // process packet if it belongs to selected stream.
   // for dvd's don't allow automatic opening of streams*/
 
@@ -18,6 +18,7 @@
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/log.h"
 
 #include "system.h"
@@ -391,7 +392,14 @@ void CVideoPlayerAudio::Process()
         continue;
       }
 
-      if (!m_pAudioCodec->AddData(*pPacket))
+      CPerformanceTrace::AddCounter("Audio::QueueLevel", m_messageQueue.GetLevel());
+
+      bool added;
+      {
+        CPerformanceTraceSpan span("Audio::AddData");
+        added = m_pAudioCodec->AddData(*pPacket);
+      }
+      if (!added)
       {
         m_messageQueue.PutBack(pMsg);
         onlyPrioMsgs = true;
@@ -416,7 +424,10 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
   {
     audioframe.hasDownmix = false;
 
-    m_pAudioCodec->GetData(audioframe);
+    {
+      CPerformanceTraceSpan span("Audio::GetData");
+      m_pAudioCodec->GetData(audioframe);
+    }
 
     if (audioframe.nb_frames == 0)
     {
@@ -492,6 +503,7 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
 
   {
     double syncerror = m_audioSink.GetSyncError();
+    CPerformanceTrace::AddCounter("Audio::SyncError", DVD_TIME_TO_MSEC(syncerror));
     if (m_synctype == SYNC_DISCON && fabs(syncerror) > DVD_MSEC_TO_TIME(10))
     {
       double correction = m_pClock->ErrorAdjust(syncerror, "CVideoPlayerAudio::OutputPacket");
@@ -502,7 +514,11 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
     }
   }
 
-  int framesOutput = m_audioSink.AddPackets(audioframe);
+  int framesOutput;
+  {
+    CPerformanceTraceSpan span("Audio::AddPackets");
+    framesOutput = m_audioSink.AddPackets(audioframe);
+  }
 
   // guess next pts
   m_audioClock += audioframe.duration * ((double)framesOutput / audioframe.nb_frames);
@@ -17,6 +17,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/MathUtils.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
 #include "windowing/WinSystem.h"
@@ -524,6 +525,8 @@ void CVideoPlayerVideo::Process()
       DemuxPacket* pPacket = std::static_pointer_cast<CDVDMsgDemuxerPacket>(pMsg)->GetPacket();
       bool bPacketDrop = std::static_pointer_cast<CDVDMsgDemuxerPacket>(pMsg)->GetPacketDrop();
 
+      CPerformanceTrace::AddCounter("Video::QueueLevel", m_messageQueue.GetLevel());
+
       if (m_stalled)
       {
         CLog::Log(LOGDEBUG, "CVideoPlayerVideo - Stillframe left, switching to normal playback");
@@ -540,6 +543,7 @@ void CVideoPlayerVideo::Process()
       }
       if (iDropDirective & DROP_DROPPED)
       {
+        CPerformanceTrace::AddInstant("Video::DroppedInDecoder");
         m_iDroppedFrames++;
         m_ptsTracker.Flush();
       }
@@ -563,7 +567,12 @@ void CVideoPlayerVideo::Process()
         codecControl |= DVD_CODEC_CTRL_ROTATE;
       m_pVideoCodec->SetCodecControl(codecControl);
 
-      if (m_pVideoCodec->AddData(*pPacket))
+      bool added;
+      {
+        CPerformanceTraceSpan span("Video::AddData");
+        added = m_pVideoCodec->AddData(*pPacket);
+      }
+      if (added)
       {
         // buffer packets so we can recover should decoder flush for some reason
         if (m_pVideoCodec->GetConvergeCount() > 0)
@@ -592,7 +601,11 @@ void CVideoPlayerVideo::Process()
 
 bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
 {
-  CDVDVideoCodec::VCReturn decoderState = m_pVideoCodec->GetPicture(&m_picture);
+  CDVDVideoCodec::VCReturn decoderState;
+  {
+    CPerformanceTraceSpan span("Video::GetPicture");
+    decoderState = m_pVideoCodec->GetPicture(&m_picture);
+  }
 
   if (decoderState == CDVDVideoCodec::VC_BUFFER)
   {
@@ -739,6 +752,7 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
     }
     else if ((m_outputSate == OUTPUT_DROPPED) && !(m_picture.iFlags & DVP_FLAG_DROPPED))
     {
+      CPerformanceTrace::AddInstant("Video::DroppedInOutput");
       m_iDroppedFrames++;
       m_ptsTracker.Flush();
     }
@@ -909,7 +923,12 @@ CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPict
   // don't wait when going ff
   if (m_speed > DVD_PLAYSPEED_NORMAL)
     maxWaitTime = std::max(timeToDisplay, 0);
-  int buffer = m_renderManager.WaitForBuffer(m_bAbortOutput, maxWaitTime);
+  CPerformanceTrace::AddCounter("Video::TimeToDisplay", timeToDisplay);
+  int buffer;
+  {
+    CPerformanceTraceSpan span("Video::WaitForBuffer");
+    buffer = m_renderManager.WaitForBuffer(m_bAbortOutput, maxWaitTime);
+  }
   if (buffer < 0)
   {
     if (m_speed != DVD_PLAYSPEED_PAUSE)
@@ -924,6 +943,7 @@ CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPict
   if (!m_processInfo.Supports(deintMethod))
     deintMethod = m_processInfo.GetDeinterlacingMethodDefault();
 
+  CPerformanceTraceSpan span("Video::AddVideoPicture");
   if (!m_renderManager.AddVideoPicture(*pPicture, m_bAbortOutput, deintMethod, (m_syncState == ESyncState::SYNC_STARTING)))
   {
     m_droppingStats.AddOutputDropGain(pPicture->pts, 1);
@@ -55,6 +55,9 @@ public:
   virtual bool Configure(const VideoPicture &picture, float fps, unsigned int orientation) = 0;
   virtual bool IsConfigured() = 0;
   virtual void AddVideoPicture(const VideoPicture &picture, int index) = 0;
+  // Called before AddVideoPicture, without the locks of the render manager held, to copy the
+  // picture into the buffer of the given index.
+  virtual void PrepareVideoPicture(const VideoPicture &picture, int index) {}
   virtual bool IsPictureHW(const VideoPicture &picture) { return false; };
   virtual void UnInit() = 0;
   virtual bool Flush(bool saveBuffers) { return false; };
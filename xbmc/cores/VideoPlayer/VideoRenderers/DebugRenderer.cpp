@@ -69,8 +69,17 @@ void CDebugRenderer::SetInfo(DEBUG_INFO_PLAYER& info)
     m_overlay[3] = new CDVDOverlayText();
     m_overlay[3]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[3]));
   }
+  if (info.subtitles != m_strDebug[4])
+  {
+    m_strDebug[4] = info.subtitles;
+    if (m_overlay[4])
+      m_overlay[4]->Release();
+    m_overlay[4] = new CDVDOverlayText();
+    m_overlay[4]->AddElement(new CDVDOverlayText::CElementText(m_strDebug[4]));
+  }
 
-  for (int i = 0; i < 4; i++)
+  const int count = info.subtitles.empty() ? 4 : 5;
+  for (int i = 0; i < count; i++)
     m_overlayRenderer.AddOverlay(m_overlay[i], 0, 0);
 }
 
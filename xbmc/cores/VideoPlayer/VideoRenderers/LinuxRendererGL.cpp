@@ -30,6 +30,7 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StringUtils.h"
 #include "RenderCapture.h"
 #include "cores/IPlayer.h"
@@ -49,6 +50,9 @@
 //! is a multiple of 128 and deinterlacing is on
 #define PBO_OFFSET 16
 
+// ns to wait for the upload from a persistently mapped pbo when its buffer is released
+#define PBO_FENCE_TIMEOUT 100000000
+
 using namespace Shaders;
 
 static const GLubyte stipple_weave[] = {
@@ -92,8 +96,10 @@ CLinuxRendererGL::CPictureBuffer::CPictureBuffer()
   memset(&fields, 0, sizeof(fields));
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
+  memset(&pboMapped, 0, sizeof(pboMapped));
   videoBuffer = nullptr;
   loaded = false;
+  copied = false;
 }
 
 CBaseRenderer* CLinuxRendererGL::Create(CVideoBuffer *buffer)
@@ -233,6 +239,10 @@ bool CLinuxRendererGL::Configure(const VideoPicture &picture, float fps, unsigne
   m_pixelRatio = 1.0;
 
   m_pboSupported = CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_pixel_buffer_object");
+#if defined(GL_MAP_PERSISTENT_BIT)
+  m_pboPersistent =
+      m_pboSupported && CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_buffer_storage");
+#endif
 
   // setup the background colour
   m_clearColour = CServiceBroker::GetWinSystem()->UseLimitedColor() ? (16.0f / 0xff) : 0.0f;
@@ -275,6 +285,7 @@ void CLinuxRendererGL::AddVideoPicture(const VideoPicture &picture, int index)
   buf.videoBuffer = picture.videoBuffer;
   buf.videoBuffer->Acquire();
   buf.loaded = false;
+  buf.copied = false;
   buf.m_srcPrimaries = static_cast<AVColorPrimaries>(picture.color_primaries);
   buf.m_srcColSpace = static_cast<AVColorSpace>(picture.color_space);
   buf.m_srcFullRange = picture.color_range == 1;
@@ -285,11 +296,47 @@ void CLinuxRendererGL::AddVideoPicture(const VideoPicture &picture, int index)
   buf.lightMetadata = picture.lightMetadata;
   if (picture.hasLightMetadata && picture.lightMetadata.MaxCLL)
     buf.hasLightMetadata = picture.hasLightMetadata;
+
+  CSingleLock lock(m_pboSection);
+  buf.copied = buf.preparedBuffer == picture.videoBuffer;
+
+  // a picture prepared for another buffer, when buffers were flushed in between, is stale
+  for (int i = 0; i < NUM_BUFFERS; i++)
+    m_buffers[i].preparedBuffer = nullptr;
+}
+
+void CLinuxRendererGL::PrepareVideoPicture(const VideoPicture& picture, int index)
+{
+  // with persistently mapped pbos the frame is copied here, on the decoder thread before the
+  // render manager takes its locks, and the render thread only starts the upload
+  CSingleLock lock(m_pboSection);
+  CPictureBuffer& buf = m_buffers[index];
+  buf.preparedBuffer = nullptr;
+
+  // the pbos are sized for the configured source. ConfigChanged only compares the format, a
+  // resize with the same format is only applied by the render thread, so until then the picture
+  // is copied there
+  YuvImage mapped;
+  if (!ConfigChanged(picture) && GetMappedImage(buf, mapped) &&
+      mapped.width == picture.iWidth && mapped.height == picture.iHeight)
+  {
+    CopyVideoBuffer(picture.videoBuffer, mapped);
+    buf.preparedBuffer = picture.videoBuffer;
+  }
 }
 
 void CLinuxRendererGL::ReleaseBuffer(int idx)
 {
   CPictureBuffer &buf = m_buffers[idx];
+
+  // the pbo is written by the next AddVideoPicture, the upload from it has to be done
+  if (buf.fence)
+  {
+    glClientWaitSync(buf.fence, GL_SYNC_FLUSH_COMMANDS_BIT, PBO_FENCE_TIMEOUT);
+    glDeleteSync(buf.fence);
+    buf.fence = nullptr;
+  }
+
   if (buf.videoBuffer)
   {
     buf.videoBuffer->Release();
@@ -955,7 +1002,8 @@ void CLinuxRendererGL::LoadShaders(int field)
 
   if (m_pboSupported)
   {
-    CLog::Log(LOGINFO, "GL: Using GL_ARB_pixel_buffer_object");
+    CLog::Log(LOGINFO, "GL: Using GL_ARB_pixel_buffer_object{}",
+              m_pboPersistent ? " with persistent mapping" : "");
     m_pboUsed = true;
   }
   else
@@ -1731,6 +1779,8 @@ GLint CLinuxRendererGL::GetInternalFormat(GLint format, int bpp)
 
 bool CLinuxRendererGL::CreateTexture(int index)
 {
+  CSingleLock lock(m_pboSection);
+
   if (m_format == AV_PIX_FMT_NV12)
     return CreateNV12Texture(index);
   else if (m_format == AV_PIX_FMT_YUYV422 ||
@@ -1742,8 +1792,20 @@ bool CLinuxRendererGL::CreateTexture(int index)
 
 void CLinuxRendererGL::DeleteTexture(int index)
 {
+  CSingleLock lock(m_pboSection);
+
   CPictureBuffer& buf = m_buffers[index];
   buf.loaded = false;
+  buf.copied = false;
+  buf.preparedBuffer = nullptr;
+
+  if (buf.fence)
+  {
+    glClientWaitSync(buf.fence, GL_SYNC_FLUSH_COMMANDS_BIT, PBO_FENCE_TIMEOUT);
+    glDeleteSync(buf.fence);
+    buf.fence = nullptr;
+  }
+  memset(&buf.pboMapped, 0, sizeof(buf.pboMapped));
 
   if (m_format == AV_PIX_FMT_NV12)
     DeleteNV12Texture(index);
@@ -1756,44 +1818,50 @@ void CLinuxRendererGL::DeleteTexture(int index)
 
 bool CLinuxRendererGL::UploadTexture(int index)
 {
-  if (!m_buffers[index].videoBuffer)
+  CPictureBuffer& buf = m_buffers[index];
+  if (!buf.videoBuffer)
     return false;
 
   bool ret = true;
 
-  if (!m_buffers[index].loaded)
+  if (!buf.loaded)
   {
+    CPerformanceTraceSpan span("Render::UploadTexture");
     ret = false;
 
-    YuvImage &dst = m_buffers[index].image;
-    YuvImage src;
-    m_buffers[index].videoBuffer->GetPlanes(src.plane);
-    m_buffers[index].videoBuffer->GetStrides(src.stride);
-
-    UnBindPbo(m_buffers[index]);
+    YuvImage mapped;
+    if (GetMappedImage(buf, mapped))
+    {
+      // textures were created after the frame was added
+      if (!buf.copied)
+        CopyVideoBuffer(buf.videoBuffer, mapped);
+    }
+    else
+    {
+      UnBindPbo(buf);
+      CopyVideoBuffer(buf.videoBuffer, buf.image);
+      BindPbo(buf);
+    }
 
     if (m_format == AV_PIX_FMT_NV12)
-    {
-      CVideoBuffer::CopyNV12Picture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadNV12Texture(index);
-    }
     else if (m_format == AV_PIX_FMT_YUYV422 ||
              m_format == AV_PIX_FMT_UYVY422)
-    {
-      CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadYUV422PackedTexture(index);
-    }
     else
-    {
-      CVideoBuffer::CopyPicture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadYV12Texture(index);
-    }
 
     if (ret)
-      m_buffers[index].loaded = true;
+    {
+      buf.loaded = true;
+
+      if (buf.pboMapped[0])
+      {
+        if (buf.fence)
+          glDeleteSync(buf.fence);
+        buf.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      }
+    }
   }
 
   if (ret)
@@ -1802,6 +1870,32 @@ bool CLinuxRendererGL::UploadTexture(int index)
   return ret;
 }
 
+void CLinuxRendererGL::CopyVideoBuffer(CVideoBuffer* videoBuffer, YuvImage& dst)
+{
+  YuvImage src;
+  videoBuffer->GetPlanes(src.plane);
+  videoBuffer->GetStrides(src.stride);
+
+  if (m_format == AV_PIX_FMT_NV12)
+    CVideoBuffer::CopyNV12Picture(&dst, &src);
+  else if (m_format == AV_PIX_FMT_YUYV422 ||
+           m_format == AV_PIX_FMT_UYVY422)
+    CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
+  else
+    CVideoBuffer::CopyPicture(&dst, &src);
+}
+
+bool CLinuxRendererGL::GetMappedImage(const CPictureBuffer& buf, YuvImage& image) const
+{
+  if (!buf.pboMapped[0])
+    return false;
+
+  image = buf.image;
+  for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+    image.plane[p] = buf.pboMapped[p];
+  return true;
+}
+
 //********************************************************************************************************
 // YV12 Texture creation, deletion, copying + clearing
 //********************************************************************************************************
@@ -1863,9 +1957,7 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
 
     for (int i = 0; i < 3; i++)
     {
-      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[i]);
-      glBufferData(GL_PIXEL_UNPACK_BUFFER, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW);
-      void* pboPtr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+      void* pboPtr = MapPbo(pbo[i], im.planesize[i]);
       if (pboPtr)
       {
         im.plane[i] = (uint8_t*) pboPtr + PBO_OFFSET;
@@ -1898,6 +1990,8 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
     for (int i = 0; i < 3; i++)
       im.plane[i] = new uint8_t[im.planesize[i]];
   }
+  else
+    KeepPboMapped(buf);
 
   for(int f = 0;f<MAX_FIELDS;f++)
   {
@@ -2169,9 +2263,7 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
 
     for (int i = 0; i < 2; i++)
     {
-      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[i]);
-      glBufferData(GL_PIXEL_UNPACK_BUFFER, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW);
-      void* pboPtr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+      void* pboPtr = MapPbo(pbo[i], im.planesize[i]);
       if (pboPtr)
       {
         im.plane[i] = (uint8_t*)pboPtr + PBO_OFFSET;
@@ -2204,6 +2296,8 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
     for (int i = 0; i < 2; i++)
       im.plane[i] = new uint8_t[im.planesize[i]];
   }
+  else
+    KeepPboMapped(buf);
 
   for(int f = 0;f<MAX_FIELDS;f++)
   {
@@ -2435,9 +2529,7 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
     pboSetup = true;
     glGenBuffers(1, pbo);
 
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[0]);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, im.planesize[0] + PBO_OFFSET, 0, GL_STREAM_DRAW);
-    void* pboPtr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    void* pboPtr = MapPbo(pbo[0], im.planesize[0]);
     if (pboPtr)
     {
       im.plane[0] = (uint8_t*)pboPtr + PBO_OFFSET;
@@ -2464,6 +2556,8 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
   {
     im.plane[0] = new uint8_t[im.planesize[0]];
   }
+  else
+    KeepPboMapped(buf);
 
   for(int f = 0;f<MAX_FIELDS;f++)
   {
@@ -2610,6 +2704,55 @@ bool CLinuxRendererGL::Supports(ESCALINGMETHOD method)
   return false;
 }
 
+void* CLinuxRendererGL::MapPbo(GLuint pbo, unsigned int size)
+{
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+#if defined(GL_MAP_PERSISTENT_BIT)
+  if (m_pboPersistent)
+  {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size + PBO_OFFSET, nullptr, flags);
+    return glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size + PBO_OFFSET, flags);
+  }
+#endif
+  glBufferData(GL_PIXEL_UNPACK_BUFFER, size + PBO_OFFSET, 0, GL_STREAM_DRAW);
+  return glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+}
+
+void CLinuxRendererGL::KeepPboMapped(CPictureBuffer& buff)
+{
+  if (!m_pboPersistent)
+    return;
+
+  // the mapping stays valid while the gpu reads from the pbo, so frames are written to it
+  // directly and the planes of the image are the offsets to upload from
+  for (int plane = 0; plane < YuvImage::MAX_PLANES; plane++)
+  {
+    if (!buff.pbo[plane])
+      continue;
+
+    buff.pboMapped[plane] = buff.image.plane[plane];
+    buff.image.plane[plane] = (uint8_t*)PBO_OFFSET;
+  }
+}
+
+bool CLinuxRendererGL::NeedBuffer(int idx)
+{
+  CPictureBuffer& buf = m_buffers[idx];
+  if (!buf.fence)
+    return false;
+
+  GLint state;
+  GLsizei length;
+  glGetSynciv(buf.fence, GL_SYNC_STATUS, 1, &length, &state);
+  if (state != GL_SIGNALED)
+    return true;
+
+  glDeleteSync(buf.fence);
+  buf.fence = nullptr;
+  return false;
+}
+
 void CLinuxRendererGL::BindPbo(CPictureBuffer& buff)
 {
   bool pbo = false;
@@ -20,6 +20,7 @@
 #include "windowing/GraphicContext.h"
 #include "BaseRenderer.h"
 #include "ColorManager.h"
+#include "threads/CriticalSection.h"
 #include "threads/Event.h"
 #include "VideoShaders/ShaderFormats.h"
 #include "utils/Geometry.h"
@@ -77,10 +78,12 @@ public:
   bool Configure(const VideoPicture &picture, float fps, unsigned int orientation) override;
   bool IsConfigured() override { return m_bConfigured; }
   void AddVideoPicture(const VideoPicture &picture, int index) override;
+  void PrepareVideoPicture(const VideoPicture& picture, int index) override;
   void UnInit() override;
   bool Flush(bool saveBuffers) override;
   void SetBufferSize(int numBuffers) override { m_NumYV12Buffers = numBuffers; }
   void ReleaseBuffer(int idx) override;
+  bool NeedBuffer(int idx) override;
   void RenderUpdate(int index, int index2, bool clear, unsigned int flags, unsigned int alpha) override;
   void Update() override;
   bool RenderCapture(CRenderCapture* capture) override;
@@ -135,6 +138,10 @@ protected:
   struct CYuvPlane;
   struct CPictureBuffer;
 
+  void* MapPbo(GLuint pbo, unsigned int size);
+  void KeepPboMapped(CPictureBuffer& buff);
+  bool GetMappedImage(const CPictureBuffer& buf, YuvImage& image) const;
+  void CopyVideoBuffer(CVideoBuffer* videoBuffer, YuvImage& dst);
   void BindPbo(CPictureBuffer& buff);
   void UnBindPbo(CPictureBuffer& buff);
   void LoadPlane(CYuvPlane& plane, int type,
@@ -191,9 +198,13 @@ protected:
     CYuvPlane fields[MAX_FIELDS][YuvImage::MAX_PLANES];
     YuvImage image;
     GLuint pbo[3]; // one pbo for 3 planes
+    uint8_t* pboMapped[3]; // persistent mapping of the pbos, image planes hold the offset
+    GLsync fence = nullptr; // upload from the persistently mapped pbos
 
     CVideoBuffer *videoBuffer;
     bool loaded;
+    bool copied; // frame was written to the persistently mapped pbos
+    CVideoBuffer* preparedBuffer = nullptr; // written to the pbos before it was added
 
     AVColorPrimaries m_srcPrimaries;
     AVColorSpace m_srcColSpace;
@@ -224,6 +235,8 @@ protected:
   float m_clearColour = 0.0f;
   bool m_pboSupported = true;
   bool m_pboUsed = false;
+  bool m_pboPersistent = false;
+  CCriticalSection m_pboSection;
   bool m_nonLinStretch = false;
   bool m_nonLinStretchGui = false;
   float m_pixelRatio = 0.0f;
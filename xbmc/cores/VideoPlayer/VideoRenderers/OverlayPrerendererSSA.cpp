@@ -0,0 +1,224 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "OverlayPrerendererSSA.h"
+
+#include "OverlayRendererUtil.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitlesLibass.h"
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
+#include "threads/SingleLock.h"
+
+#include <chrono>
+
+using namespace OVERLAY;
+
+namespace
+{
+// frame durations above are taken as seeks or pauses
+constexpr double MAX_FRAME_DURATION = DVD_TIME_BASE / 10.0;
+
+size_t GetSize(const SQuads& quads)
+{
+  return static_cast<size_t>(quads.size_x) * quads.size_y + quads.count * sizeof(SQuad);
+}
+
+double Average(double average, double sample)
+{
+  return average == 0.0 ? sample : average * 0.9 + sample * 0.1;
+}
+} // namespace
+
+bool SAssRenderParams::operator==(const SAssRenderParams& other) const
+{
+  return frameWidth == other.frameWidth && frameHeight == other.frameHeight &&
+         videoWidth == other.videoWidth && videoHeight == other.videoHeight &&
+         sourceWidth == other.sourceWidth && sourceHeight == other.sourceHeight &&
+         useMargin == other.useMargin && position == other.position;
+}
+
+CPrerendererSSA::CPrerendererSSA(std::shared_ptr<CDVDSubtitlesLibass> libass)
+  : CThread("SubtitlePrerender"),
+    m_libass(std::move(libass)),
+    m_pts(DVD_NOPTS_VALUE),
+    m_frameDuration(DVD_TIME_BASE / 25.0)
+{
+  Create();
+}
+
+CPrerendererSSA::~CPrerendererSSA()
+{
+  m_bStop = true;
+  m_wake.Set();
+  StopThread();
+}
+
+std::shared_ptr<const SQuads> CPrerendererSSA::Get(const SAssRenderParams& params, double pts)
+{
+  {
+    CSingleLock lock(m_section);
+
+    const int events = m_libass->GetNrOfEvents();
+    if (params != m_params || events < m_events)
+    {
+      Flush();
+      m_params = params;
+      m_events = events;
+    }
+    else if (events != m_events)
+    {
+      // new events of embedded subtitles may show up in frames already rendered
+      double start;
+      double end;
+      if (m_libass->GetEventsTimeRange(m_events, start, end))
+        Invalidate(start, end);
+      m_events = events;
+    }
+
+    if (m_pts != DVD_NOPTS_VALUE && pts > m_pts && pts - m_pts < MAX_FRAME_DURATION)
+      m_frameDuration = pts - m_pts;
+    m_pts = pts;
+
+    while (!m_cache.empty() && m_cache.front().end <= pts)
+    {
+      m_bytes -= GetSize(*m_cache.front().quads);
+      m_cache.pop_front();
+    }
+
+    // seeked backwards, the worker has to start over from the clock
+    if (!m_cache.empty() && m_cache.front().start - pts > 2 * m_frameDuration)
+      Flush();
+
+    m_wake.Set();
+
+    if (!m_cache.empty() && m_cache.front().start <= pts)
+    {
+      m_stats.hits++;
+      return m_cache.front().quads;
+    }
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<const SQuads> quads = Render(params, pts, false);
+  const double elapsed =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  CSingleLock lock(m_section);
+  m_stats.misses++;
+  m_stats.renderTime = Average(m_stats.renderTime, elapsed);
+  return quads;
+}
+
+CPrerendererSSA::SStats CPrerendererSSA::GetStats() const
+{
+  CSingleLock lock(m_section);
+  SStats stats = m_stats;
+  stats.entries = m_cache.size();
+  stats.bytes = m_bytes;
+  return stats;
+}
+
+void CPrerendererSSA::Process()
+{
+  while (!m_bStop)
+  {
+    SAssRenderParams params;
+    double pts = 0.0;
+    double duration = 0.0;
+    unsigned int generation = 0;
+    {
+      CSingleLock lock(m_section);
+      if (m_pts != DVD_NOPTS_VALUE && m_params.frameWidth > 0 && m_params.frameHeight > 0 &&
+          m_cache.size() < MAX_ENTRIES && m_bytes < MAX_BYTES)
+      {
+        pts = m_cache.empty() ? m_pts + m_frameDuration : m_cache.back().end;
+        if (pts <= m_pts + LOOKAHEAD)
+        {
+          params = m_params;
+          duration = m_frameDuration;
+          generation = m_generation;
+        }
+      }
+    }
+
+    if (duration <= 0.0)
+    {
+      m_wake.WaitMSec(100);
+      continue;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const SQuads> quads = Render(params, pts, true);
+    const double elapsed =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    CSingleLock lock(m_section);
+    m_stats.workerTime = Average(m_stats.workerTime, elapsed);
+    if (generation != m_generation)
+      continue;
+
+    // unchanged frames extend the entry of the line that is still shown
+    if (!m_cache.empty() && m_cache.back().quads == quads)
+      m_cache.back().end = pts + duration;
+    else
+    {
+      m_cache.push_back({pts, pts + duration, quads});
+      m_bytes += GetSize(*quads);
+    }
+  }
+}
+
+std::shared_ptr<const SQuads> CPrerendererSSA::Render(const SAssRenderParams& params,
+                                                      double pts,
+                                                      bool worker)
+{
+  std::shared_ptr<const SQuads>& previous = worker ? m_workerQuads : m_syncQuads;
+
+  CSingleLock lock(m_renderSection);
+  int changes = 0;
+  ASS_Image* images = m_libass->RenderImage(
+      params.frameWidth, params.frameHeight, params.videoWidth, params.videoHeight,
+      params.sourceWidth, params.sourceHeight, pts, params.useMargin, params.position, &changes);
+
+  if (changes == 0 && previous && m_workerRenderedLast == worker)
+    return previous;
+  m_workerRenderedLast = worker;
+
+  // the images are only valid until the next render, pack them while still locked
+  auto quads = std::make_shared<SQuads>();
+  convert_quad(images, *quads, params.frameWidth);
+  previous = quads;
+  return previous;
+}
+
+void CPrerendererSSA::Flush()
+{
+  m_cache.clear();
+  m_bytes = 0;
+  m_generation++;
+}
+
+void CPrerendererSSA::Invalidate(double start, double end)
+{
+  if (m_cache.empty() || end <= m_cache.front().start || start >= m_cache.back().end)
+    return;
+
+  // the cache has to stay consecutive, drop everything from the first frame changed on
+  while (!m_cache.empty() && m_cache.back().end > start)
+  {
+    SEntry& entry = m_cache.back();
+    if (entry.start < start)
+    {
+      entry.end = start;
+      break;
+    }
+
+    m_bytes -= GetSize(*entry.quads);
+    m_cache.pop_back();
+  }
+  m_generation++;
+}
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <memory>
+#include <stdint.h>
+
+class CDVDSubtitlesLibass;
+
+namespace OVERLAY
+{
+
+struct SQuads;
+
+/*!
+ \brief Frame and video geometry libass renders for, see CDVDSubtitlesLibass::RenderImage.
+ */
+struct SAssRenderParams
+{
+  int frameWidth = 0;
+  int frameHeight = 0;
+  int videoWidth = 0;
+  int videoHeight = 0;
+  int sourceWidth = 0;
+  int sourceHeight = 0;
+  int useMargin = 0;
+  double position = 0.0;
+
+  bool operator==(const SAssRenderParams& other) const;
+  bool operator!=(const SAssRenderParams& other) const { return !(*this == other); }
+};
+
+/*!
+ \brief Rasterizes ASS subtitles ahead of the video clock.
+
+ Heavily typeset subtitles take longer to rasterize than a frame lasts, so a worker thread
+ renders the frames following the last requested time into a bounded cache of packed glyph
+ quads. The render thread then only uploads them, and only renders synchronously when the
+ cache doesn't cover the requested time, e.g. after a seek.
+
+ Consecutive frames libass reports as unchanged share one cache entry, so the quads of a
+ static line are the same object for its whole duration and its texture can be reused.
+ */
+class CPrerendererSSA : private CThread
+{
+public:
+  static constexpr double LOOKAHEAD = 1000000.0; //!< us rendered ahead of the clock
+  static constexpr size_t MAX_ENTRIES = 256;
+  static constexpr size_t MAX_BYTES = 32 * 1024 * 1024;
+
+  struct SStats
+  {
+    uint64_t hits = 0; //!< frames served from the cache
+    uint64_t misses = 0; //!< frames rendered on the render thread
+    size_t entries = 0;
+    size_t bytes = 0;
+    double renderTime = 0.0; //!< ms per synchronous render, moving average
+    double workerTime = 0.0; //!< ms per render of the worker, moving average
+  };
+
+  explicit CPrerendererSSA(std::shared_ptr<CDVDSubtitlesLibass> libass);
+  ~CPrerendererSSA() override;
+
+  const std::shared_ptr<CDVDSubtitlesLibass>& GetLibass() const { return m_libass; }
+
+  /*!
+   \brief Get the rasterized subtitles of a frame and let the worker render ahead of it.
+   \param params geometry to render for, the cache is dropped when it changes
+   \param pts presentation time of the frame
+   \return the quads of the frame, the same object as for the previous frame if unchanged
+   */
+  std::shared_ptr<const SQuads> Get(const SAssRenderParams& params, double pts);
+
+  SStats GetStats() const;
+
+protected:
+  void Process() override;
+
+private:
+  struct SEntry
+  {
+    double start;
+    double end;
+    std::shared_ptr<const SQuads> quads;
+  };
+
+  /*!
+   \brief Render a frame with libass and pack the images.
+   \param worker whether this is called by the worker or the render thread
+   \return the quads, the previous ones of the calling thread if libass reports no change
+   */
+  std::shared_ptr<const SQuads> Render(const SAssRenderParams& params, double pts, bool worker);
+  void Flush();
+
+  /*!
+   \brief Drop the frames from the start of a time range on if the cache overlaps it.
+   */
+  void Invalidate(double start, double end);
+
+  std::shared_ptr<CDVDSubtitlesLibass> m_libass;
+
+  // libass images are only valid until the next render, and its change detection compares
+  // with the previous render, whichever thread that was for
+  CCriticalSection m_renderSection;
+  bool m_workerRenderedLast = false;
+  std::shared_ptr<const SQuads> m_workerQuads; // worker thread only
+  std::shared_ptr<const SQuads> m_syncQuads; // render thread only
+
+  mutable CCriticalSection m_section;
+  CEvent m_wake;
+  std::deque<SEntry> m_cache; // consecutive frames from the clock on
+  size_t m_bytes = 0;
+  unsigned int m_generation = 0; // bumped by Flush(), discards renders in progress
+  SAssRenderParams m_params;
+  int m_events = 0; // events of the track the cache was rendered with
+  double m_pts;
+  double m_frameDuration;
+  SStats m_stats;
+};
+
+} // namespace OVERLAY
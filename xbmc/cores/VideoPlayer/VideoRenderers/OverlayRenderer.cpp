@@ -8,6 +8,7 @@
  */
 
 #include "OverlayRenderer.h"
+#include "OverlayPrerendererSSA.h"
 #include "cores/VideoPlayer/DVDCodecs/Overlay/DVDOverlay.h"
 #include "cores/VideoPlayer/DVDCodecs/Overlay/DVDOverlayImage.h"
 #include "cores/VideoPlayer/DVDCodecs/Overlay/DVDOverlaySpu.h"
@@ -23,6 +24,7 @@
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/ColorUtils.h"
+#include "utils/StringUtils.h"
 #include "OverlayRendererUtil.h"
 #include "OverlayRendererGUI.h"
 #if defined(HAS_GL) || defined(HAS_GLES)
@@ -97,6 +99,7 @@ void CRenderer::Flush()
     Release(buffer);
 
   ReleaseCache();
+  m_prerendererSSA.reset();
 
   g_fontManager.Unload(m_font);
   g_fontManager.Unload(m_fontBorder);
@@ -115,6 +118,7 @@ void CRenderer::ReleaseCache()
     delete overlay.second;
   }
   m_textureCache.clear();
+  m_quadsCache.clear();
   m_textureid++;
 }
 
@@ -139,6 +143,7 @@ void CRenderer::ReleaseUnused()
     if (!found)
     {
       delete it->second;
+      m_quadsCache.erase(it->first);
       it = m_textureCache.erase(it);
     }
     else
@@ -339,6 +344,19 @@ void CRenderer::SetStereoMode(const std::string &stereomode)
   m_stereomode = stereomode;
 }
 
+std::string CRenderer::GetDebugInfo()
+{
+  CSingleLock lock(m_section);
+  if (!m_prerendererSSA)
+    return "";
+
+  const CPrerendererSSA::SStats stats = m_prerendererSSA->GetStats();
+  return StringUtils::Format("Subtitles: prerendered:{} ({:.1f} MB) hits:{} misses:{} "
+                             "render:{:.2f} ms prerender:{:.2f} ms",
+                             stats.entries, stats.bytes / (1024.0 * 1024.0), stats.hits,
+                             stats.misses, stats.renderTime, stats.workerTime);
+}
+
 COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
 {
   if (!o || !o->GetLibass())
@@ -390,14 +408,27 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   }
   else
     position = 0.0;
-  int changes = 0;
-  ASS_Image* images =
-      o->GetLibass()->RenderImage(targetWidth, targetHeight, videoWidth, videoHeight, sourceWidth,
-                                  sourceHeight, pts, useMargin, position, &changes);
 
+  // rasterized ahead of time, only the upload is left for the render thread
+  if (!m_prerendererSSA || m_prerendererSSA->GetLibass() != o->GetLibass())
+    m_prerendererSSA = std::make_unique<CPrerendererSSA>(o->GetLibass());
+
+  SAssRenderParams params;
+  params.frameWidth = targetWidth;
+  params.frameHeight = targetHeight;
+  params.videoWidth = videoWidth;
+  params.videoHeight = videoHeight;
+  params.sourceWidth = sourceWidth;
+  params.sourceHeight = sourceHeight;
+  params.useMargin = useMargin;
+  params.position = position;
+  std::shared_ptr<const SQuads> quads = m_prerendererSSA->Get(params, pts);
+
+  // unchanged subtitles come as the same quads
   if(o->m_textureid)
   {
-    if(changes == 0)
+    auto quadsIt = m_quadsCache.find(o->m_textureid);
+    if (quadsIt != m_quadsCache.end() && quadsIt->second == quads)
     {
       std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
       if (it != m_textureCache.end())
@@ -407,9 +438,9 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
 
   COverlay *overlay = NULL;
 #if defined(HAS_GL) || defined(HAS_GLES)
-  overlay = new COverlayGlyphGL(images, targetWidth, targetHeight);
+  overlay = new COverlayGlyphGL(*quads, targetWidth, targetHeight);
 #elif defined(HAS_DX)
-  overlay = new COverlayQuadsDX(images, targetWidth, targetHeight);
+  overlay = new COverlayQuadsDX(*quads, targetWidth, targetHeight);
 #endif
   // scale to video dimensions
   if (overlay)
@@ -420,6 +451,7 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
     overlay->m_y = ((float)videoHeight - targetHeight) / 2 / videoHeight;
   }
   m_textureCache[m_textureid] = overlay;
+  m_quadsCache[m_textureid] = quads;
   o->m_textureid = m_textureid;
   m_textureid++;
   return overlay;
@@ -13,6 +13,8 @@
 #include "threads/CriticalSection.h"
 
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 class CDVDOverlay;
@@ -22,6 +24,9 @@ class CDVDOverlaySSA;
 
 namespace OVERLAY {
 
+  class CPrerendererSSA;
+  struct SQuads;
+
   struct SRenderState
   {
     float x;
@@ -77,6 +82,12 @@ namespace OVERLAY {
     void SetVideoRect(CRect &source, CRect &dest, CRect &view);
     void SetStereoMode(const std::string &stereomode);
 
+    /*!
+     \brief Statistics of the ASS subtitle pre-rendering for the debug overlay.
+     \return empty if no ASS subtitles are shown
+     */
+    std::string GetDebugInfo();
+
   protected:
 
     struct SElement
@@ -101,6 +112,8 @@ namespace OVERLAY {
     CCriticalSection m_section;
     std::vector<SElement> m_buffers[NUM_BUFFERS];
     std::map<unsigned int, COverlay*> m_textureCache;
+    std::map<unsigned int, std::shared_ptr<const SQuads>> m_quadsCache; // ASS quads per texture
+    std::unique_ptr<CPrerendererSSA> m_prerendererSSA;
     static unsigned int m_textureid;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
@@ -19,11 +19,13 @@ typedef struct ass_image ASS_Image;
 
 namespace OVERLAY {
 
+  struct SQuads;
+
   class COverlayQuadsDX
     : public COverlay
   {
   public:
-    COverlayQuadsDX(ASS_Image* images, int width, int height);
+    COverlayQuadsDX(const SQuads& quads, int width, int height);
     virtual ~COverlayQuadsDX();
 
     void Render(SRenderState& state);
@@ -21,6 +21,8 @@ typedef struct ass_image ASS_Image;
 
 namespace OVERLAY {
 
+  struct SQuads;
+
   class COverlayTextureGL : public COverlay
   {
   public:
@@ -39,7 +41,7 @@ namespace OVERLAY {
   class COverlayGlyphGL : public COverlay
   {
   public:
-   COverlayGlyphGL(ASS_Image* images, int width, int height);
+   COverlayGlyphGL(const SQuads& quads, int width, int height);
 
    ~COverlayGlyphGL() override;
 
@@ -41,6 +41,8 @@ namespace OVERLAY {
       free(data);
       free(quad);
     }
+    SQuads(const SQuads&) = delete;
+    SQuads& operator=(const SQuads&) = delete;
     int      size_x;
     int      size_y;
     int      count;
@@ -21,6 +21,7 @@
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StringUtils.h"
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
@@ -169,6 +170,7 @@ bool CRenderManager::Configure(const VideoPicture& picture, float fps, unsigned
 bool CRenderManager::Configure()
 {
   // lock all interfaces
+  CSingleLock lock0(m_preparelock);
   CSingleLock lock(m_statelock);
   CSingleLock lock2(m_presentlock);
   CSingleLock lock3(m_datalock);
@@ -281,6 +283,7 @@ bool CRenderManager::IsPresenting()
 
 void CRenderManager::FrameMove()
 {
+  CPerformanceTraceSpan span("Render::FrameMove");
   bool firstFrame = false;
   UpdateResolution();
 
@@ -393,6 +396,7 @@ void CRenderManager::UnInit()
     }
   }
 
+  CSingleLock lock0(m_preparelock);
   CSingleLock lock(m_statelock);
 
   m_overlays.Flush();
@@ -420,6 +424,7 @@ bool CRenderManager::Flush(bool wait, bool saveBuffers)
 
     CSingleExit exitlock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
+    CSingleLock lock0(m_preparelock);
     CSingleLock lock(m_statelock);
     CSingleLock lock2(m_presentlock);
     CSingleLock lock3(m_datalock);
@@ -688,6 +693,7 @@ RESOLUTION CRenderManager::GetResolution()
 
 void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 {
+  CPerformanceTraceSpan span("Render::Render");
   CSingleExit exitLock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
   {
@@ -748,6 +754,8 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
                                             refreshrate, missedvblanks, clockspeed * 100);
         }
 
+        info.subtitles = m_overlays.GetDebugInfo();
+
         m_debugRenderer.SetInfo(info);
       }
 
@@ -922,12 +930,29 @@ void CRenderManager::ToggleDebugVideo()
 
 bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::atomic_bool& bStop, EINTERLACEMETHOD deintMethod, bool wait)
 {
+  int index;
+  {
+    CSingleLock lock(m_presentlock);
+    if (m_free.empty())
+      return false;
+    index = m_free.front();
+  }
+
+  // copy the picture without holding the locks the render thread waits for
+  {
+    CSingleLock lock(m_preparelock);
+    if (!m_pRenderer)
+      return false;
+
+    m_pRenderer->PrepareVideoPicture(picture, index);
+  }
+
   CSingleLock lock(m_presentlock);
 
+  // buffers flushed in the meantime, the renderer copies the picture when it uploads it then
   if (m_free.empty())
     return false;
-
-  int index = m_free.front();
+  index = m_free.front();
 
   {
     CSingleLock lock(m_datalock);
@@ -1103,6 +1128,9 @@ void CRenderManager::PrepareNextRender()
   if (!m_showVideo && !m_forceNext)
     return;
 
+  CPerformanceTraceSpan span("Render::PrepareNextRender");
+  CPerformanceTrace::AddCounter("Render::Queued", m_queued.size());
+
   double frameOnScreen = m_dvdClock.GetClock();
   double frametime = 1.0 /
                      static_cast<double>(CServiceBroker::GetWinSystem()->GetGfxContext().GetFPS()) *
@@ -1146,6 +1174,7 @@ void CRenderManager::PrepareNextRender()
              "forceNext: {}",
              frameOnScreen, renderPts, nextFramePts, (renderPts - nextFramePts),
              renderPts >= nextFramePts, m_forceNext);
+  CPerformanceTrace::AddCounter("Render::PresentError", (renderPts - nextFramePts) / 1000);
 
   bool combined = false;
   if (m_presentsourcePast >= 0)
@@ -1181,6 +1210,7 @@ void CRenderManager::PrepareNextRender()
       {
         m_discard.push_back(m_presentsourcePast);
         m_QueueSkip++;
+        CPerformanceTrace::AddInstant("Render::SkippedLate");
       }
       m_presentsourcePast = m_queued.front();
       m_queued.pop_front();
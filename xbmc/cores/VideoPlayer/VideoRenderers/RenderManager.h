@@ -138,6 +138,7 @@ protected:
   mutable CCriticalSection m_statelock;
   CCriticalSection m_presentlock;
   CCriticalSection m_datalock;
+  CCriticalSection m_preparelock; // keeps the renderer while a picture is copied into it
   bool m_bTriggerUpdateResolution = false;
   bool m_bRenderGUI = true;
   bool m_renderedOverlay = false;
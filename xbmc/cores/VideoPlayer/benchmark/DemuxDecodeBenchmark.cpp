@@ -0,0 +1,470 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxDecodeBenchmark.h"
+
+#include "DVDCodecs/Audio/DVDAudioCodec.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "DVDStreamInfo.h"
+#include "FileItem.h"
+#include "Process/ProcessInfo.h"
+#include "URL.h"
+#include "cores/AudioEngine/Utils/AEStreamInfo.h"
+#include "filesystem/File.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+using namespace std::chrono;
+
+void CLatencyHistogram::Add(nanoseconds latency)
+{
+  const uint64_t us = static_cast<uint64_t>(duration_cast<microseconds>(latency).count());
+  size_t bucket = 0;
+  while (bucket < BUCKETS - 1 && (us >> bucket) > 0)
+    bucket++;
+
+  m_buckets[bucket]++;
+  m_count++;
+  m_total += latency;
+  m_max = std::max(m_max, latency);
+}
+
+double CLatencyHistogram::MeanUs() const
+{
+  if (m_count == 0)
+    return 0.0;
+  return m_total.count() / 1000.0 / m_count;
+}
+
+double CLatencyHistogram::PercentileUs(double percentile) const
+{
+  if (m_count == 0)
+    return 0.0;
+
+  const double target = m_count * percentile / 100.0;
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < BUCKETS - 1; bucket++)
+  {
+    seen += m_buckets[bucket];
+    if (seen >= target)
+      return std::min(static_cast<double>(uint64_t(1) << bucket), MaxUs());
+  }
+  return MaxUs();
+}
+
+void CLatencyHistogram::ToVariant(CVariant& value) const
+{
+  value["count"] = m_count;
+  value["mean_us"] = MeanUs();
+  value["p50_us"] = PercentileUs(50);
+  value["p90_us"] = PercentileUs(90);
+  value["p99_us"] = PercentileUs(99);
+  value["max_us"] = MaxUs();
+
+  // bucket i counts latencies below 2^i microseconds that did not fit bucket i - 1
+  value["buckets"] = CVariant(CVariant::VariantTypeArray);
+  size_t last = BUCKETS;
+  while (last > 0 && m_buckets[last - 1] == 0)
+    last--;
+  for (size_t bucket = 0; bucket < last; bucket++)
+  {
+    CVariant entry;
+    entry["le_us"] = uint64_t(1) << bucket;
+    entry["count"] = m_buckets[bucket];
+    value["buckets"].push_back(entry);
+  }
+}
+
+double CDemuxDecodeBenchmark::Result::DemuxMBps() const
+{
+  const double seconds = duration_cast<duration<double>>(demuxTime).count();
+  if (seconds <= 0.0)
+    return 0.0;
+  return bytes / (1024.0 * 1024.0) / seconds;
+}
+
+void CDemuxDecodeBenchmark::Result::ToVariant(CVariant& value) const
+{
+  const double wallSeconds = duration_cast<duration<double>>(wallTime).count();
+
+  value["file"] = file;
+  value["packets"] = packets;
+  value["bytes"] = bytes;
+  value["demux_ms"] = duration_cast<duration<double, std::milli>>(demuxTime).count();
+  value["demux_mbps"] = DemuxMBps();
+  value["wall_ms"] = wallSeconds * 1000.0;
+  value["open_ms"] = duration_cast<duration<double, std::milli>>(openTime).count();
+  value["first_frame_ms"] = duration_cast<duration<double, std::milli>>(firstFrameTime).count();
+  value["probe_cached"] = probeCached;
+  value["allocations"] = allocations;
+  value["allocated_bytes"] = allocatedBytes;
+
+  value["streams"] = CVariant(CVariant::VariantTypeArray);
+  for (const auto& stream : streams)
+  {
+    const double decodeSeconds = duration_cast<duration<double>>(stream.decodeTime).count();
+
+    CVariant entry;
+    entry["id"] = stream.streamId;
+    entry["type"] = stream.type;
+    entry["codec"] = stream.codecName;
+    if (!stream.threading.empty())
+      entry["threading"] = stream.threading;
+    entry["packets"] = stream.packets;
+    entry["bytes"] = stream.bytes;
+    entry["frames"] = stream.frames;
+    entry["errors"] = stream.errors;
+    entry["decode_ms"] = decodeSeconds * 1000.0;
+    if (stream.type == "video")
+      entry["decode_fps"] = decodeSeconds > 0.0 ? stream.frames / decodeSeconds : 0.0;
+    else
+      entry["decode_samples_per_sec"] = decodeSeconds > 0.0 ? stream.frames / decodeSeconds : 0.0;
+    stream.packetLatency.ToVariant(entry["packet_latency"]);
+    value["streams"].push_back(entry);
+  }
+}
+
+namespace
+{
+
+struct StreamDecoder
+{
+  std::unique_ptr<CProcessInfo> processInfo;
+  std::unique_ptr<CDVDVideoCodec> videoCodec;
+  std::unique_ptr<CDVDAudioCodec> audioCodec;
+  VideoPicture picture;
+  DVDAudioFrame audioFrame = {};
+  size_t result = 0; //!< index into Result::streams
+};
+
+/*!
+ \brief Feed one packet to a video decoder and pull pictures until it wants more data.
+ \param packet the packet to decode, nullptr to drain the decoder at the end of the file
+ */
+void DecodeVideo(StreamDecoder& decoder,
+                 const DemuxPacket* packet,
+                 CDemuxDecodeBenchmark::StreamResult& result)
+{
+  CDVDVideoCodec& codec = *decoder.videoCodec;
+  if (!packet)
+    codec.SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+
+  // the decoder refuses packets while it still has output queued, retry once it is drained
+  bool added = !packet || codec.AddData(*packet);
+  while (true)
+  {
+    const CDVDVideoCodec::VCReturn ret = codec.GetPicture(&decoder.picture);
+    if (ret == CDVDVideoCodec::VC_PICTURE)
+    {
+      if (!(decoder.picture.iFlags & DVP_FLAG_DROPPED))
+        result.frames++;
+    }
+    else if (ret == CDVDVideoCodec::VC_NONE)
+      continue;
+    else if (ret == CDVDVideoCodec::VC_BUFFER)
+    {
+      if (added)
+        break;
+      added = codec.AddData(*packet);
+      if (!added)
+      {
+        result.errors++;
+        break;
+      }
+    }
+    else if (ret == CDVDVideoCodec::VC_FLUSHED)
+    {
+      codec.Reset();
+      break;
+    }
+    else if (ret == CDVDVideoCodec::VC_REOPEN)
+    {
+      // e.g. no hardware decoder was found, continue with the software decoder
+      codec.Reopen();
+      break;
+    }
+    else if (ret == CDVDVideoCodec::VC_FATAL)
+    {
+      result.errors++;
+      decoder.picture.Reset();
+      decoder.videoCodec.reset();
+      break;
+    }
+    else
+    {
+      if (ret != CDVDVideoCodec::VC_EOF)
+        result.errors++;
+      break;
+    }
+  }
+}
+
+/*!
+ \brief Feed one packet to an audio decoder and pull frames until it is empty.
+ \param packet the packet to decode, nullptr to collect remaining output
+ */
+void DecodeAudio(StreamDecoder& decoder,
+                 const DemuxPacket* packet,
+                 CDemuxDecodeBenchmark::StreamResult& result)
+{
+  CDVDAudioCodec& codec = *decoder.audioCodec;
+
+  bool added = !packet || codec.AddData(*packet);
+  while (true)
+  {
+    decoder.audioFrame.hasDownmix = false;
+    codec.GetData(decoder.audioFrame);
+    if (decoder.audioFrame.nb_frames == 0)
+    {
+      if (added)
+        break;
+      added = codec.AddData(*packet);
+      if (!added)
+      {
+        result.errors++;
+        break;
+      }
+      continue;
+    }
+    result.frames += decoder.audioFrame.nb_frames;
+    decoder.audioFrame.framesOut = decoder.audioFrame.nb_frames;
+  }
+}
+
+bool HasProbeCache(int idFile, int64_t fileSize)
+{
+  CVideoDatabase db;
+  if (!db.Open())
+    return false;
+
+  std::string probe;
+  std::string seekIndex;
+  const bool cached = db.GetDemuxCache(idFile, fileSize, probe, seekIndex);
+  db.Close();
+  return cached;
+}
+
+} // namespace
+
+bool CDemuxDecodeBenchmark::Run(const std::string& path, Result& result)
+{
+  const std::string redactPath = CURL::GetRedacted(path);
+
+  result = Result();
+  result.file = redactPath;
+
+  // the file id the player takes from the library item, looked up outside of the measurement
+  int idFile = -1;
+  int64_t fileSize = 0;
+  if (m_probeCache)
+  {
+    CVideoDatabase db;
+    if (db.Open())
+    {
+      idFile = db.AddFile(path);
+      db.Close();
+    }
+    if (idFile <= 0)
+    {
+      CLog::Log(LOGERROR, "{} - unable to add {} to the video database", __FUNCTION__,
+                redactPath);
+      return false;
+    }
+    struct __stat64 st = {};
+    if (XFILE::CFile::Stat(path, &st) == 0)
+      fileSize = st.st_size;
+    result.probeCached = HasProbeCache(idFile, fileSize);
+  }
+
+  uint64_t allocationsStart = 0;
+  uint64_t allocatedBytesStart = 0;
+  if (m_allocationCounter)
+    m_allocationCounter(allocationsStart, allocatedBytesStart);
+  const auto start = steady_clock::now();
+
+  CFileItem item(path, false);
+  item.SetMimeTypeForInternetFile();
+  auto inputStream = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+  if (!inputStream || !inputStream->Open())
+  {
+    CLog::Log(LOGERROR, "{} - unable to open input stream for {}", __FUNCTION__, redactPath);
+    return false;
+  }
+
+  std::unique_ptr<CDVDDemux> demuxer;
+  try
+  {
+    demuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(inputStream, !m_probeCache, false, idFile));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - exception thrown when opening demuxer for {}", __FUNCTION__,
+              redactPath);
+  }
+  if (!demuxer)
+  {
+    CLog::Log(LOGERROR, "{} - unable to create demuxer for {}", __FUNCTION__, redactPath);
+    return false;
+  }
+  result.openTime = steady_clock::now() - start;
+
+  std::map<std::pair<int64_t, int>, std::unique_ptr<StreamDecoder>> decoders;
+  for (CDemuxStream* stream : demuxer->GetStreams())
+  {
+    if (!stream)
+      continue;
+
+    const bool isVideo = stream->type == STREAM_VIDEO && !(stream->flags & AV_DISPOSITION_ATTACHED_PIC);
+    const bool isAudio = stream->type == STREAM_AUDIO;
+    if (!(isVideo && m_decodeVideo) && !(isAudio && m_decodeAudio))
+    {
+      demuxer->EnableStream(stream->demuxerId, stream->uniqueId, false);
+      continue;
+    }
+
+    auto decoder = std::make_unique<StreamDecoder>();
+    decoder->processInfo.reset(CProcessInfo::CreateInstance());
+
+    CDVDStreamInfo hint(*stream, true);
+    if (isVideo)
+    {
+      if (!m_threaded)
+        hint.codecOptions = CODEC_FORCE_SOFTWARE;
+      decoder->videoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *decoder->processInfo);
+    }
+    else
+    {
+      decoder->audioCodec = CDVDFactoryCodec::CreateAudioCodec(
+          hint, *decoder->processInfo, false, false, CAEStreamInfo::STREAM_TYPE_NULL);
+    }
+
+    if (!decoder->videoCodec && !decoder->audioCodec)
+    {
+      CLog::Log(LOGWARNING, "{} - no decoder for stream {} ({}) in {}", __FUNCTION__,
+                stream->uniqueId, demuxer->GetStreamCodecName(stream->demuxerId, stream->uniqueId),
+                redactPath);
+      demuxer->EnableStream(stream->demuxerId, stream->uniqueId, false);
+      continue;
+    }
+
+    StreamResult streamResult;
+    streamResult.streamId = stream->uniqueId;
+    streamResult.type = isVideo ? "video" : "audio";
+    streamResult.codecName =
+        isVideo ? decoder->videoCodec->GetName() : decoder->audioCodec->GetName();
+    decoder->result = result.streams.size();
+    result.streams.push_back(streamResult);
+
+    decoders.emplace(std::make_pair(stream->demuxerId, stream->uniqueId), std::move(decoder));
+  }
+
+  if (decoders.empty())
+  {
+    CLog::Log(LOGERROR, "{} - no decodable streams in {}", __FUNCTION__, redactPath);
+    return false;
+  }
+
+  // the demuxer may return no packet without being at the end, e.g. after a read error
+  constexpr int MAX_EMPTY_READS = 100;
+  int emptyReads = 0;
+  while (true)
+  {
+    const auto demuxStart = steady_clock::now();
+    DemuxPacket* packet = demuxer->Read();
+    result.demuxTime += steady_clock::now() - demuxStart;
+
+    if (!packet)
+    {
+      if (inputStream->IsEOF() || ++emptyReads > MAX_EMPTY_READS)
+        break;
+      continue;
+    }
+    emptyReads = 0;
+
+    result.packets++;
+    result.bytes += packet->iSize;
+
+    auto it = decoders.find(std::make_pair(packet->demuxerId, packet->iStreamId));
+    if (it == decoders.end() || (!it->second->videoCodec && !it->second->audioCodec))
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      continue;
+    }
+
+    StreamDecoder& decoder = *it->second;
+    StreamResult& streamResult = result.streams[decoder.result];
+    streamResult.packets++;
+    streamResult.bytes += packet->iSize;
+
+    const auto decodeStart = steady_clock::now();
+    if (decoder.videoCodec)
+      DecodeVideo(decoder, packet, streamResult);
+    else
+      DecodeAudio(decoder, packet, streamResult);
+    const nanoseconds latency = steady_clock::now() - decodeStart;
+
+    streamResult.decodeTime += latency;
+    streamResult.packetLatency.Add(latency);
+    if (result.firstFrameTime.count() == 0 && streamResult.frames > 0)
+      result.firstFrameTime = steady_clock::now() - start;
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  for (auto& it : decoders)
+  {
+    StreamDecoder& decoder = *it.second;
+    StreamResult& streamResult = result.streams[decoder.result];
+
+    const auto decodeStart = steady_clock::now();
+    if (decoder.videoCodec)
+      DecodeVideo(decoder, nullptr, streamResult);
+    else if (decoder.audioCodec)
+      DecodeAudio(decoder, nullptr, streamResult);
+    streamResult.decodeTime += steady_clock::now() - decodeStart;
+
+    decoder.picture.Reset();
+    if (decoder.videoCodec)
+      streamResult.threading = decoder.processInfo->GetVideoDecoderThreading();
+  }
+
+  if (m_allocationCounter)
+  {
+    m_allocationCounter(result.allocations, result.allocatedBytes);
+    result.allocations -= allocationsStart;
+    result.allocatedBytes -= allocatedBytesStart;
+  }
+  result.wallTime = steady_clock::now() - start;
+
+  // the cache is saved by a job when the demuxer is destroyed, wait for it so the next run of
+  // the file opens from the cache
+  if (m_probeCache && !result.probeCached)
+  {
+    demuxer.reset();
+    for (int i = 0; i < 100 && !HasProbeCache(idFile, fileSize); i++)
+      std::this_thread::sleep_for(milliseconds(20));
+  }
+
+  return true;
+}
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class CVariant;
+
+/*!
+ \brief Histogram of latencies in power of two microsecond buckets.
+ */
+class CLatencyHistogram
+{
+public:
+  static constexpr size_t BUCKETS = 24; //!< the last bucket holds everything >= 2^22 us
+
+  void Add(std::chrono::nanoseconds latency);
+
+  uint64_t Count() const { return m_count; }
+  double MeanUs() const;
+  double MaxUs() const { return m_max.count() / 1000.0; }
+
+  /*!
+   \brief Estimate a percentile from the buckets.
+   \param percentile in the range [0, 100]
+   \return the upper bound in microseconds of the bucket holding the percentile
+   */
+  double PercentileUs(double percentile) const;
+
+  void ToVariant(CVariant& value) const;
+
+private:
+  std::array<uint64_t, BUCKETS> m_buckets{};
+  uint64_t m_count = 0;
+  std::chrono::nanoseconds m_total{0};
+  std::chrono::nanoseconds m_max{0};
+};
+
+/*!
+ \brief Demux and decode a file through the VideoPlayer factories as fast as possible.
+
+ Streams are opened with CDVDFactoryInputStream and CDVDFactoryDemuxer and every selected
+ audio and video stream is decoded by the codec CDVDFactoryCodec picks for it, forcing
+ software video decoding unless threaded decoding is requested. Nothing is rendered or output, so this runs without a window
+ system and measures the demux and decode paths on their own.
+ */
+class CDemuxDecodeBenchmark
+{
+public:
+  struct StreamResult
+  {
+    int streamId = -1;
+    std::string type;
+    std::string codecName;
+    std::string threading; //!< video decoder threading as reported to the process info
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t frames = 0; //!< decoded pictures for video, sample frames for audio
+    uint64_t errors = 0;
+    std::chrono::nanoseconds decodeTime{0};
+    CLatencyHistogram packetLatency; //!< time from AddData until the decoder wants more data
+  };
+
+  struct Result
+  {
+    std::string file;
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    std::chrono::nanoseconds demuxTime{0};
+    std::chrono::nanoseconds wallTime{0};
+    std::chrono::nanoseconds openTime{0}; //!< opening the input and the demuxer
+    std::chrono::nanoseconds firstFrameTime{0}; //!< until the first decoded picture or samples
+    bool probeCached = false; //!< the demuxer was opened from the probe cache
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    std::vector<StreamResult> streams;
+
+    double DemuxMBps() const;
+    void ToVariant(CVariant& value) const;
+  };
+
+  /*!
+   \brief Source of the allocation counters included in the result, the running totals
+   of allocations and allocated bytes.
+   */
+  using AllocationCounter = std::function<void(uint64_t& allocations, uint64_t& bytes)>;
+
+  CDemuxDecodeBenchmark() = default;
+
+  void SetDecodeVideo(bool decode) { m_decodeVideo = decode; }
+  void SetDecodeAudio(bool decode) { m_decodeAudio = decode; }
+
+  /*!
+   \brief Open video decoders like the player does instead of forcing single threaded
+   software decoding, so the threading policy applies.
+   */
+  void SetThreaded(bool threaded) { m_threaded = threaded; }
+  void SetAllocationCounter(AllocationCounter counter) { m_allocationCounter = std::move(counter); }
+
+  /*!
+   \brief Open the demuxer for playback with the probe cache like the player does for library
+   files, see CDemuxProbeCache. Files are added to the video database, so a repeated run of a
+   file opens from the cache the previous run stored.
+   */
+  void SetProbeCache(bool probeCache) { m_probeCache = probeCache; }
+
+  /*!
+   \brief Demux and decode the whole file.
+   \param path the file to read, any path the VFS can open
+   \param result the measurements, only valid if true is returned
+   \return true if the file could be opened and at least one stream decoded
+   */
+  bool Run(const std::string& path, Result& result);
+
+private:
+  bool m_decodeVideo = true;
+  bool m_decodeAudio = true;
+  bool m_threaded = false;
+  bool m_probeCache = false;
+  AllocationCounter m_allocationCounter;
+};
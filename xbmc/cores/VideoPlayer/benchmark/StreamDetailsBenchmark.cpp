@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "StreamDetailsBenchmark.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "cores/VideoPlayer/DVDFileInfo.h"
+#include "filesystem/Directory.h"
+#include "threads/WorkerPool.h"
+#include "utils/FileExtensionProvider.h"
+#include "utils/Variant.h"
+#include "video/VideoInfoTag.h"
+
+#include <atomic>
+
+namespace
+{
+void CollectDirectory(const std::string& path,
+                      const std::string& extensions,
+                      std::vector<std::string>& files)
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(path, items, extensions, XFILE::DIR_FLAG_DEFAULTS))
+    return;
+
+  items.Sort(SortByFile, SortOrderAscending);
+  for (const auto& item : items)
+  {
+    if (item->m_bIsFolder)
+      CollectDirectory(item->GetPath(), extensions, files);
+    else
+      files.push_back(item->GetPath());
+  }
+}
+} // namespace
+
+double CStreamDetailsBenchmark::Result::FilesPerSecond() const
+{
+  const double seconds = std::chrono::duration<double>(wallTime).count();
+  return seconds > 0.0 ? files / seconds : 0.0;
+}
+
+void CStreamDetailsBenchmark::Result::ToVariant(CVariant& value) const
+{
+  value["files"] = files;
+  value["probed"] = probed;
+  value["wall_ms"] = std::chrono::duration<double, std::milli>(wallTime).count();
+  value["files_per_second"] = FilesPerSecond();
+}
+
+std::vector<std::string> CStreamDetailsBenchmark::CollectFiles(
+    const std::vector<std::string>& paths)
+{
+  const std::string extensions = CServiceBroker::GetFileExtensionProvider().GetVideoExtensions();
+
+  std::vector<std::string> files;
+  for (const auto& path : paths)
+  {
+    if (XFILE::CDirectory::Exists(path))
+      CollectDirectory(path, extensions, files);
+    else
+      files.push_back(path);
+  }
+  return files;
+}
+
+bool CStreamDetailsBenchmark::Run(const std::vector<std::string>& files, Result& result)
+{
+  result = Result();
+  result.files = files.size();
+
+  std::atomic<uint64_t> probed{0};
+  const bool probeOnly = !m_fullProbe;
+
+  const auto start = std::chrono::steady_clock::now();
+  CWorkerPool pool(m_threads, "StreamDetailsBench");
+  pool.ForEach(
+      files.size(),
+      [&files, &probed, probeOnly](size_t i) {
+        CFileItem item(files[i], false);
+        item.GetVideoInfoTag()->m_strFileNameAndPath = files[i];
+        if (CDVDFileInfo::GetFileStreamDetails(&item, probeOnly))
+          probed.fetch_add(1, std::memory_order_relaxed);
+      });
+  result.wallTime = std::chrono::steady_clock::now() - start;
+  result.probed = probed.load();
+
+  return result.probed > 0;
+}
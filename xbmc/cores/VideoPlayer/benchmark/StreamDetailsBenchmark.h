@@ -0,0 +1,61 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CVariant;
+
+/*!
+ \brief Probe the stream details of many files like the video library scanner does.
+
+ Every file goes through CDVDFileInfo::GetFileStreamDetails on a CWorkerPool, so the
+ result is the files per second a library scan reaches for the stream details alone.
+ */
+class CStreamDetailsBenchmark
+{
+public:
+  struct Result
+  {
+    uint64_t files = 0;
+    uint64_t probed = 0; //!< files stream details were found for
+    std::chrono::nanoseconds wallTime{0};
+
+    double FilesPerSecond() const;
+    void ToVariant(CVariant& value) const;
+  };
+
+  CStreamDetailsBenchmark() = default;
+
+  void SetThreads(unsigned int threads) { m_threads = threads; }
+
+  /*!
+   \brief Run avformat_find_stream_info on every file instead of taking the streams from
+   the container headers, as done for playback.
+   */
+  void SetFullProbe(bool fullProbe) { m_fullProbe = fullProbe; }
+
+  /*!
+   \brief Expand directories to the video files below them, files are kept as they are.
+   */
+  static std::vector<std::string> CollectFiles(const std::vector<std::string>& paths);
+
+  /*!
+   \brief Probe the stream details of all files.
+   \return true if the details of at least one file were found
+   */
+  bool Run(const std::vector<std::string>& files, Result& result);
+
+private:
+  unsigned int m_threads = 4;
+  bool m_fullProbe = false;
+};
@@ -0,0 +1,320 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+/*!
+ \file vpbench.cpp
+ \brief Headless VideoPlayer demux/decode benchmark.
+
+ Usage: kodi-vpbench [--json] [--video-only|--audio-only] [--threaded] [--probe-cache]
+                    [--repeat N] FILE...
+        kodi-vpbench --stream-details [--json] [--threads N] [--full-probe] PATH...
+
+ Every file is demuxed and decoded as fast as possible without any render or audio output.
+ The report lists demux throughput, decoded frames per second, per-packet decode latency
+ histograms and heap allocations per file. With --json a single JSON document is written
+ to stdout for the build farm to collect.
+
+ With --probe-cache the files are opened for playback through the demux probe cache of a
+ temporary video database, so the first run of a file fills the cache and repeated runs
+ (--repeat) measure the cached open.
+
+ With --stream-details the stream details of all video files in the given paths are probed
+ like during a library scan instead, reporting files per second.
+ */
+
+#include "DatabaseManager.h"
+#include "DemuxDecodeBenchmark.h"
+#include "ServiceBroker.h"
+#include "StreamDetailsBenchmark.h"
+#include "settings/SettingsComponent.h"
+#include "test/TestBasicEnvironment.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_allocatedBytes{0};
+
+void* CountedAlloc(std::size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+
+void PrintUsage(const char* name)
+{
+  fprintf(stderr,
+          "Usage: %s [--json] [--video-only|--audio-only] [--threaded] [--probe-cache]\n"
+          "          [--repeat N] FILE...\n"
+          "  --json        write the results as JSON to stdout\n"
+          "  --video-only  only decode video streams\n"
+          "  --audio-only  only decode audio streams\n"
+          "  --threaded    let the threading policy set up video decoders like in the player\n"
+          "  --probe-cache open through the probe cache, repeated runs open from the cache\n"
+          "  --repeat N    run every file N times\n"
+          "\n"
+          "       %s --stream-details [--json] [--threads N] [--full-probe] PATH...\n"
+          "  --threads N   probe N files at a time\n"
+          "  --full-probe  probe the streams like for playback instead of from the headers\n",
+          name, name);
+}
+
+int RunStreamDetails(const std::vector<std::string>& paths,
+                     bool json,
+                     unsigned int threads,
+                     bool fullProbe,
+                     int repeat)
+{
+  const std::vector<std::string> files = CStreamDetailsBenchmark::CollectFiles(paths);
+  if (files.empty())
+  {
+    fprintf(stderr, "No video files found\n");
+    return EXIT_FAILURE;
+  }
+
+  CStreamDetailsBenchmark benchmark;
+  benchmark.SetThreads(threads);
+  benchmark.SetFullProbe(fullProbe);
+
+  int failed = 0;
+  CVariant report(CVariant::VariantTypeArray);
+  for (int run = 0; run < repeat; run++)
+  {
+    CStreamDetailsBenchmark::Result result;
+    if (!benchmark.Run(files, result))
+      failed++;
+
+    if (json)
+    {
+      CVariant entry;
+      result.ToVariant(entry);
+      entry["threads"] = threads;
+      entry["full_probe"] = fullProbe;
+      report.push_back(entry);
+    }
+    else
+      printf("stream details: %llu files, %llu probed in %.1f ms, %.1f files/s\n",
+             static_cast<unsigned long long>(result.files),
+             static_cast<unsigned long long>(result.probed),
+             std::chrono::duration<double, std::milli>(result.wallTime).count(),
+             result.FilesPerSecond());
+  }
+
+  if (json)
+  {
+    std::string output;
+    CJSONVariantWriter::Write(report, output, false);
+    printf("%s\n", output.c_str());
+  }
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+void PrintResult(const CDemuxDecodeBenchmark::Result& result)
+{
+  printf("%s\n", result.file.c_str());
+  printf("  demux:       %llu packets, %.1f MB in %.1f ms, %.1f MB/s\n",
+         static_cast<unsigned long long>(result.packets), result.bytes / (1024.0 * 1024.0),
+         std::chrono::duration<double, std::milli>(result.demuxTime).count(), result.DemuxMBps());
+  printf("  open:        %.1f ms%s, first frame after %.1f ms\n",
+         std::chrono::duration<double, std::milli>(result.openTime).count(),
+         result.probeCached ? " from the probe cache" : "",
+         std::chrono::duration<double, std::milli>(result.firstFrameTime).count());
+  printf("  total:       %.1f ms, %llu allocations, %.1f MB allocated\n",
+         std::chrono::duration<double, std::milli>(result.wallTime).count(),
+         static_cast<unsigned long long>(result.allocations),
+         result.allocatedBytes / (1024.0 * 1024.0));
+
+  for (const auto& stream : result.streams)
+  {
+    const double seconds = std::chrono::duration<double>(stream.decodeTime).count();
+    const double rate = seconds > 0.0 ? stream.frames / seconds : 0.0;
+    const auto& latency = stream.packetLatency;
+    printf("  %s #%d (%s): %llu packets, %llu %s in %.1f ms, %.1f %s, %llu errors\n",
+           stream.type.c_str(), stream.streamId, stream.codecName.c_str(),
+           static_cast<unsigned long long>(stream.packets),
+           static_cast<unsigned long long>(stream.frames),
+           stream.type == "video" ? "frames" : "samples", seconds * 1000.0, rate,
+           stream.type == "video" ? "fps" : "samples/s",
+           static_cast<unsigned long long>(stream.errors));
+    if (!stream.threading.empty())
+      printf("    threading: %s\n", stream.threading.c_str());
+    printf("    packet latency us: mean %.1f p50 %.0f p90 %.0f p99 %.0f max %.1f\n",
+           latency.MeanUs(), latency.PercentileUs(50), latency.PercentileUs(90),
+           latency.PercentileUs(99), latency.MaxUs());
+  }
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  void* p = CountedAlloc(size);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t size)
+{
+  void* p = CountedAlloc(size);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return CountedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return CountedAlloc(size);
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+int main(int argc, char** argv)
+{
+  bool json = false;
+  bool decodeVideo = true;
+  bool decodeAudio = true;
+  bool threaded = false;
+  bool probeCache = false;
+  bool streamDetails = false;
+  bool fullProbe = false;
+  unsigned int threads = 4;
+  int repeat = 1;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--json")
+      json = true;
+    else if (arg == "--video-only")
+      decodeAudio = false;
+    else if (arg == "--audio-only")
+      decodeVideo = false;
+    else if (arg == "--threaded")
+      threaded = true;
+    else if (arg == "--probe-cache")
+      probeCache = true;
+    else if (arg == "--stream-details")
+      streamDetails = true;
+    else if (arg == "--full-probe")
+      fullProbe = true;
+    else if (arg == "--threads" && i + 1 < argc)
+      threads = static_cast<unsigned int>(std::max(1, atoi(argv[++i])));
+    else if (arg == "--repeat" && i + 1 < argc)
+      repeat = std::max(1, atoi(argv[++i]));
+    else if (StringUtils::StartsWith(arg, "--"))
+    {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    else
+      files.push_back(arg);
+  }
+
+  if (files.empty() || (!decodeVideo && !decodeAudio))
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // settings, VFS and add-ons are set up the same way as for the unit tests
+  TestBasicEnvironment environment;
+  environment.SetUp();
+
+  if (streamDetails)
+  {
+    const int ret = RunStreamDetails(files, json, threads, fullProbe, repeat);
+    environment.TearDown();
+    return ret;
+  }
+
+  CDemuxDecodeBenchmark benchmark;
+  benchmark.SetDecodeVideo(decodeVideo);
+  benchmark.SetDecodeAudio(decodeAudio);
+  benchmark.SetThreaded(threaded);
+  benchmark.SetProbeCache(probeCache);
+  // creates the databases in the temporary profile of the environment
+  if (probeCache)
+    CServiceBroker::GetDatabaseManager().Initialize();
+  benchmark.SetAllocationCounter([](uint64_t& allocations, uint64_t& bytes) {
+    allocations = g_allocations.load(std::memory_order_relaxed);
+    bytes = g_allocatedBytes.load(std::memory_order_relaxed);
+  });
+
+  int failed = 0;
+  CVariant report(CVariant::VariantTypeArray);
+  for (const auto& file : files)
+  {
+    for (int run = 0; run < repeat; run++)
+    {
+      CDemuxDecodeBenchmark::Result result;
+      if (!benchmark.Run(file, result))
+      {
+        fprintf(stderr, "Unable to demux and decode %s\n", file.c_str());
+        failed++;
+        break;
+      }
+
+      if (json)
+      {
+        CVariant entry;
+        result.ToVariant(entry);
+        report.push_back(entry);
+      }
+      else
+        PrintResult(result);
+    }
+  }
+
+  if (json)
+  {
+    std::string output;
+    CJSONVariantWriter::Write(report, output, false);
+    printf("%s\n", output.c_str());
+  }
+
+  environment.TearDown();
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -11,6 +11,7 @@
 #include "filesystem/SpecialProtocol.h"
 #include "profiles/ProfileManager.h"
 #include "settings/SettingsComponent.h"
+#include "utils/DatabaseUtils.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
@@ -27,6 +28,8 @@
 #include "platform/posix/ConvUtils.h"
 #endif
 
+#include <algorithm>
+
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
@@ -499,6 +502,47 @@ size_t CDatabase::GetDeleteQueriesCount()
   return m_pDS->delete_sql_count();
 }
 
+bool CDatabase::CommitQueuedQueries()
+{
+  if (!m_bMultiDelete && !m_bMultiInsert)
+    return true;
+
+  bool bReturn = true;
+
+  // the datasets must not commit on their own, both queues go into our transaction
+  m_pDS->set_autocommit(false);
+  m_pDS2->set_autocommit(false);
+
+  BeginTransaction();
+  try
+  {
+    if (m_bMultiDelete)
+    {
+      m_pDS->del();
+      m_pDS->deletion();
+    }
+    if (m_bMultiInsert)
+      m_pDS2->post();
+
+    bReturn = CommitTransaction();
+  }
+  catch (...)
+  {
+    RollbackTransaction();
+    bReturn = false;
+    CLog::Log(LOGERROR, "{} - failed to execute queries", __FUNCTION__);
+  }
+
+  m_bMultiDelete = false;
+  m_bMultiInsert = false;
+  m_pDS->clear_delete_sql();
+  m_pDS2->clear_insert_sql();
+  m_pDS->set_autocommit(true);
+  m_pDS2->set_autocommit(true);
+
+  return bReturn;
+}
+
 bool CDatabase::Open()
 {
   DatabaseSettings db_fallback;
@@ -654,6 +698,105 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
   return true;
 }
 
+void CDatabase::CreateFullTextIndex(const std::string& index,
+                                    const std::string& table,
+                                    const std::string& key,
+                                    const std::vector<std::string>& columns)
+{
+  m_fullTextIndexes.erase(index);
+
+  if (!m_sqlite || columns.empty())
+    return;
+
+  if (GetSingleValueInt("SELECT sqlite_compileoption_used('ENABLE_FTS5')") <= 0)
+  {
+    CLog::Log(LOGINFO, "{} - SQLite without FTS5, not creating {}", __FUNCTION__, index);
+    return;
+  }
+
+  CLog::Log(LOGINFO, "{} - creating full text index {}", __FUNCTION__, index);
+
+  const std::string cols = StringUtils::Join(columns, ", ");
+  std::string newValues;
+  std::string oldValues;
+  for (const auto& column : columns)
+  {
+    newValues += ", NEW." + column;
+    oldValues += ", OLD." + column;
+  }
+
+  // the index is derived data, drop and rebuild it from the content table
+  m_pDS->exec("DROP TABLE IF EXISTS " + index);
+  m_pDS->exec(PrepareSQL("CREATE VIRTUAL TABLE %s USING fts5(%s, content='%s', content_rowid='%s', "
+                         "tokenize='unicode61 remove_diacritics 2', prefix='2 3')",
+                         index.c_str(), cols.c_str(), table.c_str(), key.c_str()));
+  m_pDS->exec("INSERT INTO " + index + "(" + index + ") VALUES('rebuild')");
+
+  const std::string insert = "INSERT INTO " + index + "(rowid, " + cols + ") VALUES (NEW." + key +
+                             newValues + ");";
+  const std::string remove = "INSERT INTO " + index + "(" + index + ", rowid, " + cols +
+                             ") VALUES ('delete', OLD." + key + oldValues + ");";
+
+  m_pDS->exec("CREATE TRIGGER tgrInsert_" + index + " AFTER INSERT ON " + table +
+              " FOR EACH ROW BEGIN " + insert + " END");
+  m_pDS->exec("CREATE TRIGGER tgrDelete_" + index + " AFTER DELETE ON " + table +
+              " FOR EACH ROW BEGIN " + remove + " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdate_" + index + " AFTER UPDATE OF " + cols + " ON " + table +
+              " FOR EACH ROW BEGIN " + remove + " " + insert + " END");
+}
+
+bool CDatabase::HasFullTextIndex(const std::string& index) const
+{
+  if (!m_sqlite || !m_pDB)
+    return false;
+
+  auto it = m_fullTextIndexes.find(index);
+  if (it != m_fullTextIndexes.end())
+    return it->second;
+
+  // the index may be missing if the database was created by an SQLite without FTS5
+  // use a dataset of its own, callers may be iterating over m_pDS or m_pDS2
+  bool exists = false;
+  try
+  {
+    std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    exists = pDS->query(PrepareSQL("SELECT COUNT(1) FROM sqlite_master "
+                                   "WHERE type = 'table' AND name = '%s'",
+                                   index.c_str())) &&
+             pDS->num_rows() > 0 && pDS->fv(0).get_asInt() > 0;
+    pDS->close();
+
+    exists = exists && pDS->query("SELECT sqlite_compileoption_used('ENABLE_FTS5')") &&
+             pDS->num_rows() > 0 && pDS->fv(0).get_asInt() > 0;
+    pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed to check for full text index {}", __FUNCTION__, index);
+    exists = false;
+  }
+
+  m_fullTextIndexes.emplace(index, exists);
+  return exists;
+}
+
+std::string CDatabase::PrepareFullTextCondition(const std::string& index,
+                                                const std::string& key,
+                                                const std::vector<std::string>& columns,
+                                                const std::string& search,
+                                                bool anchorStart /* = false */) const
+{
+  if (!HasFullTextIndex(index))
+    return "";
+
+  const std::string match = DatabaseUtils::BuildFullTextMatch(search, columns, anchorStart);
+  if (match.empty())
+    return "";
+
+  return PrepareSQL(key + " IN (SELECT rowid FROM %s WHERE %s MATCH '%s')", index.c_str(),
+                    index.c_str(), match.c_str());
+}
+
 int CDatabase::GetDBVersion()
 {
   m_pDS->query("SELECT idVersion FROM version\n");
@@ -680,6 +823,7 @@ void CDatabase::Close()
 
   m_openCount = 0;
   m_multipleExecute = false;
+  EndBulkWrite();
 
   if (nullptr == m_pDB)
     return;
@@ -738,7 +882,22 @@ void CDatabase::BeginTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return;
+
+    if (IsInBulkWrite())
+    {
+      // start the batch lazily, then nest the caller's transaction as a savepoint
+      if (!m_pDB->in_transaction())
+      {
+        m_pDB->start_transaction();
+        m_bulkWriteStart = std::chrono::steady_clock::now();
+        // other connections can't write until the batch is committed
+        CheckExternalChanges();
+      }
+      m_pDB->start_savepoint(StringUtils::Format("bulk{}", m_bulkWriteDepth++));
+    }
+    else
       m_pDB->start_transaction();
   }
   catch (...)
@@ -751,7 +910,21 @@ bool CDatabase::CommitTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return true;
+
+    if (IsInBulkWrite() && m_bulkWriteDepth > 0)
+    {
+      m_pDB->release_savepoint(StringUtils::Format("bulk{}", --m_bulkWriteDepth));
+      if (m_bulkWriteDepth == 0 &&
+          (++m_bulkWritePending >= m_bulkWriteBatchSize ||
+           std::chrono::steady_clock::now() - m_bulkWriteStart >= BULK_WRITE_MAX_DURATION))
+      {
+        m_pDB->commit_transaction();
+        m_bulkWritePending = 0;
+      }
+    }
+    else
       m_pDB->commit_transaction();
   }
   catch (...)
@@ -766,7 +939,16 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return;
+
+    // cached IDs may refer to rows that are gone now
+    ClearCachedIds();
+
+    // only undo the caller's changes, not the rest of the batch
+    if (IsInBulkWrite() && m_bulkWriteDepth > 0)
+      m_pDB->rollback_savepoint(StringUtils::Format("bulk{}", --m_bulkWriteDepth));
+    else
       m_pDB->rollback_transaction();
   }
   catch (...)
@@ -775,6 +957,141 @@ void CDatabase::RollbackTransaction()
   }
 }
 
+void CDatabase::BeginBulkWrite(unsigned int batchSize /* = BULK_WRITE_BATCH_SIZE */)
+{
+  if (IsInBulkWrite() || nullptr == m_pDB || m_pDB->in_transaction())
+    return;
+
+  m_bulkWriteBatchSize = std::max(batchSize, 1u);
+  m_bulkWritePending = 0;
+  m_bulkWriteDepth = 0;
+  m_idCaches.clear();
+  m_dataVersion = m_pDB->data_version();
+}
+
+bool CDatabase::EndBulkWrite()
+{
+  if (!IsInBulkWrite())
+    return true;
+
+  if (m_bulkWriteDepth > 0)
+    CLog::Log(LOGWARNING, "{} - {} transaction(s) still open, committing them", __FUNCTION__,
+              m_bulkWriteDepth);
+
+  m_bulkWriteBatchSize = 0;
+  m_bulkWritePending = 0;
+  m_bulkWriteDepth = 0;
+
+  LogCachedIdStats();
+  m_idCaches.clear();
+
+  if (nullptr == m_pDB || !m_pDB->in_transaction())
+    return true;
+
+  try
+  {
+    m_pDB->commit_transaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "database:endbulkwrite failed");
+    return false;
+  }
+  return true;
+}
+
+int CDatabase::GetCachedId(const std::string& cache, const std::string& key)
+{
+  if (!IsInBulkWrite() || nullptr == m_pDB)
+    return -1;
+
+  // inside a transaction the check was done when it started
+  if (!m_pDB->in_transaction())
+    CheckExternalChanges();
+
+  IdCache& idCache = m_idCaches[cache];
+  const auto it = idCache.ids.find(key);
+  if (it == idCache.ids.end())
+  {
+    idCache.misses++;
+    return -1;
+  }
+
+  idCache.hits++;
+  return it->second;
+}
+
+void CDatabase::SetCachedId(const std::string& cache, const std::string& key, int id)
+{
+  if (IsInBulkWrite() && id >= 0)
+    m_idCaches[cache].ids[key] = id;
+}
+
+void CDatabase::SetWriteAheadLog(bool enable)
+{
+  if (!m_sqlite || nullptr == m_pDS)
+    return;
+
+  try
+  {
+    // not changed (and not an error) while another connection uses the database
+    m_pDS->exec(enable ? "PRAGMA journal_mode=WAL" : "PRAGMA journal_mode=DELETE");
+  }
+  catch (...)
+  {
+    CLog::Log(LOGWARNING, "{} - unable to change the journal mode", __FUNCTION__);
+  }
+}
+
+void CDatabase::ClearCachedIds()
+{
+  // keep the statistics
+  for (auto& idCache : m_idCaches)
+    idCache.second.ids.clear();
+}
+
+void CDatabase::CheckExternalChanges()
+{
+  // without a data version (MySQL) we can't tell, assume the worst
+  const long dataVersion = m_pDB->data_version();
+  if (dataVersion < 0 || dataVersion != m_dataVersion)
+  {
+    ClearCachedIds();
+    m_dataVersion = dataVersion;
+  }
+}
+
+void CDatabase::LogCachedIdStats() const
+{
+  if (nullptr == m_pDB)
+    return;
+
+  for (const auto& idCache : m_idCaches)
+  {
+    const unsigned int lookups = idCache.second.hits + idCache.second.misses;
+    if (lookups > 0)
+      CLog::Log(LOGDEBUG, "{}: {} id cache hit rate {:.1f}% ({} of {} lookups)", m_pDB->getDatabase(),
+                idCache.first, 100.0 * idCache.second.hits / lookups, idCache.second.hits,
+                lookups);
+  }
+}
+
+void CDatabase::FlushBulkWrite()
+{
+  if (!IsInBulkWrite() || m_bulkWriteDepth > 0 || nullptr == m_pDB || !m_pDB->in_transaction())
+    return;
+
+  try
+  {
+    m_pDB->commit_transaction();
+    m_bulkWritePending = 0;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "database:flushbulkwrite failed");
+  }
+}
+
 bool CDatabase::CreateDatabase()
 {
   BeginTransaction();
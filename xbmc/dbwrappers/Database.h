@@ -13,8 +13,11 @@ namespace dbiplus {
   class Dataset;
 }
 
+#include <chrono>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class DatabaseSettings; // forward
@@ -105,6 +108,38 @@ public:
   void BeginTransaction();
   virtual bool CommitTransaction();
   void RollbackTransaction();
+
+  /*!
+   * @brief Start a bulk write session, e.g. for a library scan.
+   *        While the session is active, transactions become savepoints inside one shared
+   *        transaction, which is committed after batchSize top level commits or once it has
+   *        been open for BULK_WRITE_MAX_DURATION, whichever comes first.
+   * @param batchSize The number of top level commits to group in one transaction.
+   * @sa EndBulkWrite, FlushBulkWrite
+   */
+  virtual void BeginBulkWrite(unsigned int batchSize = BULK_WRITE_BATCH_SIZE);
+
+  /*!
+   * @brief End a bulk write session and commit any pending changes.
+   *        Derived classes can override it to update state that is only refreshed once per
+   *        session instead of on every commit.
+   * @return true if the pending changes were committed.
+   */
+  virtual bool EndBulkWrite();
+
+  /*!
+   * @brief Commit the pending changes of a bulk write session without ending it.
+   *        Must be called before slow operations that don't need the database (e.g. online
+   *        scraping, directory listings, artwork or stream probing), so that the database is not
+   *        kept locked while they run: the BULK_WRITE_MAX_DURATION limit is only checked when a
+   *        transaction is committed.
+   */
+  void FlushBulkWrite();
+
+  bool IsInBulkWrite() const { return m_bulkWriteBatchSize > 0; }
+
+  static constexpr unsigned int BULK_WRITE_BATCH_SIZE = 100;
+  static constexpr std::chrono::milliseconds BULK_WRITE_MAX_DURATION{2000};
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -235,6 +270,30 @@ public:
    */
   size_t GetDeleteQueriesCount();
 
+  /*!
+   * @brief Commit all queued DELETE and INSERT queries in a single transaction, the DELETE
+   *        queries first. Nothing is written should any one query fail.
+   * @return True if all queries were executed successfully, false otherwise.
+   * @sa QueueDeleteQuery, QueueInsertQuery
+   */
+  bool CommitQueuedQueries();
+
+  /*!
+   * @brief Build a condition restricting a key column to the rows matching a search in a full
+   * text index created with CreateFullTextIndex.
+   * @param index The name of the full text index.
+   * @param key The (qualified) key column the index rowid maps to.
+   * @param columns The indexed columns to search, all if empty.
+   * @param search The search as typed by the user, matched as a word prefix.
+   * @param anchorStart Only match text at the start of a column.
+   * @return The condition, or an empty string if the index is not available.
+   */
+  std::string PrepareFullTextCondition(const std::string& index,
+                                       const std::string& key,
+                                       const std::vector<std::string>& columns,
+                                       const std::string& search,
+                                       bool anchorStart = false) const;
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -282,6 +341,48 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Create (or recreate) an SQLite FTS5 index over text columns of a table.
+   The index is an external content table kept up to date by triggers on the
+   indexed table, so it should be created from CreateAnalytics(). Does nothing
+   for databases without FTS5 support.
+   \param index name of the full text index
+   \param table the indexed table
+   \param key the integer primary key of table
+   \param columns the text columns to index
+   */
+  void CreateFullTextIndex(const std::string& index,
+                           const std::string& table,
+                           const std::string& key,
+                           const std::vector<std::string>& columns);
+
+  /*! \brief Check whether a full text index exists and can be used.
+   */
+  bool HasFullTextIndex(const std::string& index) const;
+
+  /*! \brief Get the ID of a row cached by a previous lookup in this bulk write session.
+   The caches spare scanners a SELECT per lookup of the same artist, genre, path etc. They are
+   emptied when a session starts or ends, on rollback and when another connection changes
+   the database.
+   \param cache name of the cache, usually the table
+   \param key the unique value the row was looked up by
+   \return the ID, or -1 if it is not cached or no bulk write session is active
+   \sa SetCachedId, BeginBulkWrite
+   */
+  int GetCachedId(const std::string& cache, const std::string& key);
+
+  /*! \brief Remember the ID of a row looked up by a unique value, see GetCachedId.
+   */
+  void SetCachedId(const std::string& cache, const std::string& key, int id);
+
+  /*! \brief Empty all ID caches, must be called when rows that may be cached are deleted.
+   */
+  void ClearCachedIds();
+
+  /*! \brief Switch an SQLite database between write ahead logging and the default rollback
+   journal. Must be called outside of a transaction, does nothing for other database types.
+   */
+  void SetWriteAheadLog(bool enable);
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -304,4 +405,23 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  unsigned int m_bulkWriteBatchSize = 0; //!< number of commits per batch, 0 if not in bulk write
+  unsigned int m_bulkWritePending = 0; //!< top level commits in the open batch
+  unsigned int m_bulkWriteDepth = 0; //!< number of open savepoints
+  std::chrono::steady_clock::time_point m_bulkWriteStart; //!< when the open batch was started
+
+  struct IdCache
+  {
+    std::unordered_map<std::string, int> ids;
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+  };
+  void CheckExternalChanges();
+  void LogCachedIdStats() const;
+
+  std::map<std::string, IdCache> m_idCaches; //!< ID caches of the bulk write session by name
+  long m_dataVersion = -1; //!< data version the ID caches are valid for
+
+  mutable std::map<std::string, bool> m_fullTextIndexes; //!< cached results of HasFullTextIndex
 };
@@ -132,6 +132,14 @@ public:
   virtual void commit_transaction() {};
   virtual void rollback_transaction() {};
 
+/* \brief counter changed by commits of other connections, -1 if not supported */
+  virtual long data_version() { return -1; }
+
+/* \brief named savepoints nested inside a transaction */
+  virtual void start_savepoint(const std::string& name) {};
+  virtual void release_savepoint(const std::string& name) {};
+  virtual void rollback_savepoint(const std::string& name) {};
+
 /* virtual methods for formatting */
 
   /*! \brief Prepare a SQL statement for execution or querying using C printf nomenclature.
@@ -563,6 +563,27 @@ void MysqlDatabase::rollback_transaction() {
   }
 }
 
+void MysqlDatabase::start_savepoint(const std::string& name)
+{
+  if (active)
+    query_with_reconnect(("SAVEPOINT " + name).c_str());
+}
+
+void MysqlDatabase::release_savepoint(const std::string& name)
+{
+  if (active)
+    query_with_reconnect(("RELEASE SAVEPOINT " + name).c_str());
+}
+
+void MysqlDatabase::rollback_savepoint(const std::string& name)
+{
+  if (active)
+  {
+    query_with_reconnect(("ROLLBACK TO SAVEPOINT " + name).c_str());
+    query_with_reconnect(("RELEASE SAVEPOINT " + name).c_str());
+  }
+}
+
 bool MysqlDatabase::exists(void) {
   bool ret = false;
 
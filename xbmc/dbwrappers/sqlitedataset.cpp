@@ -360,6 +360,19 @@ bool SqliteDatabase::exists(void)
   return bRet;
 }
 
+long SqliteDatabase::data_version()
+{
+  if (!active)
+    return -1;
+
+  result_set res;
+  if (sqlite3_exec(conn, "PRAGMA data_version", &callback, &res, NULL) != SQLITE_OK ||
+      res.records.empty() || res.records[0]->empty())
+    return -1;
+
+  return res.records[0]->at(0).get_asInt();
+}
+
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
   sqlite3_close(conn);
@@ -519,6 +532,28 @@ void SqliteDatabase::rollback_transaction() {
   }
 }
 
+void SqliteDatabase::start_savepoint(const std::string& name)
+{
+  if (active)
+    sqlite3_exec(conn, ("SAVEPOINT " + name).c_str(), NULL, NULL, NULL);
+}
+
+void SqliteDatabase::release_savepoint(const std::string& name)
+{
+  if (active)
+    sqlite3_exec(conn, ("RELEASE SAVEPOINT " + name).c_str(), NULL, NULL, NULL);
+}
+
+void SqliteDatabase::rollback_savepoint(const std::string& name)
+{
+  if (active)
+  {
+    // rolling back to a savepoint keeps it on the stack, release it as well
+    sqlite3_exec(conn, ("ROLLBACK TO SAVEPOINT " + name).c_str(), NULL, NULL, NULL);
+    sqlite3_exec(conn, ("RELEASE SAVEPOINT " + name).c_str(), NULL, NULL, NULL);
+  }
+}
+
 
 // methods for formatting
 // ---------------------------------------------
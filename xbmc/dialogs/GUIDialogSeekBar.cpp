@@ -9,17 +9,99 @@
 #include "GUIDialogSeekBar.h"
 
 #include "Application.h"
+#include "FileItem.h"
 #include "GUIInfoManager.h"
 #include "SeekHandler.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/guiinfo/GUIInfoLabels.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/Variant.h"
+#include "video/VideoSpriteSheet.h"
 
+#include <chrono>
 #include <math.h>
 
 #define POPUP_SEEK_PROGRESS           401
 #define POPUP_SEEK_EPG_EVENT_PROGRESS 402
 #define POPUP_SEEK_TIMESHIFT_PROGRESS 403
 
+// how often the sheets of a file are looked at again while they are being built
+constexpr auto SPRITE_SHEET_RELOAD_INTERVAL = std::chrono::seconds(5);
+
+// no preview wanted, e.g. while not seeking
+constexpr int64_t NO_PREVIEW = -1;
+
+struct CGUIDialogSeekBar::SeekPreview
+{
+  explicit SeekPreview(const CFileItem& playingItem) : item(playingItem) {}
+
+  const CFileItem item;
+
+  // only used by the job, loading the sheets and cutting images reads and decodes files
+  std::unique_ptr<CVideoSpriteSheet> spriteSheet;
+  std::chrono::steady_clock::time_point spriteSheetLoaded;
+
+  CCriticalSection section;
+  int64_t requestedTime = NO_PREVIEW; // ms
+  int64_t imageTime = NO_PREVIEW;
+  std::string image;
+  bool imageChanged = false;
+  bool jobRunning = false;
+
+  /*!
+   \brief Cut the images of the requested times until the latest request is served.
+   */
+  static void Run(const std::shared_ptr<SeekPreview>& preview);
+};
+
+void CGUIDialogSeekBar::SeekPreview::Run(const std::shared_ptr<SeekPreview>& preview)
+{
+  while (true)
+  {
+    int64_t time;
+    {
+      CSingleLock lock(preview->section);
+      if (preview->requestedTime == preview->imageTime)
+      {
+        preview->jobRunning = false;
+        return;
+      }
+      time = preview->requestedTime;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!preview->spriteSheet)
+    {
+      preview->spriteSheet =
+          std::make_unique<CVideoSpriteSheet>(CVideoSpriteSheet::GetMediaPath(preview->item));
+      preview->spriteSheetLoaded = now;
+      if (!preview->spriteSheet->Load() || !preview->spriteSheet->IsComplete())
+        CVideoSpriteSheet::Build(preview->item);
+    }
+    else if (!preview->spriteSheet->IsComplete() &&
+             now - preview->spriteSheetLoaded > SPRITE_SHEET_RELOAD_INTERVAL)
+    {
+      // pick up the sheets finished by the build job in the meantime
+      preview->spriteSheet->Load();
+      preview->spriteSheetLoaded = now;
+    }
+
+    std::string image;
+    if (time != NO_PREVIEW)
+      image = preview->spriteSheet->GetPreviewImage(time);
+
+    CSingleLock lock(preview->section);
+    preview->imageTime = time;
+    if (image != preview->image)
+    {
+      preview->image = std::move(image);
+      preview->imageChanged = true;
+    }
+  }
+}
+
 CGUIDialogSeekBar::CGUIDialogSeekBar(void)
   : CGUIDialog(WINDOW_DIALOG_SEEK_BAR, "DialogSeekBar.xml", DialogModalityType::MODELESS)
 {
@@ -33,7 +115,10 @@ bool CGUIDialogSeekBar::OnMessage(CGUIMessage& message)
   switch ( message.GetMessage() )
   {
   case GUI_MSG_WINDOW_INIT:
+    OpenSeekPreview();
+    return CGUIDialog::OnMessage(message);
   case GUI_MSG_WINDOW_DEINIT:
+    CloseSeekPreview();
     return CGUIDialog::OnMessage(message);
   case GUI_MSG_ITEM_SELECT:
     if (message.GetSenderId() == GetID() &&
@@ -68,9 +153,68 @@ void CGUIDialogSeekBar::FrameMove()
   if (timeshiftProgress != m_lastTimeshiftProgress)
     CONTROL_SELECT_ITEM(POPUP_SEEK_TIMESHIFT_PROGRESS, m_lastTimeshiftProgress = timeshiftProgress);
 
+  UpdateSeekPreview();
+
   CGUIDialog::FrameMove();
 }
 
+void CGUIDialogSeekBar::OpenSeekPreview()
+{
+  CloseSeekPreview();
+
+  const CFileItem& item = g_application.CurrentFileItem();
+  if (!g_application.GetAppPlayer().IsPlayingVideo() || !CVideoSpriteSheet::IsSupported(item))
+    return;
+
+  m_seekPreview = std::make_shared<SeekPreview>(item);
+}
+
+void CGUIDialogSeekBar::UpdateSeekPreview()
+{
+  if (!m_seekPreview)
+    return;
+
+  int64_t time = NO_PREVIEW;
+  const int seekSize = g_application.GetAppPlayer().GetSeekHandler().GetSeekSize();
+  if (seekSize != 0)
+    time = static_cast<int64_t>((g_application.GetTime() + seekSize) * 1000);
+
+  std::string image;
+  {
+    CSingleLock lock(m_seekPreview->section);
+    if (time != m_seekPreview->requestedTime)
+    {
+      m_seekPreview->requestedTime = time;
+      if (!m_seekPreview->jobRunning)
+      {
+        m_seekPreview->jobRunning = true;
+        CJobManager::GetInstance().Submit(
+            [preview = m_seekPreview]() { SeekPreview::Run(preview); }, CJob::PRIORITY_HIGH);
+      }
+    }
+
+    if (!m_seekPreview->imageChanged)
+      return;
+
+    m_seekPreview->imageChanged = false;
+    image = m_seekPreview->image;
+  }
+
+  if (image != m_seekPreviewImage)
+  {
+    m_seekPreviewImage = image;
+    SetProperty("SeekPreview", m_seekPreviewImage);
+  }
+}
+
+void CGUIDialogSeekBar::CloseSeekPreview()
+{
+  // a running job keeps its state, the images are removed with its sprite sheet
+  m_seekPreview.reset();
+  m_seekPreviewImage.clear();
+  SetProperty("SeekPreview", "");
+}
+
 int CGUIDialogSeekBar::GetProgress() const
 {
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
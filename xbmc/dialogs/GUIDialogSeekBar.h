@@ -10,6 +10,17 @@
 
 #include "guilib/GUIDialog.h"
 
+#include <memory>
+#include <string>
+
+/*!
+ \brief The seek bar shown while seeking.
+
+ For video files with sprite sheets (see CVideoSpriteSheet) the window property
+ "SeekPreview" holds an image of the seek target while seeking, e.g. for skins:
+ $INFO[Window(seekbar).Property(SeekPreview)]. The image is cut from the sheets by a
+ background job, the dialog only picks up its result.
+ */
 class CGUIDialogSeekBar : public CGUIDialog
 {
 public:
@@ -22,7 +33,15 @@ private:
   int GetEpgEventProgress() const;
   int GetTimeshiftProgress() const;
 
+  void OpenSeekPreview();
+  void UpdateSeekPreview();
+  void CloseSeekPreview();
+
   int m_lastProgress = 0;
   int m_lastEpgEventProgress = 0;
   int m_lastTimeshiftProgress = 0;
+
+  struct SeekPreview;
+  std::shared_ptr<SeekPreview> m_seekPreview; // shared with the job cutting the images
+  std::string m_seekPreviewImage;
 };
@@ -31,37 +31,6 @@ using namespace ADDON;
 #define LABEL_ROW2 11
 #define LABEL_ROW3 12
 
-CAudioBuffer::CAudioBuffer(int iSize)
-{
-  m_iLen = iSize;
-  m_pBuffer = new float[iSize];
-}
-
-CAudioBuffer::~CAudioBuffer()
-{
-  delete [] m_pBuffer;
-}
-
-const float* CAudioBuffer::Get() const
-{
-  return m_pBuffer;
-}
-
-int CAudioBuffer::Size() const
-{
-  return m_iLen;
-}
-
-void CAudioBuffer::Set(const float* psBuffer, int iSize)
-{
-  if (iSize < 0)
-    return;
-
-  memcpy(m_pBuffer, psBuffer, iSize * sizeof(float));
-  for (int i = iSize; i < m_iLen; ++i)
-    m_pBuffer[i] = 0;
-}
-
 CGUIVisualisationControl::CGUIVisualisationControl(int parentID, int controlID, float posX, float posY, float width, float height)
   : CGUIControl(parentID, controlID, posX, posY, width, height),
     m_callStart(false),
@@ -245,35 +214,36 @@ void CGUIVisualisationControl::OnAudioData(const float* audioData, unsigned int
   if (!m_instance || !m_alreadyStarted || !audioData || audioDataLength == 0)
     return;
 
-  // Save our audio data in the buffers
-  std::unique_ptr<CAudioBuffer> pBuffer(new CAudioBuffer(audioDataLength));
-  pBuffer->Set(audioData, audioDataLength);
-  //m_vecBuffers.push_back(pBuffer.release());
-  m_vecBuffers.emplace_back(std::move(pBuffer));
+  // engine without a spectrum tap, keep our own copy of the data
+  if (m_localTap.GetFFTSize() == 0)
+    m_localTap.Configure(AUDIO_BUFFER_SIZE * 8, AUDIO_BUFFER_SIZE / 2);
 
-  if (m_vecBuffers.size() < m_numBuffers)
+  OnAudioBlock(m_localTap.Publish(audioData, audioDataLength, m_wantsFreq));
+}
+
+void CGUIVisualisationControl::OnAudioBlock(const AESpectrumBlock& block)
+{
+  if (!m_instance || !m_alreadyStarted || !block.tap || block.samples == 0)
     return;
 
-  std::unique_ptr<CAudioBuffer> ptrAudioBuffer = std::move(m_vecBuffers.front());
-  m_vecBuffers.pop_front();
+  // Remember the block, the data itself stays in the tap
+  m_vecBuffers.emplace_back(block.sequence);
 
-  // Fourier transform the data if the vis wants it...
-  if (m_wantsFreq)
-  {
-    const float *psAudioData = ptrAudioBuffer->Get();
+  if (m_vecBuffers.size() < m_numBuffers)
+    return;
 
-    if (!m_transform)
-      m_transform.reset(new RFFT(AUDIO_BUFFER_SIZE/2, false)); // half due to stereo
+  const uint64_t sequence = m_vecBuffers.front();
+  m_vecBuffers.pop_front();
 
-    m_transform->calc(psAudioData, m_freq);
+  AESpectrumBlock delayed;
+  if (!block.tap->GetBlock(sequence, delayed))
+    return; // overwritten, e.g. after the engine was reconfigured
 
-    // Transfer data to our visualisation
-    m_instance->AudioData(psAudioData, ptrAudioBuffer->Size(), m_freq, AUDIO_BUFFER_SIZE/2); // half due to complex-conjugate
-  }
+  // Transfer data to our visualisation, the spectrum has been computed by the engine
+  if (m_wantsFreq && delayed.freq)
+    m_instance->AudioData(delayed.pcm, delayed.samples, delayed.freq, delayed.freqLength);
   else
-  { // Transfer data to our visualisation
-    m_instance->AudioData(ptrAudioBuffer->Get(), ptrAudioBuffer->Size(), nullptr, 0);
-  }
+    m_instance->AudioData(delayed.pcm, delayed.samples, nullptr, 0);
 }
 
 void CGUIVisualisationControl::UpdateTrack()
@@ -451,12 +421,4 @@ void CGUIVisualisationControl::ClearBuffers()
   m_wantsFreq = false;
   m_numBuffers = 0;
   m_vecBuffers.clear();
-
-  for (float& freq : m_freq)
-  {
-    freq = 0.0f;
-  }
-
-  if (m_transform)
-    m_transform.reset();
 }
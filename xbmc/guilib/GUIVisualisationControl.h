@@ -11,31 +11,14 @@
 #include "GUIControl.h"
 #include "addons/Visualization.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
-#include "utils/rfft.h"
 
-#include <list>
+#include <deque>
 #include <string>
 #include <vector>
 
 #define AUDIO_BUFFER_SIZE 512 // MUST BE A POWER OF 2!!!
 #define MAX_AUDIO_BUFFERS 16
 
-class CAudioBuffer
-{
-public:
-  explicit CAudioBuffer(int iSize);
-  virtual ~CAudioBuffer();
-  const float* Get() const;
-  int Size() const;
-  void Set(const float* psBuffer, int iSize);
-private:
-  CAudioBuffer(const CAudioBuffer&) = delete;
-  CAudioBuffer& operator=(const CAudioBuffer&) = delete;
-  CAudioBuffer();
-  float* m_pBuffer;
-  int m_iLen;
-};
-
 class CGUIVisualisationControl : public CGUIControl, public IAudioCallback
 {
 public:
@@ -46,6 +29,8 @@ public:
   // Child functions related to IAudioCallback
   void OnInitialize(int channels, int samplesPerSec, int bitsPerSample) override;
   void OnAudioData(const float* audioData, unsigned int audioDataLength) override;
+  bool WantsFreq() const override { return m_wantsFreq; }
+  void OnAudioBlock(const AESpectrumBlock& block) override;
 
   // Child functions related to CGUIControl
   void FreeResources(bool immediately = false) override;
@@ -77,12 +62,11 @@ private:
   bool m_attemptedLoad;
   bool m_updateTrack;
 
-  std::list<std::unique_ptr<CAudioBuffer>> m_vecBuffers;
+  std::deque<uint64_t> m_vecBuffers; /*!< Delayed blocks, referenced by tap sequence number */
   unsigned int m_numBuffers; /*!< Number of Audio buffers */
   bool m_wantsFreq;
-  float m_freq[AUDIO_BUFFER_SIZE]; /*!< Frequency data */
   std::vector<std::string> m_presets; /*!< cached preset list */
-  std::unique_ptr<RFFT> m_transform;
+  CAESpectrumTap m_localTap; /*!< Used for engines that do not publish a spectrum tap */
 
   /* values set from "OnInitialize" IAudioCallback  */
   int m_channels;
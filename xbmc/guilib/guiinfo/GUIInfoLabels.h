@@ -709,6 +709,7 @@
 #define PLAYER_PROCESS_AUDIOCHANNELS (PLAYER_PROCESS + 9)
 #define PLAYER_PROCESS_AUDIOSAMPLERATE (PLAYER_PROCESS + 10)
 #define PLAYER_PROCESS_AUDIOBITSPERSAMPLE (PLAYER_PROCESS + 11)
+#define PLAYER_PROCESS_VIDEODECODERTHREADING (PLAYER_PROCESS + 12)
 
 #define WINDOW_PROPERTY             9993
 #define WINDOW_IS_VISIBLE           9995
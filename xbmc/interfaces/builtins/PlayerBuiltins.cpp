@@ -15,6 +15,7 @@
 #include "PlayListPlayer.h"
 #include "SeekHandler.h"
 #include "ServiceBroker.h"
+#include "XBDateTime.h"
 #include "filesystem/Directory.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
@@ -27,6 +28,7 @@
 #include "settings/SettingsComponent.h"
 #include "storage/MediaManager.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
@@ -545,6 +547,38 @@ static int Seek(const std::vector<std::string>& params)
   return 0;
 }
 
+/*! \brief Record playback timing and write it as Chrome trace.
+ *  \param params The parameters.
+ *  \details params[0] = "start", "stop" or "dump".
+ *           params[1] = File to dump to (optional).
+ */
+static int PlaybackTrace(const std::vector<std::string>& params)
+{
+  if (StringUtils::EqualsNoCase(params[0], "start"))
+    CPerformanceTrace::Start();
+  else if (StringUtils::EqualsNoCase(params[0], "stop"))
+    CPerformanceTrace::Stop();
+  else if (StringUtils::EqualsNoCase(params[0], "dump"))
+  {
+    std::string file;
+    if (params.size() > 1)
+      file = params[1];
+    else
+      file = "special://logpath/playbacktrace-" +
+             CDateTime::GetCurrentDateTime().GetAsSaveString() + ".json";
+
+    if (!CPerformanceTrace::Dump(file))
+      return -1;
+  }
+  else
+  {
+    CLog::Log(LOGERROR, "PlaybackTrace called with unknown parameter: {}", params[0]);
+    return -1;
+  }
+
+  return 0;
+}
+
 // Note: For new Texts with comma add a "\" before!!! Is used for table text.
 //
 /// \page page_List_of_built_in_functions
@@ -557,6 +591,19 @@ static int Seek(const std::vector<std::string>& params)
 ///     Function,
 ///     Description }
 ///   \table_row2_l{
+///     <b>`PlaybackTrace(command[\,file])`</b>
+///     \anchor Builtin_PlaybackTrace,
+///     Records the timing of decoding\, queueing and presentation during playback and
+///     writes it in the Chrome trace format\, which chrome://tracing and Perfetto open.
+///     @param[in] command               "start" to start recording\, "stop" to stop recording
+///                                      or "dump" to write the events recorded since start.
+///     @param[in] file                  File to write to when dumping (optional\, defaults to
+///                                      playbacktrace-<date>.json in the log folder).
+///     <p><hr>
+///     @skinning_v20 **[New builtin]** \link Builtin_PlaybackTrace `PlaybackTrace(command[\,file])`\endlink
+///     <p>
+///   }
+///   \table_row2_l{
 ///     <b>`PlaysDisc(parm)`</b>\n
 ///     <b>`PlayDVD(param)`</b>(deprecated)
 ///     ,
@@ -656,6 +703,7 @@ static int Seek(const std::vector<std::string>& params)
 CBuiltins::CommandMap CPlayerBuiltins::GetOperations() const
 {
   return {
+           {"playbacktrace",       {"Record playback timing and write it as Chrome trace", 1, PlaybackTrace}},
            {"playdisc",            {"Plays the inserted disc, like CD, DVD or Blu-ray, in the disc drive.", 0, PlayDVD}},
            {"playdvd",             {"Plays the inserted disc, like CD, DVD or Blu-ray, in the disc drive.", 0, PlayDVD}},
            {"playlist.clear",      {"Clear the current playlist", 0, ClearPlaylist}},
@@ -26,6 +26,7 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "video/VideoDatabase.h"
+#include "video/VideoSpriteSheet.h"
 
 using namespace XFILE;
 using namespace JSONRPC;
@@ -280,6 +281,45 @@ JSONRPC_STATUS CFileOperations::Download(const std::string &method, ITransportLa
   return transport->Download(parameterObject["path"].asString().c_str(), result) ? OK : InvalidParams;
 }
 
+JSONRPC_STATUS CFileOperations::GetSeekPreview(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  const std::string file = parameterObject["file"].asString();
+  if (!CFileUtils::RemoteAccessAllowed(file))
+    return InvalidParams;
+
+  const CFileItem item(file, false);
+  if (!CVideoSpriteSheet::IsSupported(item))
+    return InvalidParams;
+
+  const CVariant& time = parameterObject["time"];
+  const int64_t ms = ((time["hours"].asInteger() * 60 + time["minutes"].asInteger()) * 60 +
+                      time["seconds"].asInteger()) * 1000 + time["milliseconds"].asInteger();
+
+  CVideoSpriteSheet sheet(CVideoSpriteSheet::GetMediaPath(item));
+  const bool loaded = sheet.Load();
+  if (!sheet.IsComplete() && parameterObject["build"].asBoolean())
+    CVideoSpriteSheet::Build(item);
+
+  result["complete"] = sheet.IsComplete();
+
+  CVideoSpriteSheet::Preview preview;
+  if (!loaded || !sheet.GetPreview(ms, preview))
+  {
+    result["available"] = false;
+    return OK;
+  }
+
+  result["available"] = true;
+  result["image"] = preview.image;
+  result["x"] = preview.x;
+  result["y"] = preview.y;
+  result["width"] = preview.width;
+  result["height"] = preview.height;
+  result["orientation"] = preview.orientation;
+  MillisecondsToTimeObject(static_cast<int>(preview.time), result["time"]);
+  return OK;
+}
+
 bool CFileOperations::FillFileItem(
     const CFileItemPtr& originalItem,
     CFileItemPtr& item,
@@ -91,6 +91,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "Files.SetFileDetails",                         CFileOperations::SetFileDetails },
   { "Files.PrepareDownload",                        CFileOperations::PrepareDownload },
   { "Files.Download",                               CFileOperations::Download },
+  { "Files.GetSeekPreview",                         CFileOperations::GetSeekPreview },
 
 // Music Library
   { "AudioLibrary.GetProperties",                   CAudioLibrary::GetProperties },
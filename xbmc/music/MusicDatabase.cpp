@@ -394,6 +394,11 @@ void CMusicDatabase::CreateAnalytics()
               "END");
   CreateRemovedLinkTriggers(); // DELETE ON song_artist and album_artist tables
 
+  // Full text indexes used by search, maintained by triggers (SQLite only)
+  CreateFullTextIndex("song_fts", "song", "idSong", {"strTitle"});
+  CreateFullTextIndex("album_fts", "album", "idAlbum", {"strAlbum"});
+  CreateFullTextIndex("artist_fts", "artist", "idArtist", {"strArtist"});
+
   // Create native functions stored in DB (MySQL/MariaDB only)
   CreateNativeDBFunctions();
 
@@ -1685,10 +1690,17 @@ int CMusicDatabase::AddGenre(std::string& strGenre)
     if (nullptr == m_pDS)
       return -1;
 
-    auto it = m_genreCache.find(strGenre);
-    if (it != m_genreCache.end())
-      return it->second;
+    // the scan scoped cache replaces the permanent one during a bulk write session
+    int idGenre = GetCachedId("genre", strGenre);
+    if (idGenre >= 0)
+      return idGenre;
 
+    if (!IsInBulkWrite())
+    {
+      auto it = m_genreCache.find(strGenre);
+      if (it != m_genreCache.end())
+        return it->second;
+    }
 
     strSQL = PrepareSQL("SELECT idGenre, strGenre FROM genre WHERE strGenre LIKE '%s'",
                         strGenre.c_str());
@@ -1701,15 +1713,15 @@ int CMusicDatabase::AddGenre(std::string& strGenre)
                           strGenre.c_str());
       m_pDS->exec(strSQL);
 
-      int idGenre = (int)m_pDS->lastinsertid();
-      m_genreCache.insert(std::pair<std::string, int>(strGenre, idGenre));
+      idGenre = static_cast<int>(m_pDS->lastinsertid());
+      CacheGenre(strGenre, idGenre);
       return idGenre;
     }
     else
     {
-      int idGenre = m_pDS->fv("idGenre").get_asInt();
+      idGenre = m_pDS->fv("idGenre").get_asInt();
       strGenre = m_pDS->fv("strGenre").get_asString();
-      m_genreCache.insert(std::pair<std::string, int>(strGenre, idGenre));
+      CacheGenre(strGenre, idGenre);
       m_pDS->close();
       return idGenre;
     }
@@ -1768,8 +1780,17 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
                               bool bScrapedMBID /* = false*/)
 {
   std::string strSQL;
-  int idArtist = AddArtist(strArtist, strMusicBrainzArtistID, bScrapedMBID);
-  if (idArtist < 0 || strSortName.empty())
+  if (strSortName.empty())
+    return AddArtist(strArtist, strMusicBrainzArtistID, bScrapedMBID);
+
+  // Once added with this sort name, adding the artist again changes nothing
+  const std::string key = strMusicBrainzArtistID + '\t' + strArtist + '\t' + strSortName;
+  int idArtist = GetCachedId("artist", key);
+  if (idArtist >= 0)
+    return idArtist;
+
+  idArtist = AddArtist(strArtist, strMusicBrainzArtistID, bScrapedMBID);
+  if (idArtist < 0)
     return idArtist;
 
   /* Artist sort name always taken as the first value provided that is different from name, so only
@@ -1806,6 +1827,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
       m_pDS->exec(PrepareSQL("UPDATE artist SET strSortName = '%s' WHERE idArtist = %i",
                              strSortName.c_str(), idArtist));
 
+    SetCachedId("artist", key, idArtist);
     return idArtist;
   }
 
@@ -1829,6 +1851,11 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
     if (nullptr == m_pDS)
       return -1;
 
+    const std::string key = strMusicBrainzArtistID + '\t' + strArtist;
+    int idArtist = GetCachedId("artist", key);
+    if (idArtist >= 0)
+      return idArtist;
+
     // 1) MusicBrainz
     if (!strMusicBrainzArtistID.empty())
     {
@@ -1839,7 +1866,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
       m_pDS->query(strSQL);
       if (m_pDS->num_rows() > 0)
       {
-        int idArtist = m_pDS->fv("idArtist").get_asInt();
+        idArtist = m_pDS->fv("idArtist").get_asInt();
         bool update = m_pDS->fv("strArtist").get_asString().compare(strMusicBrainzArtistID) == 0;
         m_pDS->close();
         if (update)
@@ -1850,6 +1877,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
           m_pDS->exec(strSQL);
           m_pDS->close();
         }
+        SetCachedId("artist", key, idArtist);
         return idArtist;
       }
       m_pDS->close();
@@ -1863,7 +1891,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
       m_pDS->query(strSQL);
       if (m_pDS->num_rows() > 0)
       {
-        int idArtist = m_pDS->fv("idArtist").get_asInt();
+        idArtist = m_pDS->fv("idArtist").get_asInt();
         m_pDS->close();
         // 1.b.a) We found an artist by name but with no MusicBrainz ID set, update it and assume it is our artist, flag when mbid scraped
         strSQL =
@@ -1871,6 +1899,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
                        "bScrapedMBID = %i WHERE idArtist = %i",
                        strArtist.c_str(), strMusicBrainzArtistID.c_str(), bScrapedMBID, idArtist);
         m_pDS->exec(strSQL);
+        SetCachedId("artist", key, idArtist);
         return idArtist;
       }
 
@@ -1886,8 +1915,9 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
       m_pDS->query(strSQL);
       if (m_pDS->num_rows() > 0)
       {
-        int idArtist = m_pDS->fv("idArtist").get_asInt();
+        idArtist = m_pDS->fv("idArtist").get_asInt();
         m_pDS->close();
+        SetCachedId("artist", key, idArtist);
         return idArtist;
       }
       m_pDS->close();
@@ -1906,7 +1936,8 @@ int CMusicDatabase::AddArtist(const std::string& strArtist,
                           strArtist.c_str(), strMusicBrainzArtistID.c_str(), bScrapedMBID);
 
     m_pDS->exec(strSQL);
-    int idArtist = (int)m_pDS->lastinsertid();
+    idArtist = static_cast<int>(m_pDS->lastinsertid());
+    SetCachedId("artist", key, idArtist);
     return idArtist;
   }
   catch (...)
@@ -2526,11 +2557,21 @@ bool CMusicDatabase::AddSongGenres(int idSong, const std::vector<std::string>& g
       return false;
     unsigned int index = 0;
     std::vector<std::string> modgenres = genres;
+    std::string values;
+    std::set<int> genreIDs;
     for (auto& strGenre : modgenres)
     {
       int idGenre = AddGenre(strGenre); // Genre string trimed and matched case insensitively
-      strSQL = PrepareSQL("INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(%i,%i,%i)",
-                          idGenre, idSong, index++);
+      if (!genreIDs.insert(idGenre).second)
+        continue; // Same genre tagged twice, link it once
+      if (!values.empty())
+        values += ", ";
+      values += PrepareSQL("(%i, %i, %i)", idGenre, idSong, index++);
+    }
+    // Add all the genre links in one statement
+    if (!values.empty())
+    {
+      strSQL = "INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES " + values;
       if (!ExecuteQuery(strSQL))
         return false;
     }
@@ -2895,9 +2936,17 @@ int CMusicDatabase::AddPath(const std::string& strPath1)
     if (nullptr == m_pDS)
       return -1;
 
-    auto it = m_pathCache.find(strPath);
-    if (it != m_pathCache.end())
-      return it->second;
+    // the scan scoped cache replaces the permanent one during a bulk write session
+    int idPath = GetCachedId("path", strPath);
+    if (idPath >= 0)
+      return idPath;
+
+    if (!IsInBulkWrite())
+    {
+      auto it = m_pathCache.find(strPath);
+      if (it != m_pathCache.end())
+        return it->second;
+    }
 
     strSQL = PrepareSQL("SELECT * FROM path WHERE strPath='%s'", strPath.c_str());
     m_pDS->query(strSQL);
@@ -2910,14 +2959,14 @@ int CMusicDatabase::AddPath(const std::string& strPath1)
                           strPath.c_str());
       m_pDS->exec(strSQL);
 
-      int idPath = (int)m_pDS->lastinsertid();
-      m_pathCache.insert(std::pair<std::string, int>(strPath, idPath));
+      idPath = static_cast<int>(m_pDS->lastinsertid());
+      CachePath(strPath, idPath);
       return idPath;
     }
     else
     {
-      int idPath = m_pDS->fv("idPath").get_asInt();
-      m_pathCache.insert(std::pair<std::string, int>(strPath, idPath));
+      idPath = m_pDS->fv("idPath").get_asInt();
+      CachePath(strPath, idPath);
       m_pDS->close();
       return idPath;
     }
@@ -3339,7 +3388,13 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList& art
 
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    const std::string ftsCondition =
+        PrepareFullTextCondition("artist_fts", "idArtist", {}, search,
+                                 search.size() < MIN_FULL_SEARCH_LENGTH);
+    if (!ftsCondition.empty())
+      strSQL = "SELECT * FROM artist WHERE " + ftsCondition +
+               PrepareSQL(" AND strArtist <> '%s' ", strVariousArtists.c_str());
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL = PrepareSQL("SELECT * FROM artist "
                           "WHERE (strArtist LIKE '%s%%' OR strArtist LIKE '%% %s%%') "
                           "AND strArtist <> '%s' ",
@@ -3940,10 +3995,27 @@ bool CMusicDatabase::GetSongsByPath(const std::string& strPath1,
   return false;
 }
 
+void CMusicDatabase::CacheGenre(const std::string& strGenre, int idGenre)
+{
+  if (IsInBulkWrite())
+    SetCachedId("genre", strGenre, idGenre);
+  else
+    m_genreCache.insert(std::pair<std::string, int>(strGenre, idGenre));
+}
+
+void CMusicDatabase::CachePath(const std::string& strPath, int idPath)
+{
+  if (IsInBulkWrite())
+    SetCachedId("path", strPath, idPath);
+  else
+    m_pathCache.insert(std::pair<std::string, int>(strPath, idPath));
+}
+
 void CMusicDatabase::EmptyCache()
 {
   m_genreCache.erase(m_genreCache.begin(), m_genreCache.end());
   m_pathCache.erase(m_pathCache.begin(), m_pathCache.end());
+  ClearCachedIds();
 }
 
 bool CMusicDatabase::Search(const std::string& search, CFileItemList& items)
@@ -3986,7 +4058,11 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList& items
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    const std::string ftsCondition = PrepareFullTextCondition(
+        "song_fts", "idSong", {}, search, search.size() < MIN_FULL_SEARCH_LENGTH);
+    if (!ftsCondition.empty())
+      strSQL = "SELECT * FROM songview WHERE " + ftsCondition + " LIMIT 1000";
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL = PrepareSQL("SELECT * FROM songview "
                           "WHERE strTitle LIKE '%s%%' or strTitle LIKE '%% %s%%' LIMIT 1000",
                           search.c_str(), search.c_str());
@@ -4029,7 +4105,11 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList& albu
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    const std::string ftsCondition = PrepareFullTextCondition(
+        "album_fts", "idAlbum", {}, search, search.size() < MIN_FULL_SEARCH_LENGTH);
+    if (!ftsCondition.empty())
+      strSQL = "SELECT * FROM albumview WHERE " + ftsCondition;
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL = PrepareSQL("SELECT * FROM albumview "
                           "WHERE strAlbum LIKE '%s%%' OR strAlbum LIKE '%% %s%%'",
                           search.c_str(), search.c_str());
@@ -4401,6 +4481,7 @@ bool CMusicDatabase::CleanupOrphanedItems()
   if (nullptr == m_pDS)
     return false;
   SetLibraryLastUpdated();
+  ClearCachedIds();
   if (!CleanupAlbums())
     return false;
   if (!CleanupArtists())
@@ -9295,7 +9376,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 82;
+  return 83;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -11208,6 +11289,7 @@ bool CMusicDatabase::RemoveSongsFromPath(const std::string& path1, MAPSONGS& son
     // and remove the path as well (it'll be re-added later on with the new hash if it's non-empty)
     sql = "delete from path" + where;
     m_pDS->exec(sql);
+    ClearCachedIds();
     return iRowsFound > 0;
   }
   catch (...)
@@ -11406,14 +11488,52 @@ int CMusicDatabase::GetSongIDFromPath(const std::string& filePath)
 bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so reset the infomanager cache
-    CGUIComponent* gui = CServiceBroker::GetGUI();
-    if (gui)
-    {
-      gui->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider().SetLibraryBool(
-          LIBRARY_HAS_MUSIC, GetSongsCount() > 0);
+  {
+    // counted once when the bulk write session ends
+    if (IsInBulkWrite())
       return true;
-    }
+
+    return UpdateLibraryHasMusic();
+  }
+  return false;
+}
+
+void CMusicDatabase::BeginBulkWrite(unsigned int batchSize /* = BULK_WRITE_BATCH_SIZE */)
+{
+  if (IsInBulkWrite())
+    return;
+
+  CDatabase::BeginBulkWrite(batchSize);
+
+  // write ahead logging makes the many commits of an import cheaper and lets the GUI keep
+  // reading the library meanwhile
+  if (IsInBulkWrite())
+    SetWriteAheadLog(true);
+}
+
+bool CMusicDatabase::EndBulkWrite()
+{
+  const bool inBulkWrite = IsInBulkWrite();
+  const bool committed = CDatabase::EndBulkWrite();
+
+  // the batches of the session may all have been committed before it ended
+  if (inBulkWrite)
+  {
+    SetWriteAheadLog(false);
+    UpdateLibraryHasMusic();
+  }
+  return committed;
+}
+
+bool CMusicDatabase::UpdateLibraryHasMusic()
+{
+  // number of items in the db has likely changed, so reset the infomanager cache
+  CGUIComponent* gui = CServiceBroker::GetGUI();
+  if (gui)
+  {
+    gui->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider().SetLibraryBool(
+        LIBRARY_HAS_MUSIC, GetSongsCount() > 0);
+    return true;
   }
   return false;
 }
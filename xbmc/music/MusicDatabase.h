@@ -106,6 +106,8 @@ public:
 
   bool Open() override;
   bool CommitTransaction() override;
+  void BeginBulkWrite(unsigned int batchSize = BULK_WRITE_BATCH_SIZE) override;
+  bool EndBulkWrite() override;
   void EmptyCache();
   void Clean();
   int Cleanup(CGUIDialogProgress* progressDialog = nullptr);
@@ -894,6 +896,16 @@ private:
   void CreateNativeDBFunctions();
   void CreateRemovedLinkTriggers();
 
+  /*! \brief Update whether the library has music for the info manager
+   */
+  bool UpdateLibraryHasMusic();
+
+  /*! \brief Remember a genre or path id, in the permanent cache or, during a bulk write session,
+   in the scan scoped id cache of the session
+   */
+  void CacheGenre(const std::string& strGenre, int idGenre);
+  void CachePath(const std::string& strPath, int idPath);
+
   void SplitPath(const std::string& strFileNameAndPath,
                  std::string& strPath,
                  std::string& strFileName);
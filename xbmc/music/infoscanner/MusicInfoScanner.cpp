@@ -44,6 +44,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/WorkerPool.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
 #include "utils/StringUtils.h"
@@ -110,6 +111,8 @@ void CMusicInfoScanner::Process()
       // Reset progress vars
       m_currentItem=0;
       m_itemCount=-1;
+      m_tagReadFiles = 0;
+      m_tagReadDuration = {};
 
       // Create the thread to count all files to be scanned
       if (m_handle)
@@ -140,7 +143,10 @@ void CMusicInfoScanner::Process()
 
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
+        // Group the writes of many folders into few transactions
+        m_musicDatabase.BeginBulkWrite();
         bool scancomplete = DoScan(it);
+        m_musicDatabase.EndBulkWrite();
         if (scancomplete)
         {
           if (m_albumsAdded.size() > 0)
@@ -196,6 +202,9 @@ void CMusicInfoScanner::Process()
       CLog::Log(LOGINFO,
                 "My Music: Scanning for music info using worker thread, operation took {}s",
                 elapsed.count());
+      if (m_tagReadDuration.count() > 0)
+        CLog::Log(LOGINFO, "My Music: Read tags of {} files at {:.1f} files/s", m_tagReadFiles,
+                  m_tagReadFiles / std::chrono::duration<double>(m_tagReadDuration).count());
     }
     if (m_scanType == 1) // load album info
     {
@@ -487,6 +496,9 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   if (HasNoMedia(strDirectory))
     return true;
 
+  // don't keep the database locked while listing the directory
+  m_musicDatabase.FlushBulkWrite();
+
   // load subfolder
   CFileItemList items;
   CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg", DIR_FLAG_DEFAULTS);
@@ -566,11 +578,10 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
 {
   std::vector<std::string> regexps = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
 
+  std::vector<CFileItemPtr> songItems;
+  songItems.reserve(items.Size());
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -579,15 +590,46 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
+    songItems.emplace_back(pItem);
+  }
+
+  // Reading tags is dominated by file access latency, so load them on a few
+  // threads. Every job only touches the tag of its own item, everything that
+  // follows (cue sheets, adding to the library) stays on this thread.
+  const auto start = std::chrono::steady_clock::now();
+  CWorkerPool pool(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iMusicLibraryTagReaderThreads,
+                   "MusicTagReader");
+  const bool completed = pool.ForEach(
+      songItems.size(),
+      [&songItems](size_t i) {
+        CFileItem& item = *songItems[i];
+        CMusicInfoTag& tag = *item.GetMusicInfoTag();
+        if (tag.Loaded())
+          return;
+
+        std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(item));
+        if (nullptr != pLoader)
+          pLoader->Load(item.GetPath(), tag);
+      },
+      [this]() { return m_bStop.load(); });
+
+  if (!completed)
+    return INFO_CANCELLED;
+
+  m_tagReadFiles += songItems.size();
+  m_tagReadDuration += std::chrono::steady_clock::now() - start;
+
+  if (m_handle && !songItems.empty() && m_tagReadDuration.count() > 0)
+  {
+    const double rate = m_tagReadFiles / std::chrono::duration<double>(m_tagReadDuration).count();
+    m_handle->SetText(StringUtils::Format(g_localizeStrings.Get(508), Prettify(items.GetPath()), rate));
+  }
+
+  for (const auto& pItem : songItems)
+  {
     m_currentItem++;
 
     CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
-    {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (nullptr != pLoader)
-        pLoader->Load(pItem->GetPath(), tag);
-    }
 
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
@@ -912,6 +954,9 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   if (m_musicDatabase.RemoveSongsFromPath(strDirectory, songsMap))
     m_needsCleanup = true;
 
+  // don't keep the database locked while reading the tags of the files
+  m_musicDatabase.FlushBulkWrite();
+
   CFileItemList scannedItems;
   if (ScanTags(items, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
     return 0;
@@ -16,6 +16,9 @@
 #include "threads/Thread.h"
 #include "utils/ScraperUrl.h"
 
+#include <atomic>
+#include <chrono>
+
 class CAlbum;
 class CArtist;
 class CGUIDialogProgressBarHandle;
@@ -250,7 +253,9 @@ protected:
 
   int m_currentItem;
   int m_itemCount;
-  bool m_bStop;
+  size_t m_tagReadFiles = 0; //!< files whose tags were read during this scan
+  std::chrono::steady_clock::duration m_tagReadDuration{}; //!< time spent reading those tags
+  std::atomic<bool> m_bStop; // also read by the tag reader threads
   bool m_needsCleanup = false;
   int m_scanType = 0; // 0 - load from files, 1 - albums, 2 - artists
   int m_idSourcePath;
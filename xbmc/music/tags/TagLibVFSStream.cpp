@@ -9,7 +9,9 @@
 
 #include "filesystem/File.h"
 
+#include <algorithm>
 #include <limits.h>
+#include <string.h>
 
 #include <taglib/tiostream.h>
 
@@ -36,6 +38,57 @@ TagLibVFSStream::TagLibVFSStream(const std::string& strFileName, bool readOnly)
   }
   m_strFileName = strFileName;
   m_bIsReadOnly = readOnly || !m_bIsOpen;
+
+  if (readOnly && m_bIsOpen)
+    FetchWindows();
+}
+
+void TagLibVFSStream::FetchWindows()
+{
+  m_length = static_cast<long>(m_file.GetLength());
+  if (m_length <= 0)
+    return; // streams are read directly
+
+  m_prefix.resize(std::min(m_length, prefixSize()));
+  ssize_t read = m_file.Read(m_prefix.data(), m_prefix.size());
+  m_prefix.resize(read > 0 ? read : 0);
+
+  if (m_length > static_cast<long>(m_prefix.size()))
+  {
+    m_tailOffset = std::max(static_cast<long>(m_prefix.size()), m_length - tailSize());
+    m_tail.resize(m_length - m_tailOffset);
+    if (m_file.Seek(m_tailOffset, SEEK_SET) == m_tailOffset)
+    {
+      read = m_file.Read(m_tail.data(), m_tail.size());
+      m_tail.resize(read > 0 ? read : 0);
+    }
+    else
+      m_tail.clear();
+  }
+
+  m_position = 0;
+  m_bBuffered = true;
+}
+
+bool TagLibVFSStream::ReadFromWindow(const std::vector<char>& window,
+                                     long windowOffset,
+                                     ByteVector& data)
+{
+  const long windowEnd = windowOffset + static_cast<long>(window.size());
+  if (window.empty() || m_position < windowOffset || m_position >= windowEnd)
+    return false;
+
+  // a request crossing the end of a window can only be served if the window
+  // ends where the file does
+  const long wanted = static_cast<long>(data.size());
+  if (m_position + wanted > windowEnd && windowEnd != m_length)
+    return false;
+
+  const long size = std::min(wanted, windowEnd - m_position);
+  memcpy(data.data(), window.data() + (m_position - windowOffset), size);
+  data.resize(static_cast<TagLib::uint>(size));
+  m_position += size;
+  return true;
 }
 
 /*!
@@ -60,7 +113,22 @@ FileName TagLibVFSStream::name() const
 ByteVector TagLibVFSStream::readBlock(TagLib::ulong length)
 {
   ByteVector byteVector(static_cast<TagLib::uint>(length));
+
+  if (m_bBuffered)
+  {
+    if (length == 0 || m_position >= m_length)
+      return ByteVector();
+
+    if (ReadFromWindow(m_prefix, 0, byteVector) ||
+        ReadFromWindow(m_tail, m_tailOffset, byteVector))
+      return byteVector;
+
+    m_file.Seek(m_position, SEEK_SET);
+  }
+
   ssize_t read = m_file.Read(byteVector.data(), length);
+  if (m_bBuffered && read > 0)
+    m_position += read;
   if (read > 0)
     byteVector.resize(read);
   else
@@ -239,6 +307,23 @@ bool TagLibVFSStream::isOpen() const
  */
 void TagLibVFSStream::seek(long offset, Position p)
 {
+  if (m_bBuffered)
+  {
+    long startPos;
+    if (p == Beginning)
+      startPos = 0;
+    else if (p == Current)
+      startPos = m_position;
+    else if (p == End)
+      startPos = m_length;
+    else
+      return; // wrong Position value
+
+    // same clamping as below, broken files must not make taglib loop
+    m_position = std::min(std::max(startPos + offset, 0L), m_length);
+    return;
+  }
+
   const long fileLen = length();
   if (m_bIsReadOnly && fileLen > 0)
   {
@@ -297,6 +382,9 @@ void TagLibVFSStream::clear()
  */
 long TagLibVFSStream::tell() const
 {
+  if (m_bBuffered)
+    return m_position;
+
   int64_t pos = m_file.GetPosition();
   if(pos > LONG_MAX)
     return -1;
@@ -309,6 +397,9 @@ long TagLibVFSStream::tell() const
  */
 long TagLibVFSStream::length()
 {
+  if (m_bBuffered)
+    return m_length;
+
   return (long)m_file.GetLength();
 }
 
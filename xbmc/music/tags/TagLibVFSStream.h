@@ -10,6 +10,8 @@
 
 #include "filesystem/File.h"
 
+#include <vector>
+
 #include <taglib/tiostream.h>
 
 namespace MUSIC_INFO
@@ -112,11 +114,38 @@ namespace MUSIC_INFO
      */
     static TagLib::uint bufferSize() { return 1024; };
 
+    /*!
+     * Size of the window fetched from the start of read-only files, large
+     * enough for the leading tag blocks of all formats TagLib handles.
+     */
+    static constexpr long prefixSize() { return 256 * 1024; };
+
+    /*!
+     * Size of the window fetched from the end of read-only files, covers
+     * trailing ID3v1 and APE tags.
+     */
+    static constexpr long tailSize() { return 16 * 1024; };
+
   private:
     std::string   m_strFileName;
     XFILE::CFile  m_file;
     bool          m_bIsReadOnly;
     bool          m_bIsOpen;
+
+    /*!
+     * Read-only files with a known length are served from two windows fetched
+     * on open, so tag parsing usually costs at most two reads from the VFS.
+     * Requests outside the windows fall through to the file.
+     */
+    void FetchWindows();
+    bool ReadFromWindow(const std::vector<char>& window, long windowOffset, TagLib::ByteVector& data);
+
+    bool              m_bBuffered = false;
+    long              m_length = 0;
+    long              m_position = 0;
+    std::vector<char> m_prefix;
+    std::vector<char> m_tail;
+    long              m_tailOffset = 0;
   };
 }
 
@@ -0,0 +1,206 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/Album.h"
+#include "music/MusicDatabase.h"
+#include "settings/AdvancedSettings.h"
+
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr int TRACKS_PER_ALBUM = 10;
+constexpr int ARTISTS = 500;
+constexpr int GENRES = 20;
+} // namespace
+
+class TestMusicDatabase : public ::testing::Test
+{
+protected:
+  DatabaseSettings settings;
+  CMusicDatabase database;
+
+  void SetUp() override
+  {
+    settings.type = "sqlite3";
+    settings.name = "TestMusic";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+    XFILE::CFile::Delete(settings.host + settings.name + ".db");
+    ASSERT_TRUE(database.Connect(settings.name, settings, true));
+  }
+
+  /*! \brief Start over with an empty database.
+   */
+  void Recreate()
+  {
+    database.Close();
+    XFILE::CFile::Delete(settings.host + settings.name + ".db");
+    ASSERT_TRUE(database.Connect(settings.name, settings, true));
+  }
+
+  void TearDown() override
+  {
+    database.Close();
+    XFILE::CFile::Delete(settings.host + settings.name + ".db");
+  }
+
+  /*! \brief Add a synthetic library the way the scanner does, one album per folder.
+   \return the time it took in seconds
+   */
+  double ImportLibrary(int tracks, bool bulkWrite)
+  {
+    const auto start = std::chrono::steady_clock::now();
+
+    if (bulkWrite)
+      database.BeginBulkWrite();
+
+    for (int first = 0; first < tracks; first += TRACKS_PER_ALBUM)
+    {
+      const int albumNo = first / TRACKS_PER_ALBUM;
+      const std::string path = "/music/artist" + std::to_string(albumNo % ARTISTS) + "/album" +
+                               std::to_string(albumNo) + "/";
+
+      CAlbum album;
+      album.strAlbum = "Album " + std::to_string(albumNo);
+      album.strPath = path;
+      album.artistCredits.emplace_back("Artist " + std::to_string(albumNo % ARTISTS));
+      for (int track = 0; track < TRACKS_PER_ALBUM && first + track < tracks; ++track)
+      {
+        CSong song;
+        song.strTitle = "Track " + std::to_string(first + track);
+        song.strFileName = path + std::to_string(track + 1) + ".flac";
+        song.iTrack = track + 1;
+        song.iDuration = 180;
+        song.genre = {"Genre " + std::to_string((first + track) % GENRES)};
+        song.artistCredits = album.artistCredits;
+        album.songs.push_back(song);
+      }
+      database.AddAlbum(album, -1);
+    }
+
+    if (bulkWrite)
+      database.EndBulkWrite();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  }
+
+  /*! \brief Count the rows of the tables an import writes to.
+   */
+  int CountLibraryRows()
+  {
+    int rows = 0;
+    for (const char* table : {"song", "album", "artist", "genre", "path", "song_artist",
+                              "song_genre", "album_artist"})
+      rows += database.GetSingleValueInt(std::string("SELECT COUNT(1) FROM ") + table);
+    return rows;
+  }
+
+  std::string GetJournalMode()
+  {
+    return database.GetSingleValue("SELECT journal_mode FROM pragma_journal_mode");
+  }
+};
+
+TEST_F(TestMusicDatabase, BulkWriteAddsAllSongs)
+{
+  database.BeginBulkWrite(7);
+  EXPECT_TRUE(database.IsInBulkWrite());
+  ImportLibrary(250, false);
+  EXPECT_TRUE(database.EndBulkWrite());
+  EXPECT_FALSE(database.IsInBulkWrite());
+
+  EXPECT_EQ(250, database.GetSongsCount());
+}
+
+TEST_F(TestMusicDatabase, BulkWriteRollbackKeepsBatch)
+{
+  database.BeginBulkWrite();
+  ImportLibrary(20, false);
+
+  // a failed item only undoes its own changes
+  database.BeginTransaction();
+  std::string genre = "Discarded";
+  database.AddGenre(genre);
+  database.RollbackTransaction();
+
+  EXPECT_TRUE(database.EndBulkWrite());
+  EXPECT_EQ(20, database.GetSongsCount());
+  EXPECT_EQ(-1, database.GetGenreByName("Discarded"));
+}
+
+TEST_F(TestMusicDatabase, BulkWriteCachedIds)
+{
+  database.BeginBulkWrite();
+  std::string genre = "Cached";
+  const int idGenre = database.AddGenre(genre);
+  EXPECT_EQ(idGenre, database.AddGenre(genre));
+  const int idArtist = database.AddArtist("Cached Artist", "");
+  EXPECT_EQ(idArtist, database.AddArtist("Cached Artist", ""));
+
+  // rolled back rows must not be served from the cache afterwards
+  database.BeginTransaction();
+  std::string discarded = "Discarded";
+  database.AddGenre(discarded);
+  database.RollbackTransaction();
+  const int idDiscarded = database.AddGenre(discarded);
+
+  EXPECT_TRUE(database.EndBulkWrite());
+  EXPECT_EQ(idGenre, database.GetGenreByName("Cached"));
+  EXPECT_EQ(idArtist, database.GetArtistByName("Cached Artist"));
+  EXPECT_EQ(idDiscarded, database.GetGenreByName("Discarded"));
+}
+
+TEST_F(TestMusicDatabase, BulkWriteUsesWriteAheadLog)
+{
+  EXPECT_EQ("delete", GetJournalMode());
+  database.BeginBulkWrite();
+  EXPECT_EQ("wal", GetJournalMode());
+  ImportLibrary(20, false);
+  EXPECT_TRUE(database.EndBulkWrite());
+  EXPECT_EQ("delete", GetJournalMode());
+}
+
+TEST_F(TestMusicDatabase, ScanImportRate)
+{
+  const double perItem = ImportLibrary(1000, false);
+  EXPECT_EQ(1000, database.GetSongsCount());
+
+  // the same tracks again, into an empty library
+  Recreate();
+  const double bulk = ImportLibrary(1000, true);
+  EXPECT_EQ(1000, database.GetSongsCount());
+
+  RecordProperty("tracksPerSecond", static_cast<int>(1000 / perItem));
+  RecordProperty("tracksPerSecondBulk", static_cast<int>(1000 / bulk));
+}
+
+TEST_F(TestMusicDatabase, ScanImportRate5k)
+{
+  const double bulk = ImportLibrary(5000, true);
+
+  EXPECT_EQ(5000, database.GetSongsCount());
+  RecordProperty("tracksPerSecondBulk", static_cast<int>(5000 / bulk));
+  RecordProperty("rowsPerSecondBulk", static_cast<int>(CountLibraryRows() / bulk));
+}
+
+// Run with --gtest_also_run_disabled_tests to import a full size library
+TEST_F(TestMusicDatabase, DISABLED_ScanImportRate50k)
+{
+  const double bulk = ImportLibrary(50000, true);
+
+  EXPECT_EQ(50000, database.GetSongsCount());
+  RecordProperty("tracksPerSecondBulk", static_cast<int>(50000 / bulk));
+  RecordProperty("rowsPerSecondBulk", static_cast<int>(CountLibraryRows() / bulk));
+}
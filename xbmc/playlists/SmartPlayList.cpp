@@ -860,9 +860,48 @@ std::string CSmartPlaylistRule::FormatYearQuery(const std::string& field,
   return query;
 }
 
+std::string CSmartPlaylistRule::GetFullTextIndex(const std::string& strType) const
+{
+  // the fields covered by the full text indexes of the music and video databases
+  if (strType == "songs" && m_field == FieldTitle)
+    return "song_fts";
+  else if (strType == "albums" && m_field == FieldAlbum)
+    return "album_fts";
+  else if (strType == "artists" && m_field == FieldArtist)
+    return "artist_fts";
+  else if (strType == "movies" &&
+           (m_field == FieldTitle || m_field == FieldPlot || m_field == FieldPlotOutline ||
+            m_field == FieldTagline || m_field == FieldOriginalTitle))
+    return "movie_fts";
+  else if (strType == "tvshows" && m_field == FieldTitle)
+    return "tvshow_fts";
+  else if (strType == "episodes" && (m_field == FieldTitle || m_field == FieldPlot))
+    return "episode_fts";
+  else if (strType == "musicvideos" && m_field == FieldTitle)
+    return "musicvideo_fts";
+
+  return "";
+}
+
 std::string CSmartPlaylistRule::FormatWhereClause(const std::string &negate, const std::string &oper, const std::string &param,
                                                  const CDatabase &db, const std::string &strType) const
 {
+  const SEARCH_OPERATOR op = GetOperator(strType);
+  if (op == OPERATOR_CONTAINS || op == OPERATOR_DOES_NOT_CONTAIN)
+  {
+    // use the full text index (matching word prefixes) instead of a LIKE scan where available
+    const std::string index = GetFullTextIndex(strType);
+    if (!index.empty())
+    {
+      std::string column = GetField(m_field, strType);
+      column = column.substr(column.find('.') + 1);
+      const std::string condition =
+          db.PrepareFullTextCondition(index, GetField(FieldId, strType), {column}, param);
+      if (!condition.empty())
+        return negate + condition;
+    }
+  }
+
   std::string parameter = FormatParameter(oper, param, db, strType);
 
   std::string query;
@@ -66,6 +66,7 @@ protected:
 
 private:
   std::string GetVideoResolutionQuery(const std::string &parameter) const;
+  std::string GetFullTextIndex(const std::string& strType) const;
   static std::string FormatLinkQuery(const char *field, const char *table, const MediaType& mediaType, const std::string& mediaField, const std::string& parameter);
   std::string FormatYearQuery(const std::string& field,
                               const std::string& param,
@@ -9,11 +9,13 @@
 #include "PVRDatabase.h"
 
 #include "ServiceBroker.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_recordings.h"
 #include "dbwrappers/dataset.h"
 #include "pvr/addons/PVRClient.h"
 #include "pvr/channels/PVRChannel.h"
 #include "pvr/channels/PVRChannelGroupMember.h"
 #include "pvr/channels/PVRChannelGroups.h"
+#include "pvr/recordings/PVRRecording.h"
 #include "pvr/timers/PVRTimerInfoTag.h"
 #include "pvr/timers/PVRTimerType.h"
 #include "settings/AdvancedSettings.h"
@@ -23,6 +25,7 @@
 #include "utils/log.h"
 
 #include <cstdlib>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <string>
@@ -64,6 +67,41 @@ namespace
       "iRecordingGroup    integer"
   ")";
 
+  static const std::string sqlCreateRecordingsTable =
+    "CREATE TABLE recordings ("
+      "idClient            integer, "
+      "sRecordingId        varchar(255), "
+      "iDataHash           integer, "
+      "sTitle              varchar(255), "
+      "sEpisodeName        varchar(255), "
+      "iSeriesNumber       integer, "
+      "iEpisodeNumber      integer, "
+      "iYear               integer, "
+      "sDirectory          text, "
+      "sPlotOutline        text, "
+      "sPlot               text, "
+      "sGenreDescription   text, "
+      "sChannelName        varchar(255), "
+      "sIconPath           text, "
+      "sThumbnailPath      text, "
+      "sFanartPath         text, "
+      "iRecordingTime      bigint, "
+      "iDuration           integer, "
+      "iPriority           integer, "
+      "iLifetime           integer, "
+      "iGenreType          integer, "
+      "iGenreSubType       integer, "
+      "iPlayCount          integer, "
+      "iLastPlayedPosition integer, "
+      "bIsDeleted          bool, "
+      "iEpgEventId         integer, "
+      "iChannelUid         integer, "
+      "iChannelType        integer, "
+      "sFirstAired         varchar(32), "
+      "iFlags              integer, "
+      "iSizeInBytes        bigint"
+  ")";
+
   static const std::string sqlCreateChannelGroupsTable =
     "CREATE TABLE channelgroups ("
       "idGroup         integer primary key,"
@@ -77,6 +115,35 @@ namespace
   ")";
 
 // clang-format on
+
+/*!
+ * @brief Hash the columns of a map_channelgroups_channels row, to tell whether a group member
+ * changed since it was persisted.
+ */
+unsigned int GetMemberDataHash(int iChannelId,
+                               const CPVRChannelNumber& channelNumber,
+                               int iOrder,
+                               const CPVRChannelNumber& clientChannelNumber)
+{
+  const unsigned int values[] = {static_cast<unsigned int>(iChannelId),
+                                 channelNumber.GetChannelNumber(),
+                                 channelNumber.GetSubChannelNumber(),
+                                 static_cast<unsigned int>(iOrder),
+                                 clientChannelNumber.GetChannelNumber(),
+                                 clientChannelNumber.GetSubChannelNumber()};
+
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (unsigned int value : values)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      hash ^= (value >> (i * 8)) & 0xFF;
+      hash *= 16777619u;
+    }
+  }
+  return hash;
+}
 } // unnamed namespace
 
 bool CPVRDatabase::Open()
@@ -155,6 +222,9 @@ void CPVRDatabase::CreateTables()
 
   CLog::LogFC(LOGDEBUG, LOGPVR, "Creating table 'timers'");
   m_pDS->exec(sqlCreateTimersTable);
+
+  CLog::LogFC(LOGDEBUG, LOGPVR, "Creating table 'recordings'");
+  m_pDS->exec(sqlCreateRecordingsTable);
 }
 
 void CPVRDatabase::CreateAnalytics()
@@ -167,6 +237,7 @@ void CPVRDatabase::CreateAnalytics()
   m_pDS->exec("CREATE INDEX idx_channelgroups_bIsRadio on channelgroups(bIsRadio);");
   m_pDS->exec("CREATE UNIQUE INDEX idx_idGroup_idChannel on map_channelgroups_channels(idGroup, idChannel);");
   m_pDS->exec("CREATE INDEX idx_timers_iClientIndex on timers(iClientIndex);");
+  m_pDS->exec("CREATE UNIQUE INDEX idx_recordings_idClient_sRecordingId on recordings(idClient, sRecordingId);");
 }
 
 void CPVRDatabase::UpdateTables(int iVersion)
@@ -252,6 +323,9 @@ void CPVRDatabase::UpdateTables(int iVersion)
 
     m_pDS->exec("DROP TABLE channelgroups_old");
   }
+
+  if (iVersion < 39)
+    m_pDS->exec(sqlCreateRecordingsTable);
 }
 
 /********** Client methods **********/
@@ -342,21 +416,23 @@ bool CPVRDatabase::QueueDeleteQuery(const CPVRChannel& channel)
 }
 
 void CPVRDatabase::InsertChannelIntoGroup(const std::shared_ptr<CPVRChannel>& channel,
-                                          CPVRChannelGroup& group)
+                                          CPVRChannelGroup& group,
+                                          const CPVRChannelNumber& channelNumber,
+                                          int iOrder,
+                                          const CPVRChannelNumber& clientChannelNumber)
 {
   const auto newMember = std::make_shared<CPVRChannelGroupMember>();
   newMember->m_channel = channel;
-  newMember->m_channelNumber = {
-      static_cast<unsigned int>(m_pDS->fv("iChannelNumber").get_asInt()),
-      static_cast<unsigned int>(m_pDS->fv("iSubChannelNumber").get_asInt())};
-  newMember->m_clientChannelNumber = {
-      static_cast<unsigned int>(m_pDS->fv("iClientChannelNumber").get_asInt()),
-      static_cast<unsigned int>(m_pDS->fv("iClientSubChannelNumber").get_asInt())};
-  newMember->m_iOrder = static_cast<int>(m_pDS->fv("iOrder").get_asInt());
+  newMember->m_channelNumber = channelNumber;
+  newMember->m_clientChannelNumber = clientChannelNumber;
+  newMember->m_iOrder = iOrder;
   newMember->SetGroupName(group.GroupName());
 
   group.m_sortedMembers.emplace_back(newMember);
   group.m_members.insert(std::make_pair(channel->StorageId(), newMember));
+  group.m_persistedMembers[channel->StorageId()] = {
+      channel->ChannelID(),
+      GetMemberDataHash(channel->ChannelID(), channelNumber, iOrder, clientChannelNumber)};
 }
 
 int CPVRDatabase::Get(CPVRChannelGroup& results)
@@ -396,7 +472,13 @@ int CPVRDatabase::Get(CPVRChannelGroup& results)
         channel->m_bHasArchive = m_pDS->fv("bHasArchive").get_asBool();
         channel->UpdateEncryptionName();
 
-        InsertChannelIntoGroup(channel, results);
+        InsertChannelIntoGroup(
+            channel, results,
+            {static_cast<unsigned int>(m_pDS->fv("iChannelNumber").get_asInt()),
+             static_cast<unsigned int>(m_pDS->fv("iSubChannelNumber").get_asInt())},
+            m_pDS->fv("iOrder").get_asInt(),
+            {static_cast<unsigned int>(m_pDS->fv("iClientChannelNumber").get_asInt()),
+             static_cast<unsigned int>(m_pDS->fv("iClientSubChannelNumber").get_asInt())});
 
         m_pDS->next();
         ++iReturn;
@@ -439,6 +521,7 @@ bool CPVRDatabase::RemoveChannelsFromGroup(const CPVRChannelGroup& group)
   filter.AppendWhere(PrepareSQL("idGroup = %u", group.GroupID()));
 
   CSingleLock lock(m_critSection);
+  group.m_persistedMembers.clear();
   return DeleteValues("map_channelgroups_channels", filter);
 }
 
@@ -562,25 +645,25 @@ bool CPVRDatabase::RemoveStaleChannelsFromGroup(const CPVRChannelGroup& group)
 
   if (group.HasChannels())
   {
-    std::vector<int> currentMembers;
-    if (GetCurrentGroupMembers(group, currentMembers))
+    // the persisted members are keyed by client and channel uid like the members, no need to
+    // look up the current members and their clients in the database
+    std::vector<int> channelsToDelete;
+    for (auto it = group.m_persistedMembers.begin(); it != group.m_persistedMembers.end();)
     {
-      std::vector<int> channelsToDelete;
-      for (int iChannelId : currentMembers)
+      if (group.m_members.find(it->first) == group.m_members.end() &&
+          group.HasValidDataFromClient(it->first.first))
       {
-        if (!group.IsGroupMember(iChannelId))
-        {
-          int iClientId = GetClientIdByChannelId(iChannelId);
-          if (iClientId == PVR_INVALID_CLIENT_ID || group.HasValidDataFromClient(iClientId))
-          {
-            channelsToDelete.emplace_back(iChannelId);
-          }
-        }
+        channelsToDelete.emplace_back(it->second.iChannelId);
+        it = group.m_persistedMembers.erase(it);
+      }
+      else
+      {
+        ++it;
       }
-
-      if (!channelsToDelete.empty())
-        bDelete = DeleteChannelsFromGroup(group, channelsToDelete) && bDelete;
     }
+
+    if (!channelsToDelete.empty())
+      bDelete = DeleteChannelsFromGroup(group, channelsToDelete) && bDelete;
   }
   else
   {
@@ -588,6 +671,7 @@ bool CPVRDatabase::RemoveStaleChannelsFromGroup(const CPVRChannelGroup& group)
     filter.AppendWhere(PrepareSQL("idGroup = %u", group.GroupID()));
 
     bDelete = DeleteValues("map_channelgroups_channels", filter) && bDelete;
+    group.m_persistedMembers.clear();
   }
 
   return bDelete;
@@ -689,74 +773,156 @@ int CPVRDatabase::Get(CPVRChannelGroup& group, const CPVRChannelGroup& allGroup)
 
   CSingleLock lock(m_critSection);
 
-  const std::string strQuery = PrepareSQL("SELECT idChannel, iChannelNumber, iSubChannelNumber, iOrder, iClientChannelNumber, iClientSubChannelNumber FROM map_channelgroups_channels "
-                                          "WHERE idGroup = %u ORDER BY iChannelNumber", group.GroupID());
-  if (ResultQuery(strQuery))
+  ChannelGroupMemberColumns members;
+  const auto cached = m_channelGroupMembersCache.find(group.GroupID());
+  if (cached != m_channelGroupMembersCache.end())
   {
-    iReturn = 0;
+    members = std::move(cached->second);
+    m_channelGroupMembersCache.erase(cached);
+  }
+  else
+  {
+    std::map<int, ChannelGroupMemberColumns> results;
+    const std::string strQuery = PrepareSQL(
+        "SELECT idGroup, idChannel, iChannelNumber, iSubChannelNumber, iOrder, "
+        "iClientChannelNumber, iClientSubChannelNumber FROM map_channelgroups_channels "
+        "WHERE idGroup = %u ORDER BY iChannelNumber",
+        group.GroupID());
+    if (GetChannelGroupMembers(strQuery, results) < 0)
+      return -1;
+
+    members = std::move(results[group.GroupID()]);
+  }
 
-    // create a map to speedup data lookup
-    std::map<int, std::shared_ptr<CPVRChannel>> allChannels;
-    for (const auto& groupMember : allGroup.m_sortedMembers)
+  iReturn = 0;
+
+  // create a map to speedup data lookup
+  std::map<int, std::shared_ptr<CPVRChannel>> allChannels;
+  for (const auto& groupMember : allGroup.m_sortedMembers)
+  {
+    allChannels.insert(
+        std::make_pair(groupMember->Channel()->ChannelID(), groupMember->Channel()));
+  }
+
+  for (size_t i = 0; i < members.channelIds.size(); ++i)
+  {
+    const int iChannelId = members.channelIds[i];
+    const auto& channel = allChannels.find(iChannelId);
+
+    if (channel != allChannels.end())
+    {
+      InsertChannelIntoGroup(
+          channel->second, group, {members.channelNumbers[i], members.subChannelNumbers[i]},
+          members.orders[i],
+          {members.clientChannelNumbers[i], members.clientSubChannelNumbers[i]});
+      ++iReturn;
+    }
+    else
     {
-      allChannels.insert(
-          std::make_pair(groupMember->Channel()->ChannelID(), groupMember->Channel()));
+      // remove the channel from the table if it doesn't exist on client (anymore)
+      int iClientId = GetClientIdByChannelId(iChannelId);
+      if (iClientId == PVR_INVALID_CLIENT_ID || allGroup.HasValidDataFromClient(iClientId))
+      {
+        Filter filter;
+        filter.AppendWhere(PrepareSQL("idGroup = %u", group.GroupID()));
+        filter.AppendWhere(PrepareSQL("idChannel = %u", iChannelId));
+        DeleteValues("map_channelgroups_channels", filter);
+      }
     }
+  }
+
+  if (iReturn > 0)
+    group.SortByChannelNumber();
 
+  return iReturn;
+}
+
+int CPVRDatabase::GetChannelGroupMembers(const std::string& strQuery,
+                                         std::map<int, ChannelGroupMemberColumns>& results)
+{
+  int iReturn = -1;
+
+  if (ResultQuery(strQuery))
+  {
+    iReturn = 0;
     try
     {
       while (!m_pDS->eof())
       {
-        int iChannelId = m_pDS->fv("idChannel").get_asInt();
-        const auto& channel = allChannels.find(iChannelId);
+        ChannelGroupMemberColumns& members = results[m_pDS->fv("idGroup").get_asInt()];
 
-        if (channel != allChannels.end())
+        const field_value& channelId = m_pDS->fv("idChannel");
+        if (!channelId.get_isNull())
         {
-          InsertChannelIntoGroup(channel->second, group);
+          members.channelIds.emplace_back(channelId.get_asInt());
+          members.channelNumbers.emplace_back(m_pDS->fv("iChannelNumber").get_asInt());
+          members.subChannelNumbers.emplace_back(m_pDS->fv("iSubChannelNumber").get_asInt());
+          members.orders.emplace_back(m_pDS->fv("iOrder").get_asInt());
+          members.clientChannelNumbers.emplace_back(m_pDS->fv("iClientChannelNumber").get_asInt());
+          members.clientSubChannelNumbers.emplace_back(
+              m_pDS->fv("iClientSubChannelNumber").get_asInt());
           ++iReturn;
         }
-        else
-        {
-          // remove the channel from the table if it doesn't exist on client (anymore)
-          int iClientId = GetClientIdByChannelId(iChannelId);
-          if (iClientId == PVR_INVALID_CLIENT_ID || allGroup.HasValidDataFromClient(iClientId))
-          {
-            Filter filter;
-            filter.AppendWhere(PrepareSQL("idGroup = %u", group.GroupID()));
-            filter.AppendWhere(PrepareSQL("idChannel = %u", iChannelId));
-            DeleteValues("map_channelgroups_channels", filter);
-          }
-        }
 
         m_pDS->next();
       }
       m_pDS->close();
     }
-    catch(...)
+    catch (...)
     {
-      CLog::LogF(LOGERROR, "Failed to get channels");
+      CLog::LogF(LOGERROR, "Failed to get channel group members");
+      iReturn = -1;
     }
   }
 
-  if (iReturn > 0)
-    group.SortByChannelNumber();
+  return iReturn;
+}
+
+int CPVRDatabase::CacheChannelGroupMembers(bool bRadio)
+{
+  CSingleLock lock(m_critSection);
+
+  // groups without members are cached as well, so that Get does not query them again
+  const std::string strQuery = PrepareSQL(
+      "SELECT channelgroups.idGroup, map_channelgroups_channels.idChannel, "
+      "map_channelgroups_channels.iChannelNumber, map_channelgroups_channels.iSubChannelNumber, "
+      "map_channelgroups_channels.iOrder, map_channelgroups_channels.iClientChannelNumber, "
+      "map_channelgroups_channels.iClientSubChannelNumber FROM channelgroups "
+      "LEFT JOIN map_channelgroups_channels "
+      "ON map_channelgroups_channels.idGroup = channelgroups.idGroup "
+      "WHERE channelgroups.bIsRadio = %u AND channelgroups.iGroupType <> %u "
+      "ORDER BY channelgroups.idGroup, map_channelgroups_channels.iChannelNumber",
+      bRadio, PVR_GROUP_TYPE_INTERNAL);
+
+  const int iReturn = GetChannelGroupMembers(strQuery, m_channelGroupMembersCache);
+  if (iReturn < 0)
+    m_channelGroupMembersCache.clear();
 
   return iReturn;
 }
 
+void CPVRDatabase::ClearChannelGroupMembersCache()
+{
+  CSingleLock lock(m_critSection);
+  m_channelGroupMembersCache.clear();
+}
+
 bool CPVRDatabase::PersistChannels(CPVRChannelGroup& group)
 {
   bool bReturn(true);
 
-  std::shared_ptr<CPVRChannel> channel;
+  std::vector<std::shared_ptr<CPVRChannel>> newChannels;
   for (const auto& groupMember : group.m_members)
   {
-    channel = groupMember.second->Channel();
+    const std::shared_ptr<CPVRChannel> channel = groupMember.second->Channel();
     if (channel->IsChanged() || channel->IsNew())
     {
       if (Persist(*channel, false))
       {
         channel->Persisted();
+        if (channel->IsNew())
+          newChannels.emplace_back(channel);
+
         bReturn = true;
       }
     }
@@ -764,17 +930,34 @@ bool CPVRDatabase::PersistChannels(CPVRChannelGroup& group)
 
   bReturn &= CommitInsertQueries();
 
-  if (bReturn)
+  // only the ids of new channels are unknown, get them all with a single query
+  if (bReturn && !newChannels.empty())
   {
-    std::string strQuery;
-    std::string strValue;
-    for (const auto& groupMember : group.m_members)
+    std::map<std::pair<int, int>, int> channelIds;
+    if (ResultQuery("SELECT idChannel, iClientId, iUniqueId FROM channels"))
+    {
+      try
+      {
+        while (!m_pDS->eof())
+        {
+          const std::pair<int, int> storageId(m_pDS->fv("iClientId").get_asInt(),
+                                              m_pDS->fv("iUniqueId").get_asInt());
+          channelIds.insert({storageId, m_pDS->fv("idChannel").get_asInt()});
+          m_pDS->next();
+        }
+        m_pDS->close();
+      }
+      catch (...)
+      {
+        CLog::LogF(LOGERROR, "Failed to get channel ids");
+      }
+    }
+
+    for (const auto& channel : newChannels)
     {
-      channel = groupMember.second->Channel();
-      strQuery = PrepareSQL("iUniqueId = %u AND iClientId = %u", channel->UniqueID(), channel->ClientID());
-      strValue = GetSingleValue("channels", "idChannel", strQuery);
-      if (!strValue.empty() && StringUtils::IsInteger(strValue))
-        channel->SetChannelID(atoi(strValue.c_str()));
+      const auto it = channelIds.find(channel->StorageId());
+      if (it != channelIds.end())
+        channel->SetChannelID(it->second);
     }
   }
 
@@ -790,35 +973,35 @@ bool CPVRDatabase::PersistGroupMembers(const CPVRChannelGroup& group)
 
   if (group.HasChannels())
   {
+    std::vector<std::pair<std::pair<int, int>, CPVRChannelGroup::PersistedMember>> persisted;
     for (const auto& groupMember : group.m_sortedMembers)
     {
       if (groupMember->NeedsSave())
       {
-        const std::string strWhereClause =
-            PrepareSQL("idChannel = %u AND idGroup = %u AND iChannelNumber = %u AND "
-                       "iSubChannelNumber = %u AND "
-                       "iOrder = %u AND iClientChannelNumber = %u AND iClientSubChannelNumber = %u",
-                       groupMember->Channel()->ChannelID(), group.GroupID(),
-                       groupMember->ChannelNumber().GetChannelNumber(),
-                       groupMember->ChannelNumber().GetSubChannelNumber(), groupMember->Order(),
-                       groupMember->ClientChannelNumber().GetChannelNumber(),
-                       groupMember->ClientChannelNumber().GetSubChannelNumber());
-
-        const std::string strValue =
-            GetSingleValue("map_channelgroups_channels", "idChannel", strWhereClause);
-        if (strValue.empty())
+        // compare with the persisted row instead of querying the database for it
+        const std::shared_ptr<CPVRChannel> channel = groupMember->Channel();
+        const unsigned int iDataHash =
+            GetMemberDataHash(channel->ChannelID(), groupMember->ChannelNumber(),
+                              groupMember->Order(), groupMember->ClientChannelNumber());
+
+        const auto it = group.m_persistedMembers.find(channel->StorageId());
+        if (it == group.m_persistedMembers.end() || it->second.iChannelId != channel->ChannelID() ||
+            it->second.iDataHash != iDataHash)
         {
           strQuery =
               PrepareSQL("REPLACE INTO map_channelgroups_channels ("
                          "idGroup, idChannel, iChannelNumber, iSubChannelNumber, iOrder, "
                          "iClientChannelNumber, iClientSubChannelNumber) "
                          "VALUES (%i, %i, %i, %i, %i, %i, %i);",
-                         group.GroupID(), groupMember->Channel()->ChannelID(),
+                         group.GroupID(), channel->ChannelID(),
                          groupMember->ChannelNumber().GetChannelNumber(),
                          groupMember->ChannelNumber().GetSubChannelNumber(), groupMember->Order(),
                          groupMember->ClientChannelNumber().GetChannelNumber(),
                          groupMember->ClientChannelNumber().GetSubChannelNumber());
           QueueInsertQuery(strQuery);
+          persisted.emplace_back(
+              channel->StorageId(),
+              CPVRChannelGroup::PersistedMember{channel->ChannelID(), iDataHash});
         }
       }
     }
@@ -831,6 +1014,9 @@ bool CPVRDatabase::PersistGroupMembers(const CPVRChannelGroup& group)
       {
         groupMember->SetSaved();
       }
+
+      for (const auto& member : persisted)
+        group.m_persistedMembers[member.first] = member.second;
     }
 
     bRemoveChannels = RemoveStaleChannelsFromGroup(group);
@@ -1102,3 +1288,139 @@ bool CPVRDatabase::DeleteTimers()
   CSingleLock lock(m_critSection);
   return DeleteValues("timers");
 }
+
+/********** Recording methods **********/
+
+namespace
+{
+template<size_t N>
+void CopyString(char (&target)[N], const std::string& source)
+{
+  strncpy(target, source.c_str(), N - 1);
+  target[N - 1] = '\0';
+}
+} // unnamed namespace
+
+int CPVRDatabase::GetRecordings(const RecordingTransferFunction& transfer)
+{
+  int iCount = 0;
+
+  CSingleLock lock(m_critSection);
+  const std::string strQuery = PrepareSQL("SELECT * FROM recordings");
+  if (ResultQuery(strQuery))
+  {
+    try
+    {
+      // the client data is large, reuse it for all rows
+      const auto recording = std::make_unique<PVR_RECORDING>();
+      while (!m_pDS->eof())
+      {
+        *recording = {};
+        CopyString(recording->strRecordingId, m_pDS->fv("sRecordingId").get_asString());
+        CopyString(recording->strTitle, m_pDS->fv("sTitle").get_asString());
+        CopyString(recording->strEpisodeName, m_pDS->fv("sEpisodeName").get_asString());
+        recording->iSeriesNumber = m_pDS->fv("iSeriesNumber").get_asInt();
+        recording->iEpisodeNumber = m_pDS->fv("iEpisodeNumber").get_asInt();
+        recording->iYear = m_pDS->fv("iYear").get_asInt();
+        CopyString(recording->strDirectory, m_pDS->fv("sDirectory").get_asString());
+        CopyString(recording->strPlotOutline, m_pDS->fv("sPlotOutline").get_asString());
+        CopyString(recording->strPlot, m_pDS->fv("sPlot").get_asString());
+        CopyString(recording->strGenreDescription, m_pDS->fv("sGenreDescription").get_asString());
+        CopyString(recording->strChannelName, m_pDS->fv("sChannelName").get_asString());
+        CopyString(recording->strIconPath, m_pDS->fv("sIconPath").get_asString());
+        CopyString(recording->strThumbnailPath, m_pDS->fv("sThumbnailPath").get_asString());
+        CopyString(recording->strFanartPath, m_pDS->fv("sFanartPath").get_asString());
+        recording->recordingTime = static_cast<time_t>(m_pDS->fv("iRecordingTime").get_asInt64());
+        recording->iDuration = m_pDS->fv("iDuration").get_asInt();
+        recording->iPriority = m_pDS->fv("iPriority").get_asInt();
+        recording->iLifetime = m_pDS->fv("iLifetime").get_asInt();
+        recording->iGenreType = m_pDS->fv("iGenreType").get_asInt();
+        recording->iGenreSubType = m_pDS->fv("iGenreSubType").get_asInt();
+        recording->iPlayCount = m_pDS->fv("iPlayCount").get_asInt();
+        recording->iLastPlayedPosition = m_pDS->fv("iLastPlayedPosition").get_asInt();
+        recording->bIsDeleted = m_pDS->fv("bIsDeleted").get_asBool();
+        recording->iEpgEventId = m_pDS->fv("iEpgEventId").get_asUInt();
+        recording->iChannelUid = m_pDS->fv("iChannelUid").get_asInt();
+        recording->channelType =
+            static_cast<PVR_RECORDING_CHANNEL_TYPE>(m_pDS->fv("iChannelType").get_asInt());
+        CopyString(recording->strFirstAired, m_pDS->fv("sFirstAired").get_asString());
+        recording->iFlags = m_pDS->fv("iFlags").get_asUInt();
+        recording->sizeInBytes = m_pDS->fv("iSizeInBytes").get_asInt64();
+
+        transfer(*recording, m_pDS->fv("idClient").get_asInt(),
+                 static_cast<unsigned int>(m_pDS->fv("iDataHash").get_asInt64()));
+        ++iCount;
+
+        m_pDS->next();
+      }
+      m_pDS->close();
+    }
+    catch (...)
+    {
+      CLog::LogF(LOGERROR, "Could not load recordings from the database");
+    }
+  }
+  return iCount;
+}
+
+bool CPVRDatabase::QueuePersistQuery(const PVR_RECORDING& recording,
+                                     int iClientId,
+                                     unsigned int iDataHash)
+{
+  CSingleLock lock(m_critSection);
+
+  const std::string strQuery = GetPersistQuery(recording, iClientId, iDataHash);
+  return !strQuery.empty() && QueueInsertQuery(strQuery);
+}
+
+std::string CPVRDatabase::GetPersistQuery(const PVR_RECORDING& recording,
+                                          int iClientId,
+                                          unsigned int iDataHash)
+{
+  CSingleLock lock(m_critSection);
+  if (!m_pDB)
+    return {};
+
+  return PrepareSQL(
+      "REPLACE INTO recordings ("
+      "idClient, sRecordingId, iDataHash, sTitle, sEpisodeName, iSeriesNumber, iEpisodeNumber, "
+      "iYear, sDirectory, sPlotOutline, sPlot, sGenreDescription, sChannelName, sIconPath, "
+      "sThumbnailPath, sFanartPath, iRecordingTime, iDuration, iPriority, iLifetime, iGenreType, "
+      "iGenreSubType, iPlayCount, iLastPlayedPosition, bIsDeleted, iEpgEventId, iChannelUid, "
+      "iChannelType, sFirstAired, iFlags, iSizeInBytes) "
+      "VALUES (%i, '%s', %u, '%s', '%s', %i, %i, %i, '%s', '%s', '%s', '%s', '%s', '%s', '%s', "
+      "'%s', %lld, %i, %i, %i, %i, %i, %i, %i, %i, %u, %i, %i, '%s', %u, %lld)",
+      iClientId, recording.strRecordingId, iDataHash, recording.strTitle,
+      recording.strEpisodeName, recording.iSeriesNumber, recording.iEpisodeNumber, recording.iYear,
+      recording.strDirectory, recording.strPlotOutline, recording.strPlot,
+      recording.strGenreDescription, recording.strChannelName, recording.strIconPath,
+      recording.strThumbnailPath, recording.strFanartPath,
+      static_cast<long long>(recording.recordingTime), recording.iDuration, recording.iPriority,
+      recording.iLifetime, recording.iGenreType, recording.iGenreSubType, recording.iPlayCount,
+      recording.iLastPlayedPosition, recording.bIsDeleted ? 1 : 0, recording.iEpgEventId,
+      recording.iChannelUid, static_cast<int>(recording.channelType), recording.strFirstAired,
+      recording.iFlags, static_cast<long long>(recording.sizeInBytes));
+}
+
+bool CPVRDatabase::QueueDeleteQuery(const CPVRRecordingUid& uid)
+{
+  CSingleLock lock(m_critSection);
+
+  Filter filter;
+  filter.AppendWhere(PrepareSQL("idClient = %i AND sRecordingId = '%s'", uid.m_iClientId,
+                                uid.m_strRecordingId.c_str()));
+
+  std::string strQuery;
+  if (BuildSQL(PrepareSQL("DELETE FROM %s ", "recordings"), filter, strQuery))
+    return CDatabase::QueueDeleteQuery(strQuery);
+
+  return false;
+}
+
+bool CPVRDatabase::DeleteRecordings()
+{
+  CLog::LogFC(LOGDEBUG, LOGPVR, "Deleting all recordings from the database");
+
+  CSingleLock lock(m_critSection);
+  return DeleteValues("recordings");
+}
@@ -11,15 +11,21 @@
 #include "dbwrappers/Database.h"
 #include "threads/CriticalSection.h"
 
+#include <functional>
 #include <map>
+#include <string>
 #include <vector>
 
+struct PVR_RECORDING;
+
 namespace PVR
 {
   class CPVRChannel;
   class CPVRChannelGroup;
   class CPVRChannelGroups;
+  class CPVRChannelNumber;
   class CPVRClient;
+  class CPVRRecordingUid;
   class CPVRTimerInfoTag;
   class CPVRTimers;
 
@@ -61,7 +67,7 @@ namespace PVR
      * @brief Get the minimal database version that is required to operate correctly.
      * @return The minimal database version.
      */
-    int GetSchemaVersion() const override { return 38; }
+    int GetSchemaVersion() const override { return 39; }
 
     /*!
      * @brief Get the default sqlite database filename.
@@ -170,6 +176,20 @@ namespace PVR
      */
     int Get(CPVRChannelGroup& group, const CPVRChannelGroup& allGroup);
 
+    /*!
+     * @brief Load the members of all non-internal channel groups with a single query. Subsequent
+     * calls of Get(group, allGroup) take the members from this cache instead of querying the
+     * database for every group.
+     * @param bRadio Whether to cache the members of the radio or the TV groups.
+     * @return The amount of group members that were cached.
+     */
+    int CacheChannelGroupMembers(bool bRadio);
+
+    /*!
+     * @brief Drop the group members cached by CacheChannelGroupMembers.
+     */
+    void ClearChannelGroupMembersCache();
+
     /*!
      * @brief Add or update a channel group entry in the database.
      * @param group The group to persist.
@@ -214,6 +234,57 @@ namespace PVR
     bool DeleteTimers();
     //@}
 
+    /*! @name Recording methods */
+    //@{
+
+    using RecordingTransferFunction =
+        std::function<void(const PVR_RECORDING& recording, int iClientId, unsigned int iDataHash)>;
+
+    /*!
+     * @brief Get the recordings cached from the clients.
+     * @param transfer Called with the client data, the client id and the data hash of each cached
+     * recording.
+     * @return The number of cached recordings.
+     */
+    int GetRecordings(const RecordingTransferFunction& transfer);
+
+    /*!
+     * @brief Queue the query to cache a recording delivered by a client. Commit queued queries
+     * with CommitQueuedQueries.
+     * @param recording The client data of the recording.
+     * @param iClientId The id of the client.
+     * @param iDataHash The hash of the client data, to detect changed recordings.
+     * @return True if the query was queued, false otherwise.
+     */
+    bool QueuePersistQuery(const PVR_RECORDING& recording, int iClientId, unsigned int iDataHash);
+
+    /*!
+     * @brief Get the query to cache a recording delivered by a client, to queue it later with
+     * QueueInsertQuery. Much smaller than the client data, which has fixed size strings.
+     * @param recording The client data of the recording.
+     * @param iClientId The id of the client.
+     * @param iDataHash The hash of the client data, to detect changed recordings.
+     * @return The query, empty if the database is not open.
+     */
+    std::string GetPersistQuery(const PVR_RECORDING& recording,
+                                int iClientId,
+                                unsigned int iDataHash);
+
+    /*!
+     * @brief Queue the query to remove a recording from the cache. Commit queued queries
+     * with CommitQueuedQueries.
+     * @param uid The recording's unique id.
+     * @return True if the query was queued, false otherwise.
+     */
+    bool QueueDeleteQuery(const CPVRRecordingUid& uid);
+
+    /*!
+     * @brief Remove all cached recordings from the database.
+     * @return True if all cached recordings were removed, false otherwise.
+     */
+    bool DeleteRecordings();
+    //@}
+
     /*! @name Client methods */
     //@{
 
@@ -253,6 +324,28 @@ namespace PVR
     void UpdateTables(int version) override;
     int GetMinSchemaVersion() const override { return 11; }
 
+    /*!
+     * @brief Rows of map_channelgroups_channels of a group, one vector per column.
+     */
+    struct ChannelGroupMemberColumns
+    {
+      std::vector<int> channelIds;
+      std::vector<unsigned int> channelNumbers;
+      std::vector<unsigned int> subChannelNumbers;
+      std::vector<int> orders;
+      std::vector<unsigned int> clientChannelNumbers;
+      std::vector<unsigned int> clientSubChannelNumbers;
+    };
+
+    /*!
+     * @brief Load rows of map_channelgroups_channels, grouped by group id.
+     * @param strQuery The query. Rows with a NULL idChannel add an empty entry for the group.
+     * @param results The map to store the results in.
+     * @return The amount of rows that were loaded, -1 on errors.
+     */
+    int GetChannelGroupMembers(const std::string& strQuery,
+                               std::map<int, ChannelGroupMemberColumns>& results);
+
     bool DeleteChannelsFromGroup(const CPVRChannelGroup& group, const std::vector<int>& channelsToDelete);
 
     bool GetCurrentGroupMembers(const CPVRChannelGroup& group, std::vector<int>& members);
@@ -264,10 +357,14 @@ namespace PVR
 
     bool RemoveChannelsFromGroup(const CPVRChannelGroup& group);
     void InsertChannelIntoGroup(const std::shared_ptr<CPVRChannel>& channel,
-                                CPVRChannelGroup& group);
+                                CPVRChannelGroup& group,
+                                const CPVRChannelNumber& channelNumber,
+                                int iOrder,
+                                const CPVRChannelNumber& clientChannelNumber);
 
     int GetClientIdByChannelId(int iChannelId);
 
     CCriticalSection m_critSection;
+    std::map<int, ChannelGroupMemberColumns> m_channelGroupMembersCache;
   };
 }
@@ -9,6 +9,8 @@
 #include "PVRClient.h"
 
 #include "ServiceBroker.h"
+#include "addons/addoninfo/AddonInfo.h"
+#include "addons/addoninfo/AddonType.h"
 #include "addons/kodi-dev-kit/include/kodi/addon-instance/PVR.h" // added for compile test on related sources only!
 #include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -1665,6 +1667,15 @@ int CPVRClient::GetPriority() const
   return m_iPriority;
 }
 
+int CPVRClient::GetEpgUpdateThreads() const
+{
+  const CAddonType* type = GetAddonInfo()->Type(ADDON_PVRDLL);
+  if (!type)
+    return 0;
+
+  return static_cast<int>(type->GetValue("@epgupdatethreads").asInteger());
+}
+
 void CPVRClient::HandleAddonCallback(const char* strFunctionName,
                                      void* kodiInstance,
                                      const std::function<void(CPVRClient* client)>& function,
@@ -1792,10 +1803,8 @@ void CPVRClient::cb_transfer_recording_entry(void* kodiInstance,
     }
 
     // transfer this entry to the recordings container
-    const std::shared_ptr<CPVRRecording> transferRecording =
-        std::make_shared<CPVRRecording>(*recording, client->GetID());
     CPVRRecordings* recordings = static_cast<CPVRRecordings*>(handle->dataAddress);
-    recordings->UpdateFromClient(transferRecording, *client);
+    recordings->UpdateFromClient(*recording, *client);
   });
 }
 
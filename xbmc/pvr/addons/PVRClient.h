@@ -987,6 +987,13 @@ public:
    */
   int GetPriority() const;
 
+  /*!
+   * @brief Get the number of channels this client can serve EPG data for at a time, from the
+   * epgupdatethreads attribute of the add-on's extension point.
+   * @return The number of channels, 0 if the add-on does not declare one.
+   */
+  int GetEpgUpdateThreads() const;
+
   /*!
    * @brief Set a new priority for this client.
    * @param iPriority The new priority.
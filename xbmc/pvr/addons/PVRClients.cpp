@@ -16,6 +16,7 @@
 #include "pvr/PVRPlaybackState.h"
 #include "pvr/addons/PVRClient.h"
 #include "pvr/channels/PVRChannelGroupInternal.h"
+#include "threads/WorkerPool.h"
 #include "utils/JobManager.h"
 #include "utils/log.h"
 
@@ -514,12 +515,34 @@ PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings* recordings,
                                      bool deleted,
                                      std::vector<int>& failedClients)
 {
-  return ForCreatedClients(
-      __FUNCTION__,
-      [recordings, deleted](const std::shared_ptr<CPVRClient>& client) {
-        return client->GetRecordings(recordings, deleted);
-      },
-      failedClients);
+  CPVRClientMap clients;
+  GetCreatedClients(clients, failedClients);
+  if (clients.empty())
+    return PVR_ERROR_NO_ERROR;
+
+  std::vector<std::shared_ptr<CPVRClient>> clientList;
+  for (const auto& clientEntry : clients)
+    clientList.emplace_back(clientEntry.second);
+
+  // slow backends must not delay the others; the recordings are diffed on the fetching threads
+  std::vector<PVR_ERROR> errors(clientList.size(), PVR_ERROR_NO_ERROR);
+  CWorkerPool pool(static_cast<unsigned int>(clientList.size()), "PVRRecordings");
+  pool.ForEach(clientList.size(), [&clientList, &errors, recordings, deleted](size_t i) {
+    errors[i] = clientList[i]->GetRecordings(recordings, deleted);
+  });
+
+  PVR_ERROR lastError = PVR_ERROR_NO_ERROR;
+  for (size_t i = 0; i < clientList.size(); ++i)
+  {
+    if (errors[i] != PVR_ERROR_NO_ERROR && errors[i] != PVR_ERROR_NOT_IMPLEMENTED)
+    {
+      CLog::LogF(LOGERROR, "PVR client '{}' returned an error: {}",
+                 clientList[i]->GetFriendlyName(), CPVRClient::ToString(errors[i]));
+      lastError = errors[i];
+      failedClients.emplace_back(clientList[i]->GetID());
+    }
+  }
+  return lastError;
 }
 
 PVR_ERROR CPVRClients::DeleteAllRecordingsFromTrash()
@@ -197,7 +197,7 @@ namespace PVR
     //@{
 
     /*!
-     * @brief Get all recordings from clients
+     * @brief Get all recordings from clients. The clients are queried concurrently.
      * @param recordings Store the recordings in this container.
      * @param deleted If true, return deleted recordings, return not deleted recordings otherwise.
      * @param failedClients in case of errors will contain the ids of the clients for which the recordings could not be obtained.
@@ -138,6 +138,7 @@ void CPVRChannelGroup::Unload()
   CSingleLock lock(m_critSection);
   m_sortedMembers.clear();
   m_members.clear();
+  m_persistedMembers.clear();
   m_failedClients.clear();
 }
 
@@ -539,6 +539,17 @@ namespace PVR
         m_sortedMembers; /*!< members sorted by channel number */
     std::map<std::pair<int, int>, std::shared_ptr<CPVRChannelGroupMember>>
         m_members; /*!< members with key clientid+uniqueid */
+
+    /*!
+     * @brief A member row of this group as stored in the database.
+     */
+    struct PersistedMember
+    {
+      int iChannelId; /*!< the database id of the channel */
+      unsigned int iDataHash; /*!< hash of the persisted channel numbers and order */
+    };
+    mutable std::map<std::pair<int, int>, PersistedMember>
+        m_persistedMembers; /*!< persisted members with key clientid+uniqueid */
     mutable CCriticalSection m_critSection;
     std::vector<int> m_failedClients;
     CEventSource<PVREvent> m_events;
@@ -17,6 +17,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
+#include "utils/Stopwatch.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
@@ -299,6 +300,17 @@ bool CPVRChannelGroups::LoadUserDefinedChannelGroups()
 
   std::vector<std::shared_ptr<CPVRChannelGroup>> emptyGroups;
 
+  // load the members of all groups from the database at once instead of one query per group
+  const std::shared_ptr<CPVRDatabase> database(CServiceBroker::GetPVRManager().GetTVDatabase());
+  if (database)
+  {
+    CStopWatch timer;
+    timer.StartZero();
+    const int iMembers = database->CacheChannelGroupMembers(m_bRadio);
+    CLog::LogFC(LOGDEBUG, LOGPVR, "{} {} channel group members loaded from the database in {} ms",
+                iMembers, m_bRadio ? "radio" : "TV", timer.GetElapsedMilliseconds());
+  }
+
   // load group members
   for (std::vector<std::shared_ptr<CPVRChannelGroup>>::iterator it = m_groups.begin(); it != m_groups.end(); ++it)
   {
@@ -310,6 +322,8 @@ bool CPVRChannelGroups::LoadUserDefinedChannelGroups()
       {
         CLog::LogFC(LOGDEBUG, LOGPVR, "Failed to load user defined channel group '{}'",
                     (*it)->GroupName());
+        if (database)
+          database->ClearChannelGroupMembersCache();
         return false;
       }
 
@@ -321,6 +335,9 @@ bool CPVRChannelGroups::LoadUserDefinedChannelGroups()
     }
   }
 
+  if (database)
+    database->ClearChannelGroupMembersCache();
+
   for (std::vector<std::shared_ptr<CPVRChannelGroup>>::iterator it = emptyGroups.begin(); it != emptyGroups.end(); ++it)
   {
     CLog::LogFC(LOGDEBUG, LOGPVR, "Deleting empty channel group '{}'", (*it)->GroupName());
@@ -27,6 +27,12 @@
 
 using namespace PVR;
 
+namespace
+{
+// enough to cover the changes made between two guide window refreshes
+constexpr size_t MAX_REMEMBERED_CHANGES = 16;
+} // unnamed namespace
+
 CPVREpg::CPVREpg(int iEpgID,
                  const std::string& strName,
                  const std::string& strScraperName,
@@ -68,6 +74,7 @@ void CPVREpg::Clear()
 {
   CSingleLock lock(m_critSection);
   m_tags.Clear();
+  AddChange(CDateTime(), CDateTime());
 }
 
 void CPVREpg::Cleanup(int iPastDays)
@@ -80,6 +87,7 @@ void CPVREpg::Cleanup(const CDateTime& time)
 {
   CSingleLock lock(m_critSection);
   m_tags.Cleanup(time);
+  AddChange(CDateTime(), time);
 }
 
 std::shared_ptr<CPVREpgInfoTag> CPVREpg::GetTagNow(bool bUpdateIfNeeded /* = true */) const
@@ -148,7 +156,10 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpg::GetTagBetween(const CDateTime& beginTim
       tag = tmpEpg->GetTagBetween(beginTime, endTime, false);
 
     if (tag)
+    {
       m_tags.UpdateEntry(tag);
+      AddChange(tag->StartAsUTC(), tag->EndAsUTC());
+    }
   }
 
   return tag;
@@ -169,7 +180,8 @@ bool CPVREpg::UpdateEntries(const CPVREpg& epg)
   CSingleLock lock(m_critSection);
 
   /* copy over tags */
-  m_tags.UpdateEntries(epg.m_tags);
+  if (m_tags.UpdateEntries(epg.m_tags))
+    AddChange(epg.m_tags.GetFirstStartTime(), epg.m_tags.GetLastEndTime());
 
   /* update the last scan time of this table */
   m_lastScanTime = CDateTime::GetUTCDateTime();
@@ -214,6 +226,8 @@ bool CPVREpg::UpdateEntry(const std::shared_ptr<CPVREpgInfoTag>& tag, EPG_EVENT_
   {
     CSingleLock lock(m_critSection);
     bRet = !IsTagExpired(tag) && m_tags.UpdateEntry(tag);
+    if (bRet)
+      AddChange(tag->StartAsUTC(), tag->EndAsUTC());
   }
   else if (newState == EPG_EVENT_DELETED)
   {
@@ -228,6 +242,7 @@ bool CPVREpg::UpdateEntry(const std::shared_ptr<CPVREpgInfoTag>& tag, EPG_EVENT_
       if (IsTagExpired(existingTag))
       {
         m_tags.DeleteEntry(existingTag);
+        AddChange(existingTag->StartAsUTC(), existingTag->EndAsUTC());
       }
       else
       {
@@ -323,6 +338,13 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpg::GetTags() const
   return m_tags.GetAllTags();
 }
 
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpg::GetTags(const CDateTime& minEnd,
+                                                              const CDateTime& maxStart) const
+{
+  CSingleLock lock(m_critSection);
+  return m_tags.GetTags(minEnd, maxStart);
+}
+
 bool CPVREpg::QueuePersistQuery(const std::shared_ptr<CPVREpgDatabase>& database)
 {
   // Note: It is guaranteed that both this EPG instance and database instance are already
@@ -491,6 +513,56 @@ const std::string& CPVREpg::ConvertGenreIdToString(int iID, int iSubID)
   return g_localizeStrings.Get(iLabelId);
 }
 
+unsigned int CPVREpg::GetChangeCount() const
+{
+  CSingleLock lock(m_critSection);
+  return m_iChangeCount;
+}
+
+bool CPVREpg::GetChangesSince(unsigned int& iChangeCount, CDateTime& start, CDateTime& end) const
+{
+  CSingleLock lock(m_critSection);
+
+  if (iChangeCount == m_iChangeCount)
+    return false;
+
+  start.Reset();
+  end.Reset();
+
+  // if some of the changes are no longer known, everything may have changed
+  if (!m_changes.empty() && m_changes.front().iChangeCount <= iChangeCount + 1)
+  {
+    bool bFirst = true;
+    for (auto it = m_changes.crbegin(); it != m_changes.crend() && it->iChangeCount > iChangeCount;
+         ++it)
+    {
+      if (bFirst)
+      {
+        start = it->start;
+        end = it->end;
+        bFirst = false;
+        continue;
+      }
+
+      if (start.IsValid() && (!it->start.IsValid() || it->start < start))
+        start = it->start;
+
+      if (end.IsValid() && (!it->end.IsValid() || it->end > end))
+        end = it->end;
+    }
+  }
+
+  iChangeCount = m_iChangeCount;
+  return true;
+}
+
+void CPVREpg::AddChange(const CDateTime& start, const CDateTime& end)
+{
+  m_changes.push_back({++m_iChangeCount, start, end});
+  if (m_changes.size() > MAX_REMEMBERED_CHANGES)
+    m_changes.pop_front();
+}
+
 std::shared_ptr<CPVREpgChannelData> CPVREpg::GetChannelData() const
 {
   CSingleLock lock(m_critSection);
@@ -504,6 +576,18 @@ void CPVREpg::SetChannelData(const std::shared_ptr<CPVREpgChannelData>& data)
   m_tags.SetChannelData(data);
 }
 
+void CPVREpg::SetGuideIndex(const std::shared_ptr<CPVREpgGuideIndex>& guideIndex)
+{
+  CSingleLock lock(m_critSection);
+  m_tags.SetGuideIndex(guideIndex);
+}
+
+void CPVREpg::LoadTimeIndex() const
+{
+  CSingleLock lock(m_critSection);
+  m_tags.LoadIndex();
+}
+
 int CPVREpg::ChannelID() const
 {
   CSingleLock lock(m_critSection);
@@ -550,5 +634,6 @@ bool CPVREpg::IsValid() const
 
 void CPVREpg::RemovedFromContainer()
 {
+  SetGuideIndex({});
   m_events.Publish(PVREvent::EpgDeleted);
 }
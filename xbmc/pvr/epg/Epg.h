@@ -15,6 +15,7 @@
 #include "utils/EventStream.h"
 
 #include <atomic>
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
@@ -76,6 +77,17 @@ namespace PVR
      */
     void SetChannelData(const std::shared_ptr<CPVREpgChannelData>& data);
 
+    /*!
+     * @brief Keep the given guide index up to date with the events of this EPG.
+     * @param guideIndex The guide index, nullptr to stop updating the current one.
+     */
+    void SetGuideIndex(const std::shared_ptr<CPVREpgGuideIndex>& guideIndex);
+
+    /*!
+     * @brief Load the time index of this EPG, if not yet done. Adds the events to the guide index.
+     */
+    void LoadTimeIndex() const;
+
     /*!
      * @brief The id of the channel associated with this EPG.
      * @return The channel id or -1 if no channel is associated
@@ -197,6 +209,15 @@ namespace PVR
      */
     std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags() const;
 
+    /*!
+     * @brief Get the EPG tags ending at or after minEnd and starting at or before maxStart.
+     * @param minEnd The minimum end time.
+     * @param maxStart The maximum start time.
+     * @return The tags, ordered by start time.
+     */
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags(const CDateTime& minEnd,
+                                                         const CDateTime& maxStart) const;
+
     /*!
      * @brief Get all EPG tags for the given time frame, including "gap" tags.
      * @param timelineStart Start of time line
@@ -262,6 +283,21 @@ namespace PVR
      */
     bool IsValid() const;
 
+    /*!
+     * @brief Get the number of changes made to the events of this EPG so far.
+     * @return The change count.
+     */
+    unsigned int GetChangeCount() const;
+
+    /*!
+     * @brief Get the time frame of the changes made to the events of this EPG since a given change.
+     * @param iChangeCount The change count known to the caller. Set to the current change count.
+     * @param start The start of the changed time frame, invalid if not bounded.
+     * @param end The end of the changed time frame, invalid if not bounded.
+     * @return True if there were changes since the given change count, false otherwise.
+     */
+    bool GetChangesSince(unsigned int& iChangeCount, CDateTime& start, CDateTime& end) const;
+
     /*!
      * @brief Query the events available for CEventStream
      */
@@ -310,6 +346,20 @@ namespace PVR
      */
     void Cleanup(int iPastDays);
 
+    /*!
+     * @brief Remember a change of the events of this EPG. Lock must be held by the caller.
+     * @param start The start of the changed time frame, invalid if not bounded.
+     * @param end The end of the changed time frame, invalid if not bounded.
+     */
+    void AddChange(const CDateTime& start, const CDateTime& end);
+
+    struct EpgChange
+    {
+      unsigned int iChangeCount = 0;
+      CDateTime start;
+      CDateTime end;
+    };
+
     bool m_bChanged = false; /*!< true if anything changed that needs to be persisted, false otherwise */
     std::atomic<bool> m_bUpdatePending = {false}; /*!< true if manual update is pending */
     int m_iEpgID = 0; /*!< the database ID of this table */
@@ -320,6 +370,8 @@ namespace PVR
     bool m_bUpdateLastScanTime = false;
     std::shared_ptr<CPVREpgChannelData> m_channelData;
     CPVREpgTagsContainer m_tags;
+    unsigned int m_iChangeCount = 0; /*!< the number of changes made to the events of this table */
+    std::deque<EpgChange> m_changes; /*!< the most recent changes made to the events of this table */
 
     CEventSource<PVREvent> m_events;
   };
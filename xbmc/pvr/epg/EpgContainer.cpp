@@ -12,19 +12,26 @@
 #include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_channels.h" // PVR_CHANNEL_INVALID_UID
 #include "guilib/LocalizeStrings.h"
 #include "pvr/PVRManager.h"
+#include "pvr/addons/PVRClient.h"
 #include "pvr/epg/Epg.h"
 #include "pvr/epg/EpgChannelData.h"
 #include "pvr/epg/EpgContainer.h"
 #include "pvr/epg/EpgDatabase.h"
 #include "pvr/epg/EpgInfoTag.h"
+#include "pvr/epg/EpgTimeIndex.h"
 #include "pvr/guilib/PVRGUIProgressHandler.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "threads/WorkerPool.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -99,6 +106,7 @@ void CEpgTagStateChange::Deliver()
 CPVREpgContainer::CPVREpgContainer() :
   CThread("EPGUpdater"),
   m_database(new CPVREpgDatabase),
+  m_guideIndex(new CPVREpgGuideIndex),
   m_settings({
     CSettings::SETTING_EPG_EPGUPDATE,
     CSettings::SETTING_EPG_FUTURE_DAYSTODISPLAY,
@@ -292,13 +300,12 @@ bool CPVREpgContainer::PersistAll(unsigned int iMaxTimeslice) const
 
         bReturn &= epg->QueuePersistQuery(database);
 
-        size_t queryCount = database->GetInsertQueriesCount() + database->GetDeleteQueriesCount();
+        size_t queryCount = database->GetQueuedChangesCount();
         if (queryCount > EPG_COMMIT_QUERY_COUNT_LIMIT)
         {
           CLog::LogFC(LOGDEBUG, LOGEPG, "EPG Container: committing {} queries in loop.",
                       queryCount);
-          database->CommitDeleteQueries();
-          database->CommitInsertQueries();
+          database->CommitQueuedChanges();
           CLog::LogFC(LOGDEBUG, LOGEPG, "EPG Container: committed {} queries in loop.", queryCount);
         }
       }
@@ -307,10 +314,7 @@ bool CPVREpgContainer::PersistAll(unsigned int iMaxTimeslice) const
     }
 
     if (bReturn)
-    {
-      database->CommitDeleteQueries();
-      database->CommitInsertQueries();
-    }
+      database->CommitQueuedChanges();
 
     database->Unlock();
   }
@@ -539,6 +543,30 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgContainer::GetTags(
   return results;
 }
 
+void CPVREpgContainer::LoadTimeIndexes() const
+{
+  m_critSection.lock();
+  const auto epgs = m_epgIdToEpgMap;
+  m_critSection.unlock();
+
+  for (const auto& epgEntry : epgs)
+    epgEntry.second->LoadTimeIndex();
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgContainer::GetTags(
+    const CDateTime& minEnd, const CDateTime& maxStart) const
+{
+  LoadTimeIndexes();
+  return m_guideIndex->GetTags(minEnd, maxStart);
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgContainer::GetActiveTags(
+    const CDateTime& time) const
+{
+  LoadTimeIndexes();
+  return m_guideIndex->GetActiveTags(time);
+}
+
 void CPVREpgContainer::InsertFromDB(const std::shared_ptr<CPVREpg>& newEpg)
 {
   CSingleLock lock(m_critSection);
@@ -551,6 +579,7 @@ void CPVREpgContainer::InsertFromDB(const std::shared_ptr<CPVREpg>& newEpg)
     epg = newEpg;
     m_epgIdToEpgMap.insert({epg->EpgID(), epg});
     epg->Events().Subscribe(this, &CPVREpgContainer::Notify);
+    epg->SetGuideIndex(m_guideIndex);
   }
 }
 
@@ -576,6 +605,7 @@ std::shared_ptr<CPVREpg> CPVREpgContainer::CreateChannelEpg(int iEpgId, const st
     m_epgIdToEpgMap.insert({iEpgId, epg});
     m_channelUidToEpgMap.insert({{channelData->ClientId(), channelData->UniqueClientChannelId()}, epg});
     epg->Events().Subscribe(this, &CPVREpgContainer::Notify);
+    epg->SetGuideIndex(m_guideIndex);
   }
   else if (epg->ChannelID() == -1)
   {
@@ -704,7 +734,6 @@ void CPVREpgContainer::WaitForUpdateFinish()
 bool CPVREpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
 {
   bool bInterrupted = false;
-  unsigned int iUpdatedTables = 0;
   const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
 
   /* set start and end time */
@@ -734,44 +763,74 @@ bool CPVREpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
     progressHandler = new CPVRGUIProgressHandler(g_localizeStrings.Get(19004)); // Importing guide from clients
 
   /* load or update all EPG tables */
-  unsigned int iCounter = 0;
   const std::shared_ptr<CPVREpgDatabase> database = GetEpgDatabase();
 
   m_critSection.lock();
   const auto epgsToUpdate = m_epgIdToEpgMap;
   m_critSection.unlock();
 
+  // clients are updated concurrently, each with a few channels at a time. fetched events are
+  // merged into the EPGs on the worker threads.
+  std::map<int, std::vector<std::shared_ptr<CPVREpg>>> clientEpgs;
   for (const auto& epgEntry : epgsToUpdate)
   {
-    if (InterruptUpdate())
-    {
-      bInterrupted = true;
-      break;
-    }
+    if (epgEntry.second)
+      clientEpgs[epgEntry.second->GetChannelData()->ClientId()].emplace_back(epgEntry.second);
+  }
+
+  std::atomic<unsigned int> iCounter{0};
+  std::atomic<unsigned int> iUpdatedTables{0};
+  std::atomic<bool> bClientInterrupted{false};
+  std::mutex invalidTablesMutex;
 
-    const std::shared_ptr<CPVREpg> epg = epgEntry.second;
-    if (!epg)
-      continue;
+  const int iUpdateTime = m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60;
+  const int iPastDays = m_settings.GetIntValue(CSettings::SETTING_EPG_PAST_DAYSTODISPLAY);
+  const auto stop = [this] { return InterruptUpdate(); };
 
+  const auto updateEpg = [&](const std::shared_ptr<CPVREpg>& epg) {
     if (bShowProgress && !bOnlyPending)
       progressHandler->UpdateProgress(epg->GetChannelData()->ChannelName(), ++iCounter,
                                       epgsToUpdate.size());
 
     if ((!bOnlyPending || epg->UpdatePending()) &&
-        epg->Update(start,
-                    end,
-                    m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60,
-                    m_settings.GetIntValue(CSettings::SETTING_EPG_PAST_DAYSTODISPLAY),
-                    database,
-                    bOnlyPending))
+        epg->Update(start, end, iUpdateTime, iPastDays, database, bOnlyPending))
     {
       iUpdatedTables++;
     }
     else if (!epg->IsValid())
     {
+      std::unique_lock<std::mutex> lock(invalidTablesMutex);
       invalidTables.push_back(epg);
     }
-  }
+  };
+
+  std::vector<const std::vector<std::shared_ptr<CPVREpg>>*> clients;
+  for (const auto& client : clientEpgs)
+    clients.emplace_back(&client.second);
+
+  CWorkerPool clientPool(static_cast<unsigned int>(clients.size()), "EPGUpdater");
+  bInterrupted = !clientPool.ForEach(
+      clients.size(),
+      [&](size_t iClient) {
+        const std::vector<std::shared_ptr<CPVREpg>>& epgs = *clients[iClient];
+
+        // one channel at a time, unless the settings or the add-on allow more
+        int iThreads = advancedSettings->m_iEpgUpdateThreadsPerClient;
+        const std::shared_ptr<CPVRClient> client =
+            CServiceBroker::GetPVRManager().GetClient(epgs.front()->GetChannelData()->ClientId());
+        if (client)
+          iThreads = std::max(iThreads, std::min(client->GetEpgUpdateThreads(), 16));
+
+        CWorkerPool channelPool(static_cast<unsigned int>(iThreads), "EPGUpdater");
+        if (!channelPool.ForEach(
+                epgs.size(), [&](size_t iEpg) { updateEpg(epgs[iEpg]); }, stop))
+          bClientInterrupted = true;
+      },
+      stop);
+  bInterrupted |= bClientInterrupted;
+
+  CLog::LogFC(LOGDEBUG, LOGEPG, "EPG Container: Updated {} of {} tables from {} clients",
+              iUpdatedTables.load(), epgsToUpdate.size(), clients.size());
 
   if (bShowProgress && !bOnlyPending)
     progressHandler->DestroyProgress();
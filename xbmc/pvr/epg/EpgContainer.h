@@ -31,6 +31,7 @@ namespace PVR
   class CPVREpg;
   class CPVREpgChannelData;
   class CPVREpgDatabase;
+  class CPVREpgGuideIndex;
   class CPVREpgInfoTag;
 
   enum class PVREvent;
@@ -167,6 +168,22 @@ namespace PVR
      */
     std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags(const PVREpgSearchData& searchData) const;
 
+    /*!
+     * @brief Get the events of all EPGs ending at or after minEnd and starting at or before maxStart.
+     * @param minEnd The minimum end time.
+     * @param maxStart The maximum start time.
+     * @return The events, ordered by start time.
+     */
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags(const CDateTime& minEnd,
+                                                         const CDateTime& maxStart) const;
+
+    /*!
+     * @brief Get the events of all EPGs active at the given time.
+     * @param time The time.
+     * @return The events, ordered by start time.
+     */
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> GetActiveTags(const CDateTime& time) const;
+
     /*!
      * @brief Notify EPG container that there are pending manual EPG updates
      * @param bHasPendingUpdates The new value
@@ -251,6 +268,11 @@ namespace PVR
      */
     bool RemoveOldEntries();
 
+    /*!
+     * @brief Load the time indexes of all EPGs not yet loaded, filling the guide index.
+     */
+    void LoadTimeIndexes() const;
+
     /*!
      * @brief Load and update the EPG data.
      * @param bOnlyPending Only check and update EPG tables with pending manual updates
@@ -307,6 +329,8 @@ namespace PVR
     std::map<int, std::shared_ptr<CPVREpg>> m_epgIdToEpgMap; /*!< the EPGs in this container. maps epg ids to epgs */
     std::map<std::pair<int, int>, std::shared_ptr<CPVREpg>> m_channelUidToEpgMap; /*!< the EPGs in this container. maps channel uids to epgs */
 
+    const std::shared_ptr<CPVREpgGuideIndex> m_guideIndex; /*!< time index of the events of all EPGs */
+
     mutable CCriticalSection m_critSection; /*!< a critical section for changes to this container */
     CEvent m_updateEvent; /*!< trigger when an update finishes */
 
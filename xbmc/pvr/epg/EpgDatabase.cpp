@@ -16,9 +16,11 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 
 #include <cstdlib>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -26,6 +28,12 @@
 using namespace dbiplus;
 using namespace PVR;
 
+namespace
+{
+// tag rows per REPLACE statement, well below the compound select limit of SQLite
+constexpr size_t TAG_ROWS_PER_QUERY = 100;
+} // unnamed namespace
+
 bool CPVREpgDatabase::Open()
 {
   CSingleLock lock(m_critSection);
@@ -93,7 +101,8 @@ void CPVREpgDatabase::CreateTables()
         "iEpisodePart    integer, "
         "sEpisodeName    varchar(128), "
         "iFlags          integer, "
-        "sSeriesLink     varchar(255)"
+        "sSeriesLink     varchar(255), "
+        "iLongTextHash   integer"
       ")"
   );
 
@@ -112,6 +121,10 @@ void CPVREpgDatabase::CreateAnalytics()
   CSingleLock lock(m_critSection);
   m_pDS->exec("CREATE UNIQUE INDEX idx_epg_idEpg_iStartTime on epgtags(idEpg, iStartTime desc);");
   m_pDS->exec("CREATE INDEX idx_epg_iEndTime on epgtags(iEndTime);");
+
+  // full text index used by searches for a single term (SQLite only)
+  CreateFullTextIndex("epgtags_fts", "epgtags", "idBroadcast",
+                      {"sTitle", "sPlotOutline", "sPlot"});
 }
 
 void CPVREpgDatabase::UpdateTables(int iVersion)
@@ -258,6 +271,9 @@ void CPVREpgDatabase::UpdateTables(int iVersion)
     m_pDS->exec("DROP TABLE epgtags");
     m_pDS->exec("ALTER TABLE epgtags_new RENAME TO epgtags");
   }
+
+  if (iVersion < 15)
+    m_pDS->exec("ALTER TABLE epgtags ADD iLongTextHash integer;");
 }
 
 bool CPVREpgDatabase::DeleteEpg()
@@ -348,18 +364,16 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpgDatabase::CreateEpgTag(
   {
     std::shared_ptr<CPVREpgInfoTag> newTag(new CPVREpgInfoTag());
 
-    time_t iStartTime;
-    iStartTime = static_cast<time_t>(m_pDS->fv("iStartTime").get_asInt());
-    const CDateTime startTime(iStartTime);
-    newTag->m_startTime = startTime;
-
-    time_t iEndTime = static_cast<time_t>(m_pDS->fv("iEndTime").get_asInt());
-    const CDateTime endTime(iEndTime);
-    newTag->m_endTime = endTime;
+    newTag->m_startTime = static_cast<time_t>(m_pDS->fv("iStartTime").get_asInt());
+    newTag->m_endTime = static_cast<time_t>(m_pDS->fv("iEndTime").get_asInt());
 
     const std::string sFirstAired = m_pDS->fv("sFirstAired").get_asString();
     if (sFirstAired.length() > 0)
-      newTag->m_firstAired.SetFromW3CDate(sFirstAired);
+    {
+      CDateTime firstAired;
+      firstAired.SetFromW3CDate(sFirstAired);
+      firstAired.GetAsTime(newTag->m_firstAired);
+    }
 
     int iBroadcastUID = m_pDS->fv("iBroadcastUid").get_asInt();
     // Compat: null value for broadcast uid changed from numerical -1 to 0 with PVR Addon API v4.0.0
@@ -367,34 +381,100 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpgDatabase::CreateEpgTag(
 
     newTag->m_iEpgID = m_pDS->fv("idEpg").get_asInt();
     newTag->m_iDatabaseID = m_pDS->fv("idBroadcast").get_asInt();
-    newTag->m_strTitle = m_pDS->fv("sTitle").get_asString().c_str();
+    newTag->m_strTitle = CPVREpgStringPool::Intern(m_pDS->fv("sTitle").get_asString());
     newTag->m_strPlotOutline = m_pDS->fv("sPlotOutline").get_asString().c_str();
-    newTag->m_strPlot = m_pDS->fv("sPlot").get_asString().c_str();
-    newTag->m_strOriginalTitle = m_pDS->fv("sOriginalTitle").get_asString().c_str();
-    newTag->m_cast = newTag->Tokenize(m_pDS->fv("sCast").get_asString());
-    newTag->m_directors = newTag->Tokenize(m_pDS->fv("sDirector").get_asString());
-    newTag->m_writers = newTag->Tokenize(m_pDS->fv("sWriter").get_asString());
-    newTag->m_iYear = m_pDS->fv("iYear").get_asInt();
-    newTag->m_strIMDBNumber = m_pDS->fv("sIMDBNumber").get_asString().c_str();
-    newTag->m_iParentalRating = m_pDS->fv("iParentalRating").get_asInt();
-    newTag->m_iStarRating = m_pDS->fv("iStarRating").get_asInt();
+    newTag->m_strOriginalTitle =
+        CPVREpgStringPool::Intern(m_pDS->fv("sOriginalTitle").get_asString());
+    newTag->m_strDirectors = CPVREpgStringPool::Intern(m_pDS->fv("sDirector").get_asString());
+    newTag->m_strWriters = CPVREpgStringPool::Intern(m_pDS->fv("sWriter").get_asString());
+    newTag->m_iYear = static_cast<int16_t>(m_pDS->fv("iYear").get_asInt());
+    newTag->m_strIMDBNumber = CPVREpgStringPool::Intern(m_pDS->fv("sIMDBNumber").get_asString());
+    newTag->m_iParentalRating = static_cast<int16_t>(m_pDS->fv("iParentalRating").get_asInt());
+    newTag->m_iStarRating = static_cast<int16_t>(m_pDS->fv("iStarRating").get_asInt());
     newTag->m_iEpisodeNumber = m_pDS->fv("iEpisodeId").get_asInt();
     newTag->m_iEpisodePart = m_pDS->fv("iEpisodePart").get_asInt();
-    newTag->m_strEpisodeName = m_pDS->fv("sEpisodeName").get_asString().c_str();
+    newTag->m_strEpisodeName = CPVREpgStringPool::Intern(m_pDS->fv("sEpisodeName").get_asString());
     newTag->m_iSeriesNumber = m_pDS->fv("iSeriesId").get_asInt();
-    newTag->m_strIconPath = m_pDS->fv("sIconPath").get_asString().c_str();
+    newTag->m_strIconPath = CPVREpgStringPool::Intern(m_pDS->fv("sIconPath").get_asString());
     newTag->m_iFlags = m_pDS->fv("iFlags").get_asInt();
-    newTag->m_strSeriesLink = m_pDS->fv("sSeriesLink").get_asString().c_str();
+    newTag->m_strSeriesLink = CPVREpgStringPool::Intern(m_pDS->fv("sSeriesLink").get_asString());
 
     newTag->SetGenre(m_pDS->fv("iGenreType").get_asInt(), m_pDS->fv("iGenreSubType").get_asInt(),
                      m_pDS->fv("sGenre").get_asString().c_str());
-    newTag->UpdatePath();
+
+    // plot and cast are loaded when needed, see GetEpgTagPlotAndCast. 0 for rows of older versions.
+    newTag->m_bLongTextLoaded = false;
+    newTag->m_iLongTextHash =
+        static_cast<unsigned int>(m_pDS->fv("iLongTextHash").get_asInt64());
 
     return newTag;
   }
   return {};
 }
 
+bool CPVREpgDatabase::GetEpgTagPlotAndCast(int iDatabaseID, std::string& strPlot, std::string& strCast)
+{
+  CSingleLock lock(m_critSection);
+  if (!m_pDB)
+    return false;
+
+  const std::string strQuery =
+      PrepareSQL("SELECT sPlot, sCast FROM epgtags WHERE idBroadcast = %u;", iDatabaseID);
+
+  // tags may be read from m_pDS and inserts are queued on m_pDS2, so use a dataset of its own
+  try
+  {
+    std::unique_ptr<dbiplus::Dataset> pDS(m_pDB->CreateDataset());
+    pDS->query(strQuery);
+    if (!pDS->eof())
+    {
+      strPlot = pDS->fv("sPlot").get_asString();
+      strCast = pDS->fv("sCast").get_asString();
+    }
+    pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::LogF(LOGERROR, "Could not load plot and cast for tag ({})", iDatabaseID);
+  }
+  return false;
+}
+
+std::map<int, std::string> CPVREpgDatabase::GetEpgTagPlots(int iEpgID, const CDateTime& minEnd)
+{
+  time_t iMinEnd;
+  minEnd.GetAsTime(iMinEnd);
+
+  CSingleLock lock(m_critSection);
+  if (!m_pDB)
+    return {};
+
+  const std::string strQuery =
+      PrepareSQL("SELECT idBroadcast, sPlot FROM epgtags WHERE idEpg = %u AND iEndTime >= %u;",
+                 iEpgID, static_cast<unsigned int>(iMinEnd));
+
+  // tags may be read from m_pDS and inserts are queued on m_pDS2, so use a dataset of its own
+  try
+  {
+    std::map<int, std::string> plots;
+    std::unique_ptr<dbiplus::Dataset> pDS(m_pDB->CreateDataset());
+    pDS->query(strQuery);
+    while (!pDS->eof())
+    {
+      plots.emplace(pDS->fv("idBroadcast").get_asInt(), pDS->fv("sPlot").get_asString());
+      pDS->next();
+    }
+    pDS->close();
+    return plots;
+  }
+  catch (...)
+  {
+    CLog::LogF(LOGERROR, "Could not load plots of tags for EPG ({})", iEpgID);
+  }
+  return {};
+}
+
 CDateTime CPVREpgDatabase::GetFirstStartTime(int iEpgID)
 {
   CSingleLock lock(m_critSection);
@@ -519,6 +599,18 @@ public:
     return result;
   }
 
+  /*!
+   * @brief Get the term if the search consists of a single term without any operators.
+   * @return The term, or an empty string.
+   */
+  std::string GetSingleTerm() const
+  {
+    if (m_bHasOperators || m_terms.size() != 1)
+      return {};
+
+    return m_terms.front();
+  }
+
 private:
   void Parse(const std::string& strSearchTerm)
   {
@@ -539,6 +631,7 @@ private:
         GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " NOT ";
         bNextOR = false;
+        m_bHasOperators = true;
       }
       else if (StringUtils::StartsWith(strParsedSearchTerm, "+") ||
                StringUtils::StartsWithNoCase(strParsedSearchTerm, "and"))
@@ -547,6 +640,7 @@ private:
         GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " AND ";
         bNextOR = false;
+        m_bHasOperators = true;
       }
       else if (StringUtils::StartsWith(strParsedSearchTerm, "|") ||
                StringUtils::StartsWithNoCase(strParsedSearchTerm, "or"))
@@ -555,6 +649,7 @@ private:
         GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " OR ";
         bNextOR = false;
+        m_bHasOperators = true;
       }
       else
       {
@@ -570,6 +665,8 @@ private:
           m_fragments.emplace_back(strFragment);
           strFragment.clear();
 
+          m_terms.emplace_back(strTerm);
+
           strFragment += ") LIKE UPPER('%";
           StringUtils::Replace(strTerm, "'", "''"); // escape '
           strFragment += strTerm;
@@ -614,6 +711,8 @@ private:
   }
 
   std::vector<std::string> m_fragments;
+  std::vector<std::string> m_terms;
+  bool m_bHasOperators = false;
 };
 
 } // unnamed namespace
@@ -673,18 +772,28 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgDatabase::GetEpgTags(
   {
     const CSearchTermConverter conv(searchData.m_strSearchTerm);
 
-    // title
-    std::string strWhere = conv.ToSQL("sTitle");
-
-    // plot outline
-    strWhere += " OR ";
-    strWhere += conv.ToSQL("sPlotOutline");
-
+    std::vector<std::string> columns = {"sTitle", "sPlotOutline"};
     if (searchData.m_bSearchInDescription)
+      columns.emplace_back("sPlot");
+
+    // a single term can be looked up in the full text index (matching word prefixes)
+    std::string strWhere =
+        PrepareFullTextCondition("epgtags_fts", "idBroadcast", columns, conv.GetSingleTerm());
+    if (strWhere.empty())
     {
-      // plot
+      // title
+      strWhere = conv.ToSQL("sTitle");
+
+      // plot outline
       strWhere += " OR ";
-      strWhere += conv.ToSQL("sPlot");
+      strWhere += conv.ToSQL("sPlotOutline");
+
+      if (searchData.m_bSearchInDescription)
+      {
+        // plot
+        strWhere += " OR ";
+        strWhere += conv.ToSQL("sPlot");
+      }
     }
 
     filter.AppendWhere(strWhere);
@@ -1111,6 +1220,14 @@ bool CPVREpgDatabase::QueuePersistQuery(const CPVREpgInfoTag& tag)
     return false;
   }
 
+  // plot and cast of a tag read from the database are written back, they must be loaded
+  if (!tag.LoadLongText(*this))
+  {
+    CLog::LogF(LOGERROR, "Plot and cast of tag '{}' could not be loaded, not persisting it",
+               tag.Title());
+    return false;
+  }
+
   time_t iStartTime, iEndTime;
   tag.StartAsUTC().GetAsTime(iStartTime);
   tag.EndAsUTC().GetAsTime(iEndTime);
@@ -1120,48 +1237,104 @@ bool CPVREpgDatabase::QueuePersistQuery(const CPVREpgInfoTag& tag)
     sFirstAired = tag.FirstAired().GetAsW3CDate();
 
   int iBroadcastId = tag.DatabaseID();
-  std::string strQuery;
 
   /* Only store the genre string when needed */
   std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING || tag.GenreSubType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
 
   CSingleLock lock(m_critSection);
 
+  // the row, the columns are listed by QueueTagRows
+  std::string strRow = PrepareSQL(
+      "(%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', '%s', "
+      "%i, %i, %i, %i, %i, '%s', %i, '%s', %i, %u",
+      tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
+      tag.Title().c_str(), tag.PlotOutline().c_str(), tag.Plot().c_str(),
+      tag.OriginalTitle().c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
+      tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
+      tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+      sFirstAired.c_str(), tag.ParentalRating(), tag.StarRating(),
+      tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(), tag.SeriesLink().c_str(),
+      tag.UniqueBroadcastID(), tag.LongTextHash());
+
   if (iBroadcastId < 0)
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, sFirstAired, iParentalRating, iStarRating, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, sSeriesLink, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', '%s', %i, %i, %i, %i, %i, '%s', %i, '%s', %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title().c_str(), tag.PlotOutline().c_str(), tag.Plot().c_str(),
-        tag.OriginalTitle().c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        sFirstAired.c_str(), tag.ParentalRating(), tag.StarRating(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(), tag.SeriesLink().c_str(),
-        tag.UniqueBroadcastID());
-  }
+    strRow += ")";
   else
+    strRow += PrepareSQL(", %i)", iBroadcastId);
+
+  // a later row for the same slot supersedes an earlier one, like a database replace would
+  m_tagRows[{tag.EpgID(), static_cast<unsigned int>(iStartTime)}] = {iBroadcastId,
+                                                                     std::move(strRow)};
+
+  if (m_tagRows.size() >= TAG_ROWS_PER_QUERY)
+    QueueTagRows();
+
+  return true;
+}
+
+void CPVREpgDatabase::QueueTagRows()
+{
+  if (m_tagRows.empty())
+    return;
+
+  static const std::string columns =
+      "INSERT INTO epgtags (idEpg, iStartTime, iEndTime, sTitle, sPlotOutline, sPlot, "
+      "sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, sIconPath, iGenreType, "
+      "iGenreSubType, sGenre, sFirstAired, iParentalRating, iStarRating, iSeriesId, iEpisodeId, "
+      "iEpisodePart, sEpisodeName, iFlags, sSeriesLink, iBroadcastUid, iLongTextHash";
+
+  std::vector<std::string> newRows;
+  std::vector<std::string> existingRows;
+  std::vector<std::string> existingIds;
+  std::map<int, std::vector<std::string>> startTimesPerEpg;
+
+  for (auto& row : m_tagRows)
   {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, sFirstAired, iParentalRating, iStarRating, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, sSeriesLink, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', '%s', %i, %i, %i, %i, %i, '%s', %i, '%s', %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title().c_str(), tag.PlotOutline().c_str(), tag.Plot().c_str(),
-        tag.OriginalTitle().c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        sFirstAired.c_str(), tag.ParentalRating(), tag.StarRating(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(), tag.SeriesLink().c_str(),
-        tag.UniqueBroadcastID(), iBroadcastId);
+    startTimesPerEpg[row.first.first].emplace_back(std::to_string(row.first.second));
+
+    if (row.second.iBroadcastId < 0)
+    {
+      newRows.emplace_back(std::move(row.second.strRow));
+    }
+    else
+    {
+      existingIds.emplace_back(std::to_string(row.second.iBroadcastId));
+      existingRows.emplace_back(std::move(row.second.strRow));
+    }
   }
+  m_tagRows.clear();
+
+  // Delete the rows being replaced explicitly, instead of using REPLACE INTO. The implicit
+  // deletions done by REPLACE do not fire the full text index delete trigger, as sqlite only
+  // does that with recursive triggers enabled. The deletes are queued together with the inserts,
+  // so they run in order with them.
+  if (!existingIds.empty())
+    QueueInsertQuery("DELETE FROM epgtags WHERE idBroadcast IN (" +
+                     StringUtils::Join(existingIds, ",") + ");");
+
+  for (const auto& startTimes : startTimesPerEpg)
+    QueueInsertQuery(PrepareSQL("DELETE FROM epgtags WHERE idEpg = %u AND iStartTime IN (",
+                                startTimes.first) +
+                     StringUtils::Join(startTimes.second, ",") + ");");
+
+  if (!newRows.empty())
+    QueueInsertQuery(columns + ") VALUES " + StringUtils::Join(newRows, ", ") + ";");
+
+  if (!existingRows.empty())
+    QueueInsertQuery(columns + ", idBroadcast) VALUES " + StringUtils::Join(existingRows, ", ") +
+                     ";");
+}
 
-  QueueInsertQuery(strQuery);
-  return true;
+size_t CPVREpgDatabase::GetQueuedChangesCount()
+{
+  CSingleLock lock(m_critSection);
+  return GetInsertQueriesCount() + GetDeleteQueriesCount() + m_tagRows.size();
+}
+
+bool CPVREpgDatabase::CommitQueuedChanges()
+{
+  CSingleLock lock(m_critSection);
+  QueueTagRows();
+  return CommitQueuedQueries();
 }
 
 int CPVREpgDatabase::GetLastEPGId()
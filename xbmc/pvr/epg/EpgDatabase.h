@@ -11,7 +11,10 @@
 #include "dbwrappers/Database.h"
 #include "threads/CriticalSection.h"
 
+#include <map>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 class CDateTime;
@@ -65,7 +68,7 @@ namespace PVR
      * @brief Get the minimal database version that is required to operate correctly.
      * @return The minimal database version.
      */
-    int GetSchemaVersion() const override { return 13; }
+    int GetSchemaVersion() const override { return 15; }
 
     /*!
      * @brief Get the default sqlite database filename.
@@ -146,6 +149,24 @@ namespace PVR
      */
     std::vector<std::shared_ptr<CPVREpgInfoTag>> GetEpgTags(const PVREpgSearchData& searchData);
 
+    /*!
+     * @brief Get plot and cast of an EPG tag. Tags read from the database load them on demand.
+     * @param iDatabaseID The database ID of the tag.
+     * @param strPlot The plot.
+     * @param strCast The tokenized cast.
+     * @return True on success, false otherwise.
+     */
+    bool GetEpgTagPlotAndCast(int iDatabaseID, std::string& strPlot, std::string& strCast);
+
+    /*!
+     * @brief Get the plots of the tags of an EPG ending at or after the given time, with one
+     * query. For matching the plots of many tags without loading them into the tags.
+     * @param iEpgID The ID of the EPG.
+     * @param minEnd The min end time.
+     * @return The plots, by database ID of the tag.
+     */
+    std::map<int, std::string> GetEpgTagPlots(int iEpgID, const CDateTime& minEnd);
+
     /*!
      * @brief Get an EPG tag given its EPG id and unique broadcast ID.
      * @param iEpgID The ID of the EPG for the tag to get.
@@ -280,6 +301,18 @@ namespace PVR
      */
     bool QueuePersistQuery(const CPVREpgInfoTag& tag);
 
+    /*!
+     * @brief Get the number of queued changes, including tag rows not yet added to a query.
+     * @return The number of changes.
+     */
+    size_t GetQueuedChangesCount();
+
+    /*!
+     * @brief Commit all queued changes in a single transaction.
+     * @return True if all changes were written successfully, false otherwise.
+     */
+    bool CommitQueuedChanges();
+
     /*!
      * @return Last EPG id in the database
      */
@@ -308,6 +341,21 @@ namespace PVR
 
     std::shared_ptr<CPVREpgInfoTag> CreateEpgTag(const std::unique_ptr<dbiplus::Dataset>& pDS);
 
+    /*!
+     * @brief Add the queued tag rows to the insert queue, as multi-row statements, each preceded
+     * by the deletion of the rows they replace.
+     */
+    void QueueTagRows();
+
     CCriticalSection m_critSection;
+
+    struct TagRow
+    {
+      int iBroadcastId; // database id of the tag, -1 for new tags
+      std::string strRow;
+    };
+
+    // tag rows queued by QueuePersistQuery, keyed by epg id and start time
+    std::map<std::pair<int, unsigned int>, TagRow> m_tagRows;
   };
 }
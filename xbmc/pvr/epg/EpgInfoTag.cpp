@@ -14,6 +14,7 @@
 #include "pvr/addons/PVRClient.h"
 #include "pvr/epg/Epg.h"
 #include "pvr/epg/EpgChannelData.h"
+#include "pvr/epg/EpgContainer.h"
 #include "pvr/epg/EpgDatabase.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
@@ -28,9 +29,49 @@
 
 using namespace PVR;
 
+namespace
+{
+const time_t INVALID_TIME = -1;
+
+time_t ToTime(const CDateTime& dateTime)
+{
+  if (!dateTime.IsValid())
+    return INVALID_TIME;
+
+  time_t time;
+  dateTime.GetAsTime(time);
+  return time;
+}
+
+CDateTime ToDateTime(time_t time)
+{
+  return time == INVALID_TIME ? CDateTime() : CDateTime(time);
+}
+
+unsigned int GetLongTextHash(const std::string& strPlot, const std::string& strCast)
+{
+  // FNV-1a, including the terminators so that text can not shift from plot to cast
+  unsigned int iHash = 2166136261u;
+  for (const std::string* str : {&strPlot, &strCast})
+  {
+    for (const char c : *str)
+    {
+      iHash ^= static_cast<unsigned char>(c);
+      iHash *= 16777619u;
+    }
+    iHash *= 16777619u;
+  }
+
+  // 0 means not calculated yet
+  return iHash != 0 ? iHash : 1;
+}
+
+} // unnamed namespace
+
 CPVREpgInfoTag::CPVREpgInfoTag()
 : m_iUniqueBroadcastID(EPG_TAG_INVALID_UID),
   m_iFlags(EPG_TAG_FLAG_UNDEFINED),
+  m_firstAired(INVALID_TIME),
   m_channelData(new CPVREpgChannelData)
 {
 }
@@ -43,6 +84,7 @@ CPVREpgInfoTag::CPVREpgInfoTag(const std::shared_ptr<CPVREpgChannelData>& channe
   : m_iUniqueBroadcastID(EPG_TAG_INVALID_UID),
     m_iFlags(EPG_TAG_FLAG_UNDEFINED),
     m_bIsGapTag(bIsGapTag),
+    m_firstAired(INVALID_TIME),
     m_iEpgID(iEpgID)
 {
   if (channelData)
@@ -52,28 +94,31 @@ CPVREpgInfoTag::CPVREpgInfoTag(const std::shared_ptr<CPVREpgChannelData>& channe
 
   const CDateTimeSpan correction(
       0, 0, 0, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iPVRTimeCorrection);
-  m_startTime = start + correction;
-  m_endTime = end + correction;
-
-  UpdatePath();
+  m_startTime = ToTime(start + correction);
+  m_endTime = ToTime(end + correction);
 }
 
 CPVREpgInfoTag::CPVREpgInfoTag(const EPG_TAG& data, int iClientId, const std::shared_ptr<CPVREpgChannelData>& channelData, int iEpgID)
-: m_iParentalRating(data.iParentalRating),
-  m_iStarRating(data.iStarRating),
-  m_iSeriesNumber(data.iSeriesNumber),
+: m_iSeriesNumber(data.iSeriesNumber),
   m_iEpisodeNumber(data.iEpisodeNumber),
   m_iEpisodePart(data.iEpisodePartNumber),
   m_iUniqueBroadcastID(data.iUniqueBroadcastId),
-  m_iYear(data.iYear),
+  m_iFlags(data.iFlags),
+  m_iParentalRating(static_cast<int16_t>(data.iParentalRating)),
+  m_iStarRating(static_cast<int16_t>(data.iStarRating)),
+  m_iYear(static_cast<int16_t>(data.iYear)),
   m_startTime(data.startTime + CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iPVRTimeCorrection),
   m_endTime(data.endTime + CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iPVRTimeCorrection),
-  m_iFlags(data.iFlags),
+  m_firstAired(INVALID_TIME),
   m_iEpgID(iEpgID)
 {
   // strFirstAired is optional, so check if supported before assigning it
   if (data.strFirstAired && strlen(data.strFirstAired) > 0)
-    m_firstAired.SetFromW3CDate(data.strFirstAired);
+  {
+    CDateTime firstAired;
+    firstAired.SetFromW3CDate(data.strFirstAired);
+    m_firstAired = ToTime(firstAired);
+  }
 
   if (channelData)
   {
@@ -96,29 +141,27 @@ CPVREpgInfoTag::CPVREpgInfoTag(const EPG_TAG& data, int iClientId, const std::sh
 
   // explicit NULL check, because there is no implicit NULL constructor for std::string
   if (data.strTitle)
-    m_strTitle = data.strTitle;
+    m_strTitle = CPVREpgStringPool::Intern(data.strTitle);
   if (data.strPlotOutline)
     m_strPlotOutline = data.strPlotOutline;
   if (data.strPlot)
     m_strPlot = data.strPlot;
   if (data.strOriginalTitle)
-    m_strOriginalTitle = data.strOriginalTitle;
+    m_strOriginalTitle = CPVREpgStringPool::Intern(data.strOriginalTitle);
   if (data.strCast)
-    m_cast = Tokenize(data.strCast);
+    m_strCast = data.strCast;
   if (data.strDirector)
-    m_directors = Tokenize(data.strDirector);
+    m_strDirectors = CPVREpgStringPool::Intern(data.strDirector);
   if (data.strWriter)
-    m_writers = Tokenize(data.strWriter);
+    m_strWriters = CPVREpgStringPool::Intern(data.strWriter);
   if (data.strIMDBNumber)
-    m_strIMDBNumber = data.strIMDBNumber;
+    m_strIMDBNumber = CPVREpgStringPool::Intern(data.strIMDBNumber);
   if (data.strEpisodeName)
-    m_strEpisodeName = data.strEpisodeName;
+    m_strEpisodeName = CPVREpgStringPool::Intern(data.strEpisodeName);
   if (data.strIconPath)
-    m_strIconPath = data.strIconPath;
+    m_strIconPath = CPVREpgStringPool::Intern(data.strIconPath);
   if (data.strSeriesLink)
-    m_strSeriesLink = data.strSeriesLink;
-
-  UpdatePath();
+    m_strSeriesLink = CPVREpgStringPool::Intern(data.strSeriesLink);
 }
 
 void CPVREpgInfoTag::SetChannelData(const std::shared_ptr<CPVREpgChannelData>& data)
@@ -157,30 +200,33 @@ void CPVREpgInfoTag::Serialize(CVariant& value) const
   value["channeluid"] = m_channelData->UniqueClientChannelId();
   value["parentalrating"] = m_iParentalRating;
   value["rating"] = m_iStarRating;
-  value["title"] = m_strTitle;
+  value["title"] = Title();
   value["plotoutline"] = m_strPlotOutline;
-  value["plot"] = m_strPlot;
-  value["originaltitle"] = m_strOriginalTitle;
-  value["cast"] = DeTokenize(m_cast);
-  value["director"] = DeTokenize(m_directors);
-  value["writer"] = DeTokenize(m_writers);
+  value["plot"] = Plot();
+  value["originaltitle"] = OriginalTitle();
+  value["cast"] = DeTokenize(Cast());
+  value["director"] = CPVREpgStringPool::Get(m_strDirectors);
+  value["writer"] = CPVREpgStringPool::Get(m_strWriters);
   value["year"] = m_iYear;
-  value["imdbnumber"] = m_strIMDBNumber;
-  value["genre"] = m_genre;
-  value["filenameandpath"] = m_strFileNameAndPath;
-  value["starttime"] = m_startTime.IsValid() ? m_startTime.GetAsDBDateTime() : StringUtils::Empty;
-  value["endtime"] = m_endTime.IsValid() ? m_endTime.GetAsDBDateTime() : StringUtils::Empty;
+  value["imdbnumber"] = IMDBNumber();
+  value["genre"] = Genre();
+  value["filenameandpath"] = Path();
+  const CDateTime startTime = StartAsUTC();
+  const CDateTime endTime = EndAsUTC();
+  const CDateTime firstAired = FirstAired();
+  value["starttime"] = startTime.IsValid() ? startTime.GetAsDBDateTime() : StringUtils::Empty;
+  value["endtime"] = endTime.IsValid() ? endTime.GetAsDBDateTime() : StringUtils::Empty;
   value["runtime"] = GetDuration() / 60;
-  value["firstaired"] = m_firstAired.IsValid() ? m_firstAired.GetAsDBDate() : StringUtils::Empty;
+  value["firstaired"] = firstAired.IsValid() ? firstAired.GetAsDBDate() : StringUtils::Empty;
   value["progress"] = Progress();
   value["progresspercentage"] = ProgressPercentage();
-  value["episodename"] = m_strEpisodeName;
+  value["episodename"] = EpisodeName();
   value["episodenum"] = m_iEpisodeNumber;
   value["episodepart"] = m_iEpisodePart;
   value["isactive"] = IsActive();
   value["wasactive"] = WasActive();
   value["isseries"] = IsSeries();
-  value["serieslink"] = m_strSeriesLink;
+  value["serieslink"] = SeriesLink();
   value["clientid"] = m_channelData->ClientId();
 }
 
@@ -198,19 +244,19 @@ CDateTime CPVREpgInfoTag::GetCurrentPlayingTime() const
 
 bool CPVREpgInfoTag::IsActive() const
 {
-  CDateTime now = GetCurrentPlayingTime();
+  const time_t now = ToTime(GetCurrentPlayingTime());
   return (m_startTime <= now && m_endTime > now);
 }
 
 bool CPVREpgInfoTag::WasActive() const
 {
-  CDateTime now = GetCurrentPlayingTime();
+  const time_t now = ToTime(GetCurrentPlayingTime());
   return (m_endTime < now);
 }
 
 bool CPVREpgInfoTag::IsUpcoming() const
 {
-  CDateTime now = GetCurrentPlayingTime();
+  const time_t now = ToTime(GetCurrentPlayingTime());
   return (m_startTime > now);
 }
 
@@ -218,10 +264,10 @@ float CPVREpgInfoTag::ProgressPercentage() const
 {
   float fReturn = 0.0f;
 
-  time_t currentTime, startTime, endTime;
+  time_t currentTime;
   CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsTime(currentTime);
-  m_startTime.GetAsTime(startTime);
-  m_endTime.GetAsTime(endTime);
+  const time_t startTime = m_startTime;
+  const time_t endTime = m_endTime;
   int iDuration = endTime - startTime > 0 ? endTime - startTime : 3600;
 
   if (currentTime >= startTime && currentTime <= endTime)
@@ -234,10 +280,9 @@ float CPVREpgInfoTag::ProgressPercentage() const
 
 int CPVREpgInfoTag::Progress() const
 {
-  time_t currentTime, startTime;
+  time_t currentTime;
   CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsTime(currentTime);
-  m_startTime.GetAsTime(startTime);
-  int iDuration = currentTime - startTime;
+  int iDuration = currentTime - m_startTime;
 
   if (iDuration <= 0)
     return 0;
@@ -268,44 +313,41 @@ int CPVREpgInfoTag::UniqueChannelID() const
 
 CDateTime CPVREpgInfoTag::StartAsUTC() const
 {
-  return m_startTime;
+  return ToDateTime(m_startTime);
 }
 
 CDateTime CPVREpgInfoTag::StartAsLocalTime() const
 {
   CDateTime retVal;
-  retVal.SetFromUTCDateTime(m_startTime);
+  retVal.SetFromUTCDateTime(StartAsUTC());
   return retVal;
 }
 
 CDateTime CPVREpgInfoTag::EndAsUTC() const
 {
-  return m_endTime;
+  return ToDateTime(m_endTime);
 }
 
 CDateTime CPVREpgInfoTag::EndAsLocalTime() const
 {
   CDateTime retVal;
-  retVal.SetFromUTCDateTime(m_endTime);
+  retVal.SetFromUTCDateTime(EndAsUTC());
   return retVal;
 }
 
 void CPVREpgInfoTag::SetEndFromUTC(const CDateTime& end)
 {
-  m_endTime = end;
+  m_endTime = ToTime(end);
 }
 
 int CPVREpgInfoTag::GetDuration() const
 {
-  time_t start, end;
-  m_startTime.GetAsTime(start);
-  m_endTime.GetAsTime(end);
-  return end - start > 0 ? end - start : 3600;
+  return m_endTime - m_startTime > 0 ? m_endTime - m_startTime : 3600;
 }
 
 std::string CPVREpgInfoTag::Title() const
 {
-  return m_strTitle;
+  return CPVREpgStringPool::Get(m_strTitle);
 }
 
 std::string CPVREpgInfoTag::PlotOutline() const
@@ -315,34 +357,40 @@ std::string CPVREpgInfoTag::PlotOutline() const
 
 std::string CPVREpgInfoTag::Plot() const
 {
+  LoadLongText();
+
+  CSingleLock lock(m_critSection);
   return m_strPlot;
 }
 
 std::string CPVREpgInfoTag::OriginalTitle() const
 {
-  return m_strOriginalTitle;
+  return CPVREpgStringPool::Get(m_strOriginalTitle);
 }
 
 const std::vector<std::string> CPVREpgInfoTag::Cast() const
 {
-  return m_cast;
+  LoadLongText();
+
+  CSingleLock lock(m_critSection);
+  return Tokenize(m_strCast);
 }
 
 const std::vector<std::string> CPVREpgInfoTag::Directors() const
 {
-  return m_directors;
+  return Tokenize(CPVREpgStringPool::Get(m_strDirectors));
 }
 
 const std::vector<std::string> CPVREpgInfoTag::Writers() const
 {
-  return m_writers;
+  return Tokenize(CPVREpgStringPool::Get(m_strWriters));
 }
 
 const std::string CPVREpgInfoTag::GetCastLabel() const
 {
   // Note: see CVideoInfoTag::GetCast for reference implementation.
   std::string strLabel;
-  for (const auto& castEntry : m_cast)
+  for (const auto& castEntry : Cast())
     strLabel += StringUtils::Format("{}\n", castEntry);
 
   return StringUtils::TrimRight(strLabel, "\n");
@@ -350,17 +398,17 @@ const std::string CPVREpgInfoTag::GetCastLabel() const
 
 const std::string CPVREpgInfoTag::GetDirectorsLabel() const
 {
-  return StringUtils::Join(m_directors, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator);
+  return StringUtils::Join(Directors(), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator);
 }
 
 const std::string CPVREpgInfoTag::GetWritersLabel() const
 {
-  return StringUtils::Join(m_writers, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator);
+  return StringUtils::Join(Writers(), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator);
 }
 
 const std::string CPVREpgInfoTag::GetGenresLabel() const
 {
-  return StringUtils::Join(m_genre, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator);
+  return StringUtils::Join(Genre(), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator);
 }
 
 int CPVREpgInfoTag::Year() const
@@ -370,29 +418,25 @@ int CPVREpgInfoTag::Year() const
 
 std::string CPVREpgInfoTag::IMDBNumber() const
 {
-  return m_strIMDBNumber;
+  return CPVREpgStringPool::Get(m_strIMDBNumber);
 }
 
 void CPVREpgInfoTag::SetGenre(int iGenreType, int iGenreSubType, const char* strGenre)
 {
-  if (m_iGenreType != iGenreType || m_iGenreSubType != iGenreSubType)
+  m_iGenreType = static_cast<int16_t>(iGenreType);
+  m_iGenreSubType = static_cast<int16_t>(iGenreSubType);
+
+  if ((iGenreType == EPG_GENRE_USE_STRING || iGenreSubType == EPG_GENRE_USE_STRING) &&
+      (strGenre != NULL) && (strlen(strGenre) > 0))
   {
-    m_iGenreType = iGenreType;
-    m_iGenreSubType = iGenreSubType;
-    if ((iGenreType == EPG_GENRE_USE_STRING || iGenreSubType == EPG_GENRE_USE_STRING) && (strGenre != NULL) && (strlen(strGenre) > 0))
-    {
-      /* Type and sub type are both not given. No EPG color coding possible unless sub type is used to specify
-       * EPG_GENRE_USE_STRING leaving type available for genre category, use the provided genre description for the text. */
-      m_genre = Tokenize(strGenre);
-    }
+    /* Type and sub type are both not given. No EPG color coding possible unless sub type is used to specify
+     * EPG_GENRE_USE_STRING leaving type available for genre category, use the provided genre description for the text. */
+    m_strGenre = CPVREpgStringPool::Intern(strGenre);
   }
-
-  if (m_genre.empty())
+  else
   {
-    // Determine the genre description from the type and subtype IDs.
-    m_genre = StringUtils::Split(
-        CPVREpg::ConvertGenreIdToString(iGenreType, iGenreSubType),
-        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator);
+    // The genre description is determined from the type and subtype IDs.
+    m_strGenre.reset();
   }
 }
 
@@ -408,12 +452,17 @@ int CPVREpgInfoTag::GenreSubType() const
 
 const std::vector<std::string> CPVREpgInfoTag::Genre() const
 {
-  return m_genre;
+  if (m_strGenre)
+    return Tokenize(*m_strGenre);
+
+  return StringUtils::Split(
+      CPVREpg::ConvertGenreIdToString(m_iGenreType, m_iGenreSubType),
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator);
 }
 
 CDateTime CPVREpgInfoTag::FirstAired() const
 {
-  return m_firstAired;
+  return ToDateTime(m_firstAired);
 }
 
 int CPVREpgInfoTag::ParentalRating() const
@@ -433,7 +482,7 @@ int CPVREpgInfoTag::SeriesNumber() const
 
 std::string CPVREpgInfoTag::SeriesLink() const
 {
-  return m_strSeriesLink;
+  return CPVREpgStringPool::Get(m_strSeriesLink);
 }
 
 int CPVREpgInfoTag::EpisodeNumber() const
@@ -448,30 +497,39 @@ int CPVREpgInfoTag::EpisodePart() const
 
 std::string CPVREpgInfoTag::EpisodeName() const
 {
-  return m_strEpisodeName;
+  return CPVREpgStringPool::Get(m_strEpisodeName);
 }
 
 std::string CPVREpgInfoTag::Icon() const
 {
-  return m_strIconPath;
+  return CPVREpgStringPool::Get(m_strIconPath);
 }
 
 std::string CPVREpgInfoTag::Path() const
 {
-  return m_strFileNameAndPath;
+  return StringUtils::Format("pvr://guide/{:04}/{}.epg", EpgID(), StartAsUTC().GetAsDBDateTime());
 }
 
 bool CPVREpgInfoTag::Update(const CPVREpgInfoTag& tag, bool bUpdateBroadcastId /* = true */)
 {
+  // plot and cast of tags read from the database are compared by their stored hash, so that
+  // they don't have to be loaded for every tag
+  const bool bLongTextChanged = LongTextHash() != tag.LongTextHash();
+
+  // plot and cast of tag are taken over if anything changed. Those of a tag read from the database
+  // can be loaded later by its database id, unless this tag keeps a different one.
+  if (!bUpdateBroadcastId && m_iDatabaseID != tag.m_iDatabaseID)
+    tag.LoadLongText();
+
+  // equal pooled strings are the same instance, comparing the pointers is sufficient
   CSingleLock lock(m_critSection);
   bool bChanged = (
+      bLongTextChanged ||
       m_strTitle           != tag.m_strTitle ||
       m_strPlotOutline     != tag.m_strPlotOutline ||
-      m_strPlot            != tag.m_strPlot ||
       m_strOriginalTitle   != tag.m_strOriginalTitle ||
-      m_cast               != tag.m_cast ||
-      m_directors          != tag.m_directors ||
-      m_writers            != tag.m_writers ||
+      m_strDirectors       != tag.m_strDirectors ||
+      m_strWriters         != tag.m_strWriters ||
       m_iYear              != tag.m_iYear ||
       m_strIMDBNumber      != tag.m_strIMDBNumber ||
       m_startTime          != tag.m_startTime ||
@@ -487,7 +545,7 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag& tag, bool bUpdateBroadcastId /
       m_strEpisodeName     != tag.m_strEpisodeName ||
       m_iUniqueBroadcastID != tag.m_iUniqueBroadcastID ||
       m_iEpgID             != tag.m_iEpgID ||
-      m_genre              != tag.m_genre ||
+      m_strGenre           != tag.m_strGenre ||
       m_strIconPath        != tag.m_strIconPath ||
       m_iFlags             != tag.m_iFlags ||
       m_strSeriesLink      != tag.m_strSeriesLink ||
@@ -504,11 +562,13 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag& tag, bool bUpdateBroadcastId /
 
     m_strTitle = tag.m_strTitle;
     m_strPlotOutline = tag.m_strPlotOutline;
-    m_strPlot = tag.m_strPlot;
     m_strOriginalTitle = tag.m_strOriginalTitle;
-    m_cast = tag.m_cast;
-    m_directors = tag.m_directors;
-    m_writers = tag.m_writers;
+    m_strPlot = tag.m_strPlot;
+    m_strCast = tag.m_strCast;
+    m_bLongTextLoaded = tag.m_bLongTextLoaded;
+    m_iLongTextHash = tag.m_iLongTextHash;
+    m_strDirectors = tag.m_strDirectors;
+    m_strWriters = tag.m_strWriters;
     m_iYear = tag.m_iYear;
     m_strIMDBNumber = tag.m_strIMDBNumber;
     m_startTime = tag.m_startTime;
@@ -518,17 +578,7 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag& tag, bool bUpdateBroadcastId /
     m_iEpgID = tag.m_iEpgID;
     m_iFlags = tag.m_iFlags;
     m_strSeriesLink = tag.m_strSeriesLink;
-
-    if (m_iGenreType == EPG_GENRE_USE_STRING || m_iGenreSubType == EPG_GENRE_USE_STRING)
-    {
-      /* No type/subtype. Use the provided description */
-      m_genre = tag.m_genre;
-    }
-    else
-    {
-      /* Determine genre description by type/subtype */
-      m_genre = StringUtils::Split(CPVREpg::ConvertGenreIdToString(tag.m_iGenreType, tag.m_iGenreSubType), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoItemSeparator);
-    }
+    m_strGenre = tag.m_strGenre;
     m_firstAired = tag.m_firstAired;
     m_iParentalRating = tag.m_iParentalRating;
     m_iStarRating = tag.m_iStarRating;
@@ -541,12 +591,81 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag& tag, bool bUpdateBroadcastId /
     m_channelData = tag.m_channelData;
   }
 
-  if (bChanged)
-    UpdatePath();
-
   return bChanged;
 }
 
+unsigned int CPVREpgInfoTag::LongTextHash() const
+{
+  {
+    CSingleLock lock(m_critSection);
+    if (m_iLongTextHash != 0)
+      return m_iLongTextHash;
+  }
+
+  // tags of older database versions have no hash stored
+  const bool bLoaded = LoadLongText();
+
+  CSingleLock lock(m_critSection);
+  if (!bLoaded)
+    return 0; // unknown
+
+  if (m_iLongTextHash == 0)
+    m_iLongTextHash = GetLongTextHash(m_strPlot, m_strCast);
+  return m_iLongTextHash;
+}
+
+bool CPVREpgInfoTag::IsLongTextLoaded() const
+{
+  CSingleLock lock(m_critSection);
+  return m_bLongTextLoaded;
+}
+
+bool CPVREpgInfoTag::LoadLongText() const
+{
+  if (IsLongTextLoaded())
+    return true;
+
+  const std::shared_ptr<CPVREpgDatabase> database =
+      CServiceBroker::GetPVRManager().EpgContainer().GetEpgDatabase();
+  if (!database)
+  {
+    CLog::LogF(LOGERROR, "Could not load plot and cast of EPG tag ({}), no database", m_iDatabaseID);
+    return false;
+  }
+  return LoadLongText(*database);
+}
+
+bool CPVREpgInfoTag::LoadLongText(CPVREpgDatabase& database) const
+{
+  int iDatabaseID;
+  {
+    CSingleLock lock(m_critSection);
+    if (m_bLongTextLoaded)
+      return true;
+
+    iDatabaseID = m_iDatabaseID;
+  }
+
+  // do not hold the lock while querying, persisting tags locks the database first
+  std::string strPlot;
+  std::string strCast;
+  if (!database.GetEpgTagPlotAndCast(iDatabaseID, strPlot, strCast))
+  {
+    // the tag stays unloaded, its empty plot and cast must never replace the stored ones
+    CLog::LogF(LOGERROR, "Could not load plot and cast of EPG tag ({})", iDatabaseID);
+    return false;
+  }
+
+  CSingleLock lock(m_critSection);
+  if (!m_bLongTextLoaded)
+  {
+    m_strPlot = std::move(strPlot);
+    m_strCast = std::move(strCast);
+    m_bLongTextLoaded = true;
+  }
+  return true;
+}
+
 bool CPVREpgInfoTag::QueuePersistQuery(const std::shared_ptr<CPVREpgDatabase>& database)
 {
   if (!database)
@@ -571,12 +690,6 @@ std::vector<PVR_EDL_ENTRY> CPVREpgInfoTag::GetEdl() const
   return edls;
 }
 
-void CPVREpgInfoTag::UpdatePath()
-{
-  m_strFileNameAndPath =
-      StringUtils::Format("pvr://guide/{:04}/{}.epg", EpgID(), m_startTime.GetAsDBDateTime());
-}
-
 int CPVREpgInfoTag::EpgID() const
 {
   return m_iEpgID;
@@ -585,7 +698,6 @@ int CPVREpgInfoTag::EpgID() const
 void CPVREpgInfoTag::SetEpgID(int iEpgID)
 {
   m_iEpgID = iEpgID;
-  UpdatePath(); // Note: path contains epg id.
 }
 
 bool CPVREpgInfoTag::IsRecordable() const
@@ -9,10 +9,13 @@
 #pragma once
 
 #include "XBDateTime.h"
+#include "pvr/epg/EpgStringPool.h"
 #include "threads/CriticalSection.h"
 #include "utils/ISerializable.h"
 
+#include <ctime>
 #include <memory>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -380,6 +383,13 @@ namespace PVR
      */
     bool IsParentalLocked() const;
 
+    /*!
+     * @brief Check whether plot and cast of this event are in memory. Those of events read from
+     * the database are only loaded when asked for.
+     * @return True if loaded, false otherwise.
+     */
+    bool IsLongTextLoaded() const;
+
     /*!
      * @brief Check whether this event is a real event or a gap in the EPG timeline.
      * @return True if this event is a gap, false otherwise.
@@ -443,45 +453,64 @@ namespace PVR
      */
     void SetGenre(int iGenreType, int iGenreSubType, const char* strGenre);
 
-    /*!
-     * @brief Update the path of this tag.
-     */
-    void UpdatePath();
-
     /*!
      * @brief Get current time, taking timeshifting into account.
      * @return The playing time.
      */
     CDateTime GetCurrentPlayingTime() const;
 
+    /*!
+     * @brief Load plot and cast of a tag read from the database, if not yet done.
+     * @return True if they are loaded, false if loading failed. The tag stays unloaded then.
+     */
+    bool LoadLongText() const;
+
+    /*!
+     * @brief Load plot and cast of a tag read from the given database, if not yet done.
+     * @param database The EPG database.
+     * @return True if they are loaded, false if loading failed. The tag stays unloaded then.
+     */
+    bool LoadLongText(CPVREpgDatabase& database) const;
+
+    /*!
+     * @brief Get the hash of plot and cast, stored with the tag in the database so that they can
+     * be compared without loading them.
+     * @return The hash.
+     */
+    unsigned int LongTextHash() const;
+
+    // Tags of the whole guide may be in memory at once, so strings repeating across tags are
+    // pooled, times are stored as seconds and plot and cast of tags read from the database are
+    // only loaded when asked for.
     int m_iDatabaseID = -1; /*!< database ID */
-    int m_iGenreType = 0; /*!< genre type */
-    int m_iGenreSubType = 0; /*!< genre subtype */
-    int m_iParentalRating = 0; /*!< parental rating */
-    int m_iStarRating = 0; /*!< star rating */
     int m_iSeriesNumber = -1; /*!< series number */
     int m_iEpisodeNumber = -1; /*!< episode number */
     int m_iEpisodePart = -1; /*!< episode part number */
     unsigned int m_iUniqueBroadcastID = 0; /*!< unique broadcast ID */
-    std::string m_strTitle; /*!< title */
-    std::string m_strPlotOutline; /*!< plot outline */
-    std::string m_strPlot; /*!< plot */
-    std::string m_strOriginalTitle; /*!< original title */
-    std::vector<std::string> m_cast; /*!< cast */
-    std::vector<std::string> m_directors; /*!< director(s) */
-    std::vector<std::string> m_writers; /*!< writer(s) */
-    int m_iYear = 0; /*!< year */
-    std::string m_strIMDBNumber; /*!< imdb number */
-    std::vector<std::string> m_genre; /*!< genre */
-    std::string m_strEpisodeName; /*!< episode name */
-    std::string m_strIconPath; /*!< the path to the icon */
-    std::string m_strFileNameAndPath; /*!< the filename and path */
-    CDateTime m_startTime; /*!< event start time */
-    CDateTime m_endTime; /*!< event end time */
-    CDateTime m_firstAired; /*!< first airdate */
     unsigned int m_iFlags = 0; /*!< the flags applicable to this EPG entry */
-    std::string m_strSeriesLink; /*!< series link */
+    int16_t m_iGenreType = 0; /*!< genre type */
+    int16_t m_iGenreSubType = 0; /*!< genre subtype */
+    int16_t m_iParentalRating = 0; /*!< parental rating */
+    int16_t m_iStarRating = 0; /*!< star rating */
+    int16_t m_iYear = 0; /*!< year */
     bool m_bIsGapTag = false;
+    mutable bool m_bLongTextLoaded = true; /*!< false until plot and cast were read from the database */
+    mutable unsigned int m_iLongTextHash = 0; /*!< hash of plot and cast, 0 until calculated */
+    time_t m_startTime = 0; /*!< event start time */
+    time_t m_endTime = 0; /*!< event end time */
+    time_t m_firstAired; /*!< first airdate, INVALID_TIME if not set */
+    CPVREpgStringPool::String m_strTitle; /*!< title */
+    CPVREpgStringPool::String m_strOriginalTitle; /*!< original title */
+    CPVREpgStringPool::String m_strEpisodeName; /*!< episode name */
+    CPVREpgStringPool::String m_strDirectors; /*!< tokenized director(s) */
+    CPVREpgStringPool::String m_strWriters; /*!< tokenized writer(s) */
+    CPVREpgStringPool::String m_strGenre; /*!< tokenized genre description, if not given by type */
+    CPVREpgStringPool::String m_strIMDBNumber; /*!< imdb number */
+    CPVREpgStringPool::String m_strIconPath; /*!< the path to the icon */
+    CPVREpgStringPool::String m_strSeriesLink; /*!< series link */
+    std::string m_strPlotOutline; /*!< plot outline */
+    mutable std::string m_strPlot; /*!< plot */
+    mutable std::string m_strCast; /*!< tokenized cast */
 
     mutable CCriticalSection m_critSection;
     std::shared_ptr<CPVREpgChannelData> m_channelData;
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "EpgStringPool.h"
+
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+
+#include <string_view>
+#include <unordered_map>
+
+using namespace PVR;
+
+struct CPVREpgStringPool::SPool
+{
+  CCriticalSection critSection;
+  // keys point to the pooled strings
+  std::unordered_map<std::string_view, std::weak_ptr<const std::string>> strings;
+  size_t length = 0;
+};
+
+std::shared_ptr<CPVREpgStringPool::SPool> CPVREpgStringPool::GetPool()
+{
+  // pooled strings keep the pool alive, they may outlive this static
+  static const std::shared_ptr<SPool> pool = std::make_shared<SPool>();
+  return pool;
+}
+
+CPVREpgStringPool::String CPVREpgStringPool::Intern(const std::string& str)
+{
+  if (str.empty())
+    return {};
+
+  const std::shared_ptr<SPool> pool = GetPool();
+
+  CSingleLock lock(pool->critSection);
+
+  auto it = pool->strings.find(str);
+  if (it != pool->strings.end())
+  {
+    String pooled = it->second.lock();
+    if (pooled)
+      return pooled;
+
+    // the last user is about to release it, the key must not point to it anymore
+    pool->length -= it->first.size();
+    pool->strings.erase(it);
+  }
+
+  String pooled(new std::string(str), [pool](const std::string* released) {
+    {
+      CSingleLock lock(pool->critSection);
+      const auto it = pool->strings.find(*released);
+      if (it != pool->strings.end() && it->first.data() == released->data())
+      {
+        pool->length -= it->first.size();
+        pool->strings.erase(it);
+      }
+    }
+    delete released;
+  });
+
+  pool->strings.emplace(*pooled, pooled);
+  pool->length += pooled->size();
+  return pooled;
+}
+
+const std::string& CPVREpgStringPool::Get(const String& str)
+{
+  return str ? *str : StringUtils::Empty;
+}
+
+size_t CPVREpgStringPool::GetSize()
+{
+  const std::shared_ptr<SPool> pool = GetPool();
+  CSingleLock lock(pool->critSection);
+  return pool->strings.size();
+}
+
+size_t CPVREpgStringPool::GetLength()
+{
+  const std::shared_ptr<SPool> pool = GetPool();
+  CSingleLock lock(pool->critSection);
+  return pool->length;
+}
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <memory>
+#include <stddef.h>
+#include <string>
+
+namespace PVR
+{
+  /*!
+   * @brief Pool of the strings that repeat across EPG tags, like titles, genres, credits and
+   * icon paths. Every distinct string is stored once and shared by all tags using it, it is
+   * removed from the pool when the last tag using it is gone.
+   */
+  class CPVREpgStringPool
+  {
+  public:
+    using String = std::shared_ptr<const std::string>;
+
+    /*!
+     * @brief Get the pooled instance of a string.
+     * @param str The string.
+     * @return The shared string, nullptr for an empty string.
+     */
+    static String Intern(const std::string& str);
+
+    /*!
+     * @brief Get the value of a pooled string.
+     * @param str The pooled string, may be nullptr.
+     * @return The value, an empty string for nullptr.
+     */
+    static const std::string& Get(const String& str);
+
+    /*!
+     * @brief Get the number of distinct strings in the pool.
+     */
+    static size_t GetSize();
+
+    /*!
+     * @brief Get the number of characters of all strings in the pool.
+     */
+    static size_t GetLength();
+
+  private:
+    CPVREpgStringPool() = delete;
+
+    struct SPool;
+
+    static std::shared_ptr<SPool> GetPool();
+  };
+}
@@ -12,9 +12,8 @@
 #include "pvr/PVRManager.h"
 #include "pvr/PVRPlaybackState.h"
 #include "pvr/epg/EpgChannelData.h"
-#include "pvr/epg/EpgDatabase.h"
 #include "pvr/epg/EpgInfoTag.h"
-#include "utils/log.h"
+#include "pvr/epg/EpgTimeIndex.h"
 
 using namespace PVR;
 
@@ -76,43 +75,25 @@ void CPVREpgTagsCache::Refresh(bool bUpdateIfNeeded)
 
   if (bUpdateIfNeeded)
   {
-    m_lastEndedTag.reset();
-    m_nowActiveTag.reset();
-    m_nextStartingTag.reset();
-
-    for (const auto& tag : m_changedTags)
+    m_nowActiveTag = m_timeIndex.GetActiveTag(activeTime);
+    if (m_nowActiveTag)
     {
-      if (tag.second->StartAsUTC() <= activeTime && tag.second->EndAsUTC() > activeTime)
-      {
-        m_nowActiveTag = tag.second;
-        m_nowActiveStart = m_nowActiveTag->StartAsUTC();
-        m_nowActiveEnd = m_nowActiveTag->EndAsUTC();
-        break;
-      }
+      m_nowActiveTag->SetChannelData(m_channelData);
+      m_nowActiveStart = m_nowActiveTag->StartAsUTC();
+      m_nowActiveEnd = m_nowActiveTag->EndAsUTC();
     }
 
-    if (!m_nowActiveTag && m_database)
-    {
-      const std::vector<std::shared_ptr<CPVREpgInfoTag>> tags =
-          m_database->GetEpgTagsByMinEndMaxStartTime(m_iEpgID, activeTime + ONE_SECOND, activeTime);
-      if (!tags.empty())
-      {
-        if (tags.size() > 1)
-          CLog::LogF(LOGWARNING, "Got multiple results. Picking up the first.");
-
-        m_nowActiveTag = tags.front();
-        m_nowActiveTag->SetChannelData(m_channelData);
-        m_nowActiveStart = m_nowActiveTag->StartAsUTC();
-        m_nowActiveEnd = m_nowActiveTag->EndAsUTC();
-      }
-    }
+    m_lastEndedTag = m_timeIndex.GetLastEndedTag(activeTime);
+    if (m_lastEndedTag)
+      m_lastEndedTag->SetChannelData(m_channelData);
 
-    RefreshLastEndedTag(activeTime);
-    RefreshNextStartingTag(activeTime);
+    m_nextStartingTag = m_timeIndex.GetNextStartingTag(activeTime + ONE_SECOND);
+    if (m_nextStartingTag)
+      m_nextStartingTag->SetChannelData(m_channelData);
 
     if (!m_nowActiveTag)
     {
-      // we're in a gap. remember start and end time of that gap to avoid unneeded db load.
+      // we're in a gap. remember start and end time of that gap to avoid unneeded lookups.
       if (m_lastEndedTag)
         m_nowActiveStart = m_lastEndedTag->EndAsUTC();
       else
@@ -125,47 +106,3 @@ void CPVREpgTagsCache::Refresh(bool bUpdateIfNeeded)
     }
   }
 }
-
-void CPVREpgTagsCache::RefreshLastEndedTag(const CDateTime& activeTime)
-{
-  if (m_database)
-  {
-    m_lastEndedTag = m_database->GetEpgTagByMaxEndTime(m_iEpgID, activeTime);
-    if (m_lastEndedTag)
-      m_lastEndedTag->SetChannelData(m_channelData);
-  }
-
-  for (auto it = m_changedTags.rbegin(); it != m_changedTags.rend(); ++it)
-  {
-    if (it->second->WasActive())
-    {
-      if (!m_lastEndedTag || m_lastEndedTag->EndAsUTC() < it->second->EndAsUTC())
-      {
-        m_lastEndedTag = it->second;
-        break;
-      }
-    }
-  }
-}
-
-void CPVREpgTagsCache::RefreshNextStartingTag(const CDateTime& activeTime)
-{
-  if (m_database)
-  {
-    m_nextStartingTag = m_database->GetEpgTagByMinStartTime(m_iEpgID, activeTime + ONE_SECOND);
-    if (m_nextStartingTag)
-      m_nextStartingTag->SetChannelData(m_channelData);
-  }
-
-  for (const auto& tag : m_changedTags)
-  {
-    if (tag.second->IsUpcoming())
-    {
-      if (!m_nextStartingTag || m_nextStartingTag->StartAsUTC() > tag.second->StartAsUTC())
-      {
-        m_nextStartingTag = tag.second;
-        break;
-      }
-    }
-  }
-}
@@ -10,24 +10,21 @@
 
 #include "XBDateTime.h"
 
-#include <map>
 #include <memory>
 
 namespace PVR
 {
 class CPVREpgChannelData;
-class CPVREpgDatabase;
 class CPVREpgInfoTag;
+class CPVREpgTimeIndex;
 
 class CPVREpgTagsCache
 {
 public:
   CPVREpgTagsCache() = delete;
-  CPVREpgTagsCache(int iEpgID,
-                   const std::shared_ptr<CPVREpgChannelData>& channelData,
-                   const std::shared_ptr<CPVREpgDatabase>& database,
-                   const std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>>& changedTags)
-    : m_iEpgID(iEpgID), m_channelData(channelData), m_database(database), m_changedTags(changedTags)
+  CPVREpgTagsCache(const std::shared_ptr<CPVREpgChannelData>& channelData,
+                   const CPVREpgTimeIndex& timeIndex)
+    : m_channelData(channelData), m_timeIndex(timeIndex)
   {
   }
 
@@ -41,13 +38,9 @@ public:
 
 private:
   void Refresh(bool bUpdateIfNeeded);
-  void RefreshLastEndedTag(const CDateTime& activeTime);
-  void RefreshNextStartingTag(const CDateTime& activeTime);
 
-  int m_iEpgID;
   std::shared_ptr<CPVREpgChannelData> m_channelData;
-  std::shared_ptr<CPVREpgDatabase> m_database;
-  const std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>>& m_changedTags;
+  const CPVREpgTimeIndex& m_timeIndex;
 
   std::shared_ptr<CPVREpgInfoTag> m_lastEndedTag;
   std::shared_ptr<CPVREpgInfoTag> m_nowActiveTag;
@@ -27,7 +27,7 @@ CPVREpgTagsContainer::CPVREpgTagsContainer(int iEpgID,
   : m_iEpgID(iEpgID),
     m_channelData(channelData),
     m_database(database),
-    m_tagsCache(new CPVREpgTagsCache(iEpgID, channelData, database, m_changedTags))
+    m_tagsCache(new CPVREpgTagsCache(channelData, m_timeIndex))
 {
 }
 
@@ -38,6 +38,11 @@ void CPVREpgTagsContainer::SetEpgID(int iEpgID)
   m_iEpgID = iEpgID;
   for (const auto& tag : m_changedTags)
     tag.second->SetEpgID(iEpgID);
+
+  m_timeIndex.Reset();
+  m_timeIndex.SetEpgID(iEpgID);
+  m_persistedStart.Reset();
+  m_persistedEnd.Reset();
 }
 
 void CPVREpgTagsContainer::SetChannelData(const std::shared_ptr<CPVREpgChannelData>& data)
@@ -46,46 +51,17 @@ void CPVREpgTagsContainer::SetChannelData(const std::shared_ptr<CPVREpgChannelDa
   m_tagsCache->SetChannelData(data);
   for (const auto& tag : m_changedTags)
     tag.second->SetChannelData(data);
+  for (const auto& tag : m_timeIndex.GetAllTags())
+    tag->SetChannelData(data);
 }
 
-namespace
+void CPVREpgTagsContainer::SetGuideIndex(const std::shared_ptr<CPVREpgGuideIndex>& guideIndex)
 {
+  m_timeIndex.SetGuideIndex(guideIndex, m_iEpgID);
+}
 
-void ResolveConflictingTags(const std::shared_ptr<CPVREpgInfoTag>& changedTag,
-                            std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags)
+namespace
 {
-  const CDateTime changedTagStart = changedTag->StartAsUTC();
-  const CDateTime changedTagEnd = changedTag->EndAsUTC();
-
-  for (auto it = tags.begin(); it != tags.end();)
-  {
-    bool bInsert = false;
-
-    if (changedTagEnd > (*it)->StartAsUTC() && changedTagStart < (*it)->EndAsUTC())
-    {
-      it = tags.erase(it);
-
-      if (it == tags.end())
-      {
-        bInsert = true;
-      }
-    }
-    else if ((*it)->StartAsUTC() >= changedTagEnd)
-    {
-      bInsert = true;
-    }
-    else
-    {
-      ++it;
-    }
-
-    if (bInsert)
-    {
-      tags.emplace(it, changedTag);
-      break;
-    }
-  }
-}
 
 bool FixOverlap(const std::shared_ptr<CPVREpgInfoTag>& previousTag,
                 const std::shared_ptr<CPVREpgInfoTag>& currentTag)
@@ -133,86 +109,19 @@ bool CPVREpgTagsContainer::UpdateEntries(const CPVREpgTagsContainer& tags)
   if (tags.m_changedTags.empty())
     return false;
 
-  if (m_database)
-  {
-    const CDateTime minEventEnd = (*tags.m_changedTags.cbegin()).second->StartAsUTC() + ONE_SECOND;
-    const CDateTime maxEventStart = (*tags.m_changedTags.crbegin()).second->EndAsUTC();
-
-    std::vector<std::shared_ptr<CPVREpgInfoTag>> existingTags =
-        m_database->GetEpgTagsByMinEndMaxStartTime(m_iEpgID, minEventEnd, maxEventStart);
-
-    if (!m_changedTags.empty())
-    {
-      // Fix data inconsistencies
-      for (const auto& changedTagsEntry : m_changedTags)
-      {
-        const auto& changedTag = changedTagsEntry.second;
-
-        if (changedTag->EndAsUTC() > minEventEnd && changedTag->StartAsUTC() < maxEventStart)
-        {
-          // tag is in queried range, thus it could cause inconsistencies...
-          ResolveConflictingTags(changedTag, existingTags);
-        }
-      }
-    }
-
-    bool bResetCache = false;
-    for (const auto& tagsEntry : tags.m_changedTags)
-    {
-      const auto& tag = tagsEntry.second;
-
-      tag->SetChannelData(m_channelData);
-      tag->SetEpgID(m_iEpgID);
-
-      std::shared_ptr<CPVREpgInfoTag> existingTag;
-      for (const auto& t : existingTags)
-      {
-        if (t->StartAsUTC() == tag->StartAsUTC())
-        {
-          existingTag = t;
-          break;
-        }
-      }
-
-      if (existingTag)
-      {
-        existingTag->SetChannelData(m_channelData);
-        existingTag->SetEpgID(m_iEpgID);
-
-        if (existingTag->Update(*tag, false))
-        {
-          // tag differs from existing tag and must be persisted
-          m_changedTags.insert({existingTag->StartAsUTC(), existingTag});
-          bResetCache = true;
-        }
-      }
-      else
-      {
-        // new tags must always be persisted
-        m_changedTags.insert({tag->StartAsUTC(), tag});
-        bResetCache = true;
-      }
-    }
-
-    if (bResetCache)
-      m_tagsCache->Reset();
-  }
-  else
-  {
-    for (const auto& tag : tags.m_changedTags)
-      UpdateEntry(tag.second);
-  }
+  for (const auto& tag : tags.m_changedTags)
+    UpdateEntry(tag.second);
 
   return true;
 }
 
 void CPVREpgTagsContainer::FixOverlappingEvents(
-    std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags) const
+    std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>>& tags) const
 {
   std::shared_ptr<CPVREpgInfoTag> previousTag;
   for (auto it = tags.begin(); it != tags.end();)
   {
-    const std::shared_ptr<CPVREpgInfoTag> currentTag = *it;
+    const std::shared_ptr<CPVREpgInfoTag> currentTag = (*it).second;
     if (FixOverlap(previousTag, currentTag))
     {
       previousTag = currentTag;
@@ -226,34 +135,75 @@ void CPVREpgTagsContainer::FixOverlappingEvents(
   }
 }
 
-void CPVREpgTagsContainer::FixOverlappingEvents(
-    std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>>& tags) const
+std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::CreateEntry(
+    const std::shared_ptr<CPVREpgInfoTag>& tag) const
 {
-  std::shared_ptr<CPVREpgInfoTag> previousTag;
-  for (auto it = tags.begin(); it != tags.end();)
+  if (tag)
   {
-    const std::shared_ptr<CPVREpgInfoTag> currentTag = (*it).second;
-    if (FixOverlap(previousTag, currentTag))
+    tag->SetChannelData(m_channelData);
+  }
+  return tag;
+}
+
+void CPVREpgTagsContainer::LoadIndex() const
+{
+  if (m_timeIndex.IsLoaded())
+  {
+    if (m_persistedStart.IsValid())
+      LoadPersistedTags();
+    return;
+  }
+
+  m_persistedStart.Reset();
+  m_persistedEnd.Reset();
+
+  if (m_database && m_iEpgID > 0)
+    m_timeIndex.Load(CreateEntries(m_database->GetAllEpgTags(m_iEpgID)));
+  else
+    m_timeIndex.Clear();
+
+  // the database is not yet up to date, apply the pending changes
+  for (const auto& tag : m_deletedTags)
+    m_timeIndex.Erase(tag.second);
+
+  for (const auto& tag : m_changedTags)
+    m_timeIndex.Insert(tag.second);
+}
+
+void CPVREpgTagsContainer::LoadPersistedTags() const
+{
+  if (!m_database)
+    return;
+
+  std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>> persistedTags;
+  for (const auto& tag : CreateEntries(
+           m_database->GetEpgTagsByMinStartMaxEndTime(m_iEpgID, m_persistedStart, m_persistedEnd)))
+    persistedTags.insert({tag->StartAsUTC(), tag});
+
+  bool bComplete = true;
+  for (const auto& tag : m_timeIndex.GetTagsBetween(m_persistedStart, m_persistedEnd))
+  {
+    // changed again since persisted, will get its id with the next persist
+    if (tag->DatabaseID() > 0 || m_changedTags.find(tag->StartAsUTC()) != m_changedTags.end())
+      continue;
+
+    const auto it = persistedTags.find(tag->StartAsUTC());
+    if (it != persistedTags.end())
     {
-      previousTag = currentTag;
-      ++it;
+      m_timeIndex.Insert(it->second);
+      m_tagsCache->Reset();
     }
     else
     {
-      it = tags.erase(it);
-      m_tagsCache->Reset();
+      bComplete = false; // queued queries not yet committed
     }
   }
-}
 
-std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::CreateEntry(
-    const std::shared_ptr<CPVREpgInfoTag>& tag) const
-{
-  if (tag)
+  if (bComplete)
   {
-    tag->SetChannelData(m_channelData);
+    m_persistedStart.Reset();
+    m_persistedEnd.Reset();
   }
-  return tag;
 }
 
 std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::CreateEntries(
@@ -271,13 +221,16 @@ bool CPVREpgTagsContainer::UpdateEntry(const std::shared_ptr<CPVREpgInfoTag>& ta
   tag->SetChannelData(m_channelData);
   tag->SetEpgID(m_iEpgID);
 
-  std::shared_ptr<CPVREpgInfoTag> existingTag = GetTag(tag->StartAsUTC());
+  LoadIndex();
+
+  std::shared_ptr<CPVREpgInfoTag> existingTag = m_timeIndex.GetTag(tag->StartAsUTC());
   if (existingTag)
   {
     if (existingTag->Update(*tag, false))
     {
       // tag differs from existing tag and must be persisted
       m_changedTags.insert({existingTag->StartAsUTC(), existingTag});
+      m_timeIndex.Insert(existingTag); // end time may have changed
       m_tagsCache->Reset();
     }
   }
@@ -285,6 +238,7 @@ bool CPVREpgTagsContainer::UpdateEntry(const std::shared_ptr<CPVREpgInfoTag>& ta
   {
     // new tags must always be persisted
     m_changedTags.insert({tag->StartAsUTC(), tag});
+    m_timeIndex.Insert(tag);
     m_tagsCache->Reset();
   }
 
@@ -295,6 +249,7 @@ bool CPVREpgTagsContainer::DeleteEntry(const std::shared_ptr<CPVREpgInfoTag>& ta
 {
   m_changedTags.erase(tag->StartAsUTC());
   m_deletedTags.insert({tag->StartAsUTC(), tag});
+  m_timeIndex.Erase(tag);
   m_tagsCache->Reset();
   return true;
 }
@@ -319,6 +274,8 @@ void CPVREpgTagsContainer::Cleanup(const CDateTime& time)
     }
   }
 
+  m_timeIndex.EraseEndedBefore(time);
+
   if (m_database)
     m_database->DeleteEpgTags(m_iEpgID, time);
 }
@@ -326,10 +283,17 @@ void CPVREpgTagsContainer::Cleanup(const CDateTime& time)
 void CPVREpgTagsContainer::Clear()
 {
   m_changedTags.clear();
+  m_timeIndex.Reset();
+  m_persistedStart.Reset();
+  m_persistedEnd.Reset();
 }
 
 bool CPVREpgTagsContainer::IsEmpty() const
 {
+  // do not load the index just to find out, the database answers this cheaply
+  if (m_timeIndex.IsLoaded())
+    return m_timeIndex.IsEmpty();
+
   if (!m_changedTags.empty())
     return false;
 
@@ -341,14 +305,8 @@ bool CPVREpgTagsContainer::IsEmpty() const
 
 std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetTag(const CDateTime& startTime) const
 {
-  const auto it = m_changedTags.find(startTime);
-  if (it != m_changedTags.cend())
-    return (*it).second;
-
-  if (m_database)
-    return CreateEntry(m_database->GetEpgTagByStartTime(m_iEpgID, startTime));
-
-  return {};
+  LoadIndex();
+  return m_timeIndex.GetTag(startTime);
 }
 
 std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetTag(unsigned int iUniqueBroadcastID) const
@@ -388,28 +346,15 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetTagByDatabaseID(int iDa
 std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetTagBetween(const CDateTime& start,
                                                                     const CDateTime& end) const
 {
-  for (const auto& tag : m_changedTags)
-  {
-    if (tag.second->StartAsUTC() >= start)
-    {
-      if (tag.second->EndAsUTC() <= end)
-        return tag.second;
-      else
-        break;
-    }
-  }
+  LoadIndex();
 
-  if (m_database)
+  const std::vector<std::shared_ptr<CPVREpgInfoTag>> tags = m_timeIndex.GetTagsBetween(start, end);
+  if (!tags.empty())
   {
-    const std::vector<std::shared_ptr<CPVREpgInfoTag>> tags =
-        CreateEntries(m_database->GetEpgTagsByMinStartMaxEndTime(m_iEpgID, start, end));
-    if (!tags.empty())
-    {
-      if (tags.size() > 1)
-        CLog::LogF(LOGWARNING, "Got multiple tags. Picking up the first.");
+    if (tags.size() > 1)
+      CLog::LogF(LOGWARNING, "Got multiple tags. Picking up the first.");
 
-      return tags.front();
-    }
+    return tags.front();
   }
 
   return {};
@@ -417,16 +362,21 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetTagBetween(const CDateT
 
 std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetActiveTag(bool bUpdateIfNeeded) const
 {
+  if (bUpdateIfNeeded)
+    LoadIndex();
+
   return m_tagsCache->GetNowActiveTag(bUpdateIfNeeded);
 }
 
 std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetLastEndedTag() const
 {
+  LoadIndex();
   return m_tagsCache->GetLastEndedTag();
 }
 
 std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetNextStartingTag() const
 {
+  LoadIndex();
   return m_tagsCache->GetNextStartingTag();
 }
 
@@ -442,139 +392,86 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetTimeline(
     const CDateTime& minEventEnd,
     const CDateTime& maxEventStart) const
 {
-  if (m_database)
-  {
-    std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  LoadIndex();
 
-    if (!m_changedTags.empty() && !m_database->GetFirstStartTime(m_iEpgID).IsValid())
-    {
-      // nothing in the db yet. take what we have in memory.
-      for (const auto& tag : m_changedTags)
-      {
-        if (tag.second->EndAsUTC() > minEventEnd && tag.second->StartAsUTC() < maxEventStart)
-          tags.emplace_back(tag.second);
-      }
+  const std::vector<std::shared_ptr<CPVREpgInfoTag>> tags =
+      m_timeIndex.GetTags(minEventEnd, maxEventStart);
 
-      if (!tags.empty())
-        FixOverlappingEvents(tags);
-    }
-    else
-    {
-      tags = m_database->GetEpgTagsByMinEndMaxStartTime(m_iEpgID, minEventEnd, maxEventStart);
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> result;
 
-      if (!m_changedTags.empty())
+  for (const auto& epgTag : tags)
+  {
+    if (!result.empty())
+    {
+      const CDateTime currStart = epgTag->StartAsUTC();
+      const CDateTime prevEnd = result.back()->EndAsUTC();
+      if ((currStart - prevEnd) >= ONE_SECOND)
       {
-        // Fix data inconsistencies
-        for (const auto& changedTagsEntry : m_changedTags)
-        {
-          const auto& changedTag = changedTagsEntry.second;
-
-          if (changedTag->EndAsUTC() > minEventEnd && changedTag->StartAsUTC() < maxEventStart)
-          {
-            // tag is in queried range, thus it could cause inconsistencies...
-            ResolveConflictingTags(changedTag, tags);
-          }
-        }
+        // insert gap tag before current tag
+        result.emplace_back(CreateGapTag(prevEnd, currStart));
       }
     }
 
-    tags = CreateEntries(tags);
-
-    std::vector<std::shared_ptr<CPVREpgInfoTag>> result;
+    result.emplace_back(epgTag);
+  }
 
-    for (const auto& epgTag : tags)
-    {
-      if (!result.empty())
-      {
-        const CDateTime currStart = epgTag->StartAsUTC();
-        const CDateTime prevEnd = result.back()->EndAsUTC();
-        if ((currStart - prevEnd) >= ONE_SECOND)
-        {
-          // insert gap tag before current tag
-          result.emplace_back(CreateGapTag(prevEnd, currStart));
-        }
-      }
+  if (result.empty())
+  {
+    // create single gap tag
+    CDateTime maxEnd = m_timeIndex.GetMaxEndTime(minEventEnd);
+    if (!maxEnd.IsValid() || maxEnd < timelineStart)
+      maxEnd = timelineStart;
 
-      result.emplace_back(epgTag);
-    }
+    CDateTime minStart = m_timeIndex.GetMinStartTime(maxEventStart);
+    if (!minStart.IsValid() || minStart > timelineEnd)
+      minStart = timelineEnd;
 
-    if (result.empty())
+    result.emplace_back(CreateGapTag(maxEnd, minStart));
+  }
+  else
+  {
+    if (result.front()->StartAsUTC() > minEventEnd)
     {
-      // create single gap tag
-      CDateTime maxEnd = m_database->GetMaxEndTime(m_iEpgID, minEventEnd);
+      // prepend gap tag
+      CDateTime maxEnd = m_timeIndex.GetMaxEndTime(minEventEnd);
       if (!maxEnd.IsValid() || maxEnd < timelineStart)
         maxEnd = timelineStart;
 
-      CDateTime minStart = m_database->GetMinStartTime(m_iEpgID, maxEventStart);
-      if (!minStart.IsValid() || minStart > timelineEnd)
-        minStart = timelineEnd;
-
-      result.emplace_back(CreateGapTag(maxEnd, minStart));
+      result.insert(result.begin(), CreateGapTag(maxEnd, result.front()->StartAsUTC()));
     }
-    else
-    {
-      if (result.front()->StartAsUTC() > minEventEnd)
-      {
-        // prepend gap tag
-        CDateTime maxEnd = m_database->GetMaxEndTime(m_iEpgID, minEventEnd);
-        if (!maxEnd.IsValid() || maxEnd < timelineStart)
-          maxEnd = timelineStart;
 
-        result.insert(result.begin(), CreateGapTag(maxEnd, result.front()->StartAsUTC()));
-      }
-
-      if (result.back()->EndAsUTC() < maxEventStart)
-      {
-        // append gap tag
-        CDateTime minStart = m_database->GetMinStartTime(m_iEpgID, maxEventStart);
-        if (!minStart.IsValid() || minStart > timelineEnd)
-          minStart = timelineEnd;
+    if (result.back()->EndAsUTC() < maxEventStart)
+    {
+      // append gap tag
+      CDateTime minStart = m_timeIndex.GetMinStartTime(maxEventStart);
+      if (!minStart.IsValid() || minStart > timelineEnd)
+        minStart = timelineEnd;
 
-        result.emplace_back(CreateGapTag(result.back()->EndAsUTC(), minStart));
-      }
+      result.emplace_back(CreateGapTag(result.back()->EndAsUTC(), minStart));
     }
-
-    return result;
   }
 
-  return {};
+  return result;
 }
 
 std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetAllTags() const
 {
-  if (m_database)
-  {
-    std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
-    if (!m_changedTags.empty() && !m_database->GetFirstStartTime(m_iEpgID).IsValid())
-    {
-      // nothing in the db yet. take what we have in memory.
-      for (const auto& tag : m_changedTags)
-        tags.emplace_back(tag.second);
-
-      FixOverlappingEvents(tags);
-    }
-    else
-    {
-      tags = m_database->GetAllEpgTags(m_iEpgID);
-
-      if (!m_changedTags.empty())
-      {
-        // Fix data inconsistencies
-        for (const auto& changedTagsEntry : m_changedTags)
-        {
-          ResolveConflictingTags(changedTagsEntry.second, tags);
-        }
-      }
-    }
-
-    return CreateEntries(tags);
-  }
+  LoadIndex();
+  return m_timeIndex.GetAllTags();
+}
 
-  return {};
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetTags(
+    const CDateTime& minEnd, const CDateTime& maxStart) const
+{
+  LoadIndex();
+  return m_timeIndex.GetTags(minEnd, maxStart);
 }
 
 CDateTime CPVREpgTagsContainer::GetFirstStartTime() const
 {
+  if (m_timeIndex.IsLoaded())
+    return m_timeIndex.GetFirstStartTime();
+
   CDateTime result;
 
   if (!m_changedTags.empty())
@@ -592,6 +489,9 @@ CDateTime CPVREpgTagsContainer::GetFirstStartTime() const
 
 CDateTime CPVREpgTagsContainer::GetLastEndTime() const
 {
+  if (m_timeIndex.IsLoaded())
+    return m_timeIndex.GetLastEndTime();
+
   CDateTime result;
 
   if (!m_changedTags.empty())
@@ -628,13 +528,40 @@ void CPVREpgTagsContainer::QueuePersistQuery()
 
     FixOverlappingEvents(m_changedTags);
 
+    // remove any conflicting events from database before persisting the new events. the changed
+    // events do not overlap, so one delete covers a run of adjacent events.
+    CDateTime runStart;
+    CDateTime runEnd;
     for (const auto& tag : m_changedTags)
     {
-      // remove any conflicting events from database before persisting the new event
-      m_database->QueueDeleteEpgTagsByMinEndMaxStartTimeQuery(
-          m_iEpgID, tag.second->StartAsUTC() + ONE_SECOND, tag.second->EndAsUTC() - ONE_SECOND);
+      if (runEnd.IsValid() && tag.second->StartAsUTC() != runEnd)
+      {
+        m_database->QueueDeleteEpgTagsByMinEndMaxStartTimeQuery(m_iEpgID, runStart + ONE_SECOND,
+                                                                runEnd - ONE_SECOND);
+        runEnd.Reset();
+      }
+
+      if (!runEnd.IsValid())
+        runStart = tag.second->StartAsUTC();
+      runEnd = tag.second->EndAsUTC();
+    }
+
+    if (runEnd.IsValid())
+      m_database->QueueDeleteEpgTagsByMinEndMaxStartTimeQuery(m_iEpgID, runStart + ONE_SECOND,
+                                                              runEnd - ONE_SECOND);
 
+    for (const auto& tag : m_changedTags)
+    {
       tag.second->QueuePersistQuery(m_database);
+
+      // new tags get their database ids once needed again, the index stays loaded
+      if (m_timeIndex.IsLoaded() && tag.second->DatabaseID() <= 0)
+      {
+        if (!m_persistedStart.IsValid() || tag.second->StartAsUTC() < m_persistedStart)
+          m_persistedStart = tag.second->StartAsUTC();
+        if (!m_persistedEnd.IsValid() || tag.second->EndAsUTC() > m_persistedEnd)
+          m_persistedEnd = tag.second->EndAsUTC();
+      }
     }
 
     m_changedTags.clear();
@@ -649,4 +576,5 @@ void CPVREpgTagsContainer::QueueDelete()
     m_database->QueueDeleteEpgTags(m_iEpgID);
 
   Clear();
+  m_timeIndex.Clear();
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "XBDateTime.h"
+#include "pvr/epg/EpgTimeIndex.h"
 
 #include <map>
 #include <memory>
@@ -42,6 +43,18 @@ public:
    */
   void SetChannelData(const std::shared_ptr<CPVREpgChannelData>& data);
 
+  /*!
+   * @brief Keep the given guide index up to date with the events of this container.
+   * @param guideIndex The guide index, nullptr to stop updating the current one.
+   */
+  void SetGuideIndex(const std::shared_ptr<CPVREpgGuideIndex>& guideIndex);
+
+  /*!
+   * @brief Fill the time index with the events from the database and the changed events, if not
+   * yet done. Also fetches the database ids of the events persisted since the last use.
+   */
+  void LoadIndex() const;
+
   /*!
    * @brief Update an entry.
    * @param tag The tag to update.
@@ -147,6 +160,15 @@ public:
    */
   std::vector<std::shared_ptr<CPVREpgInfoTag>> GetAllTags() const;
 
+  /*!
+   * @brief Get the EPG tags ending at or after minEnd and starting at or before maxStart.
+   * @param minEnd The minimum end time.
+   * @param maxStart The maximum start time.
+   * @return The tags, ordered by start time.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags(const CDateTime& minEnd,
+                                                       const CDateTime& maxStart) const;
+
   /*!
    * @brief Get the start time of the first tag in this EPG.
    * @return The time.
@@ -176,6 +198,12 @@ public:
   void QueueDelete();
 
 private:
+  /*!
+   * @brief Replace the events persisted without a database id by the database events, once the
+   * queued queries were committed.
+   */
+  void LoadPersistedTags() const;
+
   /*!
    * @brief Complete the instance data for the given tags.
    * @param tags The tags to complete.
@@ -203,7 +231,6 @@ private:
    * @brief Fix overlapping events.
    * @param tags The events to check/fix.
    */
-  void FixOverlappingEvents(std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags) const;
   void FixOverlappingEvents(std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>>& tags) const;
 
   int m_iEpgID = 0;
@@ -213,6 +240,13 @@ private:
 
   std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>> m_changedTags;
   std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>> m_deletedTags;
+
+  // merged view of database and changed tags, loaded on first use, answers all time range lookups
+  mutable CPVREpgTimeIndex m_timeIndex;
+
+  // time range of the new events persisted since the database ids were last fetched
+  mutable CDateTime m_persistedStart;
+  mutable CDateTime m_persistedEnd;
 };
 
 } // namespace PVR
@@ -0,0 +1,380 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "EpgTimeIndex.h"
+
+#include "XBDateTime.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace PVR;
+
+namespace
+{
+
+time_t ToTime(const CDateTime& dateTime)
+{
+  time_t time;
+  dateTime.GetAsTime(time);
+  return time;
+}
+
+time_t Start(const std::shared_ptr<CPVREpgInfoTag>& tag)
+{
+  return ToTime(tag->StartAsUTC());
+}
+
+time_t End(const std::shared_ptr<CPVREpgInfoTag>& tag)
+{
+  return ToTime(tag->EndAsUTC());
+}
+
+} // unnamed namespace
+
+void CPVREpgGuideIndex::Insert(int iEpgID,
+                               time_t start,
+                               time_t duration,
+                               const std::shared_ptr<CPVREpgInfoTag>& tag)
+{
+  CSingleLock lock(m_critSection);
+
+  const auto result = m_tags.insert({{start, iEpgID}, {tag, duration}});
+  if (!result.second)
+  {
+    m_durations.erase(m_durations.find(result.first->second.duration));
+    result.first->second = {tag, duration};
+  }
+  m_durations.insert(duration);
+}
+
+void CPVREpgGuideIndex::Erase(int iEpgID, time_t start, const std::shared_ptr<CPVREpgInfoTag>& tag)
+{
+  CSingleLock lock(m_critSection);
+
+  const auto it = m_tags.find({start, iEpgID});
+  if (it != m_tags.end() && it->second.tag == tag)
+  {
+    m_durations.erase(m_durations.find(it->second.duration));
+    m_tags.erase(it);
+  }
+}
+
+size_t CPVREpgGuideIndex::Size() const
+{
+  CSingleLock lock(m_critSection);
+  return m_tags.size();
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgGuideIndex::GetTags(
+    const CDateTime& minEnd, const CDateTime& maxStart) const
+{
+  const time_t minEndTime = ToTime(minEnd);
+  const time_t maxStartTime = ToTime(maxStart);
+
+  CSingleLock lock(m_critSection);
+
+  const time_t maxDuration = m_durations.empty() ? 0 : *m_durations.rbegin();
+
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  for (auto it = m_tags.lower_bound({minEndTime - maxDuration, std::numeric_limits<int>::min()});
+       it != m_tags.end() && it->first.first <= maxStartTime; ++it)
+  {
+    if (End(it->second.tag) >= minEndTime)
+      tags.emplace_back(it->second.tag);
+  }
+  return tags;
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgGuideIndex::GetActiveTags(
+    const CDateTime& time) const
+{
+  const time_t t = ToTime(time);
+
+  CSingleLock lock(m_critSection);
+
+  const time_t maxDuration = m_durations.empty() ? 0 : *m_durations.rbegin();
+
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  for (auto it = m_tags.lower_bound({t + 1 - maxDuration, std::numeric_limits<int>::min()});
+       it != m_tags.end() && it->first.first <= t; ++it)
+  {
+    if (End(it->second.tag) > t)
+      tags.emplace_back(it->second.tag);
+  }
+  return tags;
+}
+
+CPVREpgTimeIndex::~CPVREpgTimeIndex()
+{
+  if (m_guideIndex)
+    EraseAll();
+}
+
+void CPVREpgTimeIndex::SetGuideIndex(const std::shared_ptr<CPVREpgGuideIndex>& guideIndex,
+                                     int iEpgID)
+{
+  if (m_guideIndex)
+  {
+    for (const auto& tag : m_tags)
+      m_guideIndex->Erase(m_iEpgID, tag.first, tag.second.tag);
+  }
+
+  m_guideIndex = guideIndex;
+  m_iEpgID = iEpgID;
+
+  if (m_guideIndex)
+  {
+    for (const auto& tag : m_tags)
+      m_guideIndex->Insert(m_iEpgID, tag.first, tag.second.duration, tag.second.tag);
+  }
+}
+
+void CPVREpgTimeIndex::Load(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags)
+{
+  Clear();
+
+  for (const auto& tag : tags)
+    Insert(tag);
+}
+
+void CPVREpgTimeIndex::Reset()
+{
+  EraseAll();
+  m_bLoaded = false;
+}
+
+void CPVREpgTimeIndex::Clear()
+{
+  EraseAll();
+  m_bLoaded = true;
+}
+
+CPVREpgTimeIndex::Tags::iterator CPVREpgTimeIndex::EraseEntry(Tags::iterator it)
+{
+  if (m_guideIndex)
+    m_guideIndex->Erase(m_iEpgID, it->first, it->second.tag);
+
+  m_durations.erase(m_durations.find(it->second.duration));
+  return m_tags.erase(it);
+}
+
+void CPVREpgTimeIndex::EraseAll()
+{
+  if (m_guideIndex)
+  {
+    for (const auto& tag : m_tags)
+      m_guideIndex->Erase(m_iEpgID, tag.first, tag.second.tag);
+  }
+
+  m_tags.clear();
+  m_durations.clear();
+}
+
+void CPVREpgTimeIndex::Insert(const std::shared_ptr<CPVREpgInfoTag>& tag)
+{
+  const time_t start = Start(tag);
+  const time_t end = End(tag);
+
+  for (auto it = m_tags.lower_bound(start - MaxDuration());
+       it != m_tags.end() && (it->first < end || it->first == start);)
+  {
+    if (it->first == start || End(it->second.tag) > start)
+      it = EraseEntry(it);
+    else
+      ++it;
+  }
+
+  m_tags.insert({start, {tag, end - start}});
+  m_durations.insert(end - start);
+
+  if (m_guideIndex)
+    m_guideIndex->Insert(m_iEpgID, start, end - start, tag);
+}
+
+void CPVREpgTimeIndex::Erase(const std::shared_ptr<CPVREpgInfoTag>& tag)
+{
+  const auto it = m_tags.find(Start(tag));
+  if (it != m_tags.end())
+    EraseEntry(it);
+}
+
+void CPVREpgTimeIndex::EraseEndedBefore(const CDateTime& time)
+{
+  const time_t t = ToTime(time);
+
+  for (auto it = m_tags.begin(); it != m_tags.end() && it->first < t;)
+  {
+    if (End(it->second.tag) < t)
+      it = EraseEntry(it);
+    else
+      ++it;
+  }
+}
+
+std::shared_ptr<CPVREpgInfoTag> CPVREpgTimeIndex::GetTag(const CDateTime& start) const
+{
+  const auto it = m_tags.find(ToTime(start));
+  if (it != m_tags.end())
+    return it->second.tag;
+
+  return {};
+}
+
+CPVREpgTimeIndex::Tags::const_iterator CPVREpgTimeIndex::FirstEndingAtOrAfter(time_t minEnd) const
+{
+  // no event starting before this can end at or after minEnd
+  auto it = m_tags.lower_bound(minEnd - MaxDuration());
+  while (it != m_tags.end() && it->first < minEnd && End(it->second.tag) < minEnd)
+    ++it;
+
+  return it;
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTimeIndex::GetTags(
+    const CDateTime& minEnd, const CDateTime& maxStart) const
+{
+  const time_t minEndTime = ToTime(minEnd);
+  const time_t maxStartTime = ToTime(maxStart);
+
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  for (auto it = FirstEndingAtOrAfter(minEndTime); it != m_tags.end() && it->first <= maxStartTime;
+       ++it)
+  {
+    if (End(it->second.tag) >= minEndTime)
+      tags.emplace_back(it->second.tag);
+  }
+  return tags;
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTimeIndex::GetTagsBetween(
+    const CDateTime& minStart, const CDateTime& maxEnd) const
+{
+  const time_t maxEndTime = ToTime(maxEnd);
+
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  for (auto it = m_tags.lower_bound(ToTime(minStart));
+       it != m_tags.end() && it->first <= maxEndTime; ++it)
+  {
+    if (End(it->second.tag) <= maxEndTime)
+      tags.emplace_back(it->second.tag);
+  }
+  return tags;
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTimeIndex::GetAllTags() const
+{
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  tags.reserve(m_tags.size());
+  for (const auto& tag : m_tags)
+    tags.emplace_back(tag.second.tag);
+  return tags;
+}
+
+std::shared_ptr<CPVREpgInfoTag> CPVREpgTimeIndex::GetActiveTag(const CDateTime& time) const
+{
+  const time_t t = ToTime(time);
+
+  for (auto it = FirstEndingAtOrAfter(t + 1); it != m_tags.end() && it->first <= t; ++it)
+  {
+    if (End(it->second.tag) > t)
+      return it->second.tag;
+  }
+  return {};
+}
+
+std::shared_ptr<CPVREpgInfoTag> CPVREpgTimeIndex::GetNextStartingTag(
+    const CDateTime& minStart) const
+{
+  const auto it = m_tags.lower_bound(ToTime(minStart));
+  if (it != m_tags.end())
+    return it->second.tag;
+
+  return {};
+}
+
+std::shared_ptr<CPVREpgInfoTag> CPVREpgTimeIndex::GetLastEndedTag(const CDateTime& maxEnd) const
+{
+  const time_t t = ToTime(maxEnd);
+
+  // events ending at or before t started at or before t, only those overlapping t are skipped
+  for (auto it = std::make_reverse_iterator(m_tags.upper_bound(t)); it != m_tags.rend(); ++it)
+  {
+    if (End(it->second.tag) <= t)
+      return it->second.tag;
+  }
+  return {};
+}
+
+CDateTime CPVREpgTimeIndex::GetMinStartTime(const CDateTime& minStart) const
+{
+  const auto it = m_tags.upper_bound(ToTime(minStart));
+  if (it != m_tags.end())
+    return CDateTime(it->first);
+
+  return {};
+}
+
+CDateTime CPVREpgTimeIndex::GetMaxEndTime(const CDateTime& maxEnd) const
+{
+  const time_t t = ToTime(maxEnd);
+
+  bool bFound = false;
+  time_t maxEndTime = 0;
+  for (auto it = std::make_reverse_iterator(m_tags.upper_bound(t)); it != m_tags.rend(); ++it)
+  {
+    // no earlier event can end after the latest end found
+    if (bFound && it->first + MaxDuration() <= maxEndTime)
+      break;
+
+    const time_t end = End(it->second.tag);
+    if (end <= t && (!bFound || end > maxEndTime))
+    {
+      maxEndTime = end;
+      bFound = true;
+    }
+  }
+
+  if (bFound)
+    return CDateTime(maxEndTime);
+
+  return {};
+}
+
+CDateTime CPVREpgTimeIndex::GetFirstStartTime() const
+{
+  if (!m_tags.empty())
+    return CDateTime(m_tags.begin()->first);
+
+  return {};
+}
+
+CDateTime CPVREpgTimeIndex::GetLastEndTime() const
+{
+  bool bFound = false;
+  time_t maxEndTime = 0;
+  for (auto it = m_tags.rbegin(); it != m_tags.rend(); ++it)
+  {
+    if (bFound && it->first + MaxDuration() <= maxEndTime)
+      break;
+
+    const time_t end = End(it->second.tag);
+    if (!bFound || end > maxEndTime)
+    {
+      maxEndTime = end;
+      bFound = true;
+    }
+  }
+
+  if (bFound)
+    return CDateTime(maxEndTime);
+
+  return {};
+}
@@ -0,0 +1,255 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+class CDateTime;
+
+namespace PVR
+{
+class CPVREpgInfoTag;
+
+/*!
+ * @brief In-memory time index of the events of all EPGs of the EPG container. The time indexes of
+ * the EPGs keep it up to date, so it contains the events of all EPGs with a loaded time index.
+ *
+ * Events are ordered by start time and EPG. Time range lookups start at the first event that can
+ * overlap the range, found from the longest event duration, so they take O(log n + k).
+ */
+class CPVREpgGuideIndex
+{
+public:
+  /*!
+   * @brief Add an event of an EPG, replacing the event of the EPG with the same start time.
+   * @param iEpgID The id of the EPG.
+   * @param start The start time of the event.
+   * @param duration The duration of the event.
+   * @param tag The event.
+   */
+  void Insert(int iEpgID, time_t start, time_t duration, const std::shared_ptr<CPVREpgInfoTag>& tag);
+
+  /*!
+   * @brief Remove an event of an EPG.
+   * @param iEpgID The id of the EPG.
+   * @param start The start time of the event.
+   * @param tag The event, another event of the EPG with the same start time is kept.
+   */
+  void Erase(int iEpgID, time_t start, const std::shared_ptr<CPVREpgInfoTag>& tag);
+
+  size_t Size() const;
+
+  /*!
+   * @brief Get the events of all EPGs ending at or after minEnd and starting at or before maxStart.
+   * @param minEnd The minimum end time.
+   * @param maxStart The maximum start time.
+   * @return The events, ordered by start time.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags(const CDateTime& minEnd,
+                                                       const CDateTime& maxStart) const;
+
+  /*!
+   * @brief Get the events of all EPGs active at the given time.
+   * @param time The time.
+   * @return The events, ordered by start time.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetActiveTags(const CDateTime& time) const;
+
+private:
+  struct Entry
+  {
+    std::shared_ptr<CPVREpgInfoTag> tag;
+    time_t duration;
+  };
+
+  mutable CCriticalSection m_critSection;
+  std::map<std::pair<time_t, int>, Entry> m_tags; // by start time and epg id
+  std::multiset<time_t> m_durations; // of all events, the last one is the longest
+};
+
+/*!
+ * @brief In-memory time index of the events of an EPG, the merged view of the events in the
+ * database and the changed events not yet persisted.
+ *
+ * Events are ordered by start time. Time range lookups start at the first event that can
+ * overlap the range, found from the longest event duration, so they take O(log n + k).
+ */
+class CPVREpgTimeIndex
+{
+public:
+  CPVREpgTimeIndex() = default;
+  ~CPVREpgTimeIndex();
+
+  CPVREpgTimeIndex(const CPVREpgTimeIndex&) = delete;
+  CPVREpgTimeIndex& operator=(const CPVREpgTimeIndex&) = delete;
+
+  /*!
+   * @brief Keep the given guide index up to date with the events of this index.
+   * @param guideIndex The guide index, nullptr to stop updating the current one.
+   * @param iEpgID The id of the EPG of this index.
+   */
+  void SetGuideIndex(const std::shared_ptr<CPVREpgGuideIndex>& guideIndex, int iEpgID);
+
+  /*!
+   * @brief Change the EPG id the events of this index are stored with in the guide index.
+   * @param iEpgID The id of the EPG of this index.
+   */
+  void SetEpgID(int iEpgID) { SetGuideIndex(m_guideIndex, iEpgID); }
+
+  /*!
+   * @brief Check whether the index was filled with the events of the EPG.
+   * @return True if loaded, false otherwise.
+   */
+  bool IsLoaded() const { return m_bLoaded; }
+
+  /*!
+   * @brief Replace the contents of the index.
+   * @param tags The events, may overlap. Later events replace the events they overlap.
+   */
+  void Load(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags);
+
+  /*!
+   * @brief Drop the contents of the index, it has to be loaded again before it can be used.
+   */
+  void Reset();
+
+  /*!
+   * @brief Drop the contents of the index, it stays loaded with no events.
+   */
+  void Clear();
+
+  /*!
+   * @brief Add an event, replacing the event with the same start time and the events it overlaps.
+   * @param tag The event.
+   */
+  void Insert(const std::shared_ptr<CPVREpgInfoTag>& tag);
+
+  /*!
+   * @brief Remove an event.
+   * @param tag The event.
+   */
+  void Erase(const std::shared_ptr<CPVREpgInfoTag>& tag);
+
+  /*!
+   * @brief Remove the events that ended before the given time.
+   * @param time The time.
+   */
+  void EraseEndedBefore(const CDateTime& time);
+
+  bool IsEmpty() const { return m_tags.empty(); }
+  size_t Size() const { return m_tags.size(); }
+
+  /*!
+   * @brief Get the duration of the longest event, lookups by end time start this far before.
+   * @return The duration, 0 if empty.
+   */
+  time_t MaxDuration() const { return m_durations.empty() ? 0 : *m_durations.rbegin(); }
+
+  /*!
+   * @brief Get the event starting at the given time.
+   * @param start The start time.
+   * @return The event or nullptr, if not found.
+   */
+  std::shared_ptr<CPVREpgInfoTag> GetTag(const CDateTime& start) const;
+
+  /*!
+   * @brief Get the events ending at or after minEnd and starting at or before maxStart.
+   * @param minEnd The minimum end time.
+   * @param maxStart The maximum start time.
+   * @return The events, ordered by start time.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTags(const CDateTime& minEnd,
+                                                       const CDateTime& maxStart) const;
+
+  /*!
+   * @brief Get the events starting at or after minStart and ending at or before maxEnd.
+   * @param minStart The minimum start time.
+   * @param maxEnd The maximum end time.
+   * @return The events, ordered by start time.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTagsBetween(const CDateTime& minStart,
+                                                              const CDateTime& maxEnd) const;
+
+  /*!
+   * @brief Get all events.
+   * @return The events, ordered by start time.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetAllTags() const;
+
+  /*!
+   * @brief Get the event active at the given time.
+   * @param time The time.
+   * @return The event or nullptr, if there is a gap at the given time.
+   */
+  std::shared_ptr<CPVREpgInfoTag> GetActiveTag(const CDateTime& time) const;
+
+  /*!
+   * @brief Get the first event starting at or after the given time.
+   * @param minStart The minimum start time.
+   * @return The event or nullptr, if not found.
+   */
+  std::shared_ptr<CPVREpgInfoTag> GetNextStartingTag(const CDateTime& minStart) const;
+
+  /*!
+   * @brief Get the last started event that ended at or before the given time.
+   * @param maxEnd The maximum end time.
+   * @return The event or nullptr, if not found.
+   */
+  std::shared_ptr<CPVREpgInfoTag> GetLastEndedTag(const CDateTime& maxEnd) const;
+
+  /*!
+   * @brief Get the earliest start time after the given time.
+   * @param minStart The time.
+   * @return The start time, invalid if there is no event starting after the given time.
+   */
+  CDateTime GetMinStartTime(const CDateTime& minStart) const;
+
+  /*!
+   * @brief Get the latest end time at or before the given time.
+   * @param maxEnd The time.
+   * @return The end time, invalid if there is no event ending at or before the given time.
+   */
+  CDateTime GetMaxEndTime(const CDateTime& maxEnd) const;
+
+  CDateTime GetFirstStartTime() const;
+  CDateTime GetLastEndTime() const;
+
+private:
+  struct Entry
+  {
+    std::shared_ptr<CPVREpgInfoTag> tag;
+    time_t duration; // at insertion, the end time of the tag may be changed in place later
+  };
+
+  using Tags = std::map<time_t, Entry>;
+
+  /*!
+   * @brief Get the first event that can end at or after the given time.
+   */
+  Tags::const_iterator FirstEndingAtOrAfter(time_t minEnd) const;
+
+  Tags::iterator EraseEntry(Tags::iterator it);
+  void EraseAll();
+
+  Tags m_tags; // by start time
+  std::multiset<time_t> m_durations; // of all events, the last one is the longest
+  bool m_bLoaded = false;
+
+  std::shared_ptr<CPVREpgGuideIndex> m_guideIndex;
+  int m_iEpgID = -1;
+};
+
+} // namespace PVR
@@ -0,0 +1,370 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "XBDateTime.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_epg.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "pvr/epg/EpgChannelData.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/epg/EpgSearchData.h"
+#include "pvr/epg/EpgTagsContainer.h"
+#include "settings/AdvancedSettings.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+const time_t GUIDE_START = 1614556800;
+
+/*!
+ * @brief Stand-in for a PVR client, serves a synthetic guide with events of 30 to 90 minutes.
+ */
+class CSyntheticGuide
+{
+public:
+  CSyntheticGuide(const std::string& strTitlePrefix, time_t offset = 0)
+    : m_strTitlePrefix(strTitlePrefix), m_offset(offset)
+  {
+  }
+
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetEPGForChannel(
+      int iChannel, const std::shared_ptr<CPVREpgChannelData>& channelData, time_t end) const
+  {
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+    unsigned int iEvent = iChannel;
+    for (time_t start = GUIDE_START + m_offset; start < end; iEvent++)
+    {
+      const std::string strTitle = m_strTitlePrefix + std::to_string(iEvent % 40);
+      const std::string strPlot =
+          "Plot of episode " + std::to_string(iEvent) + ", it's 100% synthetic";
+
+      EPG_TAG data = {};
+      data.iUniqueBroadcastId = iEvent;
+      data.iUniqueChannelId = iChannel;
+      data.strTitle = strTitle.c_str();
+      data.startTime = start;
+      data.endTime = start + (iEvent % 3 + 1) * 30 * 60;
+      data.strPlot = strPlot.c_str();
+      data.iGenreType = EPG_EVENT_CONTENTMASK_MOVIEDRAMA;
+      data.iEpisodeNumber = iEvent;
+      data.iEpisodePartNumber = -1;
+
+      tags.emplace_back(std::make_shared<CPVREpgInfoTag>(data, 1, channelData, iChannel));
+      start = data.endTime;
+    }
+    return tags;
+  }
+
+private:
+  const std::string m_strTitlePrefix;
+  const time_t m_offset;
+};
+} // unnamed namespace
+
+class TestEpgDatabase : public ::testing::Test
+{
+protected:
+  DatabaseSettings settings;
+  std::shared_ptr<CPVREpgDatabase> database = std::make_shared<CPVREpgDatabase>();
+
+  void SetUp() override
+  {
+    settings.type = "sqlite3";
+    settings.name = "TestEpg";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+    XFILE::CFile::Delete(settings.host + settings.name + ".db");
+    ASSERT_TRUE(database->Connect(settings.name, settings, true));
+  }
+
+  void TearDown() override
+  {
+    database->Close();
+    XFILE::CFile::Delete(settings.host + settings.name + ".db");
+  }
+
+  /*!
+   * @brief Fetch the guide of the given channels and persist it the way the EPG container does.
+   * @return The number of events persisted.
+   */
+  size_t ImportGuide(const CSyntheticGuide& guide, int iChannels, int iDays)
+  {
+    size_t iTags = 0;
+    for (int iChannel = 1; iChannel <= iChannels; iChannel++)
+    {
+      const auto channelData = std::make_shared<CPVREpgChannelData>(1, iChannel);
+      CPVREpgTagsContainer tags(iChannel, channelData, database);
+
+      for (const auto& tag : guide.GetEPGForChannel(iChannel, channelData,
+                                                    GUIDE_START + iDays * 24 * 60 * 60))
+      {
+        tags.UpdateEntry(tag);
+        iTags++;
+      }
+
+      database->Lock();
+      tags.QueuePersistQuery();
+      EXPECT_TRUE(database->CommitQueuedChanges());
+      database->Unlock();
+    }
+    return iTags;
+  }
+};
+
+TEST_F(TestEpgDatabase, PersistGuide)
+{
+  const size_t iTags = ImportGuide(CSyntheticGuide("Show "), 10, 2);
+
+  size_t iPersisted = 0;
+  for (int iChannel = 1; iChannel <= 10; iChannel++)
+  {
+    const auto tags = database->GetAllEpgTags(iChannel);
+    ASSERT_FALSE(tags.empty());
+    EXPECT_EQ(CDateTime(GUIDE_START), tags.front()->StartAsUTC());
+    EXPECT_EQ("Show " + std::to_string(iChannel), tags.front()->Title());
+    iPersisted += tags.size();
+  }
+  EXPECT_EQ(iTags, iPersisted);
+}
+
+TEST_F(TestEpgDatabase, ReplaceEvents)
+{
+  const size_t iTags = ImportGuide(CSyntheticGuide("Show "), 3, 1);
+
+  // a guide shifted by 15 minutes overlaps every persisted event, they are all deleted
+  const size_t iUpdatedTags = ImportGuide(CSyntheticGuide("Updated show ", 15 * 60), 3, 1);
+
+  size_t iPersisted = 0;
+  for (int iChannel = 1; iChannel <= 3; iChannel++)
+  {
+    for (const auto& tag : database->GetAllEpgTags(iChannel))
+    {
+      EXPECT_EQ(0u, tag->Title().find("Updated show "));
+      iPersisted++;
+    }
+  }
+  EXPECT_NE(0u, iTags);
+  EXPECT_EQ(iUpdatedTags, iPersisted);
+
+  // an event replacing several persisted events deletes them
+  const auto channelData = std::make_shared<CPVREpgChannelData>(1, 1);
+  EPG_TAG data = {};
+  data.iUniqueBroadcastId = 1000;
+  data.iUniqueChannelId = 1;
+  data.strTitle = "Movie";
+  data.startTime = GUIDE_START + 10 * 60;
+  data.endTime = GUIDE_START + 4 * 60 * 60;
+  data.iEpisodePartNumber = -1;
+
+  CPVREpgTagsContainer tags(1, channelData, database);
+  tags.UpdateEntry(std::make_shared<CPVREpgInfoTag>(data, 1, channelData, 1));
+  database->Lock();
+  tags.QueuePersistQuery();
+  EXPECT_TRUE(database->CommitQueuedChanges());
+  database->Unlock();
+
+  const auto persisted = database->GetEpgTagsByMinEndMaxStartTime(
+      1, CDateTime(data.startTime + 1), CDateTime(data.endTime - 1));
+  ASSERT_EQ(1u, persisted.size());
+  EXPECT_EQ("Movie", persisted.front()->Title());
+}
+
+TEST_F(TestEpgDatabase, PersistKeepsTheTimeIndex)
+{
+  const auto guideIndex = std::make_shared<CPVREpgGuideIndex>();
+  const CSyntheticGuide guide("Show ");
+
+  std::vector<std::unique_ptr<CPVREpgTagsContainer>> channels;
+  size_t iTags = 0;
+  for (int iChannel = 1; iChannel <= 3; iChannel++)
+  {
+    const auto channelData = std::make_shared<CPVREpgChannelData>(1, iChannel);
+    auto tags = std::make_unique<CPVREpgTagsContainer>(iChannel, channelData, database);
+    tags->SetGuideIndex(guideIndex);
+
+    for (const auto& tag :
+         guide.GetEPGForChannel(iChannel, channelData, GUIDE_START + 24 * 60 * 60))
+    {
+      tags->UpdateEntry(tag);
+      iTags++;
+    }
+
+    database->Lock();
+    tags->QueuePersistQuery();
+    EXPECT_TRUE(database->CommitQueuedChanges());
+    database->Unlock();
+
+    channels.emplace_back(std::move(tags));
+  }
+
+  // persisting does not drop the events from the index
+  EXPECT_EQ(iTags, guideIndex->Size());
+  EXPECT_EQ(3u, guideIndex->GetActiveTags(CDateTime(GUIDE_START + 60)).size());
+
+  // the new events get their database ids on next use
+  for (const auto& tags : channels)
+  {
+    for (const auto& tag : tags->GetAllTags())
+      EXPECT_LT(0, tag->DatabaseID());
+  }
+  EXPECT_EQ(iTags, guideIndex->Size());
+
+  channels.clear();
+  EXPECT_EQ(0u, guideIndex->Size());
+}
+
+TEST_F(TestEpgDatabase, UpdateComparesStoredPlotAndCast)
+{
+  ImportGuide(CSyntheticGuide("Show "), 1, 1);
+
+  const auto channelData = std::make_shared<CPVREpgChannelData>(1, 1);
+  const auto fetched = CSyntheticGuide("Show ").GetEPGForChannel(1, channelData,
+                                                                  GUIDE_START + 24 * 60 * 60);
+  const auto persisted = database->GetAllEpgTags(1);
+  ASSERT_EQ(fetched.size(), persisted.size());
+
+  // there is no EPG container to load plot and cast of persisted tags from in the tests, they
+  // must be compared by their stored hash
+  for (size_t i = 0; i < persisted.size(); i++)
+  {
+    persisted[i]->SetChannelData(channelData);
+    EXPECT_FALSE(persisted[i]->Update(*fetched[i], false));
+  }
+
+  // the first event of the guide with another plot
+  EPG_TAG data = {};
+  data.iUniqueBroadcastId = 1;
+  data.iUniqueChannelId = 1;
+  data.strTitle = "Show 1";
+  data.startTime = GUIDE_START;
+  data.endTime = GUIDE_START + 60 * 60;
+  data.strPlot = "Changed plot";
+  data.iGenreType = EPG_EVENT_CONTENTMASK_MOVIEDRAMA;
+  data.iEpisodeNumber = 1;
+  data.iEpisodePartNumber = -1;
+
+  const auto changed = std::make_shared<CPVREpgInfoTag>(data, 1, channelData, 1);
+  EXPECT_TRUE(persisted.front()->Update(*changed, false));
+  EXPECT_EQ("Changed plot", persisted.front()->Plot());
+}
+
+TEST_F(TestEpgDatabase, ReplacedTagsLeaveTheSearchIndex)
+{
+  const auto channelData = std::make_shared<CPVREpgChannelData>(1, 1);
+
+  EPG_TAG data = {};
+  data.iUniqueBroadcastId = 1;
+  data.iUniqueChannelId = 1;
+  data.strTitle = "Aardvark";
+  data.startTime = GUIDE_START;
+  data.endTime = GUIDE_START + 60 * 60;
+  data.iEpisodePartNumber = -1;
+
+  database->Lock();
+  database->QueuePersistQuery(CPVREpgInfoTag(data, 1, channelData, 1));
+  EXPECT_TRUE(database->CommitQueuedChanges());
+  database->Unlock();
+
+  PVREpgSearchData searchData;
+  searchData.m_startDateTime = CDateTime(GUIDE_START - 24 * 60 * 60);
+  searchData.m_endDateTime = CDateTime(GUIDE_START + 24 * 60 * 60);
+  const auto search = [this, &searchData](const std::string& strTerm) {
+    searchData.m_strSearchTerm = strTerm;
+    return database->GetEpgTags(searchData).size();
+  };
+  EXPECT_EQ(1u, search("Aardvark"));
+
+  // the persisted tag, updated with another title
+  const auto persisted = database->GetAllEpgTags(1);
+  ASSERT_EQ(1u, persisted.size());
+  data.strTitle = "Badger";
+  persisted.front()->Update(CPVREpgInfoTag(data, 1, channelData, 1), false);
+
+  database->Lock();
+  database->QueuePersistQuery(*persisted.front());
+  EXPECT_TRUE(database->CommitQueuedChanges());
+  database->Unlock();
+
+  EXPECT_EQ(0u, search("Aardvark"));
+  EXPECT_EQ(1u, search("Badger"));
+
+  // a new tag taking the slot of the persisted one
+  data.iUniqueBroadcastId = 2;
+  data.strTitle = "Cormorant";
+
+  database->Lock();
+  database->QueuePersistQuery(CPVREpgInfoTag(data, 1, channelData, 1));
+  EXPECT_TRUE(database->CommitQueuedChanges());
+  database->Unlock();
+
+  EXPECT_EQ(0u, search("Badger"));
+  EXPECT_EQ(1u, search("Cormorant"));
+  EXPECT_EQ(1u, database->GetAllEpgTags(1).size());
+}
+
+TEST_F(TestEpgDatabase, PlotAndCastStayInTheDatabase)
+{
+  ImportGuide(CSyntheticGuide("Show "), 1, 1);
+
+  const auto tags = database->GetAllEpgTags(1);
+  ASSERT_FALSE(tags.empty());
+  EXPECT_FALSE(tags.front()->IsLongTextLoaded());
+
+  // the plots can be matched without loading them into the tags
+  const auto plots = database->GetEpgTagPlots(1, CDateTime(GUIDE_START));
+  EXPECT_EQ(tags.size(), plots.size());
+  EXPECT_EQ("Plot of episode 1, it's 100% synthetic", plots.at(tags.front()->DatabaseID()));
+  EXPECT_FALSE(tags.front()->IsLongTextLoaded());
+
+  // persisting a tag whose plot was not asked for keeps the stored plot
+  database->Lock();
+  EXPECT_TRUE(database->QueuePersistQuery(*tags.front()));
+  EXPECT_TRUE(database->CommitQueuedChanges());
+  database->Unlock();
+
+  std::string strPlot;
+  std::string strCast;
+  EXPECT_TRUE(database->GetEpgTagPlotAndCast(tags.front()->DatabaseID(), strPlot, strCast));
+  EXPECT_EQ("Plot of episode 1, it's 100% synthetic", strPlot);
+}
+
+TEST_F(TestEpgDatabase, FailedCommitWritesNothing)
+{
+  const auto channelData = std::make_shared<CPVREpgChannelData>(1, 1);
+  const auto tags =
+      CSyntheticGuide("Show ").GetEPGForChannel(1, channelData, GUIDE_START + 60 * 60);
+  ASSERT_FALSE(tags.empty());
+
+  database->Lock();
+  database->QueuePersistQuery(*tags.front());
+  database->QueueDeleteQuery("DELETE FROM nosuchtable");
+  EXPECT_FALSE(database->CommitQueuedChanges());
+  database->Unlock();
+
+  EXPECT_TRUE(database->GetAllEpgTags(1).empty());
+}
+
+TEST_F(TestEpgDatabase, ImportBenchmark)
+{
+  // 50 channels, a week of guide data
+  const auto start = std::chrono::steady_clock::now();
+  const size_t iTags = ImportGuide(CSyntheticGuide("Show "), 50, 7);
+  const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+  RecordProperty("tags", static_cast<int>(iTags));
+  RecordProperty("tags_per_second", static_cast<int>(iTags / duration.count()));
+}
@@ -0,0 +1,172 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_epg.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/epg/EpgStringPool.h"
+#include "utils/StringUtils.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+struct SSyntheticEvent
+{
+  std::string title;
+  std::string plotOutline;
+  std::string plot;
+  std::string cast;
+  std::string director;
+  std::string episodeName;
+  std::string icon;
+  std::string genre;
+  std::string seriesLink;
+};
+
+std::shared_ptr<CPVREpgInfoTag> CreateTag(const SSyntheticEvent& event,
+                                          unsigned int iChannel,
+                                          time_t start,
+                                          time_t end)
+{
+  EPG_TAG data = {};
+  data.iUniqueBroadcastId = static_cast<unsigned int>(start);
+  data.iUniqueChannelId = iChannel;
+  data.strTitle = event.title.c_str();
+  data.startTime = start;
+  data.endTime = end;
+  data.strPlotOutline = event.plotOutline.c_str();
+  data.strPlot = event.plot.c_str();
+  data.strCast = event.cast.c_str();
+  data.strDirector = event.director.c_str();
+  data.strIconPath = event.icon.c_str();
+  data.iGenreType = EPG_GENRE_USE_STRING;
+  data.strGenreDescription = event.genre.c_str();
+  data.strFirstAired = "2021-03-01";
+  data.iSeriesNumber = 1;
+  data.iEpisodeNumber = 1;
+  data.iEpisodePartNumber = -1;
+  data.strEpisodeName = event.episodeName.c_str();
+  data.strSeriesLink = event.seriesLink.c_str();
+  return std::make_shared<CPVREpgInfoTag>(data, 1, nullptr, iChannel);
+}
+
+SSyntheticEvent CreateEvent(unsigned int iSeries, unsigned int iEpisode)
+{
+  SSyntheticEvent event;
+  event.title = StringUtils::Format("Series {}", iSeries);
+  event.plotOutline = StringUtils::Format("Episode {} of series {}.", iEpisode, iSeries);
+  event.plot = StringUtils::Format("{:*<300}", event.plotOutline);
+  event.cast = StringUtils::Format("Actor {}{}Actor {}{}Actor {}", iSeries, EPG_STRING_TOKEN_SEPARATOR,
+                                   iSeries + 1, EPG_STRING_TOKEN_SEPARATOR, iEpisode % 50);
+  event.director = StringUtils::Format("Director {}", iSeries % 200);
+  event.episodeName = StringUtils::Format("Episode {}", iEpisode);
+  event.icon = StringUtils::Format("https://images.example.org/series/{}/poster.jpg", iSeries);
+  event.genre = StringUtils::Format("Genre {}", iSeries % 20);
+  event.seriesLink = StringUtils::Format("crid://example.org/series/{}", iSeries);
+  return event;
+}
+
+size_t GetPooledLength(const SSyntheticEvent& event)
+{
+  return event.title.size() + event.director.size() + event.episodeName.size() +
+         event.icon.size() + event.genre.size() + event.seriesLink.size();
+}
+} // unnamed namespace
+
+TEST(TestEpgInfoTag, KeepsValues)
+{
+  const SSyntheticEvent event = CreateEvent(7, 3);
+  const std::shared_ptr<CPVREpgInfoTag> tag = CreateTag(event, 1, 1614556800, 1614558600);
+
+  EXPECT_EQ(event.title, tag->Title());
+  EXPECT_EQ(event.plot, tag->Plot());
+  EXPECT_EQ(event.episodeName, tag->EpisodeName());
+  EXPECT_EQ(event.icon, tag->Icon());
+  EXPECT_EQ(event.seriesLink, tag->SeriesLink());
+  EXPECT_EQ(std::vector<std::string>({"Actor 7", "Actor 8", "Actor 3"}), tag->Cast());
+  EXPECT_EQ(std::vector<std::string>({event.director}), tag->Directors());
+  EXPECT_TRUE(tag->Writers().empty());
+  EXPECT_EQ(std::vector<std::string>({event.genre}), tag->Genre());
+  EXPECT_EQ(EPG_GENRE_USE_STRING, tag->GenreType());
+
+  EXPECT_EQ(CDateTime(static_cast<time_t>(1614556800)), tag->StartAsUTC());
+  EXPECT_EQ(CDateTime(static_cast<time_t>(1614558600)), tag->EndAsUTC());
+  EXPECT_EQ(1800, tag->GetDuration());
+  EXPECT_EQ("2021-03-01", tag->FirstAired().GetAsDBDate());
+  EXPECT_EQ("pvr://guide/0001/2021-03-01 00:00:00.epg", tag->Path());
+
+  tag->SetEndFromUTC(CDateTime(static_cast<time_t>(1614560400)));
+  EXPECT_EQ(3600, tag->GetDuration());
+}
+
+TEST(TestEpgInfoTag, SharesRepeatedStrings)
+{
+  const size_t iPoolSize = CPVREpgStringPool::GetSize();
+  {
+    const SSyntheticEvent event = CreateEvent(1, 1);
+    const std::shared_ptr<CPVREpgInfoTag> tag1 = CreateTag(event, 1, 1614556800, 1614558600);
+    const std::shared_ptr<CPVREpgInfoTag> tag2 = CreateTag(event, 2, 1614556800, 1614558600);
+
+    // title, director, episode name, icon, genre, series link
+    EXPECT_EQ(iPoolSize + 6, CPVREpgStringPool::GetSize());
+    EXPECT_EQ(tag1->Title(), tag2->Title());
+
+    // the update takes the pooled strings of the other tag
+    const std::shared_ptr<CPVREpgInfoTag> tag3 =
+        CreateTag(CreateEvent(2, 1), 1, 1614556800, 1614558600);
+    EXPECT_TRUE(tag1->Update(*tag3));
+    EXPECT_EQ(tag3->Title(), tag1->Title());
+    EXPECT_EQ(tag2->Icon(), event.icon);
+  }
+  EXPECT_EQ(iPoolSize, CPVREpgStringPool::GetSize());
+}
+
+TEST(TestEpgInfoTag, MemoryBenchmark)
+{
+  // a synthetic guide as read from a large XMLTV file, fewer channels than a real lineup to keep
+  // the test fast, the ratio of pooled to repeated strings does not depend on the channel count
+  const unsigned int CHANNELS = 150;
+  const unsigned int DAYS = 14;
+  const time_t GUIDE_START = 1614556800;
+  const time_t GUIDE_END = GUIDE_START + DAYS * 24 * 60 * 60;
+
+  const size_t iPoolLength = CPVREpgStringPool::GetLength();
+
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  size_t iRepeatedLength = 0;
+  for (unsigned int iChannel = 0; iChannel < CHANNELS; iChannel++)
+  {
+    unsigned int iEvent = 0;
+    for (time_t start = GUIDE_START; start < GUIDE_END; iEvent++)
+    {
+      const time_t end = start + (iEvent % 3 + 1) * 30 * 60;
+
+      // channels air episodes of a few hundred series, with reruns
+      const SSyntheticEvent event = CreateEvent((iChannel * 7 + iEvent % 12) % 400, iEvent % 90);
+      tags.emplace_back(CreateTag(event, iChannel, start, end));
+      iRepeatedLength += GetPooledLength(event);
+
+      start = end;
+    }
+  }
+
+  const size_t iPooledLength = CPVREpgStringPool::GetLength() - iPoolLength;
+
+  RecordProperty("tags", static_cast<int>(tags.size()));
+  RecordProperty("tag_size", static_cast<int>(sizeof(CPVREpgInfoTag)));
+  RecordProperty("repeated_string_bytes", static_cast<int>(iRepeatedLength));
+  RecordProperty("pooled_string_bytes", static_cast<int>(iPooledLength));
+
+  EXPECT_LT(iPooledLength * 50, iRepeatedLength);
+}
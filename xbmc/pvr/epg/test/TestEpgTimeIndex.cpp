@@ -0,0 +1,289 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "XBDateTime.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/epg/EpgTimeIndex.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+const time_t GUIDE_START = 1614556800;
+
+std::shared_ptr<CPVREpgInfoTag> CreateTag(time_t start, time_t end)
+{
+  return std::make_shared<CPVREpgInfoTag>(nullptr, 1, CDateTime(start), CDateTime(end), false);
+}
+
+time_t Minutes(int iMinutes)
+{
+  return GUIDE_START + iMinutes * 60;
+}
+
+CDateTime At(int iMinutes)
+{
+  return CDateTime(Minutes(iMinutes));
+}
+
+std::vector<time_t> StartTimes(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags)
+{
+  std::vector<time_t> times;
+  for (const auto& tag : tags)
+  {
+    time_t start;
+    tag->StartAsUTC().GetAsTime(start);
+    times.emplace_back(start);
+  }
+  return times;
+}
+
+// the plain scan the time range lookups replace
+std::vector<std::shared_ptr<CPVREpgInfoTag>> ScanTags(
+    const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags,
+    const CDateTime& minEnd,
+    const CDateTime& maxStart)
+{
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> result;
+  for (const auto& tag : tags)
+  {
+    if (tag->EndAsUTC() >= minEnd && tag->StartAsUTC() <= maxStart)
+      result.emplace_back(tag);
+  }
+  return result;
+}
+} // unnamed namespace
+
+class TestEpgTimeIndex : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // 0-30, 30-150 (long), 150-180, gap, 240-270
+    m_index.Load({CreateTag(Minutes(0), Minutes(30)), CreateTag(Minutes(30), Minutes(150)),
+                  CreateTag(Minutes(150), Minutes(180)), CreateTag(Minutes(240), Minutes(270))});
+  }
+
+  CPVREpgTimeIndex m_index;
+};
+
+TEST_F(TestEpgTimeIndex, LoadState)
+{
+  CPVREpgTimeIndex index;
+  EXPECT_FALSE(index.IsLoaded());
+
+  index.Clear();
+  EXPECT_TRUE(index.IsLoaded());
+  EXPECT_TRUE(index.IsEmpty());
+
+  EXPECT_TRUE(m_index.IsLoaded());
+  EXPECT_EQ(4u, m_index.Size());
+
+  m_index.Reset();
+  EXPECT_FALSE(m_index.IsLoaded());
+  EXPECT_TRUE(m_index.IsEmpty());
+}
+
+TEST_F(TestEpgTimeIndex, GetTags)
+{
+  // the long event started before the range but still overlaps it
+  EXPECT_EQ(std::vector<time_t>({Minutes(30), Minutes(150)}),
+            StartTimes(m_index.GetTags(At(120), At(160))));
+  EXPECT_EQ(std::vector<time_t>({Minutes(0), Minutes(30)}),
+            StartTimes(m_index.GetTags(At(30), At(30))));
+  EXPECT_TRUE(m_index.GetTags(At(190), At(230)).empty());
+  EXPECT_EQ(4u, m_index.GetTags(At(-60), At(300)).size());
+
+  EXPECT_EQ(std::vector<time_t>({Minutes(150)}),
+            StartTimes(m_index.GetTagsBetween(At(100), At(200))));
+  EXPECT_EQ(4u, m_index.GetAllTags().size());
+}
+
+TEST_F(TestEpgTimeIndex, GetTagsAroundTime)
+{
+  EXPECT_EQ(Minutes(30), StartTimes({m_index.GetActiveTag(At(100))}).front());
+  EXPECT_EQ(Minutes(150), StartTimes({m_index.GetActiveTag(At(150))}).front());
+  EXPECT_FALSE(m_index.GetActiveTag(At(200)));
+
+  EXPECT_EQ(Minutes(240), StartTimes({m_index.GetNextStartingTag(At(181))}).front());
+  EXPECT_FALSE(m_index.GetNextStartingTag(At(241)));
+
+  EXPECT_EQ(Minutes(150), StartTimes({m_index.GetLastEndedTag(At(200))}).front());
+  EXPECT_EQ(Minutes(0), StartTimes({m_index.GetLastEndedTag(At(100))}).front());
+  EXPECT_FALSE(m_index.GetLastEndedTag(At(20)));
+
+  EXPECT_EQ(At(180), m_index.GetMaxEndTime(At(200)));
+  EXPECT_EQ(At(30), m_index.GetMaxEndTime(At(100)));
+  EXPECT_FALSE(m_index.GetMaxEndTime(At(20)).IsValid());
+
+  EXPECT_EQ(At(240), m_index.GetMinStartTime(At(150)));
+  EXPECT_FALSE(m_index.GetMinStartTime(At(240)).IsValid());
+
+  EXPECT_EQ(At(0), m_index.GetFirstStartTime());
+  EXPECT_EQ(At(270), m_index.GetLastEndTime());
+}
+
+TEST_F(TestEpgTimeIndex, Update)
+{
+  // replaces the events it overlaps
+  m_index.Insert(CreateTag(Minutes(20), Minutes(60)));
+  EXPECT_EQ(std::vector<time_t>({Minutes(20), Minutes(150), Minutes(240)}),
+            StartTimes(m_index.GetAllTags()));
+
+  // replaces the event with the same start time
+  m_index.Insert(CreateTag(Minutes(240), Minutes(250)));
+  EXPECT_EQ(At(250), m_index.GetLastEndTime());
+
+  m_index.Erase(CreateTag(Minutes(150), Minutes(180)));
+  EXPECT_FALSE(m_index.GetActiveTag(At(160)));
+
+  m_index.EraseEndedBefore(At(245));
+  EXPECT_EQ(std::vector<time_t>({Minutes(240)}), StartTimes(m_index.GetAllTags()));
+}
+
+TEST_F(TestEpgTimeIndex, MaxDuration)
+{
+  EXPECT_EQ(120 * 60, m_index.MaxDuration());
+
+  // the longest event is gone, lookups by end time no longer start two hours early
+  m_index.Erase(CreateTag(Minutes(30), Minutes(150)));
+  EXPECT_EQ(30 * 60, m_index.MaxDuration());
+
+  m_index.Insert(CreateTag(Minutes(300), Minutes(360)));
+  m_index.Insert(CreateTag(Minutes(300), Minutes(310)));
+  EXPECT_EQ(30 * 60, m_index.MaxDuration());
+
+  m_index.Clear();
+  EXPECT_EQ(0, m_index.MaxDuration());
+}
+
+TEST_F(TestEpgTimeIndex, GuideIndex)
+{
+  const auto guideIndex = std::make_shared<CPVREpgGuideIndex>();
+  m_index.SetGuideIndex(guideIndex, 1);
+  EXPECT_EQ(4u, guideIndex->Size());
+
+  {
+    CPVREpgTimeIndex index;
+    index.SetGuideIndex(guideIndex, 2);
+    index.Load({CreateTag(Minutes(0), Minutes(60)), CreateTag(Minutes(60), Minutes(200))});
+    EXPECT_EQ(6u, guideIndex->Size());
+
+    // the events of both EPGs, the long ones started before the range
+    EXPECT_EQ(std::vector<time_t>({Minutes(30), Minutes(60), Minutes(150)}),
+              StartTimes(guideIndex->GetTags(At(120), At(160))));
+    EXPECT_EQ(std::vector<time_t>({Minutes(60), Minutes(150)}),
+              StartTimes(guideIndex->GetActiveTags(At(170))));
+
+    // replaced and erased events leave the guide index
+    index.Insert(CreateTag(Minutes(50), Minutes(70)));
+    EXPECT_EQ(std::vector<time_t>({Minutes(150)}),
+              StartTimes(guideIndex->GetActiveTags(At(170))));
+    m_index.EraseEndedBefore(At(200));
+    EXPECT_EQ(2u, guideIndex->Size());
+  }
+
+  // destroyed indexes leave the guide index
+  EXPECT_EQ(1u, guideIndex->Size());
+
+  m_index.SetEpgID(3);
+  EXPECT_EQ(1u, guideIndex->Size());
+  m_index.Reset();
+  EXPECT_EQ(0u, guideIndex->Size());
+}
+
+namespace
+{
+/*!
+ * @brief Scroll the guide grid through the first day, three hours per page, all channels per page.
+ * Compares the time indexes of the channels and the guide index with a linear scan.
+ */
+void GuideGrid(unsigned int iChannels)
+{
+  // two weeks of events of 30 to 90 minutes per channel
+  const time_t GUIDE_END = GUIDE_START + 14 * 24 * 60 * 60;
+
+  const auto guideIndex = std::make_shared<CPVREpgGuideIndex>();
+  std::vector<CPVREpgTimeIndex> indexes(iChannels);
+  std::vector<std::vector<std::shared_ptr<CPVREpgInfoTag>>> tags(iChannels);
+  size_t iTags = 0;
+  for (unsigned int iChannel = 0; iChannel < iChannels; iChannel++)
+  {
+    unsigned int iEvent = iChannel;
+    for (time_t start = GUIDE_START; start < GUIDE_END; iEvent++)
+    {
+      const time_t end = start + (iEvent % 3 + 1) * 30 * 60;
+      tags[iChannel].emplace_back(CreateTag(start, end));
+      start = end;
+    }
+    indexes[iChannel].SetGuideIndex(guideIndex, iChannel + 1);
+    indexes[iChannel].Load(tags[iChannel]);
+    iTags += tags[iChannel].size();
+  }
+  ASSERT_EQ(iTags, guideIndex->Size());
+
+  std::chrono::nanoseconds indexTime{};
+  std::chrono::nanoseconds guideTime{};
+  std::chrono::nanoseconds scanTime{};
+  for (int iPage = 0; iPage < 8; iPage++)
+  {
+    const CDateTime minEnd = At(iPage * 180);
+    const CDateTime maxStart = At((iPage + 1) * 180);
+
+    size_t iFound = 0;
+    for (unsigned int iChannel = 0; iChannel < iChannels; iChannel++)
+    {
+      auto start = std::chrono::steady_clock::now();
+      const auto found = indexes[iChannel].GetTags(minEnd, maxStart);
+      indexTime += std::chrono::steady_clock::now() - start;
+
+      start = std::chrono::steady_clock::now();
+      const auto expected = ScanTags(tags[iChannel], minEnd, maxStart);
+      scanTime += std::chrono::steady_clock::now() - start;
+
+      ASSERT_EQ(expected, found);
+      iFound += found.size();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto found = guideIndex->GetTags(minEnd, maxStart);
+    guideTime += std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(iFound, found.size());
+  }
+
+  ::testing::Test::RecordProperty("channels", static_cast<int>(iChannels));
+  ::testing::Test::RecordProperty("tags", static_cast<int>(iTags));
+  ::testing::Test::RecordProperty(
+      "index_us",
+      static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(indexTime).count()));
+  ::testing::Test::RecordProperty(
+      "guide_us",
+      static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(guideTime).count()));
+  ::testing::Test::RecordProperty(
+      "scan_us",
+      static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(scanTime).count()));
+}
+} // unnamed namespace
+
+TEST(TestEpgTimeIndexBenchmark, GuideGrid)
+{
+  GuideGrid(50);
+}
+
+TEST(TestEpgTimeIndexBenchmark, DISABLED_GuideGridLarge)
+{
+  // a full lineup
+  GuideGrid(1500);
+}
@@ -23,8 +23,10 @@
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/guilib/GUIEPGGridContainerModel.h"
 #include "utils/MathUtils.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
+#include "utils/log.h"
 
 #include <algorithm>
 #include <memory>
@@ -160,6 +162,7 @@ CGUIEPGGridContainer::CGUIEPGGridContainer(const CGUIEPGGridContainer& other)
     m_updatedGridModel(other.m_updatedGridModel
                            ? new CGUIEPGGridContainerModel(*other.m_updatedGridModel)
                            : nullptr),
+    m_bEpgChanged(other.m_bEpgChanged),
     m_itemStartBlock(other.m_itemStartBlock)
 {
 }
@@ -671,9 +674,11 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
 
 void CGUIEPGGridContainer::UpdateItems()
 {
+  CPerformanceTraceSpan span("PVRGuide::UpdateItems");
+
   CSingleLock lock(m_critSection);
 
-  if (!m_updatedGridModel)
+  if (!m_updatedGridModel && !m_bEpgChanged)
     return;
 
   // Save currently selected epg tag and grid coordinates. Selection shall be restored after update.
@@ -748,7 +753,17 @@ void CGUIEPGGridContainer::UpdateItems()
   m_lastChannel = nullptr;
 
   // always use asynchronously precalculated grid data.
-  m_gridModel = std::move(m_updatedGridModel);
+  if (m_updatedGridModel)
+    m_gridModel = std::move(m_updatedGridModel);
+
+  if (m_bEpgChanged)
+  {
+    // patch the channels with changed EPG data, keep everything else
+    m_bEpgChanged = false;
+    const int iChangedChannels = m_gridModel->RefreshChangedEpgs();
+    CLog::LogFC(LOGDEBUG, LOGEPG, "Refreshed {} of {} channels", iChangedChannels,
+                m_gridModel->ChannelItemsSize());
+  }
 
   if (prevSelectedEpgTag)
   {
@@ -1839,6 +1854,22 @@ void CGUIEPGGridContainer::SetTimelineItems(const std::unique_ptr<CFileItemList>
   }
 }
 
+bool CGUIEPGGridContainer::UpdateTimelineItemsEpg(const CDateTime& gridStart,
+                                                  const CDateTime& gridEnd)
+{
+  CSingleLock lock(m_critSection);
+
+  // a pending grid model is patched after it was taken over, it was initialized before the update
+  const CGUIEPGGridContainerModel* model =
+      m_updatedGridModel ? m_updatedGridModel.get() : m_gridModel.get();
+
+  if (!model->HasChannelItems() || !model->IsSameGrid(gridStart, gridEnd, m_blocksPerPage))
+    return false;
+
+  m_bEpgChanged = true;
+  return true;
+}
+
 std::unique_ptr<CFileItemList> CGUIEPGGridContainer::GetCurrentTimeLineItems() const
 {
   return m_gridModel->GetCurrentTimeLineItems();
@@ -105,6 +105,15 @@ namespace PVR
                           const CDateTime& gridStart,
                           const CDateTime& gridEnd);
 
+    /*!
+     * @brief Update the EPG data of the current timeline items, keeping the channels. Only the
+     * channels whose EPG changed get updated, with the next update of the items.
+     * @param gridStart The start of the time frame to display.
+     * @param gridEnd The end of the time frame to display.
+     * @return True on success, false if the grid changed and SetTimelineItems must be used instead.
+     */
+    bool UpdateTimelineItemsEpg(const CDateTime& gridStart, const CDateTime& gridEnd);
+
     std::unique_ptr<CFileItemList> GetCurrentTimeLineItems() const;
 
     /*!
@@ -268,6 +277,7 @@ namespace PVR
     mutable CCriticalSection m_critSection;
     std::unique_ptr<CGUIEPGGridContainerModel> m_gridModel;
     std::unique_ptr<CGUIEPGGridContainerModel> m_updatedGridModel;
+    bool m_bEpgChanged = false;
 
     int m_itemStartBlock = 0;
   };
@@ -19,6 +19,7 @@
 #include "utils/log.h"
 
 #include <cmath>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -28,8 +29,11 @@ static const unsigned int GRID_START_PADDING = 30; // minutes
 
 void CGUIEPGGridContainerModel::SetInvalid()
 {
-  for (const auto& gridItem : m_gridIndex)
-    gridItem.second.item->SetInvalid();
+  for (const auto& channelGridItems : m_gridIndex)
+  {
+    for (const auto& gridItem : channelGridItems.second)
+      gridItem.second.item->SetInvalid();
+  }
   for (const auto& channel : m_channelItems)
     channel->SetInvalid();
   for (const auto& ruler : m_rulerItems)
@@ -81,44 +85,17 @@ void CGUIEPGGridContainerModel::Initialize(const std::unique_ptr<CFileItemList>&
   ////////////////////////////////////////////////////////////////////////
   // Create channel items
   m_channelItems.reserve(items->Size());
+  m_epgStates.reserve(items->Size());
   for (const auto& channelItem : *items)
   {
     m_channelItems.emplace_back(channelItem);
-  }
 
-  /* check for invalid start and end time */
-  if (gridStart >= gridEnd)
-  {
-    // default to start "now minus GRID_START_PADDING minutes" and end "start plus one page".
-    m_gridStart = CDateTime::GetUTCDateTime() - CDateTimeSpan(0, 0, GetGridStartPadding(), 0);
-    m_gridEnd = m_gridStart + CDateTimeSpan(0, 0, iBlocksPerPage * MINSPERBLOCK, 0);
-  }
-  else if (gridStart > (CDateTime::GetUTCDateTime() - CDateTimeSpan(0, 0, GetGridStartPadding(), 0)))
-  {
-    // adjust to start "now minus GRID_START_PADDING minutes".
-    m_gridStart = CDateTime::GetUTCDateTime() - CDateTimeSpan(0, 0, GetGridStartPadding(), 0);
-    m_gridEnd = gridEnd;
-  }
-  else
-  {
-    m_gridStart = gridStart;
-    m_gridEnd = gridEnd;
+    // remember the state of the EPG before any of its data is read
+    const std::shared_ptr<CPVREpg> epg = channelItem->GetPVRChannelInfoTag()->GetEPG();
+    m_epgStates.push_back({epg, epg ? epg->GetChangeCount() : 0});
   }
 
-  // roundup
-  m_gridStart = CDateTime(m_gridStart.GetYear(), m_gridStart.GetMonth(), m_gridStart.GetDay(),
-                          m_gridStart.GetHour(), m_gridStart.GetMinute() >= 30 ? 30 : 0, 0);
-  m_gridEnd = CDateTime(m_gridEnd.GetYear(), m_gridEnd.GetMonth(), m_gridEnd.GetDay(),
-                        m_gridEnd.GetHour(), m_gridEnd.GetMinute() >= 30 ? 30 : 0, 0);
-
-  m_blocks = GetBlock(m_gridEnd) + 1;
-
-  const int iBlocksLastPage = m_blocks % iBlocksPerPage;
-  if (iBlocksLastPage > 0)
-  {
-    m_gridEnd += CDateTimeSpan(0, 0, (iBlocksPerPage - iBlocksLastPage) * MINSPERBLOCK, 0);
-    m_blocks += (iBlocksPerPage - iBlocksLastPage);
-  }
+  GetGridBoundaries(gridStart, gridEnd, iBlocksPerPage, m_gridStart, m_gridEnd, m_blocks);
 
   ////////////////////////////////////////////////////////////////////////
   // Create ruler items
@@ -144,6 +121,123 @@ void CGUIEPGGridContainerModel::Initialize(const std::unique_ptr<CFileItemList>&
   m_lastActiveBlock = iFirstBlock + iBlocksPerPage - 1;
 }
 
+void CGUIEPGGridContainerModel::GetGridBoundaries(const CDateTime& gridStart,
+                                                  const CDateTime& gridEnd,
+                                                  int iBlocksPerPage,
+                                                  CDateTime& start,
+                                                  CDateTime& end,
+                                                  int& blocks) const
+{
+  /* check for invalid start and end time */
+  if (gridStart >= gridEnd)
+  {
+    // default to start "now minus GRID_START_PADDING minutes" and end "start plus one page".
+    start = CDateTime::GetUTCDateTime() - CDateTimeSpan(0, 0, GetGridStartPadding(), 0);
+    end = start + CDateTimeSpan(0, 0, iBlocksPerPage * MINSPERBLOCK, 0);
+  }
+  else if (gridStart > (CDateTime::GetUTCDateTime() - CDateTimeSpan(0, 0, GetGridStartPadding(), 0)))
+  {
+    // adjust to start "now minus GRID_START_PADDING minutes".
+    start = CDateTime::GetUTCDateTime() - CDateTimeSpan(0, 0, GetGridStartPadding(), 0);
+    end = gridEnd;
+  }
+  else
+  {
+    start = gridStart;
+    end = gridEnd;
+  }
+
+  // roundup
+  start = CDateTime(start.GetYear(), start.GetMonth(), start.GetDay(), start.GetHour(),
+                    start.GetMinute() >= 30 ? 30 : 0, 0);
+  end = CDateTime(end.GetYear(), end.GetMonth(), end.GetDay(), end.GetHour(),
+                  end.GetMinute() >= 30 ? 30 : 0, 0);
+
+  // the block of the grid end, see GetBlock
+  int diff = 0;
+  if (start > end)
+    diff = -1 * (start - end).GetSecondsTotal();
+  else
+    diff = (end - start).GetSecondsTotal();
+
+  blocks = diff / 60 / MINSPERBLOCK + 1;
+
+  const int iBlocksLastPage = blocks % iBlocksPerPage;
+  if (iBlocksLastPage > 0)
+  {
+    end += CDateTimeSpan(0, 0, (iBlocksPerPage - iBlocksLastPage) * MINSPERBLOCK, 0);
+    blocks += (iBlocksPerPage - iBlocksLastPage);
+  }
+}
+
+bool CGUIEPGGridContainerModel::IsSameGrid(const CDateTime& gridStart,
+                                           const CDateTime& gridEnd,
+                                           int iBlocksPerPage) const
+{
+  CDateTime start;
+  CDateTime end;
+  int blocks = 0;
+  GetGridBoundaries(gridStart, gridEnd, iBlocksPerPage, start, end, blocks);
+
+  return start == m_gridStart && end == m_gridEnd && blocks == m_blocks;
+}
+
+int CGUIEPGGridContainerModel::RefreshChangedEpgs()
+{
+  int iChangedChannels = 0;
+
+  for (int iChannel = 0; iChannel < ChannelItemsSize(); ++iChannel)
+  {
+    EpgState& state = m_epgStates[iChannel];
+    const std::shared_ptr<CPVREpg> epg = m_channelItems[iChannel]->GetPVRChannelInfoTag()->GetEPG();
+
+    CDateTime changedStart;
+    CDateTime changedEnd;
+    if (epg != state.epg)
+    {
+      // EPG was created or replaced. everything changed.
+      state.epg = epg;
+      state.iChangeCount = epg ? epg->GetChangeCount() : 0;
+    }
+    else if (!epg || !epg->GetChangesSince(state.iChangeCount, changedStart, changedEnd))
+    {
+      continue;
+    }
+
+    if (RefreshEpg(iChannel, changedStart, changedEnd))
+      ++iChangedChannels;
+  }
+
+  return iChangedChannels;
+}
+
+bool CGUIEPGGridContainerModel::RefreshEpg(int iChannel,
+                                           const CDateTime& changedStart,
+                                           const CDateTime& changedEnd)
+{
+  const auto itEpg = m_epgItems.find(iChannel);
+  if (itEpg == m_epgItems.end())
+    return false; // nothing cached, will be fetched on demand
+
+  const EpgTags& epgTags = (*itEpg).second;
+  if (!epgTags.tags.empty())
+  {
+    // the cached tags cover the blocks of all events they contain, also of those replaced now
+    const int firstChangedBlock =
+        changedStart.IsValid() ? GetBlock(changedStart) : std::numeric_limits<int>::min();
+    const int lastChangedBlock =
+        changedEnd.IsValid() ? GetBlock(changedEnd) : std::numeric_limits<int>::max();
+
+    if (lastChangedBlock < epgTags.firstBlock || firstChangedBlock > epgTags.lastBlock)
+      return false; // changes are outside of the cached time frame
+  }
+
+  m_epgItems.erase(itEpg);
+  m_gridIndex.erase(iChannel);
+
+  return true;
+}
+
 std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::CreateEpgTags(int iChannel, int iBlock) const
 {
   std::shared_ptr<CFileItem> result;
@@ -394,8 +488,9 @@ void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid,
 
 GridItem* CGUIEPGGridContainerModel::GetGridItemPtr(int iChannel, int iBlock) const
 {
-  auto it = m_gridIndex.find({iChannel, iBlock});
-  if (it == m_gridIndex.end())
+  GridItems& gridItems = m_gridIndex[iChannel];
+  auto it = gridItems.find(iBlock);
+  if (it == gridItems.end())
   {
     const CDateTime startTime = GetStartTimeForBlock(iBlock);
     if (startTime < m_gridStart || m_gridEnd < startTime)
@@ -420,7 +515,7 @@ GridItem* CGUIEPGGridContainerModel::GetGridItemPtr(int iChannel, int iBlock) co
     item->SetProperty("GenreType", epgTag->GenreType());
 
     const float fItemWidth = (endBlock - startBlock + 1) * m_fBlockSize;
-    it = m_gridIndex.insert({{iChannel, iBlock}, {item, fItemWidth, startBlock, endBlock}}).first;
+    it = gridItems.insert({iBlock, {item, fItemWidth, startBlock, endBlock}}).first;
   }
 
   return &(*it).second;
@@ -470,8 +565,12 @@ float CGUIEPGGridContainerModel::GetGridItemOriginWidth(int iChannel, int iBlock
 
 void CGUIEPGGridContainerModel::DecreaseGridItemWidth(int iChannel, int iBlock, float fSize)
 {
-  auto it = m_gridIndex.find({iChannel, iBlock});
-  if (it != m_gridIndex.end() && (*it).second.width != ((*it).second.originWidth - fSize))
+  const auto itChannel = m_gridIndex.find(iChannel);
+  if (itChannel == m_gridIndex.end())
+    return;
+
+  auto it = (*itChannel).second.find(iBlock);
+  if (it != (*itChannel).second.end() && (*it).second.width != ((*it).second.originWidth - fSize))
     (*it).second.width = (*it).second.originWidth - fSize;
 }
 
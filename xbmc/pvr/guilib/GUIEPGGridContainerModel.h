@@ -45,6 +45,7 @@ namespace PVR
     int endBlock = 0;
   };
 
+  class CPVREpg;
   class CPVREpgInfoTag;
 
   class CGUIEPGGridContainerModel
@@ -66,6 +67,22 @@ namespace PVR
                     float fBlockSize);
     void SetInvalid();
 
+    /*!
+     * @brief Check whether Initialize would create the same grid for the given time frame.
+     * @param gridStart The start of the time frame.
+     * @param gridEnd The end of the time frame.
+     * @param iBlocksPerPage The number of blocks per page.
+     * @return True if grid start, end and number of blocks would not change, false otherwise.
+     */
+    bool IsSameGrid(const CDateTime& gridStart, const CDateTime& gridEnd, int iBlocksPerPage) const;
+
+    /*!
+     * @brief Drop the cached EPG data of the channels whose EPG changed in the cached time frame
+     * since it was read. The data is fetched again on demand, other channels are kept as they are.
+     * @return The number of channels whose cached EPG data was dropped.
+     */
+    int RefreshChangedEpgs();
+
     static const int INVALID_INDEX = -1;
     void FindChannelAndBlockIndex(int channelUid, unsigned int broadcastUid, int eventOffset, int& newChannelIndex, int& newBlockIndex) const;
 
@@ -112,6 +129,14 @@ namespace PVR
     std::unique_ptr<CFileItemList> GetCurrentTimeLineItems() const;
 
   private:
+    void GetGridBoundaries(const CDateTime& gridStart,
+                           const CDateTime& gridEnd,
+                           int iBlocksPerPage,
+                           CDateTime& start,
+                           CDateTime& end,
+                           int& blocks) const;
+    bool RefreshEpg(int iChannel, const CDateTime& changedStart, const CDateTime& changedEnd);
+
     GridItem* GetGridItemPtr(int iChannel, int iBlock) const;
     std::shared_ptr<CFileItem> CreateGapItem(int iChannel) const;
     std::shared_ptr<CFileItem> GetItem(int iChannel, int iBlock) const;
@@ -143,28 +168,17 @@ namespace PVR
     std::vector<std::shared_ptr<CFileItem>> m_channelItems;
     std::vector<std::shared_ptr<CFileItem>> m_rulerItems;
 
-    struct GridCoordinates
+    struct EpgState
     {
-      GridCoordinates(int _channel, int _block) : channel(_channel), block(_block) {}
-
-      bool operator==(const GridCoordinates& other) const
-      {
-        return (channel == other.channel && block == other.block);
-      }
-
-      int channel = 0;
-      int block = 0;
+      std::shared_ptr<CPVREpg> epg;
+      unsigned int iChangeCount = 0;
     };
 
-    struct GridCoordinatesHash
-    {
-      std::size_t operator()(const GridCoordinates& coordinates) const
-      {
-        return std::hash<int>()(coordinates.channel) ^ std::hash<int>()(coordinates.block);
-      }
-    };
+    std::vector<EpgState> m_epgStates; // the EPG changes known to the cached data, per channel
+
+    using GridItems = std::unordered_map<int, GridItem>; // by block
 
-    mutable std::unordered_map<GridCoordinates, GridItem, GridCoordinatesHash> m_gridIndex;
+    mutable std::unordered_map<int, GridItems> m_gridIndex; // by channel
 
     int m_blocks = 0;
     float m_fBlockSize = 0.0f;
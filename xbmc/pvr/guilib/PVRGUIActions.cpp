@@ -1241,7 +1241,7 @@ namespace PVR
         // fileitem instead and pass the epg tags props so we use those and skip the client call
         if (epgProps)
           props = *epgProps;
-        else
+        else if (!m_channelPreTuner.GetStreamProperties(item->GetPVRChannelInfoTag(), props))
           client->GetChannelStreamProperties(item->GetPVRChannelInfoTag(), props);
       }
       else if (item->IsPVRRecording())
@@ -1818,6 +1818,9 @@ namespace PVR
 
       /* delete all timers */
       pvrDatabase->DeleteTimers();
+
+      /* delete all cached recordings */
+      pvrDatabase->DeleteRecordings();
       pDlgProgress->SetPercentage(80);
       pDlgProgress->Progress();
 
@@ -2413,6 +2416,11 @@ namespace PVR
     return m_channelNavigator;
   }
 
+  CPVRGUIChannelPreTuner& CPVRGUIActions::GetChannelPreTuner()
+  {
+    return m_channelPreTuner;
+  }
+
   void CPVRGUIActions::OnPlaybackStarted(const CFileItemPtr& item)
   {
     const std::shared_ptr<CPVRChannelGroupMember> groupMember = GetChannelGroupMember(*item);
@@ -2441,6 +2449,25 @@ namespace PVR
     }
 
     CPVRChannelNumberInputHandler::AppendChannelNumberCharacter(cCharacter);
+
+    // the channel with the number entered so far is a likely switch target
+    CPVRGUIChannelPreTuner& preTuner = CServiceBroker::GetPVRManager().GUIActions()->GetChannelPreTuner();
+    if (preTuner.IsEnabled())
+    {
+      const std::shared_ptr<CPVRChannel> playingChannel = CServiceBroker::GetPVRManager().PlaybackState()->GetPlayingChannel();
+      if (playingChannel)
+      {
+        const std::shared_ptr<CPVRChannelGroup> group =
+            CServiceBroker::GetPVRManager().PlaybackState()->GetActiveChannelGroup(playingChannel->IsRadio());
+        if (group)
+        {
+          const std::shared_ptr<CPVRChannelGroupMember> groupMember =
+              group->GetByChannelNumber(GetChannelNumber());
+          if (groupMember)
+            preTuner.PreTune({groupMember->Channel()});
+        }
+      }
+    }
   }
 
   void CPVRChannelSwitchingInputHandler::GetChannelNumbers(std::vector<std::string>& channelNumbers)
@@ -10,6 +10,7 @@
 
 #include "pvr/PVRChannelNumberInputHandler.h"
 #include "pvr/guilib/PVRGUIChannelNavigator.h"
+#include "pvr/guilib/PVRGUIChannelPreTuner.h"
 #include "pvr/settings/PVRSettings.h"
 #include "threads/CriticalSection.h"
 
@@ -429,6 +430,12 @@ namespace PVR
      */
     CPVRGUIChannelNavigator& GetChannelNavigator();
 
+    /*!
+     * @brief Get the channel pre-tuner.
+     * @return the pre-tuner.
+     */
+    CPVRGUIChannelPreTuner& GetChannelPreTuner();
+
     /*!
      * @brief Inform GUI actions that playback of an item just started.
      * @param item The item that started to play.
@@ -563,6 +570,7 @@ namespace PVR
     bool m_bChannelScanRunning = false;
     CPVRSettings m_settings;
     CPVRGUIChannelNavigator m_channelNavigator;
+    mutable CPVRGUIChannelPreTuner m_channelPreTuner;
     std::string m_selectedItemPathTV;
     std::string m_selectedItemPathRadio;
     mutable bool m_bReminderAnnouncementRunning = false;
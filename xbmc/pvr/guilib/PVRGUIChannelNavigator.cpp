@@ -14,8 +14,11 @@
 #include "guilib/GUIComponent.h"
 #include "pvr/PVRManager.h"
 #include "pvr/PVRPlaybackState.h"
+#include "pvr/channels/PVRChannel.h"
 #include "pvr/channels/PVRChannelGroup.h"
+#include "pvr/channels/PVRChannelGroupMember.h"
 #include "pvr/guilib/PVRGUIActions.h"
+#include "pvr/guilib/PVRGUIChannelPreTuner.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
@@ -23,6 +26,9 @@
 #include "utils/JobManager.h"
 #include "utils/XTimeUtils.h"
 
+#include <memory>
+#include <vector>
+
 namespace
 {
 class CPVRChannelTimeoutJobBase : public CJob, public IJobCallback
@@ -96,7 +102,10 @@ namespace PVR
 
     const std::shared_ptr<CPVRChannelGroupMember> nextMember = GetNextOrPrevChannel(true);
     if (nextMember)
+    {
       SelectChannel(nextMember, eSwitchMode);
+      PreTuneNeighbours(true);
+    }
   }
 
   void CPVRGUIChannelNavigator::SelectPreviousChannel(ChannelSwitchMode eSwitchMode)
@@ -110,7 +119,10 @@ namespace PVR
 
     const std::shared_ptr<CPVRChannelGroupMember> prevMember = GetNextOrPrevChannel(false);
     if (prevMember)
+    {
       SelectChannel(prevMember, eSwitchMode);
+      PreTuneNeighbours(false);
+    }
   }
 
   std::shared_ptr<CPVRChannelGroupMember> CPVRGUIChannelNavigator::GetNextOrPrevChannel(bool bNext)
@@ -161,6 +173,22 @@ namespace PVR
     }
   }
 
+  void CPVRGUIChannelNavigator::PreTuneNeighbours(bool bNext)
+  {
+    CPVRGUIChannelPreTuner& preTuner =
+        CServiceBroker::GetPVRManager().GUIActions()->GetChannelPreTuner();
+    if (!preTuner.IsEnabled())
+      return;
+
+    std::vector<std::shared_ptr<CPVRChannel>> channels;
+    for (const auto& groupMember : {GetNextOrPrevChannel(bNext), GetNextOrPrevChannel(!bNext)})
+    {
+      if (groupMember)
+        channels.emplace_back(groupMember->Channel());
+    }
+    preTuner.PreTune(channels);
+  }
+
   void CPVRGUIChannelNavigator::SwitchToCurrentChannel()
   {
     CFileItemPtr item;
@@ -278,6 +306,7 @@ namespace PVR
       CServiceBroker::GetGUI()->GetInfoManager().SetCurrentItem(*item);
 
     ShowInfo(false);
+    PreTuneNeighbours(true);
   }
 
   void CPVRGUIChannelNavigator::ClearPlayingChannel()
@@ -285,6 +314,8 @@ namespace PVR
     CSingleLock lock(m_critSection);
     m_playingChannel.reset();
     HideInfo();
+
+    CServiceBroker::GetPVRManager().GUIActions()->GetChannelPreTuner().Clear();
   }
 
 } // namespace PVR
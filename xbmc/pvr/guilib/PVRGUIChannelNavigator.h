@@ -98,6 +98,12 @@ namespace PVR
     void SelectChannel(const std::shared_ptr<CPVRChannelGroupMember>& groupMember,
                        ChannelSwitchMode eSwitchMode);
 
+    /*!
+     * @brief Pre-tune the channels next to the currently selected channel group member.
+     * @param bNext True if the next channel is more likely to be selected, false if the previous.
+     */
+    void PreTuneNeighbours(bool bNext);
+
     /*!
      * @brief Show the channel info OSD.
      * @param bForce True ignores value of SETTING_PVRMENU_DISPLAYCHANNELINFO and always activates the info, False acts aaccording settings value.
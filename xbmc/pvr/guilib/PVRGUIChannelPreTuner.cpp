@@ -0,0 +1,180 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PVRGUIChannelPreTuner.h"
+
+#include "ServiceBroker.h"
+#include "pvr/PVRManager.h"
+#include "pvr/PVRStreamProperties.h"
+#include "pvr/addons/PVRClient.h"
+#include "pvr/channels/PVRChannel.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+using namespace PVR;
+
+namespace
+{
+// stream urls may contain session tokens, do not use them for too long
+constexpr unsigned int PRETUNED_PROPERTIES_VALIDITY_MS = 30000;
+
+bool GetClientStreamProperties(const std::shared_ptr<CPVRChannel>& channel,
+                               CPVRStreamProperties& props)
+{
+  const std::shared_ptr<CPVRClient> client =
+      CServiceBroker::GetPVRManager().GetClient(channel->ClientID());
+  return client && client->GetChannelStreamProperties(channel, props) == PVR_ERROR_NO_ERROR;
+}
+} // unnamed namespace
+
+struct CPVRGUIChannelPreTuner::Slot
+{
+  explicit Slot(const std::shared_ptr<CPVRChannel>& slotChannel) : channel(slotChannel) {}
+
+  bool IsChannel(const std::shared_ptr<CPVRChannel>& otherChannel) const
+  {
+    return channel->StorageId() == otherChannel->StorageId();
+  }
+
+  bool IsResolved() { return resolved.WaitMSec(0); }
+
+  const std::shared_ptr<CPVRChannel> channel;
+
+  // written by the job before setting the event
+  CPVRStreamProperties props;
+  bool bSuccess = false;
+  XbmcThreads::EndTime expiry;
+  CEvent resolved{true};
+};
+
+CPVRGUIChannelPreTuner::CPVRGUIChannelPreTuner()
+  : m_resolve(GetClientStreamProperties), m_iSlots(-1), m_iValidityMs(PRETUNED_PROPERTIES_VALIDITY_MS)
+{
+}
+
+CPVRGUIChannelPreTuner::CPVRGUIChannelPreTuner(const ResolveFunction& resolve,
+                                               int iSlots,
+                                               unsigned int iValidityMs)
+  : m_resolve(resolve), m_iSlots(iSlots), m_iValidityMs(iValidityMs)
+{
+}
+
+CPVRGUIChannelPreTuner::~CPVRGUIChannelPreTuner() = default;
+
+int CPVRGUIChannelPreTuner::GetSlots() const
+{
+  if (m_iSlots >= 0)
+    return m_iSlots;
+
+  return CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iPVRPreTuneChannels;
+}
+
+bool CPVRGUIChannelPreTuner::IsEnabled() const
+{
+  return GetSlots() > 0;
+}
+
+void CPVRGUIChannelPreTuner::PreTune(const std::vector<std::shared_ptr<CPVRChannel>>& channels)
+{
+  const size_t iSlots = static_cast<size_t>(std::max(GetSlots(), 0));
+  if (iSlots == 0)
+    return;
+
+  CSingleLock lock(m_critSection);
+
+  // release slots of channels no longer predicted and expired or failed slots, unless the job
+  // is still running; running jobs keep their slot to bound the number of calls to the clients
+  m_slots.erase(std::remove_if(m_slots.begin(), m_slots.end(),
+                               [&channels](const std::shared_ptr<Slot>& slot) {
+                                 if (!slot->IsResolved())
+                                   return false;
+
+                                 if (!slot->bSuccess || slot->expiry.IsTimePast())
+                                   return true;
+
+                                 return std::none_of(
+                                     channels.cbegin(), channels.cend(),
+                                     [&slot](const std::shared_ptr<CPVRChannel>& channel) {
+                                       return channel && slot->IsChannel(channel);
+                                     });
+                               }),
+                m_slots.end());
+
+  for (const auto& channel : channels)
+  {
+    if (!channel)
+      continue;
+
+    if (std::any_of(m_slots.cbegin(), m_slots.cend(),
+                    [&channel](const std::shared_ptr<Slot>& slot) {
+                      return slot->IsChannel(channel);
+                    }))
+      continue;
+
+    if (m_slots.size() >= iSlots)
+      break;
+
+    const auto slot = std::make_shared<Slot>(channel);
+    m_slots.emplace_back(slot);
+
+    CLog::LogFC(LOGDEBUG, LOGPVR, "Pre-tuning channel '{}'", channel->ChannelName());
+
+    const ResolveFunction resolve = m_resolve;
+    const unsigned int iValidityMs = m_iValidityMs;
+    CJobManager::GetInstance().Submit(
+        [slot, resolve, iValidityMs]() {
+          slot->bSuccess = resolve(slot->channel, slot->props);
+          slot->expiry.Set(iValidityMs);
+          slot->resolved.Set();
+        },
+        CJob::PRIORITY_NORMAL);
+  }
+}
+
+bool CPVRGUIChannelPreTuner::GetStreamProperties(const std::shared_ptr<CPVRChannel>& channel,
+                                                 CPVRStreamProperties& props)
+{
+  std::shared_ptr<Slot> slot;
+  {
+    CSingleLock lock(m_critSection);
+    const auto it = std::find_if(m_slots.begin(), m_slots.end(),
+                                 [&channel](const std::shared_ptr<Slot>& candidate) {
+                                   return candidate->IsChannel(channel);
+                                 });
+    if (it == m_slots.end())
+      return false;
+
+    // pre-tuned properties are used once
+    slot = *it;
+    m_slots.erase(it);
+  }
+
+  // waiting for a running job is still faster than asking the client again
+  slot->resolved.Wait();
+
+  if (!slot->bSuccess || slot->expiry.IsTimePast())
+    return false;
+
+  CLog::LogFC(LOGDEBUG, LOGPVR, "Using pre-tuned stream properties of channel '{}'",
+              channel->ChannelName());
+  props = slot->props;
+  return true;
+}
+
+void CPVRGUIChannelPreTuner::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_slots.clear();
+}
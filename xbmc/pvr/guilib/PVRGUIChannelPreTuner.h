@@ -0,0 +1,91 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace PVR
+{
+  class CPVRChannel;
+  class CPVRStreamProperties;
+
+  /*!
+   * @brief Speculatively obtains the stream properties of the channels the user is likely to
+   * switch to next, in the background, so that a confirmed channel switch does not have to wait
+   * for the PVR client. The number of channels pre-tuned at the same time is bounded by the number
+   * of slots, pre-tuned properties are used once and expire after a short time.
+   */
+  class CPVRGUIChannelPreTuner
+  {
+  public:
+    using ResolveFunction = std::function<bool(const std::shared_ptr<CPVRChannel>& channel,
+                                               CPVRStreamProperties& props)>;
+
+    /*!
+     * @brief Create a pre-tuner obtaining the properties from the channel's PVR client, with the
+     * number of slots configured in advanced settings.
+     */
+    CPVRGUIChannelPreTuner();
+
+    /*!
+     * @brief Create a pre-tuner.
+     * @param resolve The function obtaining the stream properties of a channel.
+     * @param iSlots The maximum number of channels to pre-tune at the same time, 0 to disable.
+     * @param iValidityMs The time in milliseconds pre-tuned properties stay valid.
+     */
+    CPVRGUIChannelPreTuner(const ResolveFunction& resolve, int iSlots, unsigned int iValidityMs);
+
+    virtual ~CPVRGUIChannelPreTuner();
+
+    /*!
+     * @brief Check whether pre-tuning is enabled.
+     * @return True if enabled, false otherwise.
+     */
+    bool IsEnabled() const;
+
+    /*!
+     * @brief Pre-tune the given channels. Slots of channels not given anymore are released, as
+     * soon as their properties were obtained.
+     * @param channels The channels, the most likely switch target first.
+     */
+    void PreTune(const std::vector<std::shared_ptr<CPVRChannel>>& channels);
+
+    /*!
+     * @brief Take the pre-tuned stream properties of a channel, waiting for them if they are
+     * still being obtained.
+     * @param channel The channel.
+     * @param props The properties.
+     * @return True if pre-tuned properties were available, false otherwise.
+     */
+    bool GetStreamProperties(const std::shared_ptr<CPVRChannel>& channel,
+                             CPVRStreamProperties& props);
+
+    /*!
+     * @brief Release all slots.
+     */
+    void Clear();
+
+  private:
+    struct Slot;
+
+    int GetSlots() const;
+
+    const ResolveFunction m_resolve;
+    const int m_iSlots; // -1 for the advanced setting
+    const unsigned int m_iValidityMs;
+
+    mutable CCriticalSection m_critSection;
+    std::vector<std::shared_ptr<Slot>> m_slots;
+  };
+
+} // namespace PVR
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "XBDateTime.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "pvr/PVRManager.h"
+#include "pvr/channels/PVRChannel.h"
+#include "pvr/channels/PVRChannelGroupMember.h"
+#include "pvr/channels/PVRChannelNumber.h"
+#include "pvr/epg/Epg.h"
+#include "pvr/epg/EpgContainer.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/guilib/GUIEPGGridContainerModel.h"
+#include "pvr/test/PVRMockBackend.h"
+#include "pvr/test/PVRTestFixture.h"
+#include "settings/AdvancedSettings.h"
+
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+constexpr int CLIENT_ID = 1;
+constexpr int EVENT_SECONDS = 30 * 60;
+constexpr int GUIDE_EVENTS = 24; // twelve hours
+constexpr int BLOCKS_PER_PAGE = 36; // three hours
+
+using Clock = std::chrono::steady_clock;
+
+int Milliseconds(Clock::duration duration)
+{
+  return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+}
+} // unnamed namespace
+
+/*!
+ * @brief Measures the guide grid refresh after EPG changes of a few channels against rebuilding the
+ * grid model, which is what every EPG change used to cost. The channel EPGs are created by the EPG
+ * container of the (not started) PVR manager of the fixture.
+ */
+class TestGUIEPGGridContainerModel : public CPVRTestFixture
+{
+protected:
+  DatabaseSettings epgSettings;
+  std::unique_ptr<CFileItemList> channelItems;
+  time_t guideStart = 0;
+
+  void SetUp() override
+  {
+    CPVRTestFixture::SetUp();
+
+    epgSettings.type = "sqlite3";
+    epgSettings.name = "TestGUIEPGGridContainerModelEpg";
+    epgSettings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    XFILE::CFile::Delete(epgSettings.host + epgSettings.name + ".db");
+
+    const std::shared_ptr<CPVREpgDatabase> database =
+        CServiceBroker::GetPVRManager().EpgContainer().GetEpgDatabase();
+    ASSERT_TRUE(database->Connect(epgSettings.name, epgSettings, true));
+
+    // the guide starts with the event before the current one
+    CDateTime::GetUTCDateTime().GetAsTime(guideStart);
+    guideStart -= guideStart % EVENT_SECONDS + EVENT_SECONDS;
+  }
+
+  void TearDown() override
+  {
+    channelItems.reset();
+    CServiceBroker::GetPVRManager().EpgContainer().Unload(); // closes the database
+    XFILE::CFile::Delete(epgSettings.host + epgSettings.name + ".db");
+
+    CPVRTestFixture::TearDown();
+  }
+
+  /*!
+   * @brief Create the channel items of the grid with twelve hours of events each.
+   */
+  void CreateChannels(int iChannels)
+  {
+    channelItems = std::make_unique<CFileItemList>();
+
+    CPVRMockBackend::Settings settings;
+    settings.iChannels = iChannels;
+    CPVRMockBackend(settings).GetChannels([this](const PVR_CHANNEL& data) {
+      const auto channel = std::make_shared<CPVRChannel>(data, CLIENT_ID);
+      const CPVRChannelNumber number(data.iChannelNumber, 0);
+      channelItems->Add(std::make_shared<CFileItem>(std::make_shared<CPVRChannelGroupMember>(
+          channel, "All channels", number, 0, data.iChannelNumber, number)));
+
+      const std::shared_ptr<CPVREpg> epg = channel->GetEPG();
+      ASSERT_NE(nullptr, epg);
+      for (int i = 0; i < GUIDE_EVENTS; i++)
+      {
+        const EPG_TAG tag = CreateEvent(data.iUniqueId, i, "Show");
+        ASSERT_TRUE(epg->UpdateEntry(&tag, CLIENT_ID));
+      }
+    });
+  }
+
+  EPG_TAG CreateEvent(int iChannelUid, int iEvent, const char* strTitle) const
+  {
+    EPG_TAG tag = {};
+    tag.iUniqueBroadcastId = iEvent + 1;
+    tag.iUniqueChannelId = iChannelUid;
+    tag.strTitle = strTitle;
+    tag.startTime = guideStart + iEvent * EVENT_SECONDS;
+    tag.endTime = tag.startTime + EVENT_SECONDS;
+    tag.iEpisodePartNumber = -1;
+    return tag;
+  }
+
+  /*!
+   * @brief Rename the current event of a channel the way a backend pushing an event change does.
+   */
+  void ChangeCurrentEvent(int iChannel)
+  {
+    const std::shared_ptr<CPVRChannel> channel =
+        channelItems->Get(iChannel)->GetPVRChannelInfoTag();
+    const std::shared_ptr<CPVREpg> epg = channel->GetEPG();
+
+    const EPG_TAG data = CreateEvent(channel->UniqueID(), 1, "Changed");
+    const auto tag = std::make_shared<CPVREpgInfoTag>(data, CLIENT_ID, epg->GetChannelData(),
+                                                      epg->EpgID());
+    ASSERT_TRUE(epg->UpdateEntry(tag, EPG_EVENT_UPDATED));
+  }
+
+  void Initialize(CGUIEPGGridContainerModel& model) const
+  {
+    CDateTime gridStart;
+    gridStart.SetFromUTCDateTime(guideStart);
+    CDateTime gridEnd;
+    gridEnd.SetFromUTCDateTime(guideStart + GUIDE_EVENTS * EVENT_SECONDS);
+    model.Initialize(channelItems, gridStart, gridEnd, 0, channelItems->Size(), 0,
+                     BLOCKS_PER_PAGE, 6, 10.0f);
+  }
+
+  /*!
+   * @brief Request the grid items of the first page of every channel, as scrolling through all
+   * channels does.
+   */
+  static void FillPage(const CGUIEPGGridContainerModel& model)
+  {
+    for (int iChannel = 0; iChannel < model.ChannelItemsSize(); iChannel++)
+    {
+      for (int iBlock = 0; iBlock < BLOCKS_PER_PAGE; iBlock++)
+        ASSERT_NE(nullptr, model.GetGridItem(iChannel, iBlock));
+    }
+  }
+
+  std::string GetCurrentTitle(const CGUIEPGGridContainerModel& model, int iChannel) const
+  {
+    CDateTime eventStart;
+    eventStart.SetFromUTCDateTime(guideStart + EVENT_SECONDS);
+    return model.GetGridItem(iChannel, model.GetBlock(eventStart))->GetEPGInfoTag()->Title();
+  }
+
+  void RefreshChangedChannels(int iChannels, int iChangedChannels)
+  {
+    CreateChannels(iChannels);
+
+    CGUIEPGGridContainerModel model;
+    Initialize(model);
+
+    Clock::time_point start = Clock::now();
+    FillPage(model);
+    const Clock::duration fill = Clock::now() - start;
+
+    for (int i = 0; i < iChangedChannels; i++)
+      ChangeCurrentEvent(i * iChannels / iChangedChannels);
+
+    start = Clock::now();
+    EXPECT_EQ(iChangedChannels, model.RefreshChangedEpgs());
+    FillPage(model);
+    const Clock::duration refresh = Clock::now() - start;
+
+    EXPECT_EQ("Changed", GetCurrentTitle(model, 0));
+    EXPECT_EQ("Show", GetCurrentTitle(model, 1));
+
+    // what every EPG change cost before
+    start = Clock::now();
+    CGUIEPGGridContainerModel rebuilt;
+    Initialize(rebuilt);
+    FillPage(rebuilt);
+    const Clock::duration rebuild = Clock::now() - start;
+
+    RecordProperty("channels", iChannels);
+    RecordProperty("changed_channels", iChangedChannels);
+    RecordProperty("fill_ms", Milliseconds(fill));
+    RecordProperty("refresh_ms", Milliseconds(refresh));
+    RecordProperty("rebuild_ms", Milliseconds(rebuild));
+  }
+};
+
+TEST_F(TestGUIEPGGridContainerModel, RefreshChangedChannels)
+{
+  RefreshChangedChannels(50, 5);
+}
+
+TEST_F(TestGUIEPGGridContainerModel, DISABLED_RefreshChangedChannelsLarge)
+{
+  RefreshChangedChannels(1000, 10);
+}
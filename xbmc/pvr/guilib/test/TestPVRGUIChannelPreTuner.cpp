@@ -0,0 +1,160 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "pvr/PVRStreamProperties.h"
+#include "pvr/channels/PVRChannel.h"
+#include "pvr/guilib/PVRGUIChannelPreTuner.h"
+#include "pvr/test/PVRMockBackend.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+constexpr int CLIENT_ID = 1;
+constexpr int TUNE_LATENCY_MS = 100;
+
+using Clock = std::chrono::steady_clock;
+} // unnamed namespace
+
+class TestPVRGUIChannelPreTuner : public ::testing::Test
+{
+protected:
+  TestPVRGUIChannelPreTuner() : backend(GetSettings())
+  {
+    backend.GetChannels([this](const PVR_CHANNEL& channel) {
+      channels.emplace_back(std::make_shared<CPVRChannel>(channel, CLIENT_ID));
+    });
+  }
+
+  static CPVRMockBackend::Settings GetSettings()
+  {
+    CPVRMockBackend::Settings settings;
+    settings.iChannels = 20;
+    settings.iTuneLatencyMs = TUNE_LATENCY_MS;
+    return settings;
+  }
+
+  /*!
+   * @brief Obtain the stream properties from the backend, like a PVR client does.
+   */
+  bool Resolve(const std::shared_ptr<CPVRChannel>& channel, CPVRStreamProperties& props)
+  {
+    iResolveCalls++;
+    backend.GetChannelStreamProperties(channel->UniqueID(), [&props](const PVR_NAMED_VALUE& value) {
+      props.emplace_back(value.strName, value.strValue);
+    });
+    return true;
+  }
+
+  CPVRGUIChannelPreTuner::ResolveFunction GetResolveFunction()
+  {
+    return [this](const std::shared_ptr<CPVRChannel>& channel, CPVRStreamProperties& props) {
+      return Resolve(channel, props);
+    };
+  }
+
+  static std::string GetStreamURL(const std::shared_ptr<CPVRChannel>& channel)
+  {
+    return "http://backend/live/" + std::to_string(channel->UniqueID()) + ".ts";
+  }
+
+  /*!
+   * @brief Zap through the channels, staying on each channel for a moment.
+   * @return The average time in milliseconds it took to obtain the stream properties on a switch.
+   */
+  double Zap(CPVRGUIChannelPreTuner* preTuner, size_t iSwitches)
+  {
+    Clock::duration total{};
+    for (size_t i = 1; i <= iSwitches; i++)
+    {
+      if (preTuner)
+        preTuner->PreTune({channels[i + 1], channels[i - 1]});
+
+      // the user watches the channel for a moment
+      std::this_thread::sleep_for(std::chrono::milliseconds(3 * TUNE_LATENCY_MS));
+
+      const std::shared_ptr<CPVRChannel>& channel = channels[i + 1];
+      const auto start = Clock::now();
+      CPVRStreamProperties props;
+      if (!preTuner || !preTuner->GetStreamProperties(channel, props))
+        Resolve(channel, props);
+      total += Clock::now() - start;
+
+      EXPECT_EQ(GetStreamURL(channel), props.GetStreamURL());
+    }
+    return std::chrono::duration<double, std::milli>(total).count() / iSwitches;
+  }
+
+  CPVRMockBackend backend;
+  std::vector<std::shared_ptr<CPVRChannel>> channels;
+  std::atomic<int> iResolveCalls{0};
+};
+
+TEST_F(TestPVRGUIChannelPreTuner, Disabled)
+{
+  CPVRGUIChannelPreTuner preTuner(GetResolveFunction(), 0, 30000);
+  EXPECT_FALSE(preTuner.IsEnabled());
+
+  preTuner.PreTune({channels[0]});
+  CPVRStreamProperties props;
+  EXPECT_FALSE(preTuner.GetStreamProperties(channels[0], props));
+  EXPECT_EQ(0, iResolveCalls);
+}
+
+TEST_F(TestPVRGUIChannelPreTuner, BoundedSlots)
+{
+  CPVRGUIChannelPreTuner preTuner(GetResolveFunction(), 2, 30000);
+  EXPECT_TRUE(preTuner.IsEnabled());
+
+  preTuner.PreTune({channels[0], channels[1], channels[2], channels[3]});
+
+  CPVRStreamProperties props;
+  EXPECT_TRUE(preTuner.GetStreamProperties(channels[0], props));
+  EXPECT_EQ(GetStreamURL(channels[0]), props.GetStreamURL());
+  EXPECT_TRUE(preTuner.GetStreamProperties(channels[1], props));
+  EXPECT_FALSE(preTuner.GetStreamProperties(channels[2], props));
+  EXPECT_EQ(2, iResolveCalls);
+
+  // pre-tuned properties are used once
+  EXPECT_FALSE(preTuner.GetStreamProperties(channels[0], props));
+}
+
+TEST_F(TestPVRGUIChannelPreTuner, Expiry)
+{
+  CPVRGUIChannelPreTuner preTuner(GetResolveFunction(), 2, 0);
+  preTuner.PreTune({channels[0]});
+
+  CPVRStreamProperties props;
+  EXPECT_FALSE(preTuner.GetStreamProperties(channels[0], props));
+  EXPECT_EQ(1, iResolveCalls);
+}
+
+TEST_F(TestPVRGUIChannelPreTuner, ZapLatency)
+{
+  const double directMs = Zap(nullptr, 5);
+
+  CPVRGUIChannelPreTuner preTuner(GetResolveFunction(), 2, 30000);
+  const double preTunedMs = Zap(&preTuner, 5);
+  preTuner.Clear();
+
+  RecordProperty("tune_latency_ms", TUNE_LATENCY_MS);
+  RecordProperty("direct_zap_ms", static_cast<int>(directMs));
+  RecordProperty("pretuned_zap_ms", static_cast<int>(preTunedMs));
+
+  EXPECT_GE(directMs, TUNE_LATENCY_MS * 0.9);
+  EXPECT_LT(preTunedMs, TUNE_LATENCY_MS / 2);
+}
@@ -376,6 +376,23 @@ void CPVRRecording::UpdateMetadata(CVideoDatabase& db, const CPVRClient& client)
   m_bGotMetaData = true;
 }
 
+void CPVRRecording::UpdateMetadata(int iPlayCount,
+                                   const CBookmark& resumePoint,
+                                   const CPVRClient& client)
+{
+  if (m_bGotMetaData)
+    return;
+
+  if (!client.GetClientCapabilities().SupportsRecordingsPlayCount())
+    CVideoInfoTag::SetPlayCount(iPlayCount);
+
+  if (!client.GetClientCapabilities().SupportsRecordingsLastPlayedPosition() &&
+      resumePoint.IsSet())
+    CVideoInfoTag::SetResumePoint(resumePoint);
+
+  m_bGotMetaData = true;
+}
+
 std::vector<PVR_EDL_ENTRY> CPVRRecording::GetEdl() const
 {
   std::vector<PVR_EDL_ENTRY> edls;
@@ -190,6 +190,15 @@ namespace PVR
      */
     void UpdateMetadata(CVideoDatabase& db, const CPVRClient& client);
 
+    /*!
+     * @brief Set the resume point and play count read from the database in advance, if the
+     * client doesn't handle it itself.
+     * @param iPlayCount The play count.
+     * @param resumePoint The resume point.
+     * @param client The client this recording belongs to.
+     */
+    void UpdateMetadata(int iPlayCount, const CBookmark& resumePoint, const CPVRClient& client);
+
     /*!
      * @brief Update this tag with the contents of the given tag.
      * @param tag The new tag info.
@@ -9,22 +9,155 @@
 #include "PVRRecordings.h"
 
 #include "ServiceBroker.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_recordings.h"
+#include "pvr/PVRDatabase.h"
 #include "pvr/PVRManager.h"
+#include "pvr/addons/PVRClient.h"
 #include "pvr/addons/PVRClients.h"
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/recordings/PVRRecording.h"
 #include "pvr/recordings/PVRRecordingsPath.h"
 #include "threads/SingleLock.h"
+#include "utils/Stopwatch.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 #include "video/VideoDatabase.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <utility>
 #include <vector>
 
 using namespace PVR;
 
+namespace
+{
+using RecordingsMetadata = std::map<std::string, std::pair<int, CBookmark>>;
+
+class CDataHash
+{
+public:
+  template<typename T>
+  void Add(const T& value)
+  {
+    Add(reinterpret_cast<const unsigned char*>(&value), sizeof(value));
+  }
+
+  template<size_t N>
+  void Add(const char (&value)[N])
+  {
+    // the string and its terminator, so that neighbouring strings can not shift into each other
+    Add(reinterpret_cast<const unsigned char*>(value), strnlen(value, N - 1) + 1);
+  }
+
+  unsigned int Get() const { return m_hash; }
+
+private:
+  void Add(const unsigned char* data, size_t size)
+  {
+    // FNV-1a
+    for (size_t i = 0; i < size; ++i)
+    {
+      m_hash ^= data[i];
+      m_hash *= 16777619u;
+    }
+  }
+
+  uint32_t m_hash = 2166136261u;
+};
+
+/*!
+ * @brief Hash the client data of a recording, to tell whether it changed since the last update.
+ * The client API has no modification time for recordings, the data itself is the only reliable
+ * indicator of changes.
+ */
+unsigned int GetDataHash(const PVR_RECORDING& recording)
+{
+  CDataHash hash;
+  hash.Add(recording.strRecordingId);
+  hash.Add(recording.strTitle);
+  hash.Add(recording.strEpisodeName);
+  hash.Add(recording.iSeriesNumber);
+  hash.Add(recording.iEpisodeNumber);
+  hash.Add(recording.iYear);
+  hash.Add(recording.strDirectory);
+  hash.Add(recording.strPlotOutline);
+  hash.Add(recording.strPlot);
+  hash.Add(recording.strGenreDescription);
+  hash.Add(recording.strChannelName);
+  hash.Add(recording.strIconPath);
+  hash.Add(recording.strThumbnailPath);
+  hash.Add(recording.strFanartPath);
+  hash.Add(static_cast<int64_t>(recording.recordingTime));
+  hash.Add(recording.iDuration);
+  hash.Add(recording.iPriority);
+  hash.Add(recording.iLifetime);
+  hash.Add(recording.iGenreType);
+  hash.Add(recording.iGenreSubType);
+  hash.Add(recording.iPlayCount);
+  hash.Add(recording.iLastPlayedPosition);
+  hash.Add(recording.bIsDeleted);
+  hash.Add(recording.iEpgEventId);
+  hash.Add(recording.iChannelUid);
+  hash.Add(recording.channelType);
+  hash.Add(recording.strFirstAired);
+  hash.Add(recording.iFlags);
+  hash.Add(recording.sizeInBytes);
+  return hash.Get();
+}
+
+/*!
+ * @brief Get play counts and resume points of all recordings with a single video db query,
+ * instead of two queries per recording.
+ */
+RecordingsMetadata GetMetadata()
+{
+  RecordingsMetadata metadata;
+
+  CVideoDatabase db;
+  if (db.Open())
+  {
+    db.GetPlayCountsAndResumePoints(CPVRRecordingsPath::PATH_RECORDINGS, metadata);
+    db.Close();
+  }
+  else
+  {
+    CLog::LogF(LOGERROR, "Failed to open the video database");
+  }
+
+  return metadata;
+}
+
+void ApplyMetadata(CPVRRecording& tag, const CPVRClient& client, const RecordingsMetadata& metadata)
+{
+  const auto it = metadata.find(tag.m_strFileNameAndPath);
+  if (it != metadata.cend())
+    tag.UpdateMetadata(it->second.first, it->second.second, client);
+  else
+    tag.UpdateMetadata(0, CBookmark(), client);
+}
+} // unnamed namespace
+
+/*!
+ * @brief The state of an update, written by the clients delivering their recordings.
+ */
+struct CPVRRecordings::SyncState
+{
+  struct ChangedRecording
+  {
+    std::shared_ptr<CPVRRecording> tag;
+    std::string strPersistQuery; // to update the database cache after the fetch
+    unsigned int iDataHash;
+  };
+
+  std::shared_ptr<CPVRDatabase> database;
+  std::map<CPVRRecordingUid, unsigned int> knownHashes;
+
+  std::vector<CPVRRecordingUid> unchanged;
+  std::vector<ChangedRecording> changed;
+};
+
 CPVRRecordings::CPVRRecordings() = default;
 
 CPVRRecordings::~CPVRRecordings()
@@ -35,30 +168,185 @@ CPVRRecordings::~CPVRRecordings()
 
 void CPVRRecordings::UpdateFromClients()
 {
-  CSingleLock lock(m_critSection);
+  CStopWatch timer;
+  timer.StartZero();
 
-  for (const auto& recording : m_recordings)
-    recording.second->SetDirty(true);
+  const std::shared_ptr<CPVRDatabase> database = CServiceBroker::GetPVRManager().GetTVDatabase();
+  auto syncState = std::make_unique<SyncState>();
+  syncState->database = database;
+  {
+    CSingleLock lock(m_critSection);
+    syncState->knownHashes = m_dataHashes;
+  }
+  {
+    CSingleLock lock(m_syncCritSection);
+    m_syncState = std::move(syncState);
+  }
 
+  // the clients deliver their recordings concurrently, without holding m_critSection
   std::vector<int> failedClients;
   CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, false, failedClients);
   CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, true, failedClients);
 
-  // remove recordings that were deleted at the backend
-  for (auto it = m_recordings.begin(); it != m_recordings.end();)
   {
-    if ((*it).second->IsDirty() && std::find(failedClients.begin(), failedClients.end(),
-                                             (*it).second->ClientID()) == failedClients.end())
-      it = m_recordings.erase(it);
-    else
-      ++it;
+    CSingleLock lock(m_syncCritSection);
+    syncState = std::move(m_syncState);
   }
+
+  const int64_t iFetchMs = timer.GetElapsedMilliseconds();
+  timer.StartZero();
+
+  // the video db is only needed for recordings new to this session
+  const bool bHaveNewRecordings = std::any_of(
+      syncState->changed.cbegin(), syncState->changed.cend(), [&syncState](const auto& entry) {
+        const CPVRRecordingUid uid(entry.tag->m_iClientId, entry.tag->m_strRecordingId);
+        return syncState->knownHashes.find(uid) == syncState->knownHashes.cend();
+      });
+  const RecordingsMetadata metadata = bHaveNewRecordings ? GetMetadata() : RecordingsMetadata();
+
+  size_t iNew = 0;
+  size_t iChanged = 0;
+  std::vector<CPVRRecordingUid> removed;
+  {
+    CSingleLock lock(m_critSection);
+
+    for (const auto& recording : m_recordings)
+      recording.second->SetDirty(true);
+
+    for (const auto& uid : syncState->unchanged)
+    {
+      const auto it = m_recordings.find(uid);
+      if (it != m_recordings.end())
+        it->second->SetDirty(false);
+    }
+
+    std::map<int, std::shared_ptr<CPVRClient>> clients;
+    for (const auto& entry : syncState->changed)
+    {
+      const std::shared_ptr<CPVRRecording>& tag = entry.tag;
+
+      auto clientIt = clients.find(tag->m_iClientId);
+      if (clientIt == clients.end())
+        clientIt = clients.insert(
+            {tag->m_iClientId, CServiceBroker::GetPVRManager().GetClient(tag->m_iClientId)}).first;
+
+      const std::shared_ptr<CPVRClient>& client = clientIt->second;
+      if (!client)
+        continue;
+
+      const CPVRRecordingUid uid(tag->m_iClientId, tag->m_strRecordingId);
+      const auto it = m_recordings.find(uid);
+      if (it != m_recordings.end())
+      {
+        it->second->Update(*tag, *client);
+        it->second->SetDirty(false);
+        m_dataHashes[uid] = entry.iDataHash;
+        ++iChanged;
+      }
+      else
+      {
+        ApplyMetadata(*tag, *client, metadata);
+        InsertRecording(tag, entry.iDataHash);
+        ++iNew;
+      }
+    }
+
+    // remove recordings that were deleted at the backend
+    for (auto it = m_recordings.begin(); it != m_recordings.end();)
+    {
+      if ((*it).second->IsDirty() && std::find(failedClients.begin(), failedClients.end(),
+                                               (*it).second->ClientID()) == failedClients.end())
+      {
+        removed.emplace_back(it->first);
+        m_dataHashes.erase(it->first);
+        it = m_recordings.erase(it);
+      }
+      else
+        ++it;
+    }
+
+    UpdateCounters();
+  }
+
+  const int64_t iApplyMs = timer.GetElapsedMilliseconds();
+  timer.StartZero();
+
+  if (database)
+  {
+    // other users of the database commit its queue as well, only fill it while it is locked
+    database->Lock();
+    for (const auto& entry : syncState->changed)
+    {
+      if (!entry.strPersistQuery.empty())
+        database->QueueInsertQuery(entry.strPersistQuery);
+    }
+    for (const auto& uid : removed)
+      database->QueueDeleteQuery(uid);
+    database->CommitQueuedQueries();
+    database->Unlock();
+  }
+
+  CLog::LogFC(LOGDEBUG, LOGPVR,
+              "Updated recordings: {} new, {} changed, {} unchanged, {} removed (fetch {} ms, "
+              "apply {} ms, persist {} ms)",
+              iNew, iChanged, syncState->unchanged.size(), removed.size(), iFetchMs, iApplyMs,
+              timer.GetElapsedMilliseconds());
+}
+
+int CPVRRecordings::LoadFromDatabase()
+{
+  const std::shared_ptr<CPVRDatabase> database = CServiceBroker::GetPVRManager().GetTVDatabase();
+  if (!database)
+    return 0;
+
+  CStopWatch timer;
+  timer.StartZero();
+
+  CPVRClientMap clients;
+  CServiceBroker::GetPVRManager().Clients()->GetCreatedClients(clients);
+
+  std::vector<std::pair<std::shared_ptr<CPVRRecording>, unsigned int>> tags;
+  database->GetRecordings(
+      [&clients, &tags](const PVR_RECORDING& recording, int iClientId, unsigned int iDataHash) {
+        // recordings of clients not created (yet) are kept in the cache for later sessions
+        if (clients.find(iClientId) != clients.cend())
+          tags.emplace_back(std::make_shared<CPVRRecording>(recording, iClientId), iDataHash);
+      });
+
+  if (tags.empty())
+    return 0;
+
+  const RecordingsMetadata metadata = GetMetadata();
+
+  CSingleLock lock(m_critSection);
+  for (const auto& entry : tags)
+  {
+    ApplyMetadata(*entry.first, *clients[entry.first->m_iClientId], metadata);
+    InsertRecording(entry.first, entry.second);
+  }
+  UpdateCounters();
+
+  CLog::LogFC(LOGDEBUG, LOGPVR, "Loaded {} cached recordings in {} ms", m_recordings.size(),
+              timer.GetElapsedMilliseconds());
+  return m_recordings.size();
 }
 
 int CPVRRecordings::Load()
 {
   Unload();
-  Update();
+
+  if (LoadFromDatabase() > 0)
+  {
+    // show the cached recordings right away and sync them with the clients in the background
+    CServiceBroker::GetPVRManager().PublishEvent(PVREvent::RecordingsInvalidated);
+    CServiceBroker::GetPVRManager().TriggerRecordingsUpdate();
+  }
+  else
+  {
+    Update();
+  }
+
+  CSingleLock lock(m_critSection);
   return m_recordings.size();
 }
 
@@ -70,6 +358,7 @@ void CPVRRecordings::Unload()
   m_iTVRecordings = 0;
   m_iRadioRecordings = 0;
   m_recordings.clear();
+  m_dataHashes.clear();
 }
 
 void CPVRRecordings::Update()
@@ -199,34 +488,71 @@ std::shared_ptr<CPVRRecording> CPVRRecordings::GetById(int iClientId, const std:
   return retVal;
 }
 
-void CPVRRecordings::UpdateFromClient(const std::shared_ptr<CPVRRecording>& tag,
-                                      const CPVRClient& client)
+void CPVRRecordings::UpdateFromClient(const PVR_RECORDING& recording, const CPVRClient& client)
 {
-  CSingleLock lock(m_critSection);
-
-  if (tag->IsDeleted())
+  const unsigned int iDataHash = GetDataHash(recording);
+  std::shared_ptr<CPVRDatabase> database;
   {
-    if (tag->IsRadio())
-      m_bDeletedRadioRecordings = true;
-    else
-      m_bDeletedTVRecordings = true;
-  }
+    CSingleLock lock(m_syncCritSection);
+    if (!m_syncState)
+    {
+      CLog::LogF(LOGERROR, "No recordings update in progress");
+      return;
+    }
 
-  std::shared_ptr<CPVRRecording> existingTag = GetById(tag->m_iClientId, tag->m_strRecordingId);
-  if (existingTag)
-  {
-    existingTag->Update(*tag, client);
-    existingTag->SetDirty(false);
+    const auto it = m_syncState->knownHashes.find(
+        CPVRRecordingUid(client.GetID(), recording.strRecordingId));
+    if (it != m_syncState->knownHashes.cend() && it->second == iDataHash)
+    {
+      m_syncState->unchanged.emplace_back(it->first);
+      return;
+    }
+    database = m_syncState->database;
   }
-  else
+
+  const std::shared_ptr<CPVRRecording> tag =
+      std::make_shared<CPVRRecording>(recording, client.GetID());
+
+  // keep the row instead of the client data, whose fixed size strings take about 11 KB
+  std::string strPersistQuery;
+  if (database)
+    strPersistQuery = database->GetPersistQuery(recording, client.GetID(), iDataHash);
+
+  CSingleLock lock(m_syncCritSection);
+  m_syncState->changed.push_back({tag, std::move(strPersistQuery), iDataHash});
+}
+
+void CPVRRecordings::InsertRecording(const std::shared_ptr<CPVRRecording>& tag,
+                                     unsigned int iDataHash)
+{
+  const CPVRRecordingUid uid(tag->m_iClientId, tag->m_strRecordingId);
+  tag->m_iRecordingId = ++m_iLastId;
+  m_recordings.insert({uid, tag});
+  m_dataHashes[uid] = iDataHash;
+}
+
+void CPVRRecordings::UpdateCounters()
+{
+  m_bDeletedTVRecordings = false;
+  m_bDeletedRadioRecordings = false;
+  m_iTVRecordings = 0;
+  m_iRadioRecordings = 0;
+
+  for (const auto& recording : m_recordings)
   {
-    tag->UpdateMetadata(GetVideoDatabase(), client);
-    tag->m_iRecordingId = ++m_iLastId;
-    m_recordings.insert({CPVRRecordingUid(tag->m_iClientId, tag->m_strRecordingId), tag});
+    const std::shared_ptr<CPVRRecording>& tag = recording.second;
     if (tag->IsRadio())
+    {
       ++m_iRadioRecordings;
+      if (tag->IsDeleted())
+        m_bDeletedRadioRecordings = true;
+    }
     else
+    {
       ++m_iTVRecordings;
+      if (tag->IsDeleted())
+        m_bDeletedTVRecordings = true;
+    }
   }
 }
 
@@ -17,6 +17,8 @@
 
 class CVideoDatabase;
 
+struct PVR_RECORDING;
+
 namespace PVR
 {
   class CPVRClient;
@@ -43,11 +45,12 @@ namespace PVR
     void Unload();
 
     /*!
-     * @brief client has delivered a new/updated recording.
-     * @param tag The recording
+     * @brief client has delivered a new/updated recording. Called concurrently for different
+     * clients while the recordings are updated.
+     * @param recording The recording
      * @param client The client the recording belongs to.
      */
-    void UpdateFromClient(const std::shared_ptr<CPVRRecording>& tag, const CPVRClient& client);
+    void UpdateFromClient(const PVR_RECORDING& recording, const CPVRClient& client);
 
     /*!
      * @brief refresh the recordings list from the clients.
@@ -97,6 +100,8 @@ namespace PVR
     std::shared_ptr<CPVRRecording> GetRecordingForEpgTag(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const;
 
   private:
+    struct SyncState;
+
     mutable CCriticalSection m_critSection;
     bool m_bIsUpdating = false;
     std::map<CPVRRecordingUid, std::shared_ptr<CPVRRecording>> m_recordings;
@@ -106,9 +111,31 @@ namespace PVR
     bool m_bDeletedRadioRecordings = false;
     unsigned int m_iTVRecordings = 0;
     unsigned int m_iRadioRecordings = 0;
+    std::map<CPVRRecordingUid, unsigned int> m_dataHashes;
+
+    CCriticalSection m_syncCritSection;
+    std::unique_ptr<SyncState> m_syncState;
 
     void UpdateFromClients();
 
+    /*!
+     * @brief Load the recordings of the created clients from the local cache.
+     * @return the number of recordings loaded.
+     */
+    int LoadFromDatabase();
+
+    /*!
+     * @brief Add a recording unknown so far. m_critSection must be held.
+     * @param tag The recording.
+     * @param iDataHash The hash of the client data of the recording.
+     */
+    void InsertRecording(const std::shared_ptr<CPVRRecording>& tag, unsigned int iDataHash);
+
+    /*!
+     * @brief Recount the tv and radio recordings. m_critSection must be held.
+     */
+    void UpdateCounters();
+
     /*!
      * @brief Get/Open the video database.
      * @return A reference to the video database.
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PVRMockBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace PVR;
+
+namespace
+{
+template<size_t N>
+void Copy(char (&target)[N], const std::string& source)
+{
+  source.copy(target, N - 1);
+  target[std::min(source.size(), N - 1)] = '\0';
+}
+} // unnamed namespace
+
+void CPVRMockBackend::GetChannels(const std::function<void(const PVR_CHANNEL&)>& transfer) const
+{
+  for (int i = 1; i <= m_settings.iChannels; i++)
+  {
+    PVR_CHANNEL channel = {};
+    channel.iUniqueId = i;
+    channel.iChannelNumber = i;
+    Copy(channel.strChannelName, "Channel " + std::to_string(i));
+    Copy(channel.strIconPath, "http://backend/icons/" + std::to_string(i) + ".png");
+    channel.bHasArchive = (i % 4 == 0);
+    transfer(channel);
+  }
+}
+
+void CPVRMockBackend::GetChannelGroups(
+    const std::function<void(const PVR_CHANNEL_GROUP&)>& transfer) const
+{
+  for (int i = 1; i <= m_settings.iGroups; i++)
+  {
+    PVR_CHANNEL_GROUP group = {};
+    Copy(group.strGroupName, "Group " + std::to_string(i));
+    group.iPosition = i;
+    transfer(group);
+  }
+}
+
+void CPVRMockBackend::GetChannelGroupMembers(
+    const PVR_CHANNEL_GROUP& group,
+    const std::function<void(const PVR_CHANNEL_GROUP_MEMBER&)>& transfer) const
+{
+  if (m_settings.iChannels <= 0)
+    return;
+
+  const int iFirst = (static_cast<int>(group.iPosition) * 37) % m_settings.iChannels;
+  for (int i = 0; i < m_settings.iChannelsPerGroup && i < m_settings.iChannels; i++)
+  {
+    PVR_CHANNEL_GROUP_MEMBER member = {};
+    Copy(member.strGroupName, group.strGroupName);
+    member.iChannelUniqueId = (iFirst + i) % m_settings.iChannels + 1;
+    member.iChannelNumber = i + 1;
+    member.iOrder = i + 1;
+    transfer(member);
+  }
+}
+
+void CPVRMockBackend::GetEPGForChannel(int iChannelUid,
+                                       time_t start,
+                                       time_t end,
+                                       const std::function<void(const EPG_TAG&)>& transfer) const
+{
+  const time_t guideEnd = GUIDE_START + m_settings.iEpgDays * 24 * 60 * 60;
+
+  unsigned int iEvent = iChannelUid;
+  for (time_t eventStart = GUIDE_START; eventStart < guideEnd && eventStart < end; iEvent++)
+  {
+    const time_t eventEnd = eventStart + (iEvent % 3 + 1) * 30 * 60;
+    if (eventEnd > start)
+    {
+      const std::string strTitle = "Show " + std::to_string(iEvent % 50);
+      const std::string strPlot = "Episode " + std::to_string(iEvent) + " of show " +
+                                  std::to_string(iEvent % 50) + ", a synthetic event.";
+      const std::string strGenre = "Genre " + std::to_string(iEvent % 12);
+
+      EPG_TAG tag = {};
+      tag.iUniqueBroadcastId = iEvent;
+      tag.iUniqueChannelId = iChannelUid;
+      tag.strTitle = strTitle.c_str();
+      tag.startTime = eventStart;
+      tag.endTime = eventEnd;
+      tag.strPlot = strPlot.c_str();
+      tag.iGenreType = EPG_GENRE_USE_STRING;
+      tag.strGenreDescription = strGenre.c_str();
+      tag.iSeriesNumber = 1;
+      tag.iEpisodeNumber = iEvent;
+      tag.iEpisodePartNumber = -1;
+      transfer(tag);
+    }
+    eventStart = eventEnd;
+  }
+}
+
+void CPVRMockBackend::GetChannelStreamProperties(
+    int iChannelUid, const std::function<void(const PVR_NAMED_VALUE&)>& transfer) const
+{
+  if (m_settings.iTuneLatencyMs > 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_settings.iTuneLatencyMs));
+
+  PVR_NAMED_VALUE property = {};
+  Copy(property.strName, PVR_STREAM_PROPERTY_STREAMURL);
+  Copy(property.strValue, "http://backend/live/" + std::to_string(iChannelUid) + ".ts");
+  transfer(property);
+
+  Copy(property.strName, PVR_STREAM_PROPERTY_MIMETYPE);
+  Copy(property.strValue, "video/mp2t");
+  transfer(property);
+
+  Copy(property.strName, PVR_STREAM_PROPERTY_ISREALTIMESTREAM);
+  Copy(property.strValue, "true");
+  transfer(property);
+}
+
+void CPVRMockBackend::GetRecordings(const std::function<void(const PVR_RECORDING&)>& transfer) const
+{
+  for (int i = 1; i <= m_settings.iRecordings; i++)
+  {
+    const int iChannel = m_settings.iChannels > 0 ? (i % m_settings.iChannels) + 1 : 0;
+
+    PVR_RECORDING recording = {};
+    Copy(recording.strRecordingId, "recording-" + std::to_string(i));
+    Copy(recording.strTitle, "Show " + std::to_string(i % 50));
+    Copy(recording.strEpisodeName, "Episode " + std::to_string(i));
+    recording.iSeriesNumber = 1;
+    recording.iEpisodeNumber = i;
+    Copy(recording.strDirectory, "/Show " + std::to_string(i % 50));
+    Copy(recording.strPlot, "Recording " + std::to_string(i) + ", a synthetic recording.");
+    Copy(recording.strChannelName, "Channel " + std::to_string(iChannel));
+    recording.recordingTime = GUIDE_START - i * 60 * 60;
+    recording.iDuration = 60 * 60;
+    recording.iChannelUid = iChannel;
+    recording.channelType = PVR_RECORDING_CHANNEL_TYPE_TV;
+    recording.sizeInBytes = -1;
+    transfer(recording);
+  }
+}
+
+void CPVRMockBackend::GetTimers(const std::function<void(const PVR_TIMER&)>& transfer) const
+{
+  const int iGuideLength = m_settings.iEpgDays * 24 * 60 * 60;
+
+  for (int i = 1; i <= m_settings.iTimers; i++)
+  {
+    const int iChannel = m_settings.iChannels > 0 ? (i % m_settings.iChannels) + 1 : 0;
+
+    PVR_TIMER timer = {};
+    timer.iClientIndex = i;
+    timer.iClientChannelUid = iChannel;
+    timer.startTime = GUIDE_START + (iGuideLength > 0 ? (i * 37 * 60) % iGuideLength : 0);
+    timer.endTime = timer.startTime + 60 * 60;
+    timer.state = PVR_TIMER_STATE_SCHEDULED;
+    timer.iTimerType = 1;
+    Copy(timer.strTitle, "Show " + std::to_string(i % 50));
+    Copy(timer.strDirectory, "/Show " + std::to_string(i % 50));
+    timer.iWeekdays = PVR_WEEKDAY_NONE;
+    timer.iEpgUid = PVR_TIMER_NO_EPG_UID;
+    transfer(timer);
+  }
+}
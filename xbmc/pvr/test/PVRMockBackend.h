@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_channel_groups.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_channels.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_epg.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_general.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_recordings.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_timers.h"
+
+#include <ctime>
+#include <functional>
+
+namespace PVR
+{
+/*!
+ * @brief In-process stand-in for a PVR backend add-on. Serves synthetic channels, channel groups,
+ * EPG events, recordings and timers as the structures of the PVR add-on API, the way an add-on transfers
+ * them to Kodi. The same settings always produce the same data.
+ */
+class CPVRMockBackend
+{
+public:
+  struct Settings
+  {
+    int iChannels = 200;
+    int iGroups = 10;
+    int iChannelsPerGroup = 50;
+    int iEpgDays = 3; //!< days of EPG data from the guide start
+    int iRecordings = 500;
+    int iTimers = 100;
+    int iTuneLatencyMs = 0; //!< time it takes to obtain the stream properties of a channel
+  };
+
+  static constexpr time_t GUIDE_START = 1614556800;
+
+  explicit CPVRMockBackend(const Settings& settings) : m_settings(settings) {}
+
+  const Settings& GetSettings() const { return m_settings; }
+
+  /*!
+   * @brief Transfer all TV channels, with unique ids 1 to iChannels.
+   */
+  void GetChannels(const std::function<void(const PVR_CHANNEL&)>& transfer) const;
+
+  /*!
+   * @brief Transfer all channel groups.
+   */
+  void GetChannelGroups(const std::function<void(const PVR_CHANNEL_GROUP&)>& transfer) const;
+
+  /*!
+   * @brief Transfer the members of a channel group, consecutive channels starting at a different
+   * channel for every group.
+   */
+  void GetChannelGroupMembers(
+      const PVR_CHANNEL_GROUP& group,
+      const std::function<void(const PVR_CHANNEL_GROUP_MEMBER&)>& transfer) const;
+
+  /*!
+   * @brief Transfer the gapless events of a channel between start and end, 30 to 90 minutes each.
+   * The string members only stay valid during the call of transfer.
+   */
+  void GetEPGForChannel(int iChannelUid,
+                        time_t start,
+                        time_t end,
+                        const std::function<void(const EPG_TAG&)>& transfer) const;
+
+  /*!
+   * @brief Transfer the stream properties of a channel, after the configured tune latency.
+   */
+  void GetChannelStreamProperties(int iChannelUid,
+                                  const std::function<void(const PVR_NAMED_VALUE&)>& transfer) const;
+
+  /*!
+   * @brief Transfer all recordings, spread over the channels and a few series folders.
+   */
+  void GetRecordings(const std::function<void(const PVR_RECORDING&)>& transfer) const;
+
+  /*!
+   * @brief Transfer all timers, one-time manual timers of timer type 1 with client indices 1 to
+   * iTimers, spread over the channels and the guide.
+   */
+  void GetTimers(const std::function<void(const PVR_TIMER&)>& transfer) const;
+
+private:
+  const Settings m_settings;
+};
+} // namespace PVR
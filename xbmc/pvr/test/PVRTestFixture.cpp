@@ -0,0 +1,33 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PVRTestFixture.h"
+
+#include "Application.h"
+#include "ServiceBroker.h"
+#include "ServiceManager.h"
+#include "interfaces/AnnouncementManager.h"
+
+#include <memory>
+
+using namespace PVR;
+
+void CPVRTestFixture::SetUp()
+{
+  // not started, announcers may register but nothing is announced
+  CServiceBroker::RegisterAnnouncementManager(
+      std::make_shared<ANNOUNCEMENT::CAnnouncementManager>());
+
+  g_application.m_ServiceManager->InitPVRManagerForTesting();
+}
+
+void CPVRTestFixture::TearDown()
+{
+  g_application.m_ServiceManager->DeinitPVRManagerForTesting();
+  CServiceBroker::UnregisterAnnouncementManager();
+}
@@ -0,0 +1,26 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+namespace PVR
+{
+/*!
+ * @brief Base fixture of tests needing CServiceBroker::GetPVRManager(). Creates a PVR manager that
+ * is not started, so the PVR containers can be loaded from the databases only, and the
+ * announcement manager it registers with. Both are destroyed after each test.
+ */
+class CPVRTestFixture : public ::testing::Test
+{
+protected:
+  void SetUp() override;
+  void TearDown() override;
+};
+} // namespace PVR
@@ -0,0 +1,530 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "pvr/PVRDatabase.h"
+#include "pvr/PVRManager.h"
+#include "pvr/channels/PVRChannel.h"
+#include "pvr/channels/PVRChannelGroup.h"
+#include "pvr/channels/PVRChannelGroupInternal.h"
+#include "pvr/channels/PVRChannelGroupMember.h"
+#include "pvr/channels/PVRChannelGroups.h"
+#include "pvr/channels/PVRChannelGroupsContainer.h"
+#include "pvr/epg/Epg.h"
+#include "pvr/epg/EpgChannelData.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/recordings/PVRRecording.h"
+#include "pvr/test/PVRMockBackend.h"
+#include "pvr/test/PVRTestFixture.h"
+#include "pvr/timers/PVRTimerInfoTag.h"
+#include "pvr/timers/PVRTimerType.h"
+#include "pvr/timers/PVRTimers.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#if defined(TARGET_POSIX)
+#include <unistd.h>
+#endif
+
+using namespace PVR;
+
+namespace
+{
+constexpr int CLIENT_ID = 1;
+
+using Clock = std::chrono::steady_clock;
+
+int Milliseconds(Clock::duration duration)
+{
+  return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+}
+
+/*!
+ * @brief Resident memory of this process in KiB, 0 if unknown.
+ */
+int GetResidentKiB()
+{
+#if defined(TARGET_LINUX)
+  std::ifstream statm("/proc/self/statm");
+  long pages = 0;
+  long residentPages = 0;
+  if (statm >> pages >> residentPages)
+    return static_cast<int>(residentPages * (sysconf(_SC_PAGESIZE) / 1024));
+#endif
+  return 0;
+}
+
+struct StartupData
+{
+  std::shared_ptr<CPVRChannelGroup> allChannels;
+  std::vector<std::shared_ptr<CPVRChannelGroup>> groups;
+  std::vector<std::shared_ptr<CPVREpg>> epgs;
+  std::map<CPVRRecordingUid, std::shared_ptr<CPVRRecording>> recordings;
+  size_t iGroupMembers = 0;
+  size_t iEpgTags = 0;
+  size_t iTimers = 0;
+};
+} // unnamed namespace
+
+/*!
+ * @brief Measures the parts of PVR startup that do not need a running PVR manager or a PVR client:
+ * loading the channel groups container and the timers of the (not started) PVR manager from the TV
+ * database, loading the EPG tables and their events from the EPG database and creating the
+ * recordings a backend transfers. The databases are filled from a CPVRMockBackend the way the
+ * first synchronization with a backend does.
+ */
+class TestPVRStartup : public CPVRTestFixture
+{
+protected:
+  DatabaseSettings tvSettings;
+  DatabaseSettings epgSettings;
+  std::shared_ptr<CPVRDatabase> tvDatabase;
+  std::shared_ptr<CPVREpgDatabase> epgDatabase;
+  bool bSyncChannelGroups = true;
+
+  void SetUp() override
+  {
+    CPVRTestFixture::SetUp();
+
+    tvSettings.type = "sqlite3";
+    tvSettings.name = "TestPVRStartupTV";
+    tvSettings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    epgSettings = tvSettings;
+    epgSettings.name = "TestPVRStartupEpg";
+
+    // the mock is not a PVR client, the channel groups are loaded from the database only
+    const auto settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+    bSyncChannelGroups = settings->GetBool(CSettings::SETTING_PVRMANAGER_SYNCCHANNELGROUPS);
+    settings->SetBool(CSettings::SETTING_PVRMANAGER_SYNCCHANNELGROUPS, false);
+
+    DeleteDatabases();
+    Connect();
+  }
+
+  void TearDown() override
+  {
+    CServiceBroker::GetPVRManager().ChannelGroups()->Unload();
+    CServiceBroker::GetPVRManager().Timers()->Unload();
+
+    Close();
+    DeleteDatabases();
+
+    CServiceBroker::GetSettingsComponent()->GetSettings()->SetBool(
+        CSettings::SETTING_PVRMANAGER_SYNCCHANNELGROUPS, bSyncChannelGroups);
+
+    CPVRTestFixture::TearDown();
+  }
+
+  void Connect()
+  {
+    // the PVR manager's database, which the containers load from
+    tvDatabase = CServiceBroker::GetPVRManager().GetTVDatabase();
+    ASSERT_NE(nullptr, tvDatabase);
+    ASSERT_TRUE(tvDatabase->Connect(tvSettings.name, tvSettings, true));
+    epgDatabase = std::make_shared<CPVREpgDatabase>();
+    ASSERT_TRUE(epgDatabase->Connect(epgSettings.name, epgSettings, true));
+  }
+
+  void Close()
+  {
+    tvDatabase->Close();
+    tvDatabase.reset();
+    epgDatabase->Close();
+    epgDatabase.reset();
+  }
+
+  void DeleteDatabases()
+  {
+    XFILE::CFile::Delete(tvSettings.host + tvSettings.name + ".db");
+    XFILE::CFile::Delete(epgSettings.host + epgSettings.name + ".db");
+  }
+
+  /*!
+   * @brief Store the backend's channels, groups, EPG events, recordings and timers.
+   */
+  void Synchronize(const CPVRMockBackend& backend)
+  {
+    // transfer channels and groups into the loaded, empty containers like a client does
+    const auto channelGroups = CServiceBroker::GetPVRManager().ChannelGroups();
+    ASSERT_TRUE(channelGroups->Load());
+    CPVRChannelGroups* groups = channelGroups->GetTV();
+
+    const auto allChannels =
+        std::static_pointer_cast<CPVRChannelGroupInternal>(groups->GetGroupAll());
+    ASSERT_NE(nullptr, allChannels);
+    allChannels->SetGroupName("All channels"); // no localized strings in the test environment
+
+    backend.GetChannels([&allChannels](const PVR_CHANNEL& data) {
+      const auto channel = std::make_shared<CPVRChannel>(data, CLIENT_ID);
+      allChannels->UpdateFromClient(channel, channel->ClientChannelNumber(), data.iOrder);
+    });
+    ASSERT_TRUE(allChannels->Persist());
+
+    backend.GetChannelGroups([&](const PVR_CHANNEL_GROUP& data) {
+      ASSERT_TRUE(groups->UpdateFromClient(CPVRChannelGroup(data, allChannels)));
+      const std::shared_ptr<CPVRChannelGroup> group = groups->GetByName(data.strGroupName);
+      ASSERT_NE(nullptr, group);
+
+      backend.GetChannelGroupMembers(data, [&](const PVR_CHANNEL_GROUP_MEMBER& member) {
+        const std::shared_ptr<CPVRChannel> channel =
+            allChannels->GetByUniqueID(member.iChannelUniqueId, CLIENT_ID);
+        ASSERT_NE(nullptr, channel);
+        group->AddToGroup(channel, CPVRChannelNumber(), member.iOrder, true,
+                          CPVRChannelNumber(member.iChannelNumber, member.iSubChannelNumber));
+      });
+    });
+    ASSERT_TRUE(groups->PersistAll());
+    channelGroups->Unload();
+
+    for (int i = 1; i <= backend.GetSettings().iChannels; i++)
+    {
+      const auto channelData = std::make_shared<CPVREpgChannelData>(CLIENT_ID, i);
+      CPVREpg epg(-1, "Channel " + std::to_string(i), "client", channelData, epgDatabase);
+      const int iEpgId = epgDatabase->Persist(epg, false);
+      ASSERT_GT(iEpgId, 0);
+
+      backend.GetEPGForChannel(
+          i, CPVRMockBackend::GUIDE_START,
+          CPVRMockBackend::GUIDE_START + backend.GetSettings().iEpgDays * 24 * 60 * 60,
+          [&](const EPG_TAG& data) {
+            epgDatabase->QueuePersistQuery(CPVREpgInfoTag(data, CLIENT_ID, channelData, iEpgId));
+          });
+      ASSERT_TRUE(epgDatabase->CommitQueuedChanges());
+    }
+
+    backend.GetRecordings([this](const PVR_RECORDING& recording) {
+      tvDatabase->QueuePersistQuery(recording, CLIENT_ID, 0);
+    });
+    ASSERT_TRUE(tvDatabase->CommitQueuedQueries());
+
+    // only local timers are stored in the TV database, store the backend's timers as reminders
+    const std::shared_ptr<CPVRTimerType> reminderType = CPVRTimerType::CreateFromAttributes(
+        PVR_TIMER_TYPE_IS_REMINDER | PVR_TIMER_TYPE_IS_MANUAL, PVR_TIMER_TYPE_IS_REPEATING, -1);
+    ASSERT_NE(nullptr, reminderType);
+
+    tvDatabase->BeginTransaction();
+    backend.GetTimers([&](const PVR_TIMER& data) {
+      const auto timer = std::make_shared<CPVRTimerInfoTag>(data, nullptr, CLIENT_ID);
+      timer->m_iClientIndex = PVR_TIMER_NO_CLIENT_INDEX;
+      timer->SetTimerType(reminderType);
+      EXPECT_TRUE(tvDatabase->Persist(*timer));
+    });
+    ASSERT_TRUE(tvDatabase->CommitTransaction());
+  }
+
+  /*!
+   * @brief Load the channel groups container of the PVR manager.
+   */
+  void LoadChannels(StartupData& data)
+  {
+    const auto channelGroups = CServiceBroker::GetPVRManager().ChannelGroups();
+    ASSERT_TRUE(channelGroups->Load());
+
+    data.allChannels = channelGroups->GetGroupAllTV();
+    ASSERT_NE(nullptr, data.allChannels);
+    data.iGroupMembers += data.allChannels->Size();
+
+    for (const auto& group : channelGroups->GetTV()->GetMembers())
+    {
+      if (group->IsInternalGroup())
+        continue;
+
+      data.iGroupMembers += group->Size();
+      data.groups.emplace_back(group);
+    }
+  }
+
+  void LoadEpg(StartupData& data)
+  {
+    data.epgs = epgDatabase->GetAll();
+    for (const auto& epg : data.epgs)
+      data.iEpgTags += epg->GetTags().size();
+  }
+
+  /*!
+   * @brief Load the timers of the PVR manager.
+   */
+  void LoadTimers(StartupData& data)
+  {
+    const auto timers = CServiceBroker::GetPVRManager().Timers();
+    EXPECT_TRUE(timers->Load());
+    data.iTimers = timers->GetAll().size();
+  }
+
+  void LoadRecordings(const CPVRMockBackend& backend, StartupData& data)
+  {
+    backend.GetRecordings([&data](const PVR_RECORDING& recording) {
+      const auto tag = std::make_shared<CPVRRecording>(recording, CLIENT_ID);
+      data.recordings.insert({CPVRRecordingUid(CLIENT_ID, recording.strRecordingId), tag});
+    });
+  }
+
+  void LoadCachedRecordings(StartupData& data)
+  {
+    tvDatabase->GetRecordings([&data](const PVR_RECORDING& recording, int iClientId, unsigned int) {
+      const auto tag = std::make_shared<CPVRRecording>(recording, iClientId);
+      data.recordings.insert({CPVRRecordingUid(iClientId, recording.strRecordingId), tag});
+    });
+  }
+
+  /*!
+   * @brief Load everything once on freshly opened databases (cold) and once more on the open
+   * connections (warm), and report the timings.
+   */
+  void RunStartup(const CPVRMockBackend& backend)
+  {
+    Synchronize(backend);
+    if (HasFatalFailure())
+      return;
+
+    const auto& settings = backend.GetSettings();
+
+    Close();
+    const int iResidentBefore = GetResidentKiB();
+
+    StartupData cold;
+    auto start = Clock::now();
+    Connect();
+    LoadChannels(cold);
+    const auto channelsCold = Clock::now() - start;
+    if (HasFatalFailure())
+      return;
+
+    start = Clock::now();
+    LoadEpg(cold);
+    const auto epgCold = Clock::now() - start;
+
+    start = Clock::now();
+    LoadTimers(cold);
+    const auto timersCold = Clock::now() - start;
+
+    start = Clock::now();
+    LoadRecordings(backend, cold);
+    const auto recordingsTime = Clock::now() - start;
+
+    const int iResidentAfter = GetResidentKiB();
+
+    EXPECT_EQ(static_cast<size_t>(settings.iChannels +
+                                  settings.iGroups *
+                                      std::min(settings.iChannelsPerGroup, settings.iChannels)),
+              cold.iGroupMembers);
+    EXPECT_EQ(static_cast<size_t>(settings.iGroups), cold.groups.size());
+    EXPECT_EQ(static_cast<size_t>(settings.iChannels), cold.epgs.size());
+    EXPECT_EQ(static_cast<size_t>(settings.iTimers), cold.iTimers);
+    EXPECT_EQ(static_cast<size_t>(settings.iRecordings), cold.recordings.size());
+
+    StartupData warm;
+    start = Clock::now();
+    LoadChannels(warm);
+    const auto channelsWarm = Clock::now() - start;
+
+    start = Clock::now();
+    LoadEpg(warm);
+    const auto epgWarm = Clock::now() - start;
+
+    start = Clock::now();
+    LoadTimers(warm);
+    const auto timersWarm = Clock::now() - start;
+
+    // persisting the unchanged groups must not write anything
+    start = Clock::now();
+    for (const auto& group : warm.groups)
+      EXPECT_TRUE(group->Persist());
+    const auto persistUnchanged = Clock::now() - start;
+
+    start = Clock::now();
+    LoadCachedRecordings(warm);
+    const auto cachedRecordingsTime = Clock::now() - start;
+
+    EXPECT_EQ(cold.iGroupMembers, warm.iGroupMembers);
+    EXPECT_EQ(cold.iEpgTags, warm.iEpgTags);
+    EXPECT_EQ(cold.iTimers, warm.iTimers);
+    EXPECT_EQ(cold.recordings.size(), warm.recordings.size());
+
+    RecordProperty("channels", settings.iChannels);
+    RecordProperty("epg_tags", static_cast<int>(cold.iEpgTags));
+    RecordProperty("recordings", settings.iRecordings);
+    RecordProperty("timers", settings.iTimers);
+    RecordProperty("channels_cold_ms", Milliseconds(channelsCold));
+    RecordProperty("channels_warm_ms", Milliseconds(channelsWarm));
+    RecordProperty("groups", settings.iGroups);
+    RecordProperty("groups_persist_unchanged_ms", Milliseconds(persistUnchanged));
+    RecordProperty("epg_cold_ms", Milliseconds(epgCold));
+    RecordProperty("epg_warm_ms", Milliseconds(epgWarm));
+    RecordProperty("timers_cold_ms", Milliseconds(timersCold));
+    RecordProperty("timers_warm_ms", Milliseconds(timersWarm));
+    RecordProperty("recordings_ms", Milliseconds(recordingsTime));
+    RecordProperty("recordings_cached_ms", Milliseconds(cachedRecordingsTime));
+    if (iResidentBefore > 0)
+      RecordProperty("resident_kib", iResidentAfter - iResidentBefore);
+  }
+};
+
+TEST_F(TestPVRStartup, MockBackend)
+{
+  const CPVRMockBackend backend({});
+
+  size_t iChannels = 0;
+  backend.GetChannels([&iChannels](const PVR_CHANNEL& channel) {
+    EXPECT_EQ(++iChannels, channel.iUniqueId);
+  });
+  EXPECT_EQ(200u, iChannels);
+
+  // gapless events, starting at the guide start
+  time_t end = CPVRMockBackend::GUIDE_START;
+  backend.GetEPGForChannel(1, CPVRMockBackend::GUIDE_START, CPVRMockBackend::GUIDE_START + 86400,
+                           [&end](const EPG_TAG& tag) {
+                             EXPECT_EQ(end, tag.startTime);
+                             end = tag.endTime;
+                           });
+  EXPECT_GE(end, CPVRMockBackend::GUIDE_START + 86400);
+
+  size_t iTimers = 0;
+  backend.GetTimers([&iTimers](const PVR_TIMER& timer) {
+    EXPECT_EQ(++iTimers, timer.iClientIndex);
+    EXPECT_GE(timer.startTime, CPVRMockBackend::GUIDE_START);
+  });
+  EXPECT_EQ(100u, iTimers);
+}
+
+TEST_F(TestPVRStartup, RecordingsCache)
+{
+  CPVRMockBackend::Settings settings;
+  settings.iRecordings = 50;
+  const CPVRMockBackend backend(settings);
+
+  std::vector<PVR_RECORDING> recordings;
+  backend.GetRecordings(
+      [&recordings](const PVR_RECORDING& recording) { recordings.emplace_back(recording); });
+  ASSERT_EQ(50u, recordings.size());
+
+  for (size_t i = 0; i < recordings.size(); i++)
+    tvDatabase->QueuePersistQuery(recordings[i], CLIENT_ID, static_cast<unsigned int>(i));
+  ASSERT_TRUE(tvDatabase->CommitQueuedQueries());
+
+  // a changed recording replaces the cached one
+  recordings[0].iPlayCount = 3;
+  tvDatabase->QueuePersistQuery(recordings[0], CLIENT_ID, 1000);
+  tvDatabase->QueueDeleteQuery(CPVRRecordingUid(CLIENT_ID, recordings[1].strRecordingId));
+  ASSERT_TRUE(tvDatabase->CommitQueuedQueries());
+
+  Close();
+  Connect();
+
+  std::map<std::string, std::pair<PVR_RECORDING, unsigned int>> cached;
+  EXPECT_EQ(49, tvDatabase->GetRecordings([&cached](const PVR_RECORDING& recording,
+                                                    int iClientId, unsigned int iDataHash) {
+    EXPECT_EQ(CLIENT_ID, iClientId);
+    cached.insert({recording.strRecordingId, {recording, iDataHash}});
+  }));
+
+  EXPECT_EQ(cached.end(), cached.find(recordings[1].strRecordingId));
+  EXPECT_EQ(1000u, cached[recordings[0].strRecordingId].second);
+  EXPECT_EQ(3, cached[recordings[0].strRecordingId].first.iPlayCount);
+
+  const PVR_RECORDING& recording = recordings[10];
+  const auto it = cached.find(recording.strRecordingId);
+  ASSERT_NE(cached.end(), it);
+  EXPECT_EQ(10u, it->second.second);
+  EXPECT_STREQ(recording.strTitle, it->second.first.strTitle);
+  EXPECT_STREQ(recording.strDirectory, it->second.first.strDirectory);
+  EXPECT_STREQ(recording.strPlot, it->second.first.strPlot);
+  EXPECT_EQ(recording.recordingTime, it->second.first.recordingTime);
+  EXPECT_EQ(recording.iDuration, it->second.first.iDuration);
+  EXPECT_EQ(recording.iChannelUid, it->second.first.iChannelUid);
+  EXPECT_EQ(recording.channelType, it->second.first.channelType);
+  EXPECT_EQ(recording.sizeInBytes, it->second.first.sizeInBytes);
+
+  EXPECT_TRUE(tvDatabase->DeleteRecordings());
+  EXPECT_EQ(0, tvDatabase->GetRecordings([](const PVR_RECORDING&, int, unsigned int) {}));
+}
+
+TEST_F(TestPVRStartup, ChannelGroupMembersDelta)
+{
+  CPVRMockBackend::Settings settings;
+  settings.iChannels = 50;
+  settings.iGroups = 3;
+  settings.iChannelsPerGroup = 20;
+  Synchronize(CPVRMockBackend(settings));
+  ASSERT_FALSE(HasFatalFailure());
+
+  StartupData data;
+  LoadChannels(data);
+  ASSERT_EQ(3u, data.groups.size());
+
+  const std::shared_ptr<CPVRChannelGroup> group = data.groups[0];
+  group->SetPreventSortAndRenumber();
+  const auto members = group->GetMembers();
+  ASSERT_EQ(20u, members.size());
+
+  const std::shared_ptr<CPVRChannel> removed = members[3]->Channel();
+  const std::shared_ptr<CPVRChannel> reordered = members[5]->Channel();
+  members[5]->SetOrder(1000);
+  EXPECT_TRUE(group->RemoveFromGroup(removed));
+  EXPECT_TRUE(group->Persist());
+
+  Close();
+  Connect();
+
+  StartupData reloaded;
+  LoadChannels(reloaded);
+  ASSERT_EQ(3u, reloaded.groups.size());
+  EXPECT_EQ(data.iGroupMembers - 1, reloaded.iGroupMembers);
+
+  const std::shared_ptr<CPVRChannelGroup> reloadedGroup = reloaded.groups[0];
+  EXPECT_EQ(19u, reloadedGroup->Size());
+  EXPECT_EQ(nullptr, reloadedGroup->GetByUniqueID(removed->StorageId()));
+  const auto member = reloadedGroup->GetByUniqueID(reordered->StorageId());
+  ASSERT_NE(nullptr, member);
+  EXPECT_EQ(1000, member->Order());
+
+  // the other groups are not affected
+  EXPECT_EQ(20u, reloaded.groups[1]->Size());
+  EXPECT_EQ(20u, reloaded.groups[2]->Size());
+}
+
+TEST_F(TestPVRStartup, Startup)
+{
+  RunStartup(CPVRMockBackend({}));
+}
+
+TEST_F(TestPVRStartup, DISABLED_LargeStartup)
+{
+  // 2000 channels, 40 groups, a week of EPG data: run with --gtest_also_run_disabled_tests
+  CPVRMockBackend::Settings settings;
+  settings.iChannels = 2000;
+  settings.iGroups = 40;
+  settings.iChannelsPerGroup = 200;
+  settings.iEpgDays = 7;
+  settings.iRecordings = 5000;
+  RunStartup(CPVRMockBackend(settings));
+}
+
+TEST_F(TestPVRStartup, DISABLED_LargeChannelLineup)
+{
+  // 5000 channels in 200 groups: run with --gtest_also_run_disabled_tests
+  CPVRMockBackend::Settings settings;
+  settings.iChannels = 5000;
+  settings.iGroups = 200;
+  settings.iChannelsPerGroup = 250;
+  settings.iEpgDays = 1;
+  RunStartup(CPVRMockBackend(settings));
+}
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PVRTimerRuleIndex.h"
+
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/timers/PVRTimerRuleMatcher.h"
+
+#include <algorithm>
+
+using namespace PVR;
+
+void CPVRTimerRuleIndex::Add(const std::shared_ptr<CPVRTimerRuleMatcher>& matcher, int iEpgId)
+{
+  const Buckets buckets = GetBuckets(*matcher);
+
+  Rules& rules = m_rules[iEpgId];
+  rules.rules.emplace_back(Rule{matcher, buckets});
+  rules.buckets |= buckets;
+  rules.bMatchesPlot |=
+      matcher->GetCriteria().textMatch == CPVRTimerRuleMatcher::TextMatch::FULLTEXT;
+}
+
+bool CPVRTimerRuleIndex::MatchesPlot(int iEpgId) const
+{
+  for (const int iId : {iEpgId, ALL_EPGS})
+  {
+    const auto it = m_rules.find(iId);
+    if (it != m_rules.end() && it->second.bMatchesPlot)
+      return true;
+  }
+  return false;
+}
+
+std::vector<CPVRTimerRuleMatcher::TimeWindow> CPVRTimerRuleIndex::GetTimeWindows(
+    int iEpgId, const CDateTime& maxStart) const
+{
+  std::vector<CPVRTimerRuleMatcher::TimeWindow> windows;
+  for (const int iId : {iEpgId, ALL_EPGS})
+  {
+    const auto it = m_rules.find(iId);
+    if (it == m_rules.end())
+      continue;
+
+    for (const auto& rule : it->second.rules)
+    {
+      const auto ruleWindows = rule.matcher->GetTimeWindows(maxStart);
+      windows.insert(windows.end(), ruleWindows.begin(), ruleWindows.end());
+    }
+  }
+
+  std::sort(windows.begin(), windows.end());
+
+  std::vector<CPVRTimerRuleMatcher::TimeWindow> merged;
+  for (const auto& window : windows)
+  {
+    if (!merged.empty() && window.first <= merged.back().second)
+    {
+      if (window.second > merged.back().second)
+        merged.back().second = window.second;
+    }
+    else
+    {
+      merged.emplace_back(window);
+    }
+  }
+  return merged;
+}
+
+std::vector<std::shared_ptr<CPVRTimerRuleMatcher>> CPVRTimerRuleIndex::GetMatches(
+    const std::shared_ptr<CPVREpgInfoTag>& epgTag, const std::string* pPlot /* = nullptr */) const
+{
+  std::vector<std::shared_ptr<CPVRTimerRuleMatcher>> matches;
+
+  const auto epgRules =
+      epgTag->EpgID() != ALL_EPGS ? m_rules.find(epgTag->EpgID()) : m_rules.end();
+  const auto allEpgsRules = m_rules.find(ALL_EPGS);
+  if (epgRules == m_rules.end() && allEpgsRules == m_rules.end())
+    return matches;
+
+  const CPVRTimerRuleMatcher::TagTimes times(*epgTag);
+  const size_t iBucket = (times.iStartWeekday - 1) * 24 + times.iStartMinutes / 60;
+
+  for (const auto& it : {epgRules, allEpgsRules})
+  {
+    if (it == m_rules.end() || !it->second.buckets.test(iBucket))
+      continue;
+
+    for (const auto& rule : it->second.rules)
+    {
+      if (rule.buckets.test(iBucket) && rule.matcher->Matches(*epgTag, times, pPlot))
+        matches.emplace_back(rule.matcher);
+    }
+  }
+
+  return matches;
+}
+
+CPVRTimerRuleIndex::Buckets CPVRTimerRuleIndex::GetBuckets(const CPVRTimerRuleMatcher& matcher)
+{
+  const CPVRTimerRuleMatcher::Criteria& criteria = matcher.GetCriteria();
+
+  Buckets buckets;
+  for (int iWeekday = 0; iWeekday < 7; iWeekday++)
+  {
+    if (criteria.iWeekdays != PVR_WEEKDAY_ALLDAYS && !((1 << iWeekday) & criteria.iWeekdays))
+      continue;
+
+    for (int iHour = 0; iHour < 24; iHour++)
+    {
+      // the hour contains a minute at or after the rule's start time
+      if (criteria.iStartMinutes < 0 || iHour * 60 + 59 >= criteria.iStartMinutes)
+        buckets.set(iWeekday * 24 + iHour);
+    }
+  }
+  return buckets;
+}
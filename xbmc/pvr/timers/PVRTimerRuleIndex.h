@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "pvr/timers/PVRTimerRuleMatcher.h"
+
+#include <bitset>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PVR
+{
+  class CPVREpgInfoTag;
+
+  /*!
+   * @brief Index of timer rule matchers. Finds the rules matching an EPG tag without evaluating
+   * every rule: rules are looked up by the EPG of the tag and pre-filtered by the weekday and hour
+   * the tag starts at, only the remaining candidates are fully matched.
+   */
+  class CPVRTimerRuleIndex
+  {
+  public:
+    static const int ALL_EPGS = -1;
+
+    /*!
+     * @brief Add a timer rule matcher to the index.
+     * @param matcher The matcher.
+     * @param iEpgId The id of the EPG the rule applies to, ALL_EPGS for rules matching any channel.
+     */
+    void Add(const std::shared_ptr<CPVRTimerRuleMatcher>& matcher, int iEpgId);
+
+    /*!
+     * @brief Check whether this index contains any matcher.
+     * @return True if empty, false otherwise.
+     */
+    bool IsEmpty() const { return m_rules.empty(); }
+
+    /*!
+     * @brief Check whether any rule applying to the given EPG searches the plot of the tags.
+     * @param iEpgId The id of the EPG.
+     * @return True if the plots are needed for matching, false otherwise.
+     */
+    bool MatchesPlot(int iEpgId) const;
+
+    /*!
+     * @brief Get the time windows of the tags of the given EPG that may match any rule.
+     * @param iEpgId The id of the EPG.
+     * @param maxStart The latest start time of interest, usually the end of the EPG.
+     * @return The windows, ordered and not overlapping. Tags outside of all windows do not match.
+     */
+    std::vector<CPVRTimerRuleMatcher::TimeWindow> GetTimeWindows(int iEpgId,
+                                                                 const CDateTime& maxStart) const;
+
+    /*!
+     * @brief Get the matchers of all rules matching the given EPG tag.
+     * @param epgTag The tag.
+     * @param pPlot The tag's plot, if at hand without loading it into the tag. nullptr to take it
+     * from the tag, which may load it from the database.
+     * @return The matchers, empty if no rule matches.
+     */
+    std::vector<std::shared_ptr<CPVRTimerRuleMatcher>> GetMatches(
+        const std::shared_ptr<CPVREpgInfoTag>& epgTag, const std::string* pPlot = nullptr) const;
+
+  private:
+    // one bit per weekday and hour a matching tag may start at
+    using Buckets = std::bitset<7 * 24>;
+
+    struct Rule
+    {
+      std::shared_ptr<CPVRTimerRuleMatcher> matcher;
+      Buckets buckets;
+    };
+
+    struct Rules
+    {
+      std::vector<Rule> rules;
+      Buckets buckets; // union of the rules' buckets
+      bool bMatchesPlot = false; // any of the rules searches the plot
+    };
+
+    static Buckets GetBuckets(const CPVRTimerRuleMatcher& matcher);
+
+    std::map<int, Rules> m_rules; // by EPG id
+  };
+}
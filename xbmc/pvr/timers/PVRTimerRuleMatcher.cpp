@@ -9,24 +9,138 @@
 #include "PVRTimerRuleMatcher.h"
 
 #include "XBDateTime.h"
-#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_channels.h" // PVR_CHANNEL_INVALID_UID
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/timers/PVRTimerInfoTag.h"
 #include "utils/RegExp.h"
 
+#include <algorithm>
+
 using namespace PVR;
 
+namespace
+{
+int GetDate(const CDateTime& local)
+{
+  return local.GetYear() * 10000 + local.GetMonth() * 100 + local.GetDay();
+}
+
+int GetMinutes(const CDateTime& local)
+{
+  return local.GetHour() * 60 + local.GetMinute();
+}
+
+char ToLowerAscii(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+/*!
+ * @brief Get the lower case search text if it can be matched without a regular expression.
+ * @return True if the text is plain ASCII without regex syntax, false otherwise.
+ */
+bool GetSearchLiteral(const std::string& strSearchText, std::string& strLiteral)
+{
+  static const std::string regexSyntax = "\\^$.|?*+()[]{}";
+  for (const char c : strSearchText)
+  {
+    if (static_cast<unsigned char>(c) >= 0x80 || regexSyntax.find(c) != std::string::npos)
+      return false;
+  }
+
+  strLiteral.resize(strSearchText.size());
+  std::transform(strSearchText.begin(), strSearchText.end(), strLiteral.begin(), ToLowerAscii);
+  return true;
+}
+} // unnamed namespace
+
+CPVRTimerRuleMatcher::TagTimes::TagTimes(const CPVREpgInfoTag& epgTag)
+{
+  const CDateTime endUTC = epgTag.EndAsUTC();
+  endUTC.GetAsTime(end);
+
+  const CDateTime startLocal = CPVRTimerInfoTag::ConvertUTCToLocalTime(epgTag.StartAsUTC());
+  iStartDate = GetDate(startLocal);
+  iStartMinutes = GetMinutes(startLocal);
+  iStartWeekday = startLocal.GetDayOfWeek();
+  if (iStartWeekday == 0)
+    iStartWeekday = 7;
+
+  iEndMinutes = GetMinutes(CPVRTimerInfoTag::ConvertUTCToLocalTime(endUTC));
+}
+
 CPVRTimerRuleMatcher::CPVRTimerRuleMatcher(const std::shared_ptr<CPVRTimerInfoTag>& timerRule, const CDateTime& start)
+: CPVRTimerRuleMatcher(timerRule, CriteriaFromTimerRule(*timerRule), start)
+{
+}
+
+CPVRTimerRuleMatcher::CPVRTimerRuleMatcher(const Criteria& criteria, const CDateTime& start)
+: CPVRTimerRuleMatcher({}, criteria, start)
+{
+}
+
+CPVRTimerRuleMatcher::CPVRTimerRuleMatcher(const std::shared_ptr<CPVRTimerInfoTag>& timerRule,
+                                           const Criteria& criteria,
+                                           const CDateTime& start)
 : m_timerRule(timerRule),
+  m_criteria(criteria),
   m_start(CPVRTimerInfoTag::ConvertUTCToLocalTime(start))
 {
+  start.GetAsTime(m_startUTC);
+
+  // compile the search text once, plain text needs no regular expression at all
+  if (m_criteria.textMatch != TextMatch::NONE &&
+      !GetSearchLiteral(m_criteria.strSearchText, m_strSearchLiteral))
+  {
+    m_textSearch.reset(new CRegExp(true /* case insensitive */));
+    m_textSearch->RegComp(m_criteria.strSearchText, CRegExp::StudyRegExp);
+  }
 }
 
 CPVRTimerRuleMatcher::~CPVRTimerRuleMatcher() = default;
 
+CPVRTimerRuleMatcher::Criteria CPVRTimerRuleMatcher::CriteriaFromTimerRule(const CPVRTimerInfoTag& timerRule)
+{
+  const std::shared_ptr<CPVRTimerType> type = timerRule.GetTimerType();
+  Criteria criteria;
+
+  if (type->RequiresEpgSeriesLinkOnCreate())
+  {
+    criteria.bMatchSeriesLink = true;
+    criteria.strSeriesLink = timerRule.SeriesLink();
+  }
+
+  if (!(type->SupportsAnyChannel() && timerRule.m_iClientChannelUid == PVR_CHANNEL_INVALID_UID) &&
+      type->SupportsChannels())
+  {
+    criteria.bAnyChannel = false;
+    criteria.iClientId = timerRule.m_iClientId;
+    criteria.iClientChannelUid = timerRule.m_iClientChannelUid;
+  }
+
+  if (type->SupportsFirstDay())
+    criteria.iFirstDay = GetDate(timerRule.FirstDayAsLocalTime());
+
+  if (!(type->SupportsStartAnyTime() && timerRule.m_bStartAnyTime) && type->SupportsStartTime())
+    criteria.iStartMinutes = GetMinutes(timerRule.StartAsLocalTime());
+
+  if (!(type->SupportsEndAnyTime() && timerRule.m_bEndAnyTime) && type->SupportsEndTime())
+    criteria.iEndMinutes = GetMinutes(timerRule.EndAsLocalTime());
+
+  if (type->SupportsWeekdays())
+    criteria.iWeekdays = timerRule.m_iWeekdays;
+
+  if (type->SupportsEpgFulltextMatch() && timerRule.m_bFullTextEpgSearch)
+    criteria.textMatch = TextMatch::FULLTEXT;
+  else if (type->SupportsEpgTitleMatch())
+    criteria.textMatch = TextMatch::TITLE;
+  criteria.strSearchText = timerRule.m_strEpgSearchString;
+
+  return criteria;
+}
+
 std::shared_ptr<CPVRChannel> CPVRTimerRuleMatcher::GetChannel() const
 {
-  if (m_timerRule->GetTimerType()->SupportsChannels())
+  if (m_timerRule && m_timerRule->GetTimerType()->SupportsChannels())
     return m_timerRule->Channel();
 
   return {};
@@ -34,7 +148,7 @@ std::shared_ptr<CPVRChannel> CPVRTimerRuleMatcher::GetChannel() const
 
 CDateTime CPVRTimerRuleMatcher::GetNextTimerStart() const
 {
-  if (!m_timerRule->GetTimerType()->SupportsStartTime())
+  if (!m_timerRule || !m_timerRule->GetTimerType()->SupportsStartTime())
     return CDateTime(); // invalid datetime
 
   const CDateTime startDateLocal = m_timerRule->GetTimerType()->SupportsFirstDay()
@@ -69,134 +183,148 @@ CDateTime CPVRTimerRuleMatcher::GetNextTimerStart() const
   return nextStart.GetAsUTCDateTime();
 }
 
+std::vector<CPVRTimerRuleMatcher::TimeWindow> CPVRTimerRuleMatcher::GetTimeWindows(
+    const CDateTime& maxStart) const
+{
+  std::vector<TimeWindow> windows;
+
+  // matching tags end after the start of the matcher
+  const CDateTime minEnd(m_startUTC + 1);
+  if (!maxStart.IsValid() || maxStart < minEnd)
+    return windows;
+
+  if (m_criteria.iFirstDay == 0 && m_criteria.iStartMinutes < 0 &&
+      m_criteria.iWeekdays == PVR_WEEKDAY_ALLDAYS)
+  {
+    windows.emplace_back(minEnd, maxStart);
+    return windows;
+  }
+
+  // one window per matching local day. tags still running at the start of the matcher may have
+  // started the day before.
+  const CDateTimeSpan oneDay(1, 0, 0, 0);
+  CDateTime day(m_start.GetYear(), m_start.GetMonth(), m_start.GetDay(), 0, 0, 0);
+  day -= oneDay;
+  if (m_criteria.iFirstDay > 0)
+  {
+    const CDateTime firstDay(m_criteria.iFirstDay / 10000, m_criteria.iFirstDay / 100 % 100,
+                             m_criteria.iFirstDay % 100, 0, 0, 0);
+    if (firstDay > day)
+      day = firstDay;
+  }
+
+  for (; CPVRTimerInfoTag::ConvertLocalTimeToUTC(day) <= maxStart; day += oneDay)
+  {
+    int iWeekday = day.GetDayOfWeek();
+    if (iWeekday == 0)
+      iWeekday = 7;
+
+    if (m_criteria.iWeekdays != PVR_WEEKDAY_ALLDAYS &&
+        !((1 << (iWeekday - 1)) & m_criteria.iWeekdays))
+      continue;
+
+    CDateTime firstStart = day;
+    if (m_criteria.iStartMinutes > 0)
+      firstStart +=
+          CDateTimeSpan(0, m_criteria.iStartMinutes / 60, m_criteria.iStartMinutes % 60, 0);
+
+    CDateTime windowMinEnd = CPVRTimerInfoTag::ConvertLocalTimeToUTC(firstStart);
+    if (windowMinEnd < minEnd)
+      windowMinEnd = minEnd;
+
+    windows.emplace_back(windowMinEnd, CPVRTimerInfoTag::ConvertLocalTimeToUTC(
+                                           day + CDateTimeSpan(0, 23, 59, 59)));
+  }
+
+  return windows;
+}
+
 bool CPVRTimerRuleMatcher::Matches(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const
 {
-  return epgTag &&
-         CPVRTimerInfoTag::ConvertUTCToLocalTime(epgTag->EndAsUTC()) > m_start &&
-         MatchSeriesLink(epgTag) &&
+  return epgTag && Matches(*epgTag, TagTimes(*epgTag));
+}
+
+bool CPVRTimerRuleMatcher::Matches(const CPVREpgInfoTag& epgTag,
+                                   const TagTimes& times,
+                                   const std::string* pPlot /* = nullptr */) const
+{
+  // cheap comparisons first, text search last
+  return times.end > m_startUTC &&
          MatchChannel(epgTag) &&
-         MatchStart(epgTag) &&
-         MatchEnd(epgTag) &&
-         MatchDayOfWeek(epgTag) &&
-         MatchSearchText(epgTag);
+         MatchStart(times) &&
+         MatchEnd(times) &&
+         MatchDayOfWeek(times) &&
+         MatchSeriesLink(epgTag) &&
+         MatchSearchText(epgTag, pPlot);
 }
 
-bool CPVRTimerRuleMatcher::MatchSeriesLink(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const
+bool CPVRTimerRuleMatcher::MatchSeriesLink(const CPVREpgInfoTag& epgTag) const
 {
-  if (m_timerRule->GetTimerType()->RequiresEpgSeriesLinkOnCreate())
-    return epgTag->SeriesLink() == m_timerRule->SeriesLink();
+  if (m_criteria.bMatchSeriesLink)
+    return epgTag.SeriesLink() == m_criteria.strSeriesLink;
   else
     return true;
 }
 
-bool CPVRTimerRuleMatcher::MatchChannel(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const
+bool CPVRTimerRuleMatcher::MatchChannel(const CPVREpgInfoTag& epgTag) const
 {
-  if (m_timerRule->GetTimerType()->SupportsAnyChannel() &&
-      m_timerRule->m_iClientChannelUid == PVR_CHANNEL_INVALID_UID)
-    return true; // matches any channel
-
-  if (m_timerRule->GetTimerType()->SupportsChannels())
-    return m_timerRule->m_iClientChannelUid != PVR_CHANNEL_INVALID_UID &&
-           epgTag->ClientID() == m_timerRule->m_iClientId &&
-           epgTag->UniqueChannelID() == m_timerRule->m_iClientChannelUid;
-  else
+  if (m_criteria.bAnyChannel)
     return true;
+
+  return m_criteria.iClientChannelUid != PVR_CHANNEL_INVALID_UID &&
+         epgTag.ClientID() == m_criteria.iClientId &&
+         epgTag.UniqueChannelID() == m_criteria.iClientChannelUid;
 }
 
-bool CPVRTimerRuleMatcher::MatchStart(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const
+bool CPVRTimerRuleMatcher::MatchStart(const TagTimes& times) const
 {
-  if (m_timerRule->GetTimerType()->SupportsFirstDay())
-  {
-    // only year, month and day do matter here...
-    const CDateTime startEpgLocal = CPVRTimerInfoTag::ConvertUTCToLocalTime(epgTag->StartAsUTC());
-    const CDateTime startEpg(startEpgLocal.GetYear(),
-                             startEpgLocal.GetMonth(),
-                             startEpgLocal.GetDay(), 0, 0, 0);
-    const CDateTime firstDayLocal = m_timerRule->FirstDayAsLocalTime();
-    const CDateTime startTimer(firstDayLocal.GetYear(),
-                               firstDayLocal.GetMonth(),
-                               firstDayLocal.GetDay(), 0, 0, 0);
-    if (startEpg < startTimer)
-      return false;
-  }
-
-  if (m_timerRule->GetTimerType()->SupportsStartAnyTime() &&
-      m_timerRule->m_bStartAnyTime)
-    return true; // matches any start time
+  // only year, month and day do matter here...
+  if (m_criteria.iFirstDay > 0 && times.iStartDate < m_criteria.iFirstDay)
+    return false;
 
-  if (m_timerRule->GetTimerType()->SupportsStartTime())
-  {
-    // only hours and minutes do matter here...
-    const CDateTime startEpgLocal = CPVRTimerInfoTag::ConvertUTCToLocalTime(epgTag->StartAsUTC());
-    const CDateTime startEpg(2000, 1, 1, startEpgLocal.GetHour(), startEpgLocal.GetMinute(), 0);
-    const CDateTime startTimerLocal = m_timerRule->StartAsLocalTime();
-    const CDateTime startTimer(2000, 1, 1, startTimerLocal.GetHour(), startTimerLocal.GetMinute(), 0);
-    return startEpg >= startTimer;
-  }
-  else
-    return true;
+  // only hours and minutes do matter here...
+  return m_criteria.iStartMinutes < 0 || times.iStartMinutes >= m_criteria.iStartMinutes;
 }
 
-bool CPVRTimerRuleMatcher::MatchEnd(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const
+bool CPVRTimerRuleMatcher::MatchEnd(const TagTimes& times) const
 {
-  if (m_timerRule->GetTimerType()->SupportsEndAnyTime() &&
-      m_timerRule->m_bEndAnyTime)
-    return true; // matches any end time
-
-  if (m_timerRule->GetTimerType()->SupportsEndTime())
-  {
-    // only hours and minutes do matter here...
-    const CDateTime endEpgLocal = CPVRTimerInfoTag::ConvertUTCToLocalTime(epgTag->EndAsUTC());
-    const CDateTime endEpg(2000, 1, 1, endEpgLocal.GetHour(), endEpgLocal.GetMinute(), 0);
-    const CDateTime endTimerLocal = m_timerRule->EndAsLocalTime();
-    const CDateTime endTimer(2000, 1, 1, endTimerLocal.GetHour(), endTimerLocal.GetMinute(), 0);
-    return endEpg <= endTimer;
-  }
-  else
-    return true;
+  // only hours and minutes do matter here...
+  return m_criteria.iEndMinutes < 0 || times.iEndMinutes <= m_criteria.iEndMinutes;
 }
 
-bool CPVRTimerRuleMatcher::MatchDayOfWeek(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const
+bool CPVRTimerRuleMatcher::MatchDayOfWeek(const TagTimes& times) const
 {
-  if (m_timerRule->GetTimerType()->SupportsWeekdays())
-  {
-    if (m_timerRule->m_iWeekdays != PVR_WEEKDAY_ALLDAYS)
-    {
-      const CDateTime startEpgLocal = CPVRTimerInfoTag::ConvertUTCToLocalTime(epgTag->StartAsUTC());
-      int startWeekday = startEpgLocal.GetDayOfWeek();
-      if (startWeekday == 0)
-        startWeekday = 7;
+  if (m_criteria.iWeekdays != PVR_WEEKDAY_ALLDAYS)
+    return ((1 << (times.iStartWeekday - 1)) & m_criteria.iWeekdays);
 
-      return ((1 << (startWeekday - 1)) & m_timerRule->m_iWeekdays);
-    }
-  }
   return true;
 }
 
-bool CPVRTimerRuleMatcher::MatchSearchText(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const
+bool CPVRTimerRuleMatcher::MatchSearchText(const CPVREpgInfoTag& epgTag,
+                                           const std::string* pPlot) const
 {
-  if (m_timerRule->GetTimerType()->SupportsEpgFulltextMatch() &&
-      m_timerRule->m_bFullTextEpgSearch)
+  switch (m_criteria.textMatch)
   {
-    if (!m_textSearch)
-    {
-      m_textSearch.reset(new CRegExp(true /* case insensitive */));
-      m_textSearch->RegComp(m_timerRule->m_strEpgSearchString);
-    }
-    return m_textSearch->RegFind(epgTag->Title()) >= 0 ||
-           m_textSearch->RegFind(epgTag->EpisodeName()) >= 0 ||
-           m_textSearch->RegFind(epgTag->PlotOutline()) >= 0 ||
-           m_textSearch->RegFind(epgTag->Plot()) >= 0;
-  }
-  else if (m_timerRule->GetTimerType()->SupportsEpgTitleMatch())
-  {
-    if (!m_textSearch)
-    {
-      m_textSearch.reset(new CRegExp(true /* case insensitive */));
-      m_textSearch->RegComp(m_timerRule->m_strEpgSearchString);
-    }
-    return m_textSearch->RegFind(epgTag->Title()) >= 0;
+    case TextMatch::FULLTEXT:
+      return FindSearchText(epgTag.Title()) ||
+             FindSearchText(epgTag.EpisodeName()) ||
+             FindSearchText(epgTag.PlotOutline()) ||
+             FindSearchText(pPlot ? *pPlot : epgTag.Plot());
+    case TextMatch::TITLE:
+      return FindSearchText(epgTag.Title());
+    default:
+      return true;
   }
-  else
-    return true;
+}
+
+bool CPVRTimerRuleMatcher::FindSearchText(const std::string& strText) const
+{
+  if (m_textSearch)
+    return m_textSearch->RegFind(strText) >= 0;
+
+  return m_strSearchLiteral.empty() ||
+         std::search(strText.begin(), strText.end(), m_strSearchLiteral.begin(),
+                     m_strSearchLiteral.end(), [](char c, char literal) {
+                       return ToLowerAscii(c) == literal;
+                     }) != strText.end();
 }
@@ -9,8 +9,14 @@
 #pragma once
 
 #include "XBDateTime.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_channels.h"
+#include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/pvr/pvr_timers.h"
 
+#include <ctime>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 class CRegExp;
 
@@ -23,25 +29,101 @@ namespace PVR
   class CPVRTimerRuleMatcher
   {
   public:
+    enum class TextMatch
+    {
+      NONE, //!< any text matches
+      TITLE, //!< the search text must be found in the title
+      FULLTEXT, //!< the search text must be found in title, episode name, plot outline or plot
+    };
+
+    /*!
+     * @brief The criteria of a timer rule, as far as they are supported by its timer type.
+     */
+    struct Criteria
+    {
+      bool bMatchSeriesLink = false;
+      std::string strSeriesLink;
+      bool bAnyChannel = true;
+      int iClientId = -1;
+      int iClientChannelUid = PVR_CHANNEL_INVALID_UID;
+      int iFirstDay = 0; //!< local date as yyyymmdd, 0 for any date
+      int iStartMinutes = -1; //!< minutes after local midnight, -1 for any start time
+      int iEndMinutes = -1; //!< minutes after local midnight, -1 for any end time
+      int iWeekdays = PVR_WEEKDAY_ALLDAYS;
+      TextMatch textMatch = TextMatch::NONE;
+      std::string strSearchText; //!< a regular expression
+    };
+
+    /*!
+     * @brief The local times of an EPG tag, needed by all matchers. Obtain them once per tag.
+     */
+    struct TagTimes
+    {
+      explicit TagTimes(const CPVREpgInfoTag& epgTag);
+
+      time_t end = 0; //!< UTC
+      int iStartDate = 0; //!< local date as yyyymmdd
+      int iStartMinutes = 0; //!< minutes after local midnight
+      int iStartWeekday = 1; //!< 1 (Monday) to 7 (Sunday)
+      int iEndMinutes = 0; //!< minutes after local midnight
+    };
+
+    /*!
+     * @brief A time range to look up EPG tags in: the minimum end and maximum start time (UTC).
+     */
+    using TimeWindow = std::pair<CDateTime, CDateTime>;
+
     CPVRTimerRuleMatcher(const std::shared_ptr<CPVRTimerInfoTag>& timerRule, const CDateTime& start);
+    CPVRTimerRuleMatcher(const Criteria& criteria, const CDateTime& start);
     virtual ~CPVRTimerRuleMatcher();
 
     std::shared_ptr<CPVRTimerInfoTag> GetTimerRule() const { return m_timerRule; }
+    const Criteria& GetCriteria() const { return m_criteria; }
 
     std::shared_ptr<CPVRChannel> GetChannel() const;
     CDateTime GetNextTimerStart() const;
     bool Matches(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const;
 
+    /*!
+     * @brief Get the time windows of the EPG tags that may match this rule: those ending after the
+     * start of the matcher and starting on a matching day, at or after the rule's start time.
+     * @param maxStart The latest start time of interest, usually the end of the guide.
+     * @return The windows, ordered. Tags outside of all windows do not match.
+     */
+    std::vector<TimeWindow> GetTimeWindows(const CDateTime& maxStart) const;
+
+    /*!
+     * @brief Check whether an EPG tag matches this rule.
+     * @param epgTag The tag.
+     * @param times The tag's local times.
+     * @param pPlot The tag's plot, if at hand without loading it into the tag. nullptr to take it
+     * from the tag, which may load it from the database.
+     * @return True on match, false otherwise.
+     */
+    bool Matches(const CPVREpgInfoTag& epgTag,
+                 const TagTimes& times,
+                 const std::string* pPlot = nullptr) const;
+
   private:
-    bool MatchSeriesLink(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const;
-    bool MatchChannel(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const;
-    bool MatchStart(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const;
-    bool MatchEnd(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const;
-    bool MatchDayOfWeek(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const;
-    bool MatchSearchText(const std::shared_ptr<CPVREpgInfoTag>& epgTag) const;
+    CPVRTimerRuleMatcher(const std::shared_ptr<CPVRTimerInfoTag>& timerRule,
+                         const Criteria& criteria,
+                         const CDateTime& start);
+
+    static Criteria CriteriaFromTimerRule(const CPVRTimerInfoTag& timerRule);
+
+    bool MatchSeriesLink(const CPVREpgInfoTag& epgTag) const;
+    bool MatchChannel(const CPVREpgInfoTag& epgTag) const;
+    bool MatchStart(const TagTimes& times) const;
+    bool MatchEnd(const TagTimes& times) const;
+    bool MatchDayOfWeek(const TagTimes& times) const;
+    bool MatchSearchText(const CPVREpgInfoTag& epgTag, const std::string* pPlot) const;
+    bool FindSearchText(const std::string& strText) const;
 
     const std::shared_ptr<CPVRTimerInfoTag> m_timerRule;
+    const Criteria m_criteria;
     CDateTime m_start;
-    mutable std::unique_ptr<CRegExp> m_textSearch;
+    time_t m_startUTC = 0;
+    std::string m_strSearchLiteral; // lower case search text if it contains no regex syntax
+    std::unique_ptr<CRegExp> m_textSearch;
   };
 }
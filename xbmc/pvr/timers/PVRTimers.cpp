@@ -17,8 +17,10 @@
 #include "pvr/channels/PVRChannel.h"
 #include "pvr/epg/Epg.h"
 #include "pvr/epg/EpgContainer.h"
+#include "pvr/epg/EpgDatabase.h"
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/timers/PVRTimerInfoTag.h"
+#include "pvr/timers/PVRTimerRuleIndex.h"
 #include "pvr/timers/PVRTimerRuleMatcher.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
@@ -405,6 +407,72 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer& timers, const std::vec
 
 namespace
 {
+  /*!
+   * @brief Plots of tags read from the database are not in memory. For full text rules, get those
+   * of an EPG with one query, instead of loading each into its tag.
+   */
+  class CPlotsForMatching
+  {
+  public:
+    CPlotsForMatching(bool bMatchesPlot, int iEpgId, const CDateTime& now)
+    {
+      if (!bMatchesPlot)
+        return;
+
+      const std::shared_ptr<CPVREpgDatabase> database =
+          CServiceBroker::GetPVRManager().EpgContainer().GetEpgDatabase();
+      if (database)
+        m_plots = database->GetEpgTagPlots(iEpgId, now);
+    }
+
+    const std::string* Get(const CPVREpgInfoTag& tag) const
+    {
+      if (m_plots.empty() || tag.IsLongTextLoaded())
+        return nullptr;
+
+      const auto it = m_plots.find(tag.DatabaseID());
+      return it != m_plots.end() ? &it->second : nullptr;
+    }
+
+  private:
+    std::map<int, std::string> m_plots; // by database id of the tag
+  };
+
+  /*!
+   * @brief Get the tags of an EPG in the given time windows from the EPG's time index, instead of
+   * walking all of its tags.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetCandidateTags(
+      const CPVREpg& epg, const std::vector<CPVRTimerRuleMatcher::TimeWindow>& windows)
+  {
+    std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+    for (const auto& window : windows)
+    {
+      for (const auto& tag : epg.GetTags(window.first, window.second))
+      {
+        // a tag overlapping two windows is found in both
+        if (tags.empty() || tag->StartAsUTC() > tags.back()->StartAsUTC())
+          tags.emplace_back(tag);
+      }
+    }
+    return tags;
+  }
+
+  void AddEpgTagsForTimerRule(const CPVRTimerRuleMatcher& matcher,
+                              const std::shared_ptr<CPVREpg>& epg,
+                              std::vector<std::shared_ptr<CPVREpgInfoTag>>& matches)
+  {
+    const CPlotsForMatching plots(
+        matcher.GetCriteria().textMatch == CPVRTimerRuleMatcher::TextMatch::FULLTEXT,
+        epg->EpgID(), CDateTime::GetUTCDateTime());
+
+    for (const auto& tag : GetCandidateTags(*epg, matcher.GetTimeWindows(epg->GetLastDate())))
+    {
+      if (matcher.Matches(*tag, CPVRTimerRuleMatcher::TagTimes(*tag), plots.Get(*tag)))
+        matches.emplace_back(tag);
+    }
+  }
+
   std::vector<std::shared_ptr<CPVREpgInfoTag>> GetEpgTagsForTimerRule(const CPVRTimerRuleMatcher& matcher)
   {
     std::vector<std::shared_ptr<CPVREpgInfoTag>> matches;
@@ -415,37 +483,24 @@ namespace
       // match single channel
       const std::shared_ptr<CPVREpg> epg = channel->GetEPG();
       if (epg)
-      {
-        std::vector<std::shared_ptr<CPVREpgInfoTag>> tags = epg->GetTags();
-        for (const auto& tag : tags)
-        {
-          if (matcher.Matches(tag))
-            matches.emplace_back(tag);
-        }
-      }
+        AddEpgTagsForTimerRule(matcher, epg, matches);
     }
     else
     {
       // match any channel
       const std::vector<std::shared_ptr<CPVREpg>> epgs = CServiceBroker::GetPVRManager().EpgContainer().GetAllEpgs();
       for (const auto& epg : epgs)
-      {
-        std::vector<std::shared_ptr<CPVREpgInfoTag>> tags = epg->GetTags();
-        for (const auto& tag : tags)
-        {
-          if (matcher.Matches(tag))
-            matches.emplace_back(tag);
-        }
-      }
+        AddEpgTagsForTimerRule(matcher, epg, matches);
     }
 
     return matches;
   }
 
-  void AddTimerRuleToEpgMap(const std::shared_ptr<CPVRTimerInfoTag>& timer,
-                            const CDateTime& now,
-                            std::map<std::shared_ptr<CPVREpg>, std::vector<std::shared_ptr<CPVRTimerRuleMatcher>>>& epgMap,
-                            bool& bFetchedAllEpgs)
+  void AddTimerRuleToIndex(const std::shared_ptr<CPVRTimerInfoTag>& timer,
+                           const CDateTime& now,
+                           CPVRTimerRuleIndex& ruleIndex,
+                           std::map<int, std::shared_ptr<CPVREpg>>& epgs,
+                           bool& bFetchedAllEpgs)
   {
     const std::shared_ptr<CPVRChannel> channel = timer->Channel();
     if (channel)
@@ -453,39 +508,24 @@ namespace
       const std::shared_ptr<CPVREpg> epg = channel->GetEPG();
       if (epg)
       {
-        const std::shared_ptr<CPVRTimerRuleMatcher> matcher = std::make_shared<CPVRTimerRuleMatcher>(timer, now);
-        auto it = epgMap.find(epg);
-        if (it == epgMap.end())
-          epgMap.insert({epg, {matcher}});
-        else
-          it->second.emplace_back(matcher);
+        ruleIndex.Add(std::make_shared<CPVRTimerRuleMatcher>(timer, now), epg->EpgID());
+        epgs.insert({epg->EpgID(), epg});
       }
     }
     else
     {
       // rule matches "any channel" => we need to check all channels
+      ruleIndex.Add(std::make_shared<CPVRTimerRuleMatcher>(timer, now),
+                    CPVRTimerRuleIndex::ALL_EPGS);
+
       if (!bFetchedAllEpgs)
       {
-        const std::vector<std::shared_ptr<CPVREpg>> epgs = CServiceBroker::GetPVRManager().EpgContainer().GetAllEpgs();
-        for (const auto& epg : epgs)
-        {
-          const std::shared_ptr<CPVRTimerRuleMatcher> matcher = std::make_shared<CPVRTimerRuleMatcher>(timer, now);
-          auto it = epgMap.find(epg);
-          if (it == epgMap.end())
-            epgMap.insert({epg, {matcher}});
-          else
-            it->second.emplace_back(matcher);
-        }
+        const std::vector<std::shared_ptr<CPVREpg>> allEpgs = CServiceBroker::GetPVRManager().EpgContainer().GetAllEpgs();
+        for (const auto& epg : allEpgs)
+          epgs.insert({epg->EpgID(), epg});
+
         bFetchedAllEpgs = true;
       }
-      else
-      {
-        for (auto& epgMapEntry : epgMap)
-        {
-          const std::shared_ptr<CPVRTimerRuleMatcher> matcher = std::make_shared<CPVRTimerRuleMatcher>(timer, now);
-          epgMapEntry.second.emplace_back(matcher);
-        }
-      }
     }
   }
 } // unnamed namespace
@@ -497,7 +537,8 @@ bool CPVRTimers::UpdateEntries(int iMaxNotificationDelay)
   bool bChanged = false;
   const CDateTime now = CDateTime::GetUTCDateTime();
   bool bFetchedAllEpgs = false;
-  std::map<std::shared_ptr<CPVREpg>, std::vector<std::shared_ptr<CPVRTimerRuleMatcher>>> epgMap;
+  CPVRTimerRuleIndex ruleIndex;
+  std::map<int, std::shared_ptr<CPVREpg>> ruleEpgs;
 
   CSingleLock lock(m_critSection);
 
@@ -575,7 +616,7 @@ bool CPVRTimers::UpdateEntries(int iMaxNotificationDelay)
           if (timer->IsEpgBased())
           {
             if (m_bReminderRulesUpdatePending)
-              AddTimerRuleToEpgMap(timer, now, epgMap, bFetchedAllEpgs);
+              AddTimerRuleToIndex(timer, now, ruleIndex, ruleEpgs, bFetchedAllEpgs);
           }
           else
           {
@@ -631,19 +672,20 @@ bool CPVRTimers::UpdateEntries(int iMaxNotificationDelay)
   }
 
   // create new children of local epg-based reminder timer rules
-  for (const auto& epgMapEntry : epgMap)
+  for (const auto& ruleEpg : ruleEpgs)
   {
-    const auto epgTags = epgMapEntry.first->GetTags();
+    const CPlotsForMatching plots(ruleIndex.MatchesPlot(ruleEpg.first), ruleEpg.first, now);
+
+    const auto epgTags = GetCandidateTags(
+        *ruleEpg.second, ruleIndex.GetTimeWindows(ruleEpg.first, ruleEpg.second->GetLastDate()));
     for (const auto& epgTag : epgTags)
     {
-      if (GetTimerForEpgTag(epgTag))
+      const auto matchers = ruleIndex.GetMatches(epgTag, plots.Get(*epgTag));
+      if (matchers.empty() || GetTimerForEpgTag(epgTag))
         continue;
 
-      for (const auto& matcher : epgMapEntry.second)
+      for (const auto& matcher : matchers)
       {
-        if (!matcher->Matches(epgTag))
-          continue;
-
         const std::shared_ptr<CPVRTimerInfoTag> childTimer = CPVRTimerInfoTag::CreateReminderFromEpg(epgTag, matcher->GetTimerRule());
         if (childTimer)
         {
@@ -0,0 +1,373 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "XBDateTime.h"
+#include "pvr/epg/EpgChannelData.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/epg/EpgTimeIndex.h"
+#include "pvr/test/PVRMockBackend.h"
+#include "pvr/timers/PVRTimerRuleIndex.h"
+#include "pvr/timers/PVRTimerRuleMatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+constexpr int CLIENT_ID = 1;
+
+/*!
+ * @brief Get a UTC timestamp from local time.
+ */
+time_t LocalTime(int iYear, int iMonth, int iDay, int iHour, int iMinute)
+{
+  struct tm local = {};
+  local.tm_year = iYear - 1900;
+  local.tm_mon = iMonth - 1;
+  local.tm_mday = iDay;
+  local.tm_hour = iHour;
+  local.tm_min = iMinute;
+  local.tm_isdst = -1;
+  return mktime(&local);
+}
+
+std::shared_ptr<CPVREpgInfoTag> CreateTag(int iChannelUid,
+                                          time_t start,
+                                          int iMinutes,
+                                          const char* strTitle,
+                                          const char* strPlot = nullptr)
+{
+  EPG_TAG data = {};
+  data.iUniqueBroadcastId = static_cast<unsigned int>(start / 60);
+  data.iUniqueChannelId = iChannelUid;
+  data.strTitle = strTitle;
+  data.strPlot = strPlot;
+  data.startTime = start;
+  data.endTime = start + iMinutes * 60;
+  data.iEpisodePartNumber = -1;
+  return std::make_shared<CPVREpgInfoTag>(
+      data, CLIENT_ID, std::make_shared<CPVREpgChannelData>(CLIENT_ID, iChannelUid), iChannelUid);
+}
+
+using Match = std::pair<const CPVREpgInfoTag*, const CPVRTimerRuleMatcher*>;
+} // unnamed namespace
+
+TEST(TestPVRTimerRuleMatcher, SearchText)
+{
+  const CDateTime now(LocalTime(2021, 3, 1, 0, 0));
+  const auto tag = CreateTag(1, LocalTime(2021, 3, 1, 20, 15), 90, "The Evening News",
+                             "A look at the news of the day");
+
+  CPVRTimerRuleMatcher::Criteria criteria;
+  criteria.textMatch = CPVRTimerRuleMatcher::TextMatch::TITLE;
+
+  criteria.strSearchText = "evening NEWS";
+  EXPECT_TRUE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+
+  criteria.strSearchText = "^the .* news$";
+  EXPECT_TRUE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+
+  criteria.strSearchText = "news of the day";
+  EXPECT_FALSE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+
+  criteria.textMatch = CPVRTimerRuleMatcher::TextMatch::FULLTEXT;
+  EXPECT_TRUE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+
+  criteria.strSearchText = "";
+  EXPECT_TRUE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+
+  // a plot at hand is searched instead of the tag's
+  criteria.strSearchText = "weather";
+  const CPVRTimerRuleMatcher matcher(criteria, now);
+  const CPVRTimerRuleMatcher::TagTimes times(*tag);
+  const std::string strPlot = "The weather of tomorrow";
+  EXPECT_FALSE(matcher.Matches(*tag, times));
+  EXPECT_TRUE(matcher.Matches(*tag, times, &strPlot));
+
+  CPVRTimerRuleIndex index;
+  EXPECT_FALSE(index.MatchesPlot(1));
+  index.Add(std::make_shared<CPVRTimerRuleMatcher>(criteria, now), CPVRTimerRuleIndex::ALL_EPGS);
+  EXPECT_TRUE(index.MatchesPlot(1));
+  EXPECT_EQ(1u, index.GetMatches(tag, &strPlot).size());
+}
+
+TEST(TestPVRTimerRuleMatcher, Times)
+{
+  const CDateTime now(LocalTime(2021, 3, 1, 0, 0));
+  // Monday, 2021-03-01 20:15 - 21:45
+  const auto tag = CreateTag(1, LocalTime(2021, 3, 1, 20, 15), 90, "Movie");
+
+  CPVRTimerRuleMatcher::Criteria criteria;
+  EXPECT_TRUE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+
+  // rules do not match tags that ended before the rule's start
+  EXPECT_FALSE(CPVRTimerRuleMatcher(criteria, CDateTime(LocalTime(2021, 3, 2, 0, 0))).Matches(tag));
+
+  criteria.iStartMinutes = 20 * 60 + 15;
+  criteria.iEndMinutes = 21 * 60 + 45;
+  EXPECT_TRUE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+  criteria.iStartMinutes = 20 * 60 + 16;
+  EXPECT_FALSE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+  criteria.iStartMinutes = -1;
+  criteria.iEndMinutes = 21 * 60 + 44;
+  EXPECT_FALSE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+  criteria.iEndMinutes = -1;
+
+  criteria.iWeekdays = PVR_WEEKDAY_SATURDAY | PVR_WEEKDAY_SUNDAY;
+  EXPECT_FALSE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+  criteria.iWeekdays = PVR_WEEKDAY_MONDAY;
+  EXPECT_TRUE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+
+  criteria.iFirstDay = 20210302;
+  EXPECT_FALSE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+  criteria.iFirstDay = 20210301;
+  EXPECT_TRUE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+}
+
+TEST(TestPVRTimerRuleMatcher, Channel)
+{
+  const CDateTime now(LocalTime(2021, 3, 1, 0, 0));
+  const auto tag = CreateTag(7, LocalTime(2021, 3, 1, 20, 15), 90, "Movie");
+
+  CPVRTimerRuleMatcher::Criteria criteria;
+  criteria.bAnyChannel = false;
+  criteria.iClientId = CLIENT_ID;
+  criteria.iClientChannelUid = 7;
+  EXPECT_TRUE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+  criteria.iClientChannelUid = 8;
+  EXPECT_FALSE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+  criteria.iClientChannelUid = PVR_CHANNEL_INVALID_UID;
+  EXPECT_FALSE(CPVRTimerRuleMatcher(criteria, now).Matches(tag));
+}
+
+TEST(TestPVRTimerRuleMatcher, IndexStartBucket)
+{
+  const CDateTime now(LocalTime(2021, 3, 1, 0, 0));
+
+  CPVRTimerRuleMatcher::Criteria criteria;
+  criteria.iStartMinutes = 20 * 60 + 10;
+  criteria.iWeekdays = PVR_WEEKDAY_MONDAY;
+
+  CPVRTimerRuleIndex index;
+  EXPECT_TRUE(index.IsEmpty());
+  index.Add(std::make_shared<CPVRTimerRuleMatcher>(criteria, now), CPVRTimerRuleIndex::ALL_EPGS);
+  EXPECT_FALSE(index.IsEmpty());
+
+  EXPECT_EQ(1u, index.GetMatches(CreateTag(1, LocalTime(2021, 3, 1, 20, 15), 30, "A")).size());
+  EXPECT_EQ(0u, index.GetMatches(CreateTag(1, LocalTime(2021, 3, 1, 20, 5), 30, "A")).size());
+  EXPECT_EQ(0u, index.GetMatches(CreateTag(1, LocalTime(2021, 3, 1, 19, 59), 30, "A")).size());
+  EXPECT_EQ(1u, index.GetMatches(CreateTag(2, LocalTime(2021, 3, 1, 23, 0), 30, "A")).size());
+  EXPECT_EQ(0u, index.GetMatches(CreateTag(2, LocalTime(2021, 3, 2, 21, 0), 30, "A")).size());
+}
+
+TEST(TestPVRTimerRuleMatcher, TimeWindows)
+{
+  const CDateTime now(LocalTime(2021, 3, 1, 0, 0));
+  const CDateTime guideEnd(LocalTime(2021, 3, 14, 0, 0));
+
+  CPVRTimerRuleMatcher::Criteria criteria;
+  std::vector<CPVRTimerRuleMatcher::TimeWindow> windows =
+      CPVRTimerRuleMatcher(criteria, now).GetTimeWindows(guideEnd);
+  ASSERT_EQ(1u, windows.size());
+  EXPECT_EQ(CDateTime(LocalTime(2021, 3, 1, 0, 0) + 1), windows.front().first);
+  EXPECT_EQ(guideEnd, windows.front().second);
+
+  // Mondays from 20:10
+  criteria.iStartMinutes = 20 * 60 + 10;
+  criteria.iWeekdays = PVR_WEEKDAY_MONDAY;
+  windows = CPVRTimerRuleMatcher(criteria, now).GetTimeWindows(guideEnd);
+  ASSERT_EQ(2u, windows.size());
+  EXPECT_EQ(CDateTime(LocalTime(2021, 3, 1, 20, 10)), windows[0].first);
+  EXPECT_EQ(CDateTime(LocalTime(2021, 3, 1, 23, 59) + 59), windows[0].second);
+  EXPECT_EQ(CDateTime(LocalTime(2021, 3, 8, 20, 10)), windows[1].first);
+
+  // the index merges overlapping windows of the rules
+  CPVRTimerRuleIndex index;
+  index.Add(std::make_shared<CPVRTimerRuleMatcher>(criteria, now), 1);
+  criteria.iStartMinutes = 22 * 60;
+  criteria.iWeekdays = PVR_WEEKDAY_MONDAY | PVR_WEEKDAY_TUESDAY;
+  index.Add(std::make_shared<CPVRTimerRuleMatcher>(criteria, now), CPVRTimerRuleIndex::ALL_EPGS);
+  windows = index.GetTimeWindows(1, guideEnd);
+  ASSERT_EQ(4u, windows.size());
+  EXPECT_EQ(CDateTime(LocalTime(2021, 3, 1, 20, 10)), windows[0].first);
+  EXPECT_EQ(CDateTime(LocalTime(2021, 3, 1, 23, 59) + 59), windows[0].second);
+  EXPECT_EQ(CDateTime(LocalTime(2021, 3, 2, 22, 0)), windows[1].first);
+  EXPECT_EQ(CDateTime(LocalTime(2021, 3, 1, 22, 0)), index.GetTimeWindows(2, guideEnd)[0].first);
+}
+
+class TestPVRTimerRuleIndex : public ::testing::Test
+{
+protected:
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  std::vector<std::pair<int, std::shared_ptr<CPVRTimerRuleMatcher>>> rules; // EPG id, matcher
+
+  void CreateGuide(const CPVRMockBackend& backend)
+  {
+    const auto& settings = backend.GetSettings();
+    for (int iChannel = 1; iChannel <= settings.iChannels; iChannel++)
+    {
+      const auto channelData = std::make_shared<CPVREpgChannelData>(CLIENT_ID, iChannel);
+      backend.GetEPGForChannel(
+          iChannel, CPVRMockBackend::GUIDE_START,
+          CPVRMockBackend::GUIDE_START + settings.iEpgDays * 24 * 60 * 60,
+          [&](const EPG_TAG& data) {
+            tags.emplace_back(std::make_shared<CPVREpgInfoTag>(data, CLIENT_ID, channelData,
+                                                               iChannel));
+          });
+    }
+  }
+
+  /*!
+   * @brief Create rules of different kinds: for one channel or any channel, with literal and
+   * regular expression title searches, weekday and start time restrictions.
+   */
+  void CreateRules(int iRules, int iChannels)
+  {
+    const CDateTime now(CPVRMockBackend::GUIDE_START);
+    for (int i = 0; i < iRules; i++)
+    {
+      CPVRTimerRuleMatcher::Criteria criteria;
+      int iEpgId = CPVRTimerRuleIndex::ALL_EPGS;
+      if (i % 2 == 1)
+      {
+        criteria.bAnyChannel = false;
+        criteria.iClientId = CLIENT_ID;
+        criteria.iClientChannelUid = i % iChannels + 1;
+        iEpgId = criteria.iClientChannelUid;
+      }
+
+      criteria.textMatch = (i % 7 == 0) ? CPVRTimerRuleMatcher::TextMatch::FULLTEXT
+                                        : CPVRTimerRuleMatcher::TextMatch::TITLE;
+      criteria.strSearchText = (i % 4 == 1) ? "^show " + std::to_string(i % 5) + "[0-9]$"
+                                            : "Show " + std::to_string(i % 50);
+
+      if (i % 3 == 0)
+        criteria.iWeekdays = PVR_WEEKDAY_SATURDAY | PVR_WEEKDAY_SUNDAY;
+      if (i % 5 == 0)
+        criteria.iStartMinutes = 18 * 60 + 30;
+
+      rules.emplace_back(iEpgId, std::make_shared<CPVRTimerRuleMatcher>(criteria, now));
+    }
+  }
+
+  /*!
+   * @brief Evaluate every rule applying to a tag's EPG against the tag.
+   */
+  std::vector<Match> MatchAll() const
+  {
+    std::vector<Match> matches;
+    for (const auto& tag : tags)
+    {
+      for (const auto& rule : rules)
+      {
+        if ((rule.first == CPVRTimerRuleIndex::ALL_EPGS || rule.first == tag->EpgID()) &&
+            rule.second->Matches(tag))
+          matches.emplace_back(tag.get(), rule.second.get());
+      }
+    }
+    return matches;
+  }
+
+  /*!
+   * @brief Look up the candidate tags of each EPG in its time index, then match them through the
+   * rule index, as CPVRTimers does.
+   */
+  std::vector<Match> MatchIndexed(const std::map<int, CPVREpgTimeIndex>& timeIndexes,
+                                  size_t& iCandidates) const
+  {
+    CPVRTimerRuleIndex index;
+    for (const auto& rule : rules)
+      index.Add(rule.second, rule.first);
+
+    std::vector<Match> matches;
+    for (const auto& timeIndex : timeIndexes)
+    {
+      std::shared_ptr<CPVREpgInfoTag> lastTag;
+      for (const auto& window :
+           index.GetTimeWindows(timeIndex.first, timeIndex.second.GetLastEndTime()))
+      {
+        for (const auto& tag : timeIndex.second.GetTags(window.first, window.second))
+        {
+          // a tag overlapping two windows is found in both
+          if (lastTag && tag->StartAsUTC() <= lastTag->StartAsUTC())
+            continue;
+
+          lastTag = tag;
+          iCandidates++;
+          for (const auto& matcher : index.GetMatches(tag))
+            matches.emplace_back(tag.get(), matcher.get());
+        }
+      }
+    }
+    return matches;
+  }
+
+  void RunBenchmark(const CPVRMockBackend::Settings& settings, int iRules, bool bCompare)
+  {
+    CreateGuide(CPVRMockBackend(settings));
+    CreateRules(iRules, settings.iChannels);
+
+    std::map<int, CPVREpgTimeIndex> timeIndexes; // the EPGs are in memory already
+    for (const auto& tag : tags)
+      timeIndexes[tag->EpgID()].Insert(tag);
+
+    size_t iCandidates = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Match> indexed = MatchIndexed(timeIndexes, iCandidates);
+    const auto indexedTime = std::chrono::steady_clock::now() - start;
+
+    RecordProperty("tags", static_cast<int>(tags.size()));
+    RecordProperty("candidates", static_cast<int>(iCandidates));
+    RecordProperty("rules", iRules);
+    RecordProperty("matches", static_cast<int>(indexed.size()));
+    RecordProperty("indexed_ms", static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(indexedTime).count()));
+    EXPECT_FALSE(indexed.empty());
+
+    if (!bCompare)
+      return;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<Match> all = MatchAll();
+    const auto allTime = std::chrono::steady_clock::now() - start;
+
+    RecordProperty("all_ms", static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(allTime).count()));
+
+    std::sort(indexed.begin(), indexed.end());
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(all, indexed);
+  }
+};
+
+TEST_F(TestPVRTimerRuleIndex, SameMatchesAsAllRules)
+{
+  CPVRMockBackend::Settings settings;
+  settings.iChannels = 50;
+  settings.iEpgDays = 7;
+  RunBenchmark(settings, 200, true);
+}
+
+TEST_F(TestPVRTimerRuleIndex, DISABLED_LargeGuide)
+{
+  // 200 rules against 500k EPG events: run with --gtest_also_run_disabled_tests
+  CPVRMockBackend::Settings settings;
+  settings.iChannels = 1500;
+  settings.iEpgDays = 14;
+  RunBenchmark(settings, 200, false);
+}
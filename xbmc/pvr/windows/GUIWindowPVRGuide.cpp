@@ -39,6 +39,7 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "utils/PerformanceTrace.h"
 #include "view/GUIViewState.h"
 
 #include <functional>
@@ -54,6 +55,7 @@ CGUIWindowPVRGuideBase::CGUIWindowPVRGuideBase(bool bRadio, int id, const std::s
 {
   m_bRefreshTimelineItems = false;
   m_bSyncRefreshTimelineItems = false;
+  m_bRefreshTimelineItemsEpg = false;
   CServiceBroker::GetPVRManager().EpgContainer().Events().Subscribe(static_cast<CGUIWindowPVRBase*>(this), &CGUIWindowPVRBase::Notify);
 }
 
@@ -63,6 +65,7 @@ CGUIWindowPVRGuideBase::~CGUIWindowPVRGuideBase()
 
   m_bRefreshTimelineItems = false;
   m_bSyncRefreshTimelineItems = false;
+  m_bRefreshTimelineItemsEpg = false;
   StopRefreshTimelineItemsThread();
 }
 
@@ -151,10 +154,13 @@ void CGUIWindowPVRGuideBase::StopRefreshTimelineItemsThread()
 
 void CGUIWindowPVRGuideBase::NotifyEvent(const PVREvent& event)
 {
-  if (event == PVREvent::Epg ||
-      event == PVREvent::EpgContainer ||
-      event == PVREvent::ChannelGroupInvalidated ||
-      event == PVREvent::ChannelGroup)
+  if (event == PVREvent::Epg || event == PVREvent::EpgContainer)
+  {
+    m_bRefreshTimelineItemsEpg = true;
+    // no base class call => do async refresh
+    return;
+  }
+  else if (event == PVREvent::ChannelGroupInvalidated || event == PVREvent::ChannelGroup)
   {
     m_bRefreshTimelineItems = true;
     // no base class call => do async refresh
@@ -668,10 +674,16 @@ bool CGUIWindowPVRGuideBase::OnContextButtonNavigate(CONTEXT_BUTTON button)
 
 bool CGUIWindowPVRGuideBase::RefreshTimelineItems()
 {
-  if (m_bRefreshTimelineItems || m_bSyncRefreshTimelineItems)
+  if (m_bRefreshTimelineItems || m_bSyncRefreshTimelineItems || m_bRefreshTimelineItemsEpg)
   {
+    CPerformanceTraceSpan span("PVRGuide::RefreshTimelineItems");
+
+    // channels are unchanged if only EPG data changed, no need to recreate the grid
+    const bool bEpgOnly = !m_bRefreshTimelineItems && !m_bSyncRefreshTimelineItems;
+
     m_bRefreshTimelineItems = false;
     m_bSyncRefreshTimelineItems = false;
+    m_bRefreshTimelineItemsEpg = false;
 
     CGUIEPGGridContainer* epgGridContainer = GetGridControl();
     if (epgGridContainer)
@@ -704,6 +716,9 @@ bool CGUIWindowPVRGuideBase::RefreshTimelineItems()
       if (endDate > maxFutureDate)
         endDate = maxFutureDate;
 
+      if (bEpgOnly && epgGridContainer->UpdateTimelineItemsEpg(startDate, endDate))
+        return true;
+
       std::unique_ptr<CFileItemList> channels(new CFileItemList);
       const std::vector<std::shared_ptr<CPVRChannelGroupMember>> groupMembers =
           group->GetMembers(CPVRChannelGroup::Include::ONLY_VISIBLE);
@@ -90,6 +90,7 @@ namespace PVR
     std::unique_ptr<CPVRRefreshTimelineItemsThread> m_refreshTimelineItemsThread;
     std::atomic_bool m_bRefreshTimelineItems;
     std::atomic_bool m_bSyncRefreshTimelineItems;
+    std::atomic_bool m_bRefreshTimelineItemsEpg; // only EPG data changed, channels are unchanged
 
     std::shared_ptr<CPVRChannelGroup> m_cachedChannelGroup;
 
@@ -277,6 +277,7 @@ void CAdvancedSettings::Initialize()
   m_bMusicLibraryCleanOnUpdate = false;
   m_bMusicLibraryArtistSortOnUpdate = false;
   m_iMusicLibraryRecentlyAddedItems = 25;
+  m_iMusicLibraryTagReaderThreads = 4;
   m_strMusicLibraryAlbumFormat = "";
   m_prioritiseAPEv2tags = false;
   m_musicItemSeparator = " / ";
@@ -293,6 +294,7 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
+  m_iVideoLibraryStreamDetailsThreads = 4;
 
   m_videoEpisodeExtraArt = {};
   m_videoTvShowExtraArt = {};
@@ -322,6 +324,10 @@ void CAdvancedSettings::Initialize()
                                                       updateemptytagsinterval = 3600 => trigger an EPG update for every
                                                       channel without EPG data every 2 hours and trigger an EPG update
                                                       for every channel with EPG data every 1 hour. */
+  m_iEpgUpdateThreadsPerClient = 1; /* Number of channels to fetch EPG data for at a time from one client. Different
+                                       clients are always updated concurrently. 1 updates a client's channels one
+                                       after the other, add-ons may declare more with the epgupdatethreads attribute
+                                       of their extension point. */
   m_bEpgDisplayUpdatePopup = true; /* Display a progress popup while updating EPG data from clients */
   m_bEpgDisplayIncrementalUpdatePopup = false; /* Display a progress popup while doing incremental EPG updates, but
                                                   only if 'displayupdatepopup' is also enabled. */
@@ -378,6 +384,8 @@ void CAdvancedSettings::Initialize()
   m_iPVRNumericChannelSwitchTimeout = 2000;
   m_iPVRTimeshiftThreshold = 10;
   m_bPVRTimeshiftSimpleOSD = true;
+  m_iPVRPreTuneChannels = 0;
+  m_iPVRTimeshiftBufferSize = 0;
   m_PVRDefaultSortOrder.sortBy = SortByDate;
   m_PVRDefaultSortOrder.sortOrder = SortOrderDescending;
 
@@ -766,6 +774,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetInt(pElement, "recentlyaddeditems", m_iMusicLibraryRecentlyAddedItems, 1, INT_MAX);
+    XMLUtils::GetInt(pElement, "tagreaderthreads", m_iMusicLibraryTagReaderThreads, 1, 16);
     XMLUtils::GetBoolean(pElement, "prioritiseapetags", m_prioritiseAPEv2tags);
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bMusicLibraryCleanOnUpdate);
@@ -803,6 +812,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "importwatchedstate", m_bVideoLibraryImportWatchedState);
     XMLUtils::GetBoolean(pElement, "importresumepoint", m_bVideoLibraryImportResumePoint);
     XMLUtils::GetInt(pElement, "dateadded", m_iVideoLibraryDateAdded);
+    XMLUtils::GetInt(pElement, "streamdetailsthreads", m_iVideoLibraryStreamDetailsThreads, 0,
+                     16);
 
     SetExtraArtwork(pElement->FirstChildElement("episodeextraart"), m_videoEpisodeExtraArt);
     SetExtraArtwork(pElement->FirstChildElement("tvshowextraart"), m_videoTvShowExtraArt);
@@ -934,6 +945,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "activetagcheckinterval", m_iEpgActiveTagCheckInterval);
     XMLUtils::GetInt(pElement, "retryinterruptedupdateinterval", m_iEpgRetryInterruptedUpdateInterval);
     XMLUtils::GetInt(pElement, "updateemptytagsinterval", m_iEpgUpdateEmptyTagsInterval);
+    XMLUtils::GetInt(pElement, "updatethreadsperclient", m_iEpgUpdateThreadsPerClient, 1, 16);
     XMLUtils::GetBoolean(pElement, "displayupdatepopup", m_bEpgDisplayUpdatePopup);
     XMLUtils::GetBoolean(pElement, "displayincrementalupdatepopup", m_bEpgDisplayIncrementalUpdatePopup);
   }
@@ -1117,6 +1129,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pPVR, "numericchannelswitchtimeout", m_iPVRNumericChannelSwitchTimeout, 50, 60000);
     XMLUtils::GetInt(pPVR, "timeshiftthreshold", m_iPVRTimeshiftThreshold, 0, 60);
     XMLUtils::GetBoolean(pPVR, "timeshiftsimpleosd", m_bPVRTimeshiftSimpleOSD);
+    XMLUtils::GetInt(pPVR, "pretunechannels", m_iPVRPreTuneChannels, 0, 4);
+    XMLUtils::GetInt(pPVR, "timeshiftbuffersize", m_iPVRTimeshiftBufferSize, 0, 65536);
     TiXmlElement* pSortDecription = pPVR->FirstChildElement("pvrrecordings");
     if (pSortDecription)
     {
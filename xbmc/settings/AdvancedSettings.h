@@ -235,6 +235,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     std::vector<std::string> m_musicAlbumExtraArt;
 
     int m_iMusicLibraryRecentlyAddedItems;
+    int m_iMusicLibraryTagReaderThreads;
     int m_iMusicLibraryDateAdded;
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryCleanOnUpdate;
@@ -262,6 +263,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     bool m_bVideoScannerIgnoreErrors;
     int m_iVideoLibraryDateAdded;
+    int m_iVideoLibraryStreamDetailsThreads; // 0 = don't probe stream details while scanning
 
     std::set<std::string> m_vecTokens;
 
@@ -270,6 +272,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iEpgActiveTagCheckInterval; // seconds
     int m_iEpgRetryInterruptedUpdateInterval; // seconds
     int m_iEpgUpdateEmptyTagsInterval; // seconds
+    int m_iEpgUpdateThreadsPerClient; // EPGs updated at a time per client, clients are updated concurrently
     bool m_bEpgDisplayUpdatePopup;
     bool m_bEpgDisplayIncrementalUpdatePopup;
 
@@ -323,6 +326,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iPVRNumericChannelSwitchTimeout; /*!< @brief time in msecs after that a channel switch occurs after entering a channel number, if confirmchannelswitch is disabled */
     int m_iPVRTimeshiftThreshold; /*!< @brief time diff between current playing time and timeshift buffer end, in seconds, before a playing stream is displayed as timeshifting. */
     bool m_bPVRTimeshiftSimpleOSD; /*!< @brief use simple timeshift OSD (with progress only for the playing event instead of progress for the whole ts buffer). */
+    int m_iPVRPreTuneChannels; /*!< @brief number of channels likely to be switched to next whose stream properties are obtained in advance. defaults to 0 (disabled). */
+    int m_iPVRTimeshiftBufferSize; /*!< @brief size in MiB of the local timeshift buffer used for live streams the pvr backend can not pause or seek. defaults to 0 (disabled). */
     SortDescription m_PVRDefaultSortOrder; /*!< @brief SortDecription used to store default recording sort type and sort order */
 
     DatabaseSettings m_databaseMusic; // advanced music database setup
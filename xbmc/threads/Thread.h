@@ -42,6 +42,7 @@ public:
   bool IsRunning() const;
 
   bool IsCurrentThread() const;
+  const std::string& GetName() const { return m_ThreadName; }
   bool Join(unsigned int milliseconds);
 
   inline static const std::thread::id GetCurrentThreadId()
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "WorkerPool.h"
+
+#include "threads/IRunnable.h"
+#include "threads/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+class CWorkerPoolRunnable : public IRunnable
+{
+public:
+  CWorkerPoolRunnable(size_t count,
+                      const std::function<void(size_t)>& work,
+                      const std::function<bool()>& stop)
+    : m_count(count), m_work(work), m_stop(stop)
+  {
+  }
+
+  void Run() override
+  {
+    while (!m_stopped)
+    {
+      if (m_stop && m_stop())
+      {
+        m_stopped = true;
+        break;
+      }
+
+      const size_t index = m_next++;
+      if (index >= m_count)
+        break;
+
+      m_work(index);
+    }
+  }
+
+  bool IsStopped() const { return m_stopped; }
+
+private:
+  const size_t m_count;
+  const std::function<void(size_t)>& m_work;
+  const std::function<bool()>& m_stop;
+  std::atomic<size_t> m_next{0};
+  std::atomic<bool> m_stopped{false};
+};
+
+} // unnamed namespace
+
+CWorkerPool::CWorkerPool(unsigned int workers, const std::string& name)
+  : m_workers(std::max(workers, 1u)), m_name(name)
+{
+}
+
+bool CWorkerPool::ForEach(size_t count,
+                          const std::function<void(size_t)>& work,
+                          const std::function<bool()>& stop /* = nullptr */)
+{
+  if (count == 0)
+    return !(stop && stop());
+
+  CWorkerPoolRunnable runnable(count, work, stop);
+
+  const size_t extraThreads = std::min<size_t>(m_workers, count) - 1;
+  std::vector<std::unique_ptr<CThread>> threads;
+  threads.reserve(extraThreads);
+  for (size_t i = 0; i < extraThreads; ++i)
+  {
+    threads.emplace_back(new CThread(&runnable, m_name.c_str()));
+    threads.back()->Create();
+  }
+
+  runnable.Run();
+
+  // wait for the other workers to finish their last item. the runnable doesn't look at the thread's
+  // stop flag, StopThread(true) only joins the threads once they ran out of items
+  for (auto& thread : threads)
+    thread->StopThread(true);
+
+  return !runnable.IsStopped();
+}
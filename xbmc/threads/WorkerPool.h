@@ -0,0 +1,46 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <functional>
+#include <stddef.h>
+#include <string>
+
+/*!
+ * \brief Runs a batch of independent work items on a bounded number of threads.
+ *
+ * The calling thread takes part in the work, so a pool created with one
+ * worker does not spawn any threads at all. Items are handed out in index
+ * order; results should be written to per-index storage by the caller.
+ */
+class CWorkerPool
+{
+public:
+  /*!
+   * \param workers maximum number of threads working on a batch, including the caller
+   * \param name name given to the spawned threads
+   */
+  CWorkerPool(unsigned int workers, const std::string& name);
+
+  /*!
+   * \brief Call work(i) for every i in [0, count) and wait until all calls returned.
+   * \param stop optional predicate polled before every item, no new items are
+   *             started once it returns true
+   * \return false if the batch was stopped before all items were processed
+   */
+  bool ForEach(size_t count,
+               const std::function<void(size_t)>& work,
+               const std::function<bool()>& stop = nullptr);
+
+  unsigned int GetWorkers() const { return m_workers; }
+
+private:
+  unsigned int m_workers;
+  std::string m_name;
+};
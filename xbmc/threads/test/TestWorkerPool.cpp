@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/WorkerPool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(TestWorkerPool, ProcessesEveryItemOnce)
+{
+  CWorkerPool pool(4, "TestWorkerPool");
+
+  std::vector<std::atomic<int>> calls(1000);
+  for (auto& call : calls)
+    call = 0;
+
+  EXPECT_TRUE(pool.ForEach(calls.size(), [&calls](size_t i) { calls[i]++; }));
+
+  for (const auto& call : calls)
+    EXPECT_EQ(call, 1);
+}
+
+TEST(TestWorkerPool, SingleWorkerRunsInline)
+{
+  CWorkerPool pool(1, "TestWorkerPool");
+
+  const auto caller = std::this_thread::get_id();
+  bool sameThread = true;
+  EXPECT_TRUE(pool.ForEach(10, [&](size_t) { sameThread &= std::this_thread::get_id() == caller; }));
+  EXPECT_TRUE(sameThread);
+}
+
+TEST(TestWorkerPool, StopPredicate)
+{
+  CWorkerPool pool(2, "TestWorkerPool");
+
+  std::atomic<int> processed{0};
+  EXPECT_FALSE(pool.ForEach(
+      1000, [&processed](size_t) { processed++; }, [&processed]() { return processed >= 10; }));
+  EXPECT_LT(processed, 1000);
+}
+
+TEST(TestWorkerPool, EmptyBatch)
+{
+  CWorkerPool pool(4, "TestWorkerPool");
+  EXPECT_TRUE(pool.ForEach(0, [](size_t) { FAIL(); }));
+}
@@ -549,6 +549,27 @@ std::string DatabaseUtils::BuildLimitClauseOnly(int end, int start /* = 0 */)
   return sql.str();
 }
 
+std::string DatabaseUtils::BuildFullTextMatch(const std::string& search,
+                                              const std::vector<std::string>& columns,
+                                              bool anchorStart /* = false */)
+{
+  std::string phrase = search;
+  StringUtils::Trim(phrase);
+  if (phrase.empty())
+    return phrase;
+
+  // FTS5 strings are quoted with double quotes, which are escaped by doubling them
+  StringUtils::Replace(phrase, "\"", "\"\"");
+
+  std::string match;
+  if (!columns.empty())
+    match = "{" + StringUtils::Join(columns, " ") + "} : ";
+  if (anchorStart)
+    match += "^";
+  match += "\"" + phrase + "\"*";
+  return match;
+}
+
 size_t DatabaseUtils::GetLimitCount(int end, int start)
 {
   if (start > 0)
@@ -177,6 +177,17 @@ public:
   static std::string BuildLimitClauseOnly(int end, int start = 0);
   static size_t GetLimitCount(int end, int start);
 
+  /*! \brief Build an FTS5 match expression for a search as typed by the user.
+   The whole search is matched as a phrase whose last word may be incomplete.
+   \param search the text to search for
+   \param columns restrict the match to these columns of the index, all if empty
+   \param anchorStart only match if the phrase is at the start of the column
+   \return the match expression or an empty string if there is nothing to search for
+   */
+  static std::string BuildFullTextMatch(const std::string& search,
+                                        const std::vector<std::string>& columns,
+                                        bool anchorStart = false);
+
 private:
   static int GetField(Field field, const MediaType &mediaType, bool asIndex);
 };
@@ -15,6 +15,7 @@ class CJob;
 #define kJobTypeMediaFlags  "mediaflags"
 #define kJobTypeCacheImage  "cacheimage"
 #define kJobTypeDDSCompress "ddscompress"
+#define kJobTypeSpriteSheet "spritesheet"
 
 /*!
  \ingroup jobs
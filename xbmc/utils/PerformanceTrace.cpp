@@ -0,0 +1,266 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PerformanceTrace.h"
+
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace
+{
+enum class EventType
+{
+  SPAN,
+  COUNTER,
+  INSTANT
+};
+
+struct SEvent
+{
+  const char* name;
+  int64_t time; // us
+  int64_t duration; // us
+  double value;
+  EventType type;
+};
+
+struct SThreadBuffer
+{
+  std::unique_ptr<SEvent[]> events{new SEvent[CPerformanceTrace::EVENTS_PER_THREAD]};
+  std::atomic<uint64_t> head{0}; // events ever written
+  uint64_t startHead = 0; // first event recorded since CPerformanceTrace::Start()
+  uint64_t threadId = 0;
+  std::string threadName;
+  bool used = true; // a running thread owns the buffer
+};
+
+struct SRegistry
+{
+  CCriticalSection section;
+  std::vector<std::unique_ptr<SThreadBuffer>> buffers;
+  int64_t startTime = 0; // us, the time base of the export
+};
+
+SRegistry& GetRegistry()
+{
+  static SRegistry registry;
+  return registry;
+}
+
+// hands the buffer on to a later thread once its thread ended
+struct SThreadSlot
+{
+  SThreadBuffer* buffer = nullptr;
+
+  ~SThreadSlot()
+  {
+    if (buffer)
+    {
+      SRegistry& registry = GetRegistry();
+      CSingleLock lock(registry.section);
+      buffer->used = false;
+    }
+  }
+};
+
+thread_local SThreadSlot threadSlot;
+
+int64_t ToMicroseconds(CPerformanceTrace::Clock::time_point time)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+SThreadBuffer* GetThreadBuffer()
+{
+  if (threadSlot.buffer)
+    return threadSlot.buffer;
+
+  SRegistry& registry = GetRegistry();
+  CSingleLock lock(registry.section);
+
+  auto it = std::find_if(registry.buffers.begin(), registry.buffers.end(),
+                         [](const std::unique_ptr<SThreadBuffer>& buffer) { return !buffer->used; });
+  SThreadBuffer* buffer;
+  if (it != registry.buffers.end())
+  {
+    buffer = it->get();
+    buffer->head = 0;
+    buffer->startHead = 0;
+    buffer->used = true;
+  }
+  else
+  {
+    registry.buffers.emplace_back(new SThreadBuffer);
+    buffer = registry.buffers.back().get();
+  }
+
+  buffer->threadId = CThread::GetCurrentThreadNativeId();
+  const CThread* thread = CThread::GetCurrentThread();
+  if (thread && !thread->GetName().empty())
+    buffer->threadName = thread->GetName();
+  else
+    buffer->threadName = StringUtils::Format("Thread {}", buffer->threadId);
+
+  threadSlot.buffer = buffer;
+  return buffer;
+}
+
+void Record(const SEvent& event)
+{
+  SThreadBuffer* buffer = GetThreadBuffer();
+  const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  buffer->events[head % CPerformanceTrace::EVENTS_PER_THREAD] = event;
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+std::vector<SEvent> GetEvents(const SThreadBuffer& buffer)
+{
+  constexpr uint64_t size = CPerformanceTrace::EVENTS_PER_THREAD;
+
+  const uint64_t end = buffer.head.load(std::memory_order_acquire);
+  const uint64_t begin = std::max(end > size ? end - size : 0, buffer.startHead);
+
+  std::vector<SEvent> events;
+  events.reserve(end - begin);
+  for (uint64_t i = begin; i < end; i++)
+    events.push_back(buffer.events[i % size]);
+
+  // the thread keeps recording, drop the events it overwrote while copying, including the one
+  // it might be writing
+  const uint64_t head = buffer.head.load(std::memory_order_acquire);
+  const uint64_t written = head == end ? head : head + 1;
+  const uint64_t valid = written > size ? written - size : 0;
+  if (valid > begin)
+    events.erase(events.begin(),
+                 events.begin() + std::min<uint64_t>(valid - begin, events.size()));
+
+  return events;
+}
+} // namespace
+
+std::atomic<bool> CPerformanceTrace::m_enabled{false};
+
+void CPerformanceTrace::Start()
+{
+  SRegistry& registry = GetRegistry();
+  CSingleLock lock(registry.section);
+  for (auto& buffer : registry.buffers)
+    buffer->startHead = buffer->head.load(std::memory_order_acquire);
+
+  registry.startTime = ToMicroseconds(Clock::now());
+  m_enabled = true;
+}
+
+void CPerformanceTrace::Stop()
+{
+  m_enabled = false;
+}
+
+void CPerformanceTrace::AddSpan(const char* name, Clock::time_point start)
+{
+  if (!IsEnabled())
+    return;
+
+  const int64_t time = ToMicroseconds(start);
+  Record({name, time, ToMicroseconds(Clock::now()) - time, 0.0, EventType::SPAN});
+}
+
+void CPerformanceTrace::AddCounter(const char* name, double value)
+{
+  if (!IsEnabled() || !std::isfinite(value))
+    return;
+
+  Record({name, ToMicroseconds(Clock::now()), 0, value, EventType::COUNTER});
+}
+
+void CPerformanceTrace::AddInstant(const char* name)
+{
+  if (!IsEnabled())
+    return;
+
+  Record({name, ToMicroseconds(Clock::now()), 0, 0.0, EventType::INSTANT});
+}
+
+std::string CPerformanceTrace::Export()
+{
+  SRegistry& registry = GetRegistry();
+  CSingleLock lock(registry.section);
+
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  auto append = [&json, &first](const std::string& event) {
+    json += first ? "\n" : ",\n";
+    json += event;
+    first = false;
+  };
+
+  for (const auto& buffer : registry.buffers)
+  {
+    const std::vector<SEvent> events = GetEvents(*buffer);
+    if (events.empty())
+      continue;
+
+    const uint64_t tid = buffer->threadId;
+    append(StringUtils::Format(
+        "{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":{}}}}}",
+        tid, StringUtils::Paramify(buffer->threadName)));
+
+    for (const SEvent& event : events)
+    {
+      const std::string name = StringUtils::Paramify(event.name);
+      const int64_t time = event.time - registry.startTime;
+      switch (event.type)
+      {
+        case EventType::SPAN:
+          append(StringUtils::Format(
+              "{{\"ph\":\"X\",\"name\":{},\"pid\":1,\"tid\":{},\"ts\":{},\"dur\":{}}}", name, tid,
+              time, event.duration));
+          break;
+        case EventType::COUNTER:
+          append(StringUtils::Format(
+              "{{\"ph\":\"C\",\"name\":{},\"pid\":1,\"tid\":{},\"ts\":{},\"args\":{{\"value\":{}}}}}",
+              name, tid, time, event.value));
+          break;
+        case EventType::INSTANT:
+          append(StringUtils::Format(
+              "{{\"ph\":\"i\",\"s\":\"t\",\"name\":{},\"pid\":1,\"tid\":{},\"ts\":{}}}", name, tid,
+              time));
+          break;
+      }
+    }
+  }
+
+  json += "\n]}\n";
+  return json;
+}
+
+bool CPerformanceTrace::Dump(const std::string& path)
+{
+  const std::string json = Export();
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CPerformanceTrace::{} - failed to write {}", __FUNCTION__, path);
+    return false;
+  }
+
+  CLog::Log(LOGINFO, "CPerformanceTrace::{} - wrote {} bytes to {}", __FUNCTION__, json.size(),
+            path);
+  return true;
+}
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stddef.h>
+#include <string>
+
+/*!
+ \brief Low overhead recorder of timed spans, counters and instant events, exported in the
+ Chrome trace event format that chrome://tracing and Perfetto load.
+
+ Events are written to a fixed size ring buffer per thread that only this thread writes to, so
+ recording takes no lock, and only the last EVENTS_PER_THREAD events of a thread are kept.
+ Nothing is recorded until Start() is called.
+
+ Only the pointer to event names is stored, they have to be string literals.
+ */
+class CPerformanceTrace
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t EVENTS_PER_THREAD = 16384;
+
+  /*!
+   \brief Start recording, events recorded before are not exported anymore.
+   */
+  static void Start();
+  static void Stop();
+  static bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+  /*!
+   \brief Record a span of the calling thread that started at start and ends now.
+   */
+  static void AddSpan(const char* name, Clock::time_point start);
+  static void AddCounter(const char* name, double value);
+  static void AddInstant(const char* name);
+
+  /*!
+   \brief Get the events recorded since Start() as Chrome trace JSON.
+   */
+  static std::string Export();
+
+  /*!
+   \brief Write the events recorded since Start() to a file.
+   \param path the file to write, special:// paths are supported
+   \return true if the file was written
+   */
+  static bool Dump(const std::string& path);
+
+private:
+  static std::atomic<bool> m_enabled;
+};
+
+/*!
+ \brief Records a span from its construction to its destruction if tracing is enabled.
+ */
+class CPerformanceTraceSpan
+{
+public:
+  explicit CPerformanceTraceSpan(const char* name)
+    : m_name(CPerformanceTrace::IsEnabled() ? name : nullptr)
+  {
+    if (m_name)
+      m_start = CPerformanceTrace::Clock::now();
+  }
+
+  ~CPerformanceTraceSpan()
+  {
+    if (m_name)
+      CPerformanceTrace::AddSpan(m_name, m_start);
+  }
+
+  CPerformanceTraceSpan(const CPerformanceTraceSpan&) = delete;
+  CPerformanceTraceSpan& operator=(const CPerformanceTraceSpan&) = delete;
+
+private:
+  const char* m_name;
+  CPerformanceTrace::Clock::time_point m_start;
+};
@@ -14,9 +14,16 @@
 #include <math.h>
 
 RFFT::RFFT(int size, bool windowed) :
-  m_size(size), m_windowed(windowed)
+  m_size(size), m_windowed(windowed),
+  m_linput(m_size), m_rinput(m_size), m_loutput(m_size), m_routput(m_size)
 {
   m_cfg = kiss_fftr_alloc(m_size,0,nullptr,nullptr);
+
+  // the window doubles as the normalization factor so calc() only needs
+  // a single multiplication per sample
+  m_window.assign(m_size, 1.0f);
+  if (m_windowed)
+    hann(m_window);
 }
 
 RFFT::~RFFT()
@@ -30,42 +37,37 @@ RFFT::~RFFT()
 
 void RFFT::calc(const float* input, float* output)
 {
-  // temporary buffers
-  std::vector<kiss_fft_scalar> linput(m_size), rinput(m_size);
-  std::vector<kiss_fft_cpx> loutput(m_size), routput(m_size);
-
-  for (size_t i=0;i<m_size;++i)
-  {
-    linput[i] = input[2*i];
-    rinput[i] = input[2*i+1];
-  }
+  kiss_fft_scalar* linput = m_linput.data();
+  kiss_fft_scalar* rinput = m_rinput.data();
+  const kiss_fft_scalar* window = m_window.data();
 
-  if (m_windowed)
+  // deinterleave and window in one pass
+  for (size_t i = 0; i < m_size; ++i)
   {
-    hann(linput);
-    hann(rinput);
+    linput[i] = input[2 * i] * window[i];
+    rinput[i] = input[2 * i + 1] * window[i];
   }
 
   // transform channels
-  kiss_fftr(m_cfg, &linput[0], &loutput[0]);
-  kiss_fftr(m_cfg, &rinput[0], &routput[0]);
+  kiss_fftr(m_cfg, linput, m_loutput.data());
+  kiss_fftr(m_cfg, rinput, m_routput.data());
 
-  auto&& filter = [&](kiss_fft_cpx& data)
-  {
-    return static_cast<double>(sqrt(data.r * data.r + data.i * data.i)) * 2.0 / m_size *
-           (m_windowed ? sqrt(8.0 / 3.0) : 1.0);
-  };
+  const double scale = 2.0 / m_size * (m_windowed ? sqrt(8.0 / 3.0) : 1.0);
+  const kiss_fft_cpx* loutput = m_loutput.data();
+  const kiss_fft_cpx* routput = m_routput.data();
 
   // interleave while taking magnitudes and normalizing
-  for (size_t i=0;i<m_size/2;++i)
+  for (size_t i = 0; i < m_size / 2; ++i)
   {
-    output[2*i] = filter(loutput[i]);
-    output[2*i+1] = filter(routput[i]);
+    output[2 * i] = static_cast<float>(
+        sqrt(static_cast<double>(loutput[i].r * loutput[i].r + loutput[i].i * loutput[i].i)) *
+        scale);
+    output[2 * i + 1] = static_cast<float>(
+        sqrt(static_cast<double>(routput[i].r * routput[i].r + routput[i].i * routput[i].i)) *
+        scale);
   }
 }
 
-#include <iostream>
-
 void RFFT::hann(std::vector<kiss_fft_scalar>& data)
 {
   for (size_t i=0;i<data.size();++i)
@@ -13,6 +13,15 @@
 #include <vector>
 
 //! \brief Class performing a RFFT of interleaved stereo data.
+//!
+//! The window and all scratch buffers are allocated once in the constructor,
+//! so calc() does not allocate and its inner loops are plain contiguous
+//! array operations the compiler can vectorize.
+//!
+//! The transforms themselves still run kissfft's scalar code. The follow-up
+//! is a vectorized FFT backend, e.g. pffft with its SSE/NEON paths. kissfft's
+//! USE_SIMD mode doesn't qualify as it changes kiss_fft_scalar for every user
+//! of the library.
 class RFFT
 {
 public:
@@ -24,10 +33,17 @@ public:
   //! \brief Free the RFFT plan
   ~RFFT();
 
+  RFFT(const RFFT&) = delete;
+  RFFT& operator=(const RFFT&) = delete;
+
   //! \brief Calculate FFTs
   //! \param input Input data of size 2*m_size
   //! \param output Output data of size m_size.
   void calc(const float* input, float* output);
+
+  //! \brief Length of time data for a single channel.
+  size_t size() const { return m_size; }
+
 protected:
   //! \brief Apply a Hann window to a buffer.
   //! \param data Vector with data to apply window to.
@@ -36,4 +52,11 @@ protected:
   size_t m_size;       //!< Size for a single channel.
   bool m_windowed;     //!< Whether or not a Hann window is applied.
   kiss_fftr_cfg m_cfg; //!< FFT plan
+
+private:
+  std::vector<kiss_fft_scalar> m_window; //!< Precomputed window coefficients
+  std::vector<kiss_fft_scalar> m_linput; //!< Left channel time data
+  std::vector<kiss_fft_scalar> m_rinput; //!< Right channel time data
+  std::vector<kiss_fft_cpx> m_loutput; //!< Left channel frequency data
+  std::vector<kiss_fft_cpx> m_routput; //!< Right channel frequency data
 };
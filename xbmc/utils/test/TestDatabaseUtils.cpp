@@ -1368,6 +1368,16 @@ TEST(TestDatabaseUtils, BuildLimitClause)
   EXPECT_STREQ(" LIMIT 100", a.c_str());
 }
 
+TEST(TestDatabaseUtils, BuildFullTextMatch)
+{
+  EXPECT_EQ("\"beat\"*", DatabaseUtils::BuildFullTextMatch(" beat ", {}));
+  EXPECT_EQ("{strTitle} : ^\"the bea\"*",
+            DatabaseUtils::BuildFullTextMatch("the bea", {"strTitle"}, true));
+  EXPECT_EQ("{c00 c16} : \"say \"\"hi\"\"\"*",
+            DatabaseUtils::BuildFullTextMatch("say \"hi\"", {"c00", "c16"}));
+  EXPECT_EQ("", DatabaseUtils::BuildFullTextMatch("  ", {"strTitle"}));
+}
+
 // class DatabaseUtils
 // {
 // public:
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/JSONVariantParser.h"
+#include "utils/PerformanceTrace.h"
+#include "utils/Variant.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CVariant Export()
+{
+  CVariant trace;
+  EXPECT_TRUE(CJSONVariantParser::Parse(CPerformanceTrace::Export(), trace));
+  return trace["traceEvents"];
+}
+
+int Count(const CVariant& events, const std::string& phase, const std::string& name)
+{
+  int count = 0;
+  for (auto it = events.begin_array(); it != events.end_array(); ++it)
+  {
+    if ((*it)["ph"].asString() == phase && (*it)["name"].asString() == name)
+      count++;
+  }
+  return count;
+}
+} // namespace
+
+TEST(TestPerformanceTrace, NotRecordingWhenStopped)
+{
+  CPerformanceTrace::Start();
+  CPerformanceTrace::Stop();
+  EXPECT_FALSE(CPerformanceTrace::IsEnabled());
+
+  {
+    CPerformanceTraceSpan span("TestPerformanceTrace::Stopped");
+  }
+  CPerformanceTrace::AddCounter("TestPerformanceTrace::Stopped", 1.0);
+
+  EXPECT_EQ(0u, Export().size());
+}
+
+TEST(TestPerformanceTrace, RecordsThreads)
+{
+  CPerformanceTrace::Start();
+  {
+    CPerformanceTraceSpan span("TestPerformanceTrace::Span");
+    CPerformanceTrace::AddCounter("TestPerformanceTrace::Counter", 42.0);
+  }
+  std::thread thread([]() { CPerformanceTrace::AddInstant("TestPerformanceTrace::Instant"); });
+  thread.join();
+  CPerformanceTrace::Stop();
+
+  const CVariant events = Export();
+  EXPECT_EQ(2, Count(events, "M", "thread_name"));
+  EXPECT_EQ(1, Count(events, "X", "TestPerformanceTrace::Span"));
+  EXPECT_EQ(1, Count(events, "C", "TestPerformanceTrace::Counter"));
+  EXPECT_EQ(1, Count(events, "i", "TestPerformanceTrace::Instant"));
+
+  for (auto it = events.begin_array(); it != events.end_array(); ++it)
+  {
+    if ((*it)["ph"].asString() == "C")
+      EXPECT_EQ(42.0, (*it)["args"]["value"].asDouble());
+    if ((*it)["ph"].asString() == "X")
+      EXPECT_LE(0, (*it)["dur"].asInteger());
+  }
+
+  // a restart drops the events recorded before
+  CPerformanceTrace::Start();
+  CPerformanceTrace::Stop();
+  EXPECT_EQ(0u, Export().size());
+}
+
+TEST(TestPerformanceTrace, KeepsLatestEvents)
+{
+  CPerformanceTrace::Start();
+  for (size_t i = 0; i < CPerformanceTrace::EVENTS_PER_THREAD + 100; i++)
+    CPerformanceTrace::AddCounter("TestPerformanceTrace::Counter", static_cast<double>(i));
+  CPerformanceTrace::Stop();
+
+  const CVariant events = Export();
+  EXPECT_EQ(static_cast<int>(CPerformanceTrace::EVENTS_PER_THREAD),
+            Count(events, "C", "TestPerformanceTrace::Counter"));
+  EXPECT_EQ(static_cast<double>(CPerformanceTrace::EVENTS_PER_THREAD + 99),
+            events[events.size() - 1]["args"]["value"].asDouble());
+}
@@ -14,6 +14,7 @@
 #define _USE_MATH_DEFINES
 #endif
 
+#include <chrono>
 #include <math.h>
 
 
@@ -39,3 +40,41 @@ TEST(TestRFFT, SimpleSignal)
     EXPECT_NEAR(output[2*i+1], ((i==freq2[0]||i==freq2[1])?1.0:0.0), 1e-7);
   }
 }
+
+class TestRFFTSize : public ::testing::TestWithParam<int>
+{
+};
+
+TEST_P(TestRFFTSize, WindowedThroughput)
+{
+  const int size = GetParam();
+  const int bin = size / 8;
+  std::vector<float> input(2 * size);
+  std::vector<float> output(size);
+  for (int i = 0; i < size; ++i)
+  {
+    input[2 * i] = cos(bin * 2.0 * M_PI * i / size);
+    input[2 * i + 1] = 0.0f;
+  }
+
+  RFFT transform(size, true);
+
+  const int iterations = 200;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+    transform.calc(input.data(), output.data());
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  RecordProperty("nsPerTransform", static_cast<int>(elapsed.count() / iterations));
+
+  // the window spreads the peak over its neighbours but it stays the maximum
+  for (int i = 0; i < size / 2; ++i)
+  {
+    if (i != bin)
+      EXPECT_LT(output[2 * i], output[2 * bin]);
+    EXPECT_NEAR(output[2 * i + 1], 0.0, 1e-7);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, TestRFFTSize, ::testing::Values(512, 1024, 2048, 4096, 8192));
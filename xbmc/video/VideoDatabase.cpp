@@ -60,6 +60,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include <unordered_set>
@@ -180,6 +181,10 @@ void CVideoDatabase::CreateTables()
     "strAudioCodec text, iAudioChannels integer, strAudioLanguage text, "
     "strSubtitleLanguage text, iVideoDuration integer, strStereoMode text, strVideoLanguage text)");
 
+  CLog::Log(LOGINFO, "create demuxcache table");
+  m_pDS->exec("CREATE TABLE demuxcache (idFile integer primary key, iFileSize integer, "
+              "strProbe text, strSeekIndex text)");
+
   CLog::Log(LOGINFO, "create sets table");
   m_pDS->exec("CREATE TABLE sets ( idSet integer primary key, strSet text, strOverview text)");
 
@@ -346,8 +351,24 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM settings WHERE idFile=old.idFile; "
               "DELETE FROM stacktimes WHERE idFile=old.idFile; "
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
+              "DELETE FROM demuxcache WHERE idFile=old.idFile; "
               "END");
 
+  // Full text indexes used by search, maintained by triggers (SQLite only)
+  CreateFullTextIndex("movie_fts", "movie", "idMovie",
+                      {StringUtils::Format("c{:02}", VIDEODB_ID_TITLE),
+                       StringUtils::Format("c{:02}", VIDEODB_ID_PLOT),
+                       StringUtils::Format("c{:02}", VIDEODB_ID_PLOTOUTLINE),
+                       StringUtils::Format("c{:02}", VIDEODB_ID_TAGLINE),
+                       StringUtils::Format("c{:02}", VIDEODB_ID_ORIGINALTITLE)});
+  CreateFullTextIndex("tvshow_fts", "tvshow", "idShow",
+                      {StringUtils::Format("c{:02}", VIDEODB_ID_TV_TITLE)});
+  CreateFullTextIndex("episode_fts", "episode", "idEpisode",
+                      {StringUtils::Format("c{:02}", VIDEODB_ID_EPISODE_TITLE),
+                       StringUtils::Format("c{:02}", VIDEODB_ID_EPISODE_PLOT)});
+  CreateFullTextIndex("musicvideo_fts", "musicvideo", "idMVideo",
+                      {StringUtils::Format("c{:02}", VIDEODB_ID_MUSICVIDEO_TITLE)});
+
   CreateViews();
 }
 
@@ -567,10 +588,17 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
+    idPath = GetCachedId("path", strPath1);
+    if (idPath >= 0)
+      return idPath;
+
     strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
     m_pDS->query(strSQL);
     if (!m_pDS->eof())
+    {
       idPath = m_pDS->fv("path.idPath").get_asInt();
+      SetCachedId("path", strPath1, idPath);
+    }
 
     m_pDS->close();
     return idPath;
@@ -799,6 +827,7 @@ int CVideoDatabase::AddPath(const std::string& strPath, const std::string &paren
     }
     m_pDS->exec(strSQL);
     idPath = (int)m_pDS->lastinsertid();
+    SetCachedId("path", strPath1, idPath);
     return idPath;
   }
   catch (...)
@@ -938,6 +967,11 @@ int CVideoDatabase::AddFile(const std::string& strFileNameAndPath,
     if (idPath < 0)
       return -1;
 
+    const std::string key = std::to_string(idPath) + '\t' + strFileName;
+    idFile = GetCachedId("file", key);
+    if (idFile >= 0)
+      return idFile;
+
     std::string strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
 
     m_pDS->query(strSQL);
@@ -945,6 +979,7 @@ int CVideoDatabase::AddFile(const std::string& strFileNameAndPath,
     {
       idFile = m_pDS->fv("idFile").get_asInt() ;
       m_pDS->close();
+      SetCachedId("file", key, idFile);
       return idFile;
     }
     m_pDS->close();
@@ -961,6 +996,7 @@ int CVideoDatabase::AddFile(const std::string& strFileNameAndPath,
                         idPath, strFileName.c_str(), finalDateAdded.GetAsDBDateTime().c_str());
     m_pDS->exec(strSQL);
     idFile = (int)m_pDS->lastinsertid();
+    SetCachedId("file", key, idFile);
     return idFile;
   }
   catch (...)
@@ -1723,7 +1759,22 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
     std::string trimmedName = name.c_str();
     StringUtils::Trim(trimmedName);
 
-    std::string strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
+    std::string strSQL;
+    idActor = GetCachedId("actor", trimmedName);
+    if (idActor >= 0)
+    {
+      if (!thumbURLs.empty())
+      {
+        strSQL = PrepareSQL("update actor set art_urls = '%s' where actor_id = %i",
+                            thumbURLs.c_str(), idActor);
+        m_pDS->exec(strSQL);
+      }
+      if (!thumb.empty())
+        SetArtForItem(idActor, "actor", "thumb", thumb);
+      return idActor;
+    }
+
+    strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
     m_pDS->query(strSQL);
     if (m_pDS->num_rows() == 0)
     {
@@ -1744,6 +1795,7 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
         m_pDS->exec(strSQL);
       }
     }
+    SetCachedId("actor", trimmedName, idActor);
     // add artwork
     if (!thumb.empty())
       SetArtForItem(idActor, "actor", "thumb", thumb);
@@ -1783,6 +1835,37 @@ void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, c
   }
 }
 
+void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, const std::vector<int>& valueIds, const char *foreignKey)
+{
+  if (valueIds.empty())
+    return;
+
+  const char *key = foreignKey ? foreignKey : table.c_str();
+
+  // fetch the existing links once, then add the missing ones in a single statement
+  std::set<int> existing;
+  m_pDS->query(PrepareSQL("SELECT %s_id FROM %s_link WHERE media_id=%i AND media_type='%s'", key, table.c_str(), mediaId, mediaType.c_str()));
+  while (!m_pDS->eof())
+  {
+    existing.insert(m_pDS->fv(0).get_asInt());
+    m_pDS->next();
+  }
+  m_pDS->close();
+
+  std::string values;
+  for (int valueId : valueIds)
+  {
+    if (valueId < 0 || !existing.insert(valueId).second)
+      continue;
+    if (!values.empty())
+      values += ",";
+    values += PrepareSQL("(%i,%i,'%s')", valueId, mediaId, mediaType.c_str());
+  }
+
+  if (!values.empty())
+    ExecuteQuery(PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES ", table.c_str(), key) + values);
+}
+
 void CVideoDatabase::RemoveFromLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey)
 {
   const char *key = foreignKey ? foreignKey : table.c_str();
@@ -1793,15 +1876,13 @@ void CVideoDatabase::RemoveFromLinkTable(int mediaId, const std::string& mediaTy
 
 void CVideoDatabase::AddLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  std::vector<int> idValues;
   for (const auto &i : values)
   {
     if (!i.empty())
-    {
-      int idValue = AddToTable(field, field + "_id", "name", i);
-      if (idValue > -1)
-        AddToLinkTable(mediaId, mediaType, field, idValue);
-    }
+      idValues.push_back(AddToTable(field, field + "_id", "name", i));
   }
+  AddToLinkTable(mediaId, mediaType, field, idValues);
 }
 
 void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
@@ -1814,15 +1895,13 @@ void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType
 
 void CVideoDatabase::AddActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  std::vector<int> idValues;
   for (const auto &i : values)
   {
     if (!i.empty())
-    {
-      int idValue = AddActor(i, "");
-      if (idValue > -1)
-        AddToLinkTable(mediaId, mediaType, field, idValue, "actor");
-    }
+      idValues.push_back(AddActor(i, ""));
   }
+  AddToLinkTable(mediaId, mediaType, field, idValues, "actor");
 }
 
 void CVideoDatabase::UpdateActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
@@ -3705,6 +3784,66 @@ void CVideoDatabase::DeleteStreamDetails(int idFile)
   m_pDS->exec(PrepareSQL("DELETE FROM streamdetails WHERE idFile = %i", idFile));
 }
 
+bool CVideoDatabase::GetDemuxCache(int idFile,
+                                   int64_t fileSize,
+                                   std::string& probe,
+                                   std::string& seekIndex)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    m_pDS->query(PrepareSQL("SELECT iFileSize, strProbe, strSeekIndex FROM demuxcache "
+                            "WHERE idFile = %i",
+                            idFile));
+    bool found = false;
+    if (!m_pDS->eof())
+    {
+      // the file changed since it was probed, e.g. a recording that was cut
+      found = m_pDS->fv(0).get_asInt64() == fileSize;
+      if (found)
+      {
+        probe = m_pDS->fv(1).get_asString();
+        seekIndex = m_pDS->fv(2).get_asString();
+      }
+    }
+    m_pDS->close();
+    return found;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} ({}) failed", __FUNCTION__, idFile);
+  }
+  return false;
+}
+
+void CVideoDatabase::SetDemuxCache(int idFile,
+                                   int64_t fileSize,
+                                   const std::string& probe,
+                                   const std::string& seekIndex)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return;
+    if (nullptr == m_pDS)
+      return;
+
+    m_pDS->exec(PrepareSQL("DELETE FROM demuxcache WHERE idFile = %i", idFile));
+    m_pDS->exec(PrepareSQL("INSERT INTO demuxcache (idFile, iFileSize, strProbe, strSeekIndex) "
+                           "VALUES (%i, %lld, '%s', '%s')",
+                           idFile, static_cast<long long>(fileSize), probe.c_str(),
+                           seekIndex.c_str()));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} ({}) failed", __FUNCTION__, idFile);
+  }
+}
+
 void CVideoDatabase::DeleteSet(int idSet)
 {
   try
@@ -5815,11 +5954,15 @@ void CVideoDatabase::UpdateTables(int iVersion)
 
   if (iVersion < 119)
     m_pDS->exec("ALTER TABLE path ADD allAudio bool");
+
+  if (iVersion < 121)
+    m_pDS->exec("CREATE TABLE demuxcache (idFile integer primary key, iFileSize integer, "
+                "strProbe text, strSeekIndex text)");
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 119;
+  return 121;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -5930,6 +6073,58 @@ bool CVideoDatabase::GetPlayCounts(const std::string &strPath, CFileItemList &it
   return false;
 }
 
+bool CVideoDatabase::GetPlayCountsAndResumePoints(
+    const std::string& pathPrefix, std::map<std::string, std::pair<int, CBookmark>>& files)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    const std::string sql = PrepareSQL(
+        "SELECT"
+        "  path.strPath, files.strFilename, files.playCount,"
+        "  bookmark.timeInSeconds, bookmark.totalTimeInSeconds,"
+        "  bookmark.player, bookmark.playerState "
+        "FROM files"
+        "  INNER JOIN path ON files.idPath = path.idPath"
+        "  LEFT JOIN bookmark ON"
+        "    files.idFile = bookmark.idFile AND bookmark.type = %i "
+        "WHERE SUBSTR(path.strPath, 1, %i) = '%s'",
+        static_cast<int>(CBookmark::RESUME), static_cast<int>(pathPrefix.size()),
+        pathPrefix.c_str());
+
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      CBookmark resumePoint;
+      if (!m_pDS->fv(3).get_isNull())
+      {
+        resumePoint.timeInSeconds = m_pDS->fv(3).get_asDouble();
+        resumePoint.totalTimeInSeconds = m_pDS->fv(4).get_asDouble();
+        resumePoint.player = m_pDS->fv(5).get_asString();
+        resumePoint.playerState = m_pDS->fv(6).get_asString();
+        resumePoint.type = CBookmark::RESUME;
+      }
+
+      files.emplace(m_pDS->fv(0).get_asString() + m_pDS->fv(1).get_asString(),
+                    std::make_pair(m_pDS->fv(2).get_asInt(), resumePoint));
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} failed", __FUNCTION__);
+  }
+  return false;
+}
+
 int CVideoDatabase::GetPlayCount(int iFileId)
 {
   if (iFileId < 0)
@@ -8798,18 +8993,26 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (nullptr == m_pDS)
       return;
 
+    std::string where = PrepareFullTextCondition(
+        "movie_fts", "movie.idMovie",
+        {StringUtils::Format("c{:02}", VIDEODB_ID_TITLE),
+         StringUtils::Format("c{:02}", VIDEODB_ID_ORIGINALTITLE)},
+        strSearch);
+    if (where.empty())
+      where = PrepareSQL("movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
+                         VIDEODB_ID_TITLE, strSearch.c_str(), VIDEODB_ID_ORIGINALTITLE,
+                         strSearch.c_str());
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
       strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie "
                           "INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON "
-                          "path.idPath=files.idPath "
-                          "WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
-                          VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str(),
-                          VIDEODB_ID_ORIGINALTITLE, strSearch.c_str());
+                          "path.idPath=files.idPath WHERE ",
+                          VIDEODB_ID_TITLE) +
+               where;
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie,movie.c%02d, movie.idSet FROM movie WHERE "
-                          "movie.c%02d like '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
-                          VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str(),
-                          VIDEODB_ID_ORIGINALTITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie,movie.c%02d, movie.idSet FROM movie WHERE ",
+                          VIDEODB_ID_TITLE) +
+               where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8853,10 +9056,16 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
     if (nullptr == m_pDS)
       return;
 
+    std::string where = PrepareFullTextCondition(
+        "tvshow_fts", "tvshow.idShow", {StringUtils::Format("c{:02}", VIDEODB_ID_TV_TITLE)},
+        strSearch);
+    if (where.empty())
+      where = PrepareSQL("tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, strSearch.c_str());
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE ", VIDEODB_ID_TV_TITLE) + where;
     else
-      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where ",VIDEODB_ID_TV_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8897,10 +9106,17 @@ void CVideoDatabase::GetEpisodesByName(const std::string& strSearch, CFileItemLi
     if (nullptr == m_pDS)
       return;
 
+    std::string where = PrepareFullTextCondition(
+        "episode_fts", "episode.idEpisode",
+        {StringUtils::Format("c{:02}", VIDEODB_ID_EPISODE_TITLE)}, strSearch);
+    if (where.empty())
+      where = PrepareSQL("episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE,
+                         strSearch.c_str());
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d like '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8944,10 +9160,17 @@ void CVideoDatabase::GetMusicVideosByName(const std::string& strSearch, CFileIte
     if (nullptr == m_pDS)
       return;
 
+    std::string where = PrepareFullTextCondition(
+        "musicvideo_fts", "musicvideo.idMVideo",
+        {StringUtils::Format("c{:02}", VIDEODB_ID_MUSICVIDEO_TITLE)}, strSearch);
+    if (where.empty())
+      where = PrepareSQL("musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE,
+                         strSearch.c_str());
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_MUSICVIDEO_TITLE) + where;
     else
-      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where musicvideo.c%02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where ",VIDEODB_ID_MUSICVIDEO_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8994,10 +9217,17 @@ void CVideoDatabase::GetEpisodesByPlot(const std::string& strSearch, CFileItemLi
     if (nullptr == m_pDS)
       return;
 
+    std::string where = PrepareFullTextCondition(
+        "episode_fts", "episode.idEpisode",
+        {StringUtils::Format("c{:02}", VIDEODB_ID_EPISODE_PLOT)}, strSearch);
+    if (where.empty())
+      where = PrepareSQL("episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_PLOT,
+                         strSearch.c_str());
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9037,10 +9267,19 @@ void CVideoDatabase::GetMoviesByPlot(const std::string& strSearch, CFileItemList
     if (nullptr == m_pDS)
       return;
 
+    std::string where = PrepareFullTextCondition(
+        "movie_fts", "movie.idMovie",
+        {StringUtils::Format("c{:02}", VIDEODB_ID_PLOT),
+         StringUtils::Format("c{:02}", VIDEODB_ID_PLOTOUTLINE),
+         StringUtils::Format("c{:02}", VIDEODB_ID_TAGLINE)},
+        strSearch);
+    if (where.empty())
+      where = PrepareSQL("(movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE,VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_TITLE) + where;
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE (movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE ", VIDEODB_ID_TITLE) + where;
 
     m_pDS->query( strSQL );
 
@@ -9541,6 +9780,7 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
     sql = "DELETE FROM sets WHERE NOT EXISTS (SELECT 1 FROM movie WHERE movie.idSet = sets.idSet)";
     m_pDS->exec(sql);
 
+    ClearCachedIds();
     CommitTransaction();
 
     if (handle)
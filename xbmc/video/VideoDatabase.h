@@ -15,6 +15,7 @@
 #include "utils/SortUtils.h"
 #include "video/VideoDbUrl.h"
 
+#include <map>
 #include <memory>
 #include <set>
 #include <utility>
@@ -471,6 +472,16 @@ public:
    */
   bool GetPlayCounts(const std::string &path, CFileItemList &items);
 
+  /*! \brief Get the playcounts and resume points of all files below a path in one query
+   Files without a resume point get an unset bookmark.
+   \param pathPrefix the path to fetch files from, including its sub paths
+   \param files map of file name and path to playcount and resume point
+   \return true on success, false on error
+   \sa GetPlayCounts
+   */
+  bool GetPlayCountsAndResumePoints(const std::string& pathPrefix,
+                                    std::map<std::string, std::pair<int, CBookmark>>& files);
+
   void UpdateMovieTitle(int idMovie, const std::string& strNewMovieTitle, VIDEODB_CONTENT_TYPE iType=VIDEODB_CONTENT_MOVIES);
   bool UpdateVideoSortTitle(int idDb, const std::string& strNewSortTitle, VIDEODB_CONTENT_TYPE iType = VIDEODB_CONTENT_MOVIES);
 
@@ -539,6 +550,19 @@ public:
   void SetStreamDetailsForFile(const CStreamDetails& details, const std::string &strFileNameAndPath);
   void SetStreamDetailsForFileId(const CStreamDetails& details, int idFile);
 
+  /*! \brief Get the cached demuxer probe and seek index of a file.
+   \param idFile id of the file
+   \param fileSize current size of the file, the cache is ignored if the size changed
+   \param probe [out] the stream parameters, see CDemuxProbeCache
+   \param seekIndex [out] the serialized keyframe index, see CDemuxSeekIndex
+   \return true if the file has a valid cache entry
+   */
+  bool GetDemuxCache(int idFile, int64_t fileSize, std::string& probe, std::string& seekIndex);
+  void SetDemuxCache(int idFile,
+                     int64_t fileSize,
+                     const std::string& probe,
+                     const std::string& seekIndex);
+
   bool SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, int dbField, const std::string &strValue);
   bool SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, Field dbField, const std::string &strValue);
   bool SetSingleValue(const std::string &table, const std::string &fieldName, const std::string &strValue,
@@ -958,6 +982,7 @@ protected:
   // link functions - these two do all the work
   void AddLinkToActor(int mediaId, const char *mediaType, int actorId, const std::string &role, int order);
   void AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey = NULL);
+  void AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, const std::vector<int>& valueIds, const char *foreignKey = NULL);
   void RemoveFromLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey = NULL);
 
   void AddLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values);
@@ -17,6 +17,7 @@
 #include "URL.h"
 #include "Util.h"
 #include "VideoInfoDownloader.h"
+#include "cores/VideoPlayer/DVDFileInfo.h"
 #include "dialogs/GUIDialogExtendedProgressBar.h"
 #include "dialogs/GUIDialogProgress.h"
 #include "events/EventLog.h"
@@ -36,6 +37,7 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "tags/VideoInfoTagLoaderFactory.h"
+#include "threads/WorkerPool.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
 #include "utils/RegExp.h"
@@ -56,6 +58,13 @@ using namespace KODI::MESSAGING;
 using KODI::MESSAGING::HELPERS::DialogResponse;
 using KODI::UTILITY::CDigest;
 
+namespace
+{
+// probed stream details written per transaction, keeps the library writable for other
+// connections while they are stored
+constexpr size_t STREAM_DETAILS_WRITE_BATCH = 50;
+} // unnamed namespace
+
 namespace VIDEO
 {
 
@@ -112,6 +121,13 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      // Group the writes of many items into few transactions
+      m_database.BeginBulkWrite();
+
+      m_streamDetailsToProbe.clear();
+      m_streamDetailsFiles = 0;
+      m_streamDetailsDuration = {};
+
       bool bCancelled = false;
       while (!bCancelled && !m_pathsToScan.empty())
       {
@@ -141,6 +157,8 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      m_database.EndBulkWrite();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -161,6 +179,11 @@ namespace VIDEO
 
       CLog::Log(LOGINFO, "VideoInfoScanner: Finished scan. Scanning for video info took {} ms",
                 duration.count());
+      if (m_streamDetailsDuration.count() > 0)
+        CLog::Log(LOGINFO, "VideoInfoScanner: Probed stream details of {} files at {:.1f} files/s",
+                  m_streamDetailsFiles,
+                  m_streamDetailsFiles /
+                      std::chrono::duration<double>(m_streamDetailsDuration).count());
     }
     catch (...)
     {
@@ -276,6 +299,9 @@ namespace VIDEO
       return true;
     }
 
+    // don't keep the database locked while listing and hashing the directory
+    m_database.FlushBulkWrite();
+
     std::string hash, dbHash;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
     {
@@ -362,7 +388,11 @@ namespace VIDEO
 
     if (!bSkip)
     {
-      if (RetrieveVideoInfo(items, settings.parent_name_root, content))
+      const bool added = RetrieveVideoInfo(items, settings.parent_name_root, content);
+      if (!ProbeStreamDetails())
+        m_bStop = true;
+
+      if (added)
       {
         if (!m_bStop && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
         {
@@ -826,6 +856,7 @@ namespace VIDEO
 
       if (updateSeasonArt)
       {
+        m_database.FlushBulkWrite();
         if (!item->IsPlugin() || scraper->ID() != "metadata.local")
         {
           CVideoInfoDownloader loader(scraper);
@@ -849,6 +880,9 @@ namespace VIDEO
 
     bool bSkip = false;
 
+    // don't keep the database locked while listing and hashing the show folder
+    m_database.FlushBulkWrite();
+
     if (item->m_bIsFolder)
     {
       /*
@@ -1417,6 +1451,15 @@ namespace VIDEO
 
     if (!pItem->m_bIsFolder)
     {
+      // probed by ProbeStreamDetails() after the directory, instead of by the thumb loader
+      // once the item is shown
+      if (lResult > -1 && !libraryImport && m_bRunning && movieDetails.m_iFileId > 0 &&
+          !movieDetails.HasStreamDetails() &&
+          CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iVideoLibraryStreamDetailsThreads > 0 &&
+          CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTFLAGS) &&
+          CThumbExtractor::IsExtractable(*pItem))
+        m_streamDetailsToProbe.emplace(movieDetails.m_iFileId, movieDetails.m_strFileNameAndPath);
+
       if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryImportWatchedState || libraryImport)
         m_database.SetPlayCount(*pItem, movieDetails.GetPlayCount(), movieDetails.m_lastPlayed);
 
@@ -1437,6 +1480,63 @@ namespace VIDEO
     return lResult;
   }
 
+  bool CVideoInfoScanner::ProbeStreamDetails()
+  {
+    if (m_streamDetailsToProbe.empty())
+      return true;
+
+    std::vector<std::pair<int, std::string>> files(m_streamDetailsToProbe.begin(),
+                                                   m_streamDetailsToProbe.end());
+    m_streamDetailsToProbe.clear();
+
+    // don't keep the database locked by the bulk write while the files are probed
+    m_database.FlushBulkWrite();
+
+    // Probing is dominated by file access latency. Only the headers are read, see
+    // CDVDDemuxFFmpeg::Open, and the database is only written from this thread.
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<CFileItem> items(files.size());
+    std::vector<char> probed(files.size(), 0);
+    CWorkerPool pool(
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iVideoLibraryStreamDetailsThreads,
+        "VideoStreamDetails");
+    const bool completed = pool.ForEach(
+        files.size(),
+        [&files, &items, &probed](size_t i) {
+          CFileItem& item = items[i];
+          item.SetPath(files[i].second);
+          item.GetVideoInfoTag()->m_strFileNameAndPath = files[i].second;
+          probed[i] = CDVDFileInfo::GetFileStreamDetails(&item, true) ? 1 : 0;
+        },
+        [this]() { return m_bStop.load(); });
+
+    if (!completed)
+      return false;
+
+    m_streamDetailsFiles += files.size();
+    m_streamDetailsDuration += std::chrono::steady_clock::now() - start;
+
+    for (size_t batch = 0; batch < files.size(); batch += STREAM_DETAILS_WRITE_BATCH)
+    {
+      const size_t end = std::min(files.size(), batch + STREAM_DETAILS_WRITE_BATCH);
+      m_database.BeginTransaction();
+      for (size_t i = batch; i < end; ++i)
+      {
+        if (!probed[i])
+        {
+          CLog::Log(LOGDEBUG, "VideoInfoScanner: Failed to probe stream details of {}",
+                    CURL::GetRedacted(files[i].second));
+          continue;
+        }
+        m_database.SetStreamDetailsForFileId(items[i].GetVideoInfoTag()->m_streamDetails,
+                                             files[i].first);
+      }
+      m_database.CommitTransaction();
+      m_database.FlushBulkWrite();
+    }
+    return true;
+  }
+
   std::string ContentToMediaType(CONTENT_TYPE content, bool folder)
   {
     switch (content)
@@ -1543,6 +1643,9 @@ namespace VIDEO
     if (artLevel == CSettings::VIDEOLIBRARY_ARTWORK_LEVEL_NONE)
       return;
 
+    // don't keep the database locked while looking for local art and caching images
+    m_database.FlushBulkWrite();
+
     CVideoInfoTag &movieDetails = *pItem->GetVideoInfoTag();
     movieDetails.m_fanart.Unpack();
     movieDetails.m_strPictureURL.Parse();
@@ -1755,6 +1858,7 @@ namespace VIDEO
             pDlgProgress->Progress();
           }
 
+          m_database.FlushBulkWrite();
           CVideoInfoDownloader imdb(scraper);
           if (!imdb.GetEpisodeList(url, episodes))
             return INFO_NOT_FOUND;
@@ -1861,6 +1965,7 @@ namespace VIDEO
 
       if (bFound)
       {
+        m_database.FlushBulkWrite();
         CVideoInfoDownloader imdb(scraper);
         CFileItem item;
         item.SetPath(file->strPath);
@@ -1898,6 +2003,9 @@ namespace VIDEO
     if (m_handle && !url.GetTitle().empty())
       m_handle->SetText(url.GetTitle());
 
+    // don't keep the database locked while waiting for the scraper
+    m_database.FlushBulkWrite();
+
     CVideoInfoDownloader imdb(scraper);
     bool ret = imdb.GetDetails(url, movieDetails, pDialog);
 
@@ -2175,6 +2283,7 @@ namespace VIDEO
   int CVideoInfoScanner::FindVideo(const std::string &title, int year, const ScraperPtr &scraper, CScraperUrl &url, CGUIDialogProgress *progress)
   {
     MOVIELIST movielist;
+    m_database.FlushBulkWrite();
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(title, year, movielist, progress);
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
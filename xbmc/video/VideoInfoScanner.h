@@ -12,6 +12,9 @@
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 
+#include <atomic>
+#include <chrono>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -225,15 +228,27 @@ namespace VIDEO
      */
     INFO_RET OnProcessSeriesFolder(EPISODELIST& files, const ADDON::ScraperPtr &scraper, bool useLocal, const CVideoInfoTag& showInfo, CGUIDialogProgress* pDlgProgress = NULL);
 
+    /*! \brief Probe the stream details of the files added since the last call.
+     Files are probed on a few threads, without opening decoders, and outside of the bulk
+     write. The details are written to the database on the scanner thread, in short
+     transactions. See
+     CAdvancedSettings::m_iVideoLibraryStreamDetailsThreads.
+     \return false if the scan was cancelled
+     */
+    bool ProbeStreamDetails();
+
     bool EnumerateSeriesFolder(CFileItem* item, EPISODELIST& episodeList);
     bool ProcessItemByVideoInfoTag(const CFileItem *item, EPISODELIST &episodeList);
 
-    bool m_bStop;
+    std::atomic<bool> m_bStop; // also read by the stream details probe threads
     bool m_scanAll;
     std::string m_strStartDir;
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    std::map<int, std::string> m_streamDetailsToProbe; //!< files by id, queued by AddVideo()
+    size_t m_streamDetailsFiles = 0; //!< files whose stream details were probed during this scan
+    std::chrono::steady_clock::duration m_streamDetailsDuration{}; //!< time spent probing them
 
   private:
     static void AddLocalItemArtwork(CGUIListItem::ArtMap& itemArt,
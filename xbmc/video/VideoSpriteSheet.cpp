@@ -0,0 +1,421 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoSpriteSheet.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "TextureCache.h"
+#include "TextureDatabase.h"
+#include "URL.h"
+#include "cores/VideoPlayer/DVDFileInfo.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "guilib/Texture.h"
+#include "pictures/Picture.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+#include "video/VideoInfoTag.h"
+#include "video/VideoThumbLoader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <set>
+
+namespace
+{
+constexpr int INDEX_VERSION = 1;
+constexpr unsigned int TILES_PER_SHEET = CVideoSpriteSheet::COLUMNS * CVideoSpriteSheet::ROWS;
+constexpr const char* PREVIEW_FOLDER = "special://temp/seekpreview/";
+
+// files that have a build job queued or running
+struct BuildingFiles
+{
+  CCriticalSection section;
+  std::set<std::string> paths;
+};
+
+BuildingFiles& GetBuildingFiles()
+{
+  static BuildingFiles building;
+  return building;
+}
+} // namespace
+
+CVideoSpriteSheet::CVideoSpriteSheet(const std::string& path) : m_path(path)
+{
+}
+
+CVideoSpriteSheet::~CVideoSpriteSheet()
+{
+  RemovePreviewImages();
+}
+
+bool CVideoSpriteSheet::Load()
+{
+  m_tiles = 0;
+  m_complete = false;
+  m_sheet.reset();
+
+  XFILE::CFile file;
+  XFILE::auto_buffer buffer;
+  if (file.LoadFile(GetIndexFile(), buffer) <= 0)
+    return false;
+
+  CVariant index;
+  if (!CJSONVariantParser::Parse(std::string(buffer.get(), buffer.size()), index) ||
+      index["version"].asInteger() != INDEX_VERSION)
+    return false;
+
+  m_interval = index["interval"].asInteger();
+  m_tiles = static_cast<unsigned int>(index["tiles"].asUnsignedInteger());
+  m_totalTiles = static_cast<unsigned int>(index["totaltiles"].asUnsignedInteger());
+  m_tileWidth = static_cast<unsigned int>(index["tilewidth"].asUnsignedInteger());
+  m_tileHeight = static_cast<unsigned int>(index["tileheight"].asUnsignedInteger());
+  m_orientation = static_cast<int>(index["orientation"].asInteger());
+  m_complete = index["complete"].asBoolean();
+
+  if (m_interval <= 0 || m_tileWidth == 0 || m_tileHeight == 0)
+  {
+    m_tiles = 0;
+    m_complete = false;
+  }
+
+  return m_tiles > 0;
+}
+
+bool CVideoSpriteSheet::Save() const
+{
+  CVariant index;
+  index["version"] = INDEX_VERSION;
+  index["interval"] = m_interval;
+  index["tiles"] = m_tiles;
+  index["totaltiles"] = m_totalTiles;
+  index["tilewidth"] = m_tileWidth;
+  index["tileheight"] = m_tileHeight;
+  index["columns"] = COLUMNS;
+  index["rows"] = ROWS;
+  index["orientation"] = m_orientation;
+  index["complete"] = m_complete;
+
+  std::string json;
+  if (!CJSONVariantWriter::Write(index, json, true))
+    return false;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(GetIndexFile(), true))
+    return false;
+
+  return file.Write(json.c_str(), json.size()) == static_cast<ssize_t>(json.size());
+}
+
+bool CVideoSpriteSheet::GetPreview(int64_t time, Preview& preview) const
+{
+  if (m_tiles == 0 || m_interval <= 0)
+    return false;
+
+  const unsigned int tile = GetTile(time, m_interval, m_totalTiles);
+  if (tile >= m_tiles)
+    return false;
+
+  const TilePosition position = GetTilePosition(tile, m_tileWidth, m_tileHeight);
+  const std::string url = GetSheetURL(m_path, position.sheet);
+
+  preview.image = CTextureUtils::GetWrappedImageURL(url);
+  preview.cachedImage = CTextureCache::GetCachedPath(CTextureCache::GetCacheFile(url) + ".jpg");
+  preview.x = position.x;
+  preview.y = position.y;
+  preview.width = m_tileWidth;
+  preview.height = m_tileHeight;
+  preview.time = tile * m_interval;
+  preview.orientation = m_orientation;
+  return true;
+}
+
+std::string CVideoSpriteSheet::GetPreviewImage(int64_t time)
+{
+  Preview preview;
+  if (!GetPreview(time, preview))
+    return "";
+
+  const unsigned int tile = static_cast<unsigned int>(preview.time / m_interval);
+  const std::string image = StringUtils::Format(
+      "{}{:08x}-{}.jpg", PREVIEW_FOLDER, Crc32::ComputeFromLowerCase(m_path), tile);
+  if (std::find(m_previewImages.begin(), m_previewImages.end(), image) != m_previewImages.end())
+    return image;
+
+  const unsigned int sheetIndex = tile / TILES_PER_SHEET;
+  if (!m_sheet || m_sheetIndex != sheetIndex)
+  {
+    m_sheet.reset(CTexture::LoadFromFile(preview.cachedImage, 0, 0, true));
+    m_sheetIndex = sheetIndex;
+  }
+
+  if (!m_sheet || !m_sheet->GetPixels() ||
+      preview.x + preview.width > m_sheet->GetWidth() ||
+      preview.y + preview.height > m_sheet->GetHeight())
+    return "";
+
+  if (!XFILE::CDirectory::Exists(PREVIEW_FOLDER))
+    XFILE::CDirectory::Create(PREVIEW_FOLDER);
+
+  uint8_t* pixels = m_sheet->GetPixels() + preview.y * m_sheet->GetPitch() + preview.x * 4;
+  uint32_t width = preview.width;
+  uint32_t height = preview.height;
+  if (!CPicture::CacheTexture(pixels, preview.width, preview.height, m_sheet->GetPitch(),
+                              m_orientation, width, height, image))
+    return "";
+
+  m_previewImages.push_back(image);
+  return image;
+}
+
+void CVideoSpriteSheet::RemovePreviewImages()
+{
+  for (const auto& image : m_previewImages)
+    XFILE::CFile::Delete(image);
+
+  m_previewImages.clear();
+}
+
+bool CVideoSpriteSheet::Build(const CFileItem& item)
+{
+  if (!IsSupported(item) ||
+      !CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(
+          CSettings::SETTING_MYVIDEOS_EXTRACTTHUMB))
+    return false;
+
+  const std::string path = GetMediaPath(item);
+  CVideoSpriteSheet sheet(path);
+  if (sheet.Load() && sheet.IsComplete())
+    return true;
+
+  BuildingFiles& building = GetBuildingFiles();
+  {
+    CSingleLock lock(building.section);
+    if (!building.paths.insert(path).second)
+      return true;
+  }
+
+  // not pausable, the previews are needed while the file is playing
+  CJobManager::GetInstance().AddJob(new CVideoSpriteSheetJob(item), nullptr, CJob::PRIORITY_LOW);
+  return true;
+}
+
+bool CVideoSpriteSheet::IsSupported(const CFileItem& item)
+{
+  if (item.m_bIsFolder || item.IsStack() || !item.IsVideo())
+    return false;
+
+  CFileItem mediaItem(item);
+  mediaItem.SetPath(GetMediaPath(item));
+  return CThumbExtractor::IsExtractable(mediaItem);
+}
+
+std::string CVideoSpriteSheet::GetMediaPath(const CFileItem& item)
+{
+  if (item.IsVideoDb() && item.HasVideoInfoTag())
+    return item.GetVideoInfoTag()->m_strFileNameAndPath;
+
+  return item.GetPath();
+}
+
+int64_t CVideoSpriteSheet::GetInterval(int64_t duration)
+{
+  // round up to full seconds so tiles stay on readable times
+  const int64_t interval = (duration + MAX_TILES - 1) / MAX_TILES;
+  return std::max(MIN_INTERVAL, (interval + 999) / 1000 * 1000);
+}
+
+unsigned int CVideoSpriteSheet::GetTile(int64_t time, int64_t interval, unsigned int totalTiles)
+{
+  int64_t tile = (std::max<int64_t>(time, 0) + interval / 2) / interval;
+  if (totalTiles > 0)
+    tile = std::min<int64_t>(tile, totalTiles - 1);
+  return static_cast<unsigned int>(
+      std::min<int64_t>(tile, std::numeric_limits<unsigned int>::max()));
+}
+
+CVideoSpriteSheet::TilePosition CVideoSpriteSheet::GetTilePosition(unsigned int tile,
+                                                                   unsigned int tileWidth,
+                                                                   unsigned int tileHeight)
+{
+  const unsigned int pos = tile % TILES_PER_SHEET;
+
+  TilePosition position;
+  position.sheet = tile / TILES_PER_SHEET;
+  position.x = (pos % COLUMNS) * tileWidth;
+  position.y = (pos / COLUMNS) * tileHeight;
+  return position;
+}
+
+std::string CVideoSpriteSheet::GetSheetURL(const std::string& path, unsigned int sheet)
+{
+  return StringUtils::Format("seekpreview://{}/{}", path, sheet);
+}
+
+std::string CVideoSpriteSheet::GetIndexFile() const
+{
+  const std::string url = StringUtils::Format("seekpreview://{}/index", m_path);
+  return CTextureCache::GetCachedPath(CTextureCache::GetCacheFile(url) + ".json");
+}
+
+CVideoSpriteSheetJob::CVideoSpriteSheetJob(const CFileItem& item)
+  : m_path(CVideoSpriteSheet::GetMediaPath(item))
+{
+  if (item.HasVideoInfoTag())
+    m_duration = static_cast<int64_t>(item.GetVideoInfoTag()->GetDuration()) * 1000;
+}
+
+CVideoSpriteSheetJob::~CVideoSpriteSheetJob()
+{
+  BuildingFiles& building = GetBuildingFiles();
+  CSingleLock lock(building.section);
+  building.paths.erase(m_path);
+}
+
+bool CVideoSpriteSheetJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) != 0)
+    return false;
+
+  const CVideoSpriteSheetJob* spriteJob = dynamic_cast<const CVideoSpriteSheetJob*>(job);
+  return spriteJob && spriteJob->m_path == m_path;
+}
+
+bool CVideoSpriteSheetJob::DoWork()
+{
+  const std::string redactPath = CURL::GetRedacted(m_path);
+
+  int64_t duration = m_duration;
+  if (duration <= 0)
+  {
+    int fileDuration = 0;
+    if (CDVDFileInfo::GetFileDuration(m_path, fileDuration))
+      duration = fileDuration;
+  }
+
+  if (duration <= 0)
+  {
+    CLog::Log(LOGDEBUG, "CVideoSpriteSheetJob - unknown duration of {}", redactPath);
+    return false;
+  }
+
+  CVideoSpriteSheet sheet(m_path);
+  sheet.m_interval = CVideoSpriteSheet::GetInterval(duration);
+  sheet.m_totalTiles =
+      static_cast<unsigned int>((duration + sheet.m_interval - 1) / sheet.m_interval);
+
+  std::vector<int64_t> positions(sheet.m_totalTiles);
+  for (unsigned int i = 0; i < sheet.m_totalTiles; i++)
+    positions[i] = i * sheet.m_interval;
+
+  CLog::Log(LOGDEBUG, "CVideoSpriteSheetJob - extracting {} tiles every {} ms from {}",
+            sheet.m_totalTiles, sheet.m_interval, redactPath);
+
+  std::vector<uint8_t> pixels;
+  unsigned int sheetIndex = 0;
+  bool failed = false;
+
+  CFileItem item(m_path, false);
+  CDVDFileInfo::ExtractFrames(
+      item, positions, CVideoSpriteSheet::TILE_WIDTH, nullptr,
+      [&](size_t index, const uint8_t* frame, unsigned int width, unsigned int height,
+          unsigned int pitch, int orientation) {
+        if (ShouldCancel(static_cast<unsigned int>(index), sheet.m_totalTiles))
+          return false;
+
+        // the first frame decides the tile size, later ones are cropped to it
+        if (sheet.m_tileWidth == 0)
+        {
+          sheet.m_tileWidth = width;
+          sheet.m_tileHeight = height;
+          sheet.m_orientation = orientation;
+        }
+
+        // positions that could not be extracted stay black
+        const CVideoSpriteSheet::TilePosition position = CVideoSpriteSheet::GetTilePosition(
+            static_cast<unsigned int>(index), sheet.m_tileWidth, sheet.m_tileHeight);
+        while (sheetIndex < position.sheet)
+        {
+          if (!WriteSheet(sheet, sheetIndex, pixels, TILES_PER_SHEET))
+          {
+            failed = true;
+            return false;
+          }
+          pixels.clear();
+          sheetIndex++;
+        }
+
+        const unsigned int sheetPitch = CVideoSpriteSheet::COLUMNS * sheet.m_tileWidth * 4;
+        if (pixels.empty())
+          pixels.assign(sheetPitch * CVideoSpriteSheet::ROWS * sheet.m_tileHeight, 0);
+
+        const unsigned int x = position.x;
+        const unsigned int y = position.y;
+        const unsigned int copyWidth = std::min(width, sheet.m_tileWidth) * 4;
+        const unsigned int copyHeight = std::min(height, sheet.m_tileHeight);
+        for (unsigned int row = 0; row < copyHeight; row++)
+          memcpy(pixels.data() + (y + row) * sheetPitch + x * 4, frame + row * pitch, copyWidth);
+
+        return true;
+      });
+
+  if (failed || sheet.m_tileWidth == 0 || ShouldCancel(sheet.m_totalTiles, sheet.m_totalTiles))
+    return false;
+
+  const unsigned int sheets = (sheet.m_totalTiles + TILES_PER_SHEET - 1) / TILES_PER_SHEET;
+  while (sheetIndex < sheets)
+  {
+    const unsigned int tiles =
+        std::min(TILES_PER_SHEET, sheet.m_totalTiles - sheetIndex * TILES_PER_SHEET);
+    if (!WriteSheet(sheet, sheetIndex, pixels, tiles))
+      return false;
+    pixels.clear();
+    sheetIndex++;
+  }
+
+  sheet.m_complete = true;
+  return sheet.Save();
+}
+
+bool CVideoSpriteSheetJob::WriteSheet(CVideoSpriteSheet& sheet,
+                                      unsigned int index,
+                                      std::vector<uint8_t>& pixels,
+                                      unsigned int tiles)
+{
+  const unsigned int rows = (tiles + CVideoSpriteSheet::COLUMNS - 1) / CVideoSpriteSheet::COLUMNS;
+  const unsigned int width = CVideoSpriteSheet::COLUMNS * sheet.m_tileWidth;
+  const unsigned int height = rows * sheet.m_tileHeight;
+  if (pixels.empty())
+    pixels.assign(width * CVideoSpriteSheet::ROWS * sheet.m_tileHeight * 4, 0);
+
+  const std::string url = CVideoSpriteSheet::GetSheetURL(sheet.m_path, index);
+  CTextureDetails details;
+  details.file = CTextureCache::GetCacheFile(url) + ".jpg";
+  details.width = width;
+  details.height = height;
+  if (!CPicture::CreateThumbnailFromSurface(pixels.data(), width, height, width * 4,
+                                            CTextureCache::GetCachedPath(details.file)))
+    return false;
+
+  CTextureCache::GetInstance().AddCachedTexture(url, details);
+
+  sheet.m_tiles = index * TILES_PER_SHEET + tiles;
+  return sheet.Save();
+}
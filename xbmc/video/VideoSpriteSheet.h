@@ -0,0 +1,171 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/Job.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CFileItem;
+class CTexture;
+
+/*!
+ \brief Trick-play sprite sheets of a video file.
+
+ Key frames at fixed intervals are scaled down to tiles which are packed into sheets of
+ COLUMNS x ROWS tiles and stored in the texture cache. The preview for any time of the file
+ is then looked up in the sheets, without seeking in the player or reading the file again.
+
+ Sheets are built in the background by CVideoSpriteSheetJob, see Build(). The index is
+ saved after every finished sheet, so previews for the start of a file become available
+ while the rest is still being extracted.
+ */
+class CVideoSpriteSheet
+{
+public:
+  static constexpr unsigned int TILE_WIDTH = 240;
+  static constexpr unsigned int COLUMNS = 10;
+  static constexpr unsigned int ROWS = 10;
+  static constexpr int64_t MIN_INTERVAL = 10000; //!< ms between two tiles
+  static constexpr unsigned int MAX_TILES = 720; //!< longer files get longer intervals
+
+  struct Preview
+  {
+    std::string image; //!< texture cache url of the sheet, see CTextureUtils::GetWrappedImageURL
+    std::string cachedImage; //!< path of the sheet in the texture cache
+    unsigned int x = 0; //!< position of the tile in the sheet
+    unsigned int y = 0;
+    unsigned int width = 0; //!< size of the tile
+    unsigned int height = 0;
+    int64_t time = 0; //!< time of the tile in ms
+    int orientation = 0; //!< EXIF orientation of the tile
+  };
+
+  struct TilePosition
+  {
+    unsigned int sheet = 0; //!< index of the sheet holding the tile
+    unsigned int x = 0; //!< offset of the tile in the sheet in pixels
+    unsigned int y = 0;
+  };
+
+  explicit CVideoSpriteSheet(const std::string& path);
+  ~CVideoSpriteSheet();
+
+  /*!
+   \brief Load the index of the sheets built so far.
+   \return true if there is at least one finished sheet
+   */
+  bool Load();
+
+  /*!
+   \brief Look up the tile closest to a time.
+   \param time time in ms
+   \param[out] preview the sheet and position of the tile
+   \return false if no sheet covers the time (yet)
+   */
+  bool GetPreview(int64_t time, Preview& preview) const;
+
+  /*!
+   \brief Get a tile as an image of its own, for skins that can't show parts of a sheet.
+   The tile is cut from the sheet into special://temp and removed with the sprite sheet.
+   \param time time in ms
+   \return path of the image, empty if no sheet covers the time
+   */
+  std::string GetPreviewImage(int64_t time);
+
+  const std::string& GetPath() const { return m_path; }
+  bool IsComplete() const { return m_complete; }
+  int64_t GetInterval() const { return m_interval; }
+
+  /*!
+   \brief Queue building the sheets of an item in the background, unless they exist already.
+   \return true if sheets exist or are being built
+   */
+  static bool Build(const CFileItem& item);
+
+  /*!
+   \brief Whether sprite sheets can be built for an item.
+   */
+  static bool IsSupported(const CFileItem& item);
+
+  /*!
+   \brief Get the path of the media file of an item, e.g. of library items.
+   */
+  static std::string GetMediaPath(const CFileItem& item);
+
+  /*!
+   \brief Time between two tiles for a file of the given duration in ms.
+   */
+  static int64_t GetInterval(int64_t duration);
+
+  /*!
+   \brief Index of the tile closest to a time.
+   \param time time in ms
+   \param interval time between two tiles in ms
+   \param totalTiles tiles of the whole file, 0 if unknown
+   */
+  static unsigned int GetTile(int64_t time, int64_t interval, unsigned int totalTiles);
+
+  /*!
+   \brief Sheet and offset of a tile in the sheet, tiles are packed row by row.
+   */
+  static TilePosition GetTilePosition(unsigned int tile,
+                                      unsigned int tileWidth,
+                                      unsigned int tileHeight);
+
+  static std::string GetSheetURL(const std::string& path, unsigned int sheet);
+
+private:
+  friend class CVideoSpriteSheetJob;
+
+  bool Save() const;
+  std::string GetIndexFile() const;
+  void RemovePreviewImages();
+
+  std::string m_path;
+  int64_t m_interval = 0;
+  unsigned int m_tiles = 0; //!< tiles in the finished sheets
+  unsigned int m_totalTiles = 0; //!< tiles of the whole file
+  unsigned int m_tileWidth = 0;
+  unsigned int m_tileHeight = 0;
+  int m_orientation = 0;
+  bool m_complete = false;
+
+  // sheet the preview images are cut from
+  std::unique_ptr<CTexture> m_sheet;
+  unsigned int m_sheetIndex = 0;
+  std::vector<std::string> m_previewImages;
+};
+
+/*!
+ \ingroup jobs
+ \brief Builds the sprite sheets of a video file, see CVideoSpriteSheet.
+ */
+class CVideoSpriteSheetJob : public CJob
+{
+public:
+  explicit CVideoSpriteSheetJob(const CFileItem& item);
+  ~CVideoSpriteSheetJob() override;
+
+  bool DoWork() override;
+  const char* GetType() const override { return kJobTypeSpriteSheet; }
+  bool operator==(const CJob* job) const override;
+
+private:
+  bool WriteSheet(CVideoSpriteSheet& sheet,
+                  unsigned int index,
+                  std::vector<uint8_t>& pixels,
+                  unsigned int tiles);
+
+  std::string m_path;
+  int64_t m_duration = 0; //!< ms, 0 if unknown
+};
@@ -64,6 +64,20 @@ CThumbExtractor::CThumbExtractor(const CFileItem& item,
     m_item.SetPath(CStackDirectory::GetFirstStackedFile(m_item.GetPath()));
 }
 
+CThumbExtractor::CThumbExtractor(const CFileItem& item,
+                                 const std::string& listpath,
+                                 const std::vector<std::pair<std::string, int64_t>>& targets)
+  : CThumbExtractor(item,
+                    listpath,
+                    true,
+                    targets.empty() ? "" : targets.front().first,
+                    targets.empty() ? -1 : targets.front().second,
+                    false)
+{
+  if (!targets.empty())
+    m_extraTargets.assign(targets.begin() + 1, targets.end());
+}
+
 CThumbExtractor::~CThumbExtractor() = default;
 
 bool CThumbExtractor::operator==(const CJob* job) const
@@ -78,29 +92,37 @@ bool CThumbExtractor::operator==(const CJob* job) const
   return false;
 }
 
-bool CThumbExtractor::DoWork()
+bool CThumbExtractor::IsExtractable(const CFileItem& item)
 {
-  if (m_item.IsLiveTV()
+  if (item.IsLiveTV()
   // Due to a pvr addon api design flaw (no support for multiple concurrent streams
   // per addon instance), pvr recording thumbnail extraction does not work (reliably).
-  ||  URIUtils::IsPVRRecording(m_item.GetDynPath())
-  ||  URIUtils::IsUPnP(m_item.GetPath())
-  ||  URIUtils::IsBluray(m_item.GetPath())
-  ||  URIUtils::IsPlugin(m_item.GetDynPath()) // plugin path not fully resolved
-  ||  m_item.IsBDFile()
-  ||  m_item.IsDVD()
-  ||  m_item.IsDiscImage()
-  ||  m_item.IsDVDFile(false, true)
-  ||  m_item.IsInternetStream()
-  ||  m_item.IsDiscStub()
-  ||  m_item.IsPlayList())
+  ||  URIUtils::IsPVRRecording(item.GetDynPath())
+  ||  URIUtils::IsUPnP(item.GetPath())
+  ||  URIUtils::IsBluray(item.GetPath())
+  ||  URIUtils::IsPlugin(item.GetDynPath()) // plugin path not fully resolved
+  ||  item.IsBDFile()
+  ||  item.IsDVD()
+  ||  item.IsDiscImage()
+  ||  item.IsDVDFile(false, true)
+  ||  item.IsInternetStream()
+  ||  item.IsDiscStub()
+  ||  item.IsPlayList())
     return false;
 
   // For HTTP/FTP we only allow extraction when on a LAN
-  if (URIUtils::IsRemote(m_item.GetPath()) &&
-     !URIUtils::IsOnLAN(m_item.GetPath())  &&
-     (URIUtils::IsFTP(m_item.GetPath())    ||
-      URIUtils::IsHTTP(m_item.GetPath())))
+  if (URIUtils::IsRemote(item.GetPath()) &&
+     !URIUtils::IsOnLAN(item.GetPath())  &&
+     (URIUtils::IsFTP(item.GetPath())    ||
+      URIUtils::IsHTTP(item.GetPath())))
+    return false;
+
+  return true;
+}
+
+bool CThumbExtractor::DoWork()
+{
+  if (!IsExtractable(m_item))
     return false;
 
   bool result=false;
@@ -111,8 +133,26 @@ bool CThumbExtractor::DoWork()
     // construct the thumb cache file
     CTextureDetails details;
     details.file = CTextureCache::GetCacheFile(m_target) + ".jpg";
-    result = CDVDFileInfo::ExtractThumb(m_item, details, m_fillStreamDetails ? &m_item.GetVideoInfoTag()->m_streamDetails : nullptr, m_pos);
-    if (result)
+    std::vector<CTextureDetails> extraDetails(m_extraTargets.size());
+    std::vector<CDVDFileInfo::ThumbPosition> positions(m_extraTargets.size() + 1);
+    positions[0].pos = m_pos;
+    positions[0].details = &details;
+    for (size_t i = 0; i < m_extraTargets.size(); i++)
+    {
+      extraDetails[i].file = CTextureCache::GetCacheFile(m_extraTargets[i].first) + ".jpg";
+      positions[i + 1].pos = m_extraTargets[i].second;
+      positions[i + 1].details = &extraDetails[i];
+    }
+
+    result = CDVDFileInfo::ExtractThumbs(m_item, positions, m_fillStreamDetails ? &m_item.GetVideoInfoTag()->m_streamDetails : nullptr);
+
+    for (size_t i = 0; i < m_extraTargets.size(); i++)
+    {
+      if (positions[i + 1].extracted)
+        CTextureCache::GetInstance().AddCachedTexture(m_extraTargets[i].first, extraDetails[i]);
+    }
+
+    if (positions[0].extracted)
     {
       CTextureCache::GetInstance().AddCachedTexture(m_target, details);
       m_item.SetProperty("HasAutoThumb", true);
@@ -747,6 +787,10 @@ void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* jo
     CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg);
   }
   CJobQueue::OnJobComplete(jobID, success, job);
+
+  // keep the thumb decoders while further files are waiting for extraction only
+  if (!IsProcessing())
+    CDVDFileInfo::ReleaseThumbDecoders();
 }
 
 void CVideoThumbLoader::DetectAndAddMissingItemData(CFileItem &item)
@@ -13,6 +13,8 @@
 #include "utils/JobManager.h"
 
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 class CStreamDetails;
@@ -34,6 +36,14 @@ class CThumbExtractor : public CJob
 {
 public:
   CThumbExtractor(const CFileItem& item, const std::string& listpath, bool thumb, const std::string& strTarget="", int64_t pos = -1, bool fillStreamDetails = true);
+
+  /*!
+   \brief Extract thumbs for several positions of the file in a single pass, e.g. for chapters.
+   \param targets thumbpaths and the positions (in ms) to extract them from
+   */
+  CThumbExtractor(const CFileItem& item,
+                  const std::string& listpath,
+                  const std::vector<std::pair<std::string, int64_t>>& targets);
   ~CThumbExtractor() override;
 
   /*!
@@ -48,12 +58,18 @@ public:
 
   bool operator==(const CJob* job) const override;
 
+  /*!
+   \brief Whether frames may be extracted from the item, e.g. not from live TV or discs.
+   */
+  static bool IsExtractable(const CFileItem& item);
+
   std::string m_target; ///< thumbpath
   std::string m_listpath; ///< path used in fileitem list
   CFileItem  m_item;
   bool       m_thumb; ///< extract thumb?
   int64_t    m_pos; ///< position to extract thumb from
   bool m_fillStreamDetails; ///< fill in stream details?
+  std::vector<std::pair<std::string, int64_t>> m_extraTargets; ///< further thumbpaths and positions
 };
 
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
@@ -37,6 +37,7 @@
 #include "view/ViewState.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 using namespace KODI::MESSAGING;
@@ -263,6 +264,8 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
   }
 
   // add chapters if around
+  std::vector<std::pair<std::string, int64_t>> chapterThumbs;
+  std::vector<unsigned int> chapterThumbIdx;
   for (int i = 1; i <= g_application.GetAppPlayer().GetChapterCount(); ++i)
   {
     std::string chapterName;
@@ -285,11 +288,9 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
       item->SetArt("thumb", cachefile);
     else if (i > m_jobsStarted && CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTCHAPTERTHUMBS))
     {
-      CFileItem item(m_filePath, false);
-      CJob* job = new CThumbExtractor(item, m_filePath, true, chapterPath, pos * 1000, false);
-      AddJob(job);
-      m_mapJobsChapter[job] = i;
-      m_jobsStarted++;
+      chapterThumbs.emplace_back(chapterPath, pos * 1000);
+      chapterThumbIdx.push_back(i);
+      m_jobsStarted = i;
     }
 
     item->SetProperty("chapter", i);
@@ -298,6 +299,15 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
+  // extract all missing chapter thumbs in one pass through the file
+  if (!chapterThumbs.empty())
+  {
+    CFileItem item(m_filePath, false);
+    CJob* job = new CThumbExtractor(item, m_filePath, chapterThumbs);
+    AddJob(job);
+    m_mapJobsChapter[job] = chapterThumbIdx;
+  }
+
   // sort items by resume point
   std::sort(items.begin(), items.end(), [](const CFileItemPtr &item1, const CFileItemPtr &item2) {
     return item1->GetProperty("resumepoint").asDouble() < item2->GetProperty("resumepoint").asDouble();
@@ -568,9 +578,11 @@ void CGUIDialogVideoBookmarks::OnJobComplete(unsigned int jobID,
     MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
     if (iter != m_mapJobsChapter.end())
     {
-      unsigned int chapterIdx = (*iter).second;
-      CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
-      CApplicationMessenger::GetInstance().SendGUIMessage(m);
+      for (unsigned int chapterIdx : (*iter).second)
+      {
+        CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
+        CApplicationMessenger::GetInstance().SendGUIMessage(m);
+      }
       m_mapJobsChapter.erase(iter);
     }
   }
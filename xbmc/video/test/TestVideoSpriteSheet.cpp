@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "video/VideoSpriteSheet.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr unsigned int TILE_WIDTH = CVideoSpriteSheet::TILE_WIDTH;
+constexpr unsigned int TILE_HEIGHT = 135;
+
+void ExpectPosition(unsigned int tile, unsigned int sheet, unsigned int x, unsigned int y)
+{
+  const CVideoSpriteSheet::TilePosition position =
+      CVideoSpriteSheet::GetTilePosition(tile, TILE_WIDTH, TILE_HEIGHT);
+  EXPECT_EQ(sheet, position.sheet) << "tile " << tile;
+  EXPECT_EQ(x, position.x) << "tile " << tile;
+  EXPECT_EQ(y, position.y) << "tile " << tile;
+}
+} // unnamed namespace
+
+TEST(TestVideoSpriteSheet, GetInterval)
+{
+  // short files use the minimum interval
+  EXPECT_EQ(CVideoSpriteSheet::MIN_INTERVAL, CVideoSpriteSheet::GetInterval(0));
+  EXPECT_EQ(CVideoSpriteSheet::MIN_INTERVAL, CVideoSpriteSheet::GetInterval(60 * 60 * 1000));
+
+  // longer ones stay within MAX_TILES, rounded up to full seconds
+  EXPECT_EQ(15000, CVideoSpriteSheet::GetInterval(3 * 60 * 60 * 1000));
+  EXPECT_EQ(11000, CVideoSpriteSheet::GetInterval(2 * 60 * 60 * 1000 + 1));
+}
+
+TEST(TestVideoSpriteSheet, GetTile)
+{
+  EXPECT_EQ(0u, CVideoSpriteSheet::GetTile(-1000, 10000, 10));
+  EXPECT_EQ(0u, CVideoSpriteSheet::GetTile(0, 10000, 10));
+
+  // closest tile
+  EXPECT_EQ(0u, CVideoSpriteSheet::GetTile(4999, 10000, 10));
+  EXPECT_EQ(1u, CVideoSpriteSheet::GetTile(5000, 10000, 10));
+  EXPECT_EQ(1u, CVideoSpriteSheet::GetTile(14999, 10000, 10));
+
+  // times past the end get the last tile, unless the number of tiles is unknown
+  EXPECT_EQ(9u, CVideoSpriteSheet::GetTile(1000000, 10000, 10));
+  EXPECT_EQ(100u, CVideoSpriteSheet::GetTile(1000000, 10000, 0));
+}
+
+TEST(TestVideoSpriteSheet, GetTilePosition)
+{
+  // first sheet, row by row
+  ExpectPosition(0, 0, 0, 0);
+  ExpectPosition(1, 0, TILE_WIDTH, 0);
+  ExpectPosition(CVideoSpriteSheet::COLUMNS - 1, 0, (CVideoSpriteSheet::COLUMNS - 1) * TILE_WIDTH,
+                 0);
+  ExpectPosition(CVideoSpriteSheet::COLUMNS, 0, 0, TILE_HEIGHT);
+
+  const unsigned int tilesPerSheet = CVideoSpriteSheet::COLUMNS * CVideoSpriteSheet::ROWS;
+  ExpectPosition(tilesPerSheet - 1, 0, (CVideoSpriteSheet::COLUMNS - 1) * TILE_WIDTH,
+                 (CVideoSpriteSheet::ROWS - 1) * TILE_HEIGHT);
+
+  // following sheets start over at the top left
+  ExpectPosition(tilesPerSheet, 1, 0, 0);
+  ExpectPosition(2 * tilesPerSheet + 2 * CVideoSpriteSheet::COLUMNS + 3, 2, 3 * TILE_WIDTH,
+                 2 * TILE_HEIGHT);
+}